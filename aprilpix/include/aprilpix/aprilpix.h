@@ -13,7 +13,9 @@
 #ifndef APRILPIX_H
 #define APRILPIX_H
 
+#include <april/Image.h>
 #include <hltypes/harray.h>
+#include <hltypes/hsbase.h>
 #include <hltypes/hstring.h>
 
 #include "aprilpixExport.h"
@@ -25,6 +27,14 @@ namespace aprilpix
 	aprilpixFnExport void init();
 	aprilpixFnExport void destroy();
 	aprilpixFnExport harray<hstr> getExtensions();
+	/// @brief Loads a WEBP image, decoding it directly into the given format and size.
+	/// @param[in] stream The stream with the WEBP data.
+	/// @param[in] format The format to decode into. Use Image::Format::Invalid for RGBA/RGB depending on whether the image has alpha.
+	/// @param[in] width The width to scale to while decoding. Ignored unless both width and height are positive.
+	/// @param[in] height The height to scale to while decoding. Ignored unless both width and height are positive.
+	/// @return The loaded image or NULL if loading failed or WEBP support is not compiled in.
+	/// @note Scaling in the decoder is cheaper than loading the full image and scaling it afterwards.
+	aprilpixFnExport april::Image* loadWebp(hsbase& stream, april::Image::Format format, int width = 0, int height = 0);
 
 };
 
@@ -7,18 +7,467 @@
 /// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
 
 #ifdef _PVR
+#include <string.h>
+
+#include <april/april.h>
 #include <april/Image.h>
+#include <april/RenderSystem.h>
+#include <april/WorkerPool.h>
+#include <hltypes/harray.h>
 #include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
 #include <hltypes/hstream.h>
 
 #include "aprilpix.h"
 #include "ImagePvr.h"
 #include "PowerVR-SDK/PVRTGlobal.h"
 #include "PowerVR-SDK/PVRTTexture.h"
-#include "PowerVR-SDK/PVRTDecompress.h"
 
 namespace aprilpix
 {
+	// one word covers 4x4 pixels in 4bpp mode and 8x4 pixels in 2bpp mode
+	struct PvrtcWord
+	{
+		unsigned int modulation;
+		unsigned int color;
+	};
+
+	struct PvrtcDecodeData
+	{
+		unsigned int* words;
+		bool twoBitMode;
+		int wordWidth;
+		int wordHeight;
+		int wordsX;
+		int wordsY;
+		int trueWidth;
+		int trueHeight;
+		int width;
+		int height;
+		unsigned char* destData;
+		int destBpp;
+		int destIndices[4];
+		bool opaquePadding;
+		harray<unsigned int> twiddlesX;
+		harray<unsigned int> twiddlesY;
+	};
+
+	// colors are stored as red, green, blue, alpha with 5 bits per color channel and 4 bits for alpha
+	static inline void _getColorA(unsigned int data, int color[4])
+	{
+		if ((data & 0x8000) != 0) // opaque RGB 554
+		{
+			color[0] = (data & 0x7C00) >> 10;
+			color[1] = (data & 0x3E0) >> 5;
+			color[2] = (data & 0x1E) | ((data & 0x1E) >> 4);
+			color[3] = 0xF;
+		}
+		else // transparent ARGB 3443
+		{
+			color[0] = ((data & 0xF00) >> 7) | ((data & 0xF00) >> 11);
+			color[1] = ((data & 0xF0) >> 3) | ((data & 0xF0) >> 7);
+			color[2] = ((data & 0xE) << 1) | ((data & 0xE) >> 2);
+			color[3] = (data & 0x7000) >> 11;
+		}
+	}
+
+	static inline void _getColorB(unsigned int data, int color[4])
+	{
+		if ((data & 0x80000000) != 0) // opaque RGB 555
+		{
+			color[0] = (data & 0x7C000000) >> 26;
+			color[1] = (data & 0x3E00000) >> 21;
+			color[2] = (data & 0x1F0000) >> 16;
+			color[3] = 0xF;
+		}
+		else // transparent ARGB 3444
+		{
+			color[0] = ((data & 0xF000000) >> 23) | ((data & 0xF000000) >> 27);
+			color[1] = ((data & 0xF00000) >> 19) | ((data & 0xF00000) >> 23);
+			color[2] = ((data & 0xF0000) >> 15) | ((data & 0xF0000) >> 19);
+			color[3] = (data & 0x70000000) >> 27;
+		}
+	}
+
+	// bilinear upscale of the 4 word colors to the whole area, all loops over the 4 channels are kept simple so compilers can vectorize them
+	static void _interpolateColors(int p[4], int q[4], int r[4], int s[4], int result[32][4], bool twoBitMode)
+	{
+		int wordWidth = (twoBitMode ? 8 : 4);
+		int qp[4];
+		int sr[4];
+		int dy[4];
+		int value[4];
+		int i = 0;
+		int j = 0;
+		int c = 0;
+		for_iterx (c, 0, 4)
+		{
+			qp[c] = q[c] - p[c];
+			sr[c] = s[c] - r[c];
+			p[c] *= wordWidth;
+			r[c] *= wordWidth;
+		}
+		// 2bpp steps vertically in the inner loop, 4bpp horizontally
+		for_iterx (i, 0, wordWidth)
+		{
+			for_iterx (c, 0, 4)
+			{
+				value[c] = p[c] * 4;
+				dy[c] = r[c] - p[c];
+			}
+			for_iterx (j, 0, 4)
+			{
+				int* pixel = result[twoBitMode ? (j * wordWidth + i) : (i * wordWidth + j)];
+				if (twoBitMode)
+				{
+					for_iterx (c, 0, 3)
+					{
+						pixel[c] = (value[c] >> 7) + (value[c] >> 2);
+					}
+					pixel[3] = (value[3] >> 5) + (value[3] >> 1);
+				}
+				else
+				{
+					for_iterx (c, 0, 3)
+					{
+						pixel[c] = (value[c] >> 6) + (value[c] >> 1);
+					}
+					pixel[3] = (value[3] >> 4) + value[3];
+				}
+				for_iterx (c, 0, 4)
+				{
+					value[c] += dy[c];
+				}
+			}
+			for_iterx (c, 0, 4)
+			{
+				p[c] += qp[c];
+				r[c] += sr[c];
+			}
+		}
+	}
+
+	static void _unpackModulations(const PvrtcWord& word, int offsetX, int offsetY, int values[16][8], int modes[16][8], bool twoBitMode)
+	{
+		int mode = (word.color & 0x1);
+		unsigned int bits = word.modulation;
+		int x = 0;
+		int y = 0;
+		if (twoBitMode)
+		{
+			if (mode != 0)
+			{
+				if ((bits & 0x1) != 0) // H-only or V-only interpolation, the center texel's LSB decides which one
+				{
+					mode = ((bits & (0x1 << 20)) != 0 ? 3 : 2);
+					if ((bits & (0x1 << 21)) != 0)
+					{
+						bits |= (0x1 << 20);
+					}
+					else
+					{
+						bits &= ~(0x1 << 20);
+					}
+				}
+				if ((bits & 0x2) != 0)
+				{
+					bits |= 0x1;
+				}
+				else
+				{
+					bits &= ~0x1;
+				}
+				for_iterx (y, 0, 4)
+				{
+					for_iterx (x, 0, 8)
+					{
+						modes[x + offsetX][y + offsetY] = mode;
+						if (((x ^ y) & 1) == 0) // stored value
+						{
+							values[x + offsetX][y + offsetY] = (bits & 3);
+							bits >>= 2;
+						}
+					}
+				}
+			}
+			else // 1 bit per pixel
+			{
+				for_iterx (y, 0, 4)
+				{
+					for_iterx (x, 0, 8)
+					{
+						modes[x + offsetX][y + offsetY] = mode;
+						values[x + offsetX][y + offsetY] = ((bits & 1) != 0 ? 0x3 : 0x0);
+						bits >>= 1;
+					}
+				}
+			}
+		}
+		else if (mode != 0) // punch-through alpha mode, 2 means punch-through and is marked with +10
+		{
+			static const int punchThroughValues[4] = {0, 4, 14, 8};
+			for_iterx (y, 0, 4)
+			{
+				for_iterx (x, 0, 4)
+				{
+					values[y + offsetY][x + offsetX] = punchThroughValues[bits & 3];
+					bits >>= 2;
+				}
+			}
+		}
+		else
+		{
+			static const int standardValues[4] = {0, 3, 5, 8};
+			for_iterx (y, 0, 4)
+			{
+				for_iterx (x, 0, 4)
+				{
+					values[y + offsetY][x + offsetX] = standardValues[bits & 3];
+					bits >>= 2;
+				}
+			}
+		}
+	}
+
+	static inline int _getModulationValue(int values[16][8], int modes[16][8], int x, int y, bool twoBitMode)
+	{
+		if (!twoBitMode)
+		{
+			return values[x][y];
+		}
+		static const int repeatValues[4] = {0, 3, 5, 8};
+		if (modes[x][y] == 0 || ((x ^ y) & 1) == 0)
+		{
+			return repeatValues[values[x][y]];
+		}
+		if (modes[x][y] == 1) // H and V interpolation
+		{
+			return ((repeatValues[values[x][y - 1]] + repeatValues[values[x][y + 1]] + repeatValues[values[x - 1][y]] + repeatValues[values[x + 1][y]] + 2) / 4);
+		}
+		if (modes[x][y] == 2) // H-only
+		{
+			return ((repeatValues[values[x - 1][y]] + repeatValues[values[x + 1][y]] + 1) / 2);
+		}
+		// V-only
+		return ((repeatValues[values[x][y - 1]] + repeatValues[values[x][y + 1]] + 1) / 2);
+	}
+
+	// decodes the area between the centers of the 4 words
+	static void _decodeArea(const PvrtcWord& p, const PvrtcWord& q, const PvrtcWord& r, const PvrtcWord& s, unsigned char pixels[32][4], bool twoBitMode)
+	{
+		int values[16][8];
+		int modes[16][8];
+		int colorsA[32][4];
+		int colorsB[32][4];
+		int wordWidth = (twoBitMode ? 8 : 4);
+		_unpackModulations(p, 0, 0, values, modes, twoBitMode);
+		_unpackModulations(q, wordWidth, 0, values, modes, twoBitMode);
+		_unpackModulations(r, 0, 4, values, modes, twoBitMode);
+		_unpackModulations(s, wordWidth, 4, values, modes, twoBitMode);
+		int colorP[4];
+		int colorQ[4];
+		int colorR[4];
+		int colorS[4];
+		_getColorA(p.color, colorP);
+		_getColorA(q.color, colorQ);
+		_getColorA(r.color, colorR);
+		_getColorA(s.color, colorS);
+		_interpolateColors(colorP, colorQ, colorR, colorS, colorsA, twoBitMode);
+		_getColorB(p.color, colorP);
+		_getColorB(q.color, colorQ);
+		_getColorB(r.color, colorR);
+		_getColorB(s.color, colorS);
+		_interpolateColors(colorP, colorQ, colorR, colorS, colorsB, twoBitMode);
+		int modulation = 0;
+		bool punchThrough = false;
+		int index = 0;
+		int* colorA = NULL;
+		int* colorB = NULL;
+		unsigned char* pixel = NULL;
+		int x = 0;
+		int y = 0;
+		int c = 0;
+		for_iterx (y, 0, 4)
+		{
+			for_iterx (x, 0, wordWidth)
+			{
+				modulation = _getModulationValue(values, modes, x + wordWidth / 2, y + 2, twoBitMode);
+				punchThrough = (modulation > 10);
+				if (punchThrough)
+				{
+					modulation -= 10;
+				}
+				index = y * wordWidth + x;
+				colorA = colorsA[index];
+				colorB = colorsB[index];
+				// 4bpp is stored transposed, but since its area is square this can be mapped directly
+				pixel = pixels[twoBitMode ? index : (y + x * 4)];
+				for_iterx (c, 0, 4)
+				{
+					pixel[c] = (unsigned char)((colorA[c] * (8 - modulation) + colorB[c] * modulation) / 8);
+				}
+				if (punchThrough)
+				{
+					pixel[3] = 0;
+				}
+			}
+		}
+	}
+
+	static unsigned int _twiddle(unsigned int sizeX, unsigned int sizeY, unsigned int x, unsigned int y)
+	{
+		unsigned int minSize = sizeX;
+		unsigned int maxValue = y;
+		unsigned int result = 0;
+		unsigned int srcBit = 1;
+		unsigned int destBit = 1;
+		int shift = 0;
+		if (sizeY < sizeX)
+		{
+			minSize = sizeY;
+			maxValue = x;
+		}
+		while (srcBit < minSize)
+		{
+			if ((y & srcBit) != 0)
+			{
+				result |= destBit;
+			}
+			if ((x & srcBit) != 0)
+			{
+				result |= (destBit << 1);
+			}
+			srcBit <<= 1;
+			destBit <<= 2;
+			++shift;
+		}
+		return (result | ((maxValue >> shift) << (2 * shift)));
+	}
+
+	// decodes the areas whose top words are in the given rows, different rows write to different pixels so they can run in parallel
+	static void _decodeRows(void* bandData, int firstRow, int lastRow)
+	{
+		PvrtcDecodeData* data = (PvrtcDecodeData*)bandData;
+		unsigned char pixels[32][4];
+		PvrtcWord p;
+		PvrtcWord q;
+		PvrtcWord r;
+		PvrtcWord s;
+		unsigned int offset = 0;
+		unsigned char* pixel = NULL;
+		unsigned char* dest = NULL;
+		int rowP = 0;
+		int rowR = 0;
+		int columnP = 0;
+		int columnQ = 0;
+		int x = 0;
+		int y = 0;
+		int i = 0;
+		int j = 0;
+		int c = 0;
+		int halfWordWidth = data->wordWidth / 2;
+		int halfWordHeight = data->wordHeight / 2;
+		unsigned int* words = data->words;
+		for_iterx (j, firstRow, lastRow)
+		{
+			// the area starting at the last row wraps around to the first row
+			rowP = (j + data->wordsY - 1) % data->wordsY;
+			rowR = j;
+			for_iterx (i, 0, data->wordsX)
+			{
+				columnP = (i + data->wordsX - 1) % data->wordsX;
+				columnQ = i;
+				offset = (data->twiddlesX[columnP] | data->twiddlesY[rowP]) * 2;
+				p.modulation = words[offset];
+				p.color = words[offset + 1];
+				offset = (data->twiddlesX[columnQ] | data->twiddlesY[rowP]) * 2;
+				q.modulation = words[offset];
+				q.color = words[offset + 1];
+				offset = (data->twiddlesX[columnP] | data->twiddlesY[rowR]) * 2;
+				r.modulation = words[offset];
+				r.color = words[offset + 1];
+				offset = (data->twiddlesX[columnQ] | data->twiddlesY[rowR]) * 2;
+				s.modulation = words[offset];
+				s.color = words[offset + 1];
+				_decodeArea(p, q, r, s, pixels, data->twoBitMode);
+				// the area starts in the center of word P
+				for_iterx (y, 0, data->wordHeight)
+				{
+					int destY = (rowP * data->wordHeight + halfWordHeight + y) % data->trueHeight;
+					if (destY >= data->height)
+					{
+						continue;
+					}
+					for_iterx (x, 0, data->wordWidth)
+					{
+						int destX = (columnP * data->wordWidth + halfWordWidth + x) % data->trueWidth;
+						if (destX >= data->width)
+						{
+							continue;
+						}
+						pixel = pixels[y * data->wordWidth + x];
+						dest = &data->destData[(destX + destY * data->width) * data->destBpp];
+						for_iterx (c, 0, 4)
+						{
+							if (data->destIndices[c] >= 0)
+							{
+								dest[data->destIndices[c]] = pixel[c];
+							}
+						}
+						if (data->opaquePadding)
+						{
+							dest[data->destIndices[3]] = 0xFF;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	static bool _decodePvrtc(unsigned char* srcData, bool twoBitMode, int width, int height, unsigned char* destData, april::Image::Format destFormat)
+	{
+		PvrtcDecodeData data;
+		data.destBpp = destFormat.getBpp();
+		if (data.destBpp != 3 && data.destBpp != 4)
+		{
+			return false;
+		}
+		destFormat.getChannelIndices(&data.destIndices[0], &data.destIndices[1], &data.destIndices[2], &data.destIndices[3]);
+		// the padding byte of X formats is at the alpha index and is always opaque
+		data.opaquePadding = (data.destBpp == 4 && destFormat.getIndexAlpha() < 0);
+		data.words = (unsigned int*)srcData;
+		data.twoBitMode = twoBitMode;
+		data.wordWidth = (twoBitMode ? 8 : 4);
+		data.wordHeight = 4;
+		// PVRTC requires at least 2x2 words
+		data.trueWidth = hmax(width, data.wordWidth * 2);
+		data.trueHeight = hmax(height, data.wordHeight * 2);
+		data.wordsX = data.trueWidth / data.wordWidth;
+		data.wordsY = data.trueHeight / data.wordHeight;
+		data.width = width;
+		data.height = height;
+		data.destData = destData;
+		// twiddled offsets are separable into X and Y bits
+		for_iter (i, 0, data.wordsX)
+		{
+			data.twiddlesX += _twiddle(data.wordsX, data.wordsY, i, 0);
+		}
+		for_iter (i, 0, data.wordsY)
+		{
+			data.twiddlesY += _twiddle(data.wordsX, data.wordsY, 0, i);
+		}
+		int threshold = april::getParallelPixelThreshold();
+		if (threshold > 0 && width * height >= threshold)
+		{
+			april::WorkerPool::run(data.wordsY, &_decodeRows, &data);
+		}
+		else
+		{
+			_decodeRows(&data, 0, data.wordsY);
+		}
+		return true;
+	}
+
 	ImagePvr::ImagePvr() : april::Image()
 	{
 	}
@@ -28,6 +477,17 @@ namespace aprilpix
 	}
 	
 	april::Image* ImagePvr::load(hsbase& stream)
+	{
+		april::Image::Format format = april::Image::Format::RGBA;
+		// decoding straight into the format the GPU uses avoids another conversion on texture upload
+		if (april::rendersys != NULL)
+		{
+			format = april::rendersys->getNativeTextureFormat(format);
+		}
+		return ImagePvr::load(stream, format);
+	}
+
+	april::Image* ImagePvr::load(hsbase& stream, april::Image::Format format)
 	{
 		int size = (int)stream.size();
 		if (size < sizeof(PVR_Texture_Header))
@@ -35,32 +495,46 @@ namespace aprilpix
 			hlog::error(logTag, "PVR v1 not supported!");
 			return NULL;
 		}
-		uint8_t* data = new uint8_t[size];
-		stream.readRaw(data, size);
-		PVR_Texture_Header* header = (PVR_Texture_Header*)data;
-		if (header->dwWidth <= 0 || header->dwHeight <= 0)
+		PVR_Texture_Header header;
+		stream.readRaw(&header, sizeof(PVR_Texture_Header));
+		if (header.dwWidth <= 0 || header.dwHeight <= 0)
 		{
-			delete[] data;
 			hlog::error(logTag, "Could not load PVR meta data!");
 			return NULL;
 		}
-		if (header->dwBitCount != 4 && header->dwBitCount != 2 && header->dwpfFlags != MGLPT_PVRTC4 && header->dwpfFlags != OGL_PVRTC4)
+		if (header.dwBitCount != 4 && header.dwBitCount != 2 && header.dwpfFlags != MGLPT_PVRTC4 && header.dwpfFlags != OGL_PVRTC4)
 		{
 			hlog::error(logTag, "Unsupported pixel format!");
 			return NULL;
 		}
+		bool twoBitMode = (header.dwBitCount == 2);
+		int wordsX = hmax((int)header.dwWidth, twoBitMode ? 16 : 8) / (twoBitMode ? 8 : 4);
+		int wordsY = hmax((int)header.dwHeight, 8) / 4;
+		int dataSize = wordsX * wordsY * sizeof(PvrtcWord);
+		if (size - (int)sizeof(PVR_Texture_Header) < dataSize)
+		{
+			hlog::error(logTag, "PVR data is incomplete!");
+			return NULL;
+		}
+		unsigned char* data = new unsigned char[dataSize];
+		stream.readRaw(data, dataSize);
 		april::Image* image = new ImagePvr();
-		image->format = Format::RGBA;
-		image->w = header->dwWidth;
-		image->h = header->dwHeight;
+		image->format = (format.getBpp() == 3 || format.getBpp() == 4 ? format : april::Image::Format::RGBA);
+		image->w = header.dwWidth;
+		image->h = header.dwHeight;
 		image->data = new unsigned char[image->getByteSize()];
-		int twoBitMode = (header->dwBitCount == 2);
-		int result = PVRTDecompressPVRTC(&data[sizeof(PVR_Texture_Header)], twoBitMode, image->w, image->h, image->data);
-		if (result == 0)
+		_decodePvrtc(data, twoBitMode, image->w, image->h, image->data, image->format);
+		delete[] data;
+		if (image->format != format)
 		{
-			hlog::warn(logTag, "PVR reported 0 bytes decompressed!");
+			unsigned char* convertedData = NULL;
+			if (april::Image::convertToFormat(image->w, image->h, image->data, image->format, &convertedData, format))
+			{
+				delete[] image->data;
+				image->data = convertedData;
+				image->format = format;
+			}
 		}
-		delete[] data;
 		return image;
 	}
 
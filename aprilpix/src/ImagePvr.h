@@ -25,6 +25,7 @@ namespace aprilpix
 		~ImagePvr();
 
 		static april::Image* load(hsbase& stream);
+		static april::Image* load(hsbase& stream, april::Image::Format format);
 		static april::Image* loadMetaData(hsbase& stream);
 		//static bool save(hsbase& stream, april::Image*);
 	
@@ -12,12 +12,18 @@
 #include <webp/encode.h>
 #endif
 
+#include <april/april.h>
 #include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
 #include <hltypes/hstring.h>
 
 #include "aprilpix.h"
 #include "ImageWebp.h"
 
+#define HEADER_SIZE 64
+#define META_DATA_BUFFER_SIZE 4096
+#define CHUNK_SIZE 65536
+
 #define SAVE_QUALITY "quality"
 #define SAVE_QUALITY_DEFAULT 95.0f
 #define SAVE_LOSSLESS "lossless"
@@ -33,62 +39,156 @@ namespace aprilpix
 	{
 	}
 
+	// only formats that libwebp can write directly
+	static bool _getColorspace(april::Image::Format format, WEBP_CSP_MODE* colorspace)
+	{
+		if (format == april::Image::Format::RGBA || format == april::Image::Format::RGBX)
+		{
+			*colorspace = MODE_RGBA;
+		}
+		else if (format == april::Image::Format::BGRA || format == april::Image::Format::BGRX)
+		{
+			*colorspace = MODE_BGRA;
+		}
+		else if (format == april::Image::Format::ARGB || format == april::Image::Format::XRGB)
+		{
+			*colorspace = MODE_ARGB;
+		}
+		else if (format == april::Image::Format::RGB)
+		{
+			*colorspace = MODE_RGB;
+		}
+		else if (format == april::Image::Format::BGR)
+		{
+			*colorspace = MODE_BGR;
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+
+	// reads only as much data as is needed to get the features, the read data stays in the buffer so it can be decoded afterwards
+	static VP8StatusCode _getFeatures(hsbase& stream, unsigned char* buffer, int bufferSize, int& size, WebPBitstreamFeatures* features)
+	{
+		VP8StatusCode code = VP8_STATUS_NOT_ENOUGH_DATA;
+		int readSize = hmin(HEADER_SIZE, bufferSize);
+		int read = 0;
+		size = 0;
+		while (code == VP8_STATUS_NOT_ENOUGH_DATA && size < bufferSize)
+		{
+			read = stream.readRaw(&buffer[size], hmin(readSize, bufferSize - size));
+			if (read <= 0)
+			{
+				break;
+			}
+			size += read;
+			readSize = size;
+			code = WebPGetFeatures(buffer, size, features);
+		}
+		return code;
+	}
+
 	april::Image* ImageWebp::load(hsbase& stream)
 	{
-		int size = (int)stream.size();
-		uint8_t* data = new uint8_t[size];
-		stream.readRaw(data, size);
-		WebPBitstreamFeatures features;
-		VP8StatusCode code = WebPGetFeatures(data, size, &features);
-		if (code != VP8_STATUS_OK || features.width <= 0 || features.height <= 0)
+		return ImageWebp::load(stream, april::Image::Format::Invalid);
+	}
+
+	april::Image* ImageWebp::load(hsbase& stream, april::Image::Format format, int width, int height)
+	{
+		WebPDecoderConfig config;
+		if (!WebPInitDecoderConfig(&config))
+		{
+			hlog::error(logTag, "Could not initialize WEBP decoder!");
+			return NULL;
+		}
+		unsigned char* buffer = new unsigned char[CHUNK_SIZE];
+		int size = 0;
+		VP8StatusCode code = _getFeatures(stream, buffer, CHUNK_SIZE, size, &config.input);
+		if (code != VP8_STATUS_OK || config.input.width <= 0 || config.input.height <= 0)
 		{
 			hlog::error(logTag, "Could not load WEBP file!");
-			delete[] data;
+			delete[] buffer;
 			return NULL;
 		}
+		if (format == april::Image::Format::Invalid)
+		{
+			format = (config.input.has_alpha ? april::Image::Format::RGBA : april::Image::Format::RGB);
+		}
 		april::Image* image = new ImageWebp();
-		image->w = features.width;
-		image->h = features.height;
-		int bpp = 0;
-		if (features.has_alpha)
+		image->w = config.input.width;
+		image->h = config.input.height;
+		image->format = format;
+		WEBP_CSP_MODE colorspace = MODE_RGBA;
+		if (!_getColorspace(image->format, &colorspace))
 		{
-			image->format = Format::RGBA;
-			bpp = 4;
+			image->format = (config.input.has_alpha ? april::Image::Format::RGBA : april::Image::Format::RGB);
+			_getColorspace(image->format, &colorspace);
 		}
-		else
+		if (width > 0 && height > 0 && (width != image->w || height != image->h))
 		{
-			image->format = Format::RGB;
-			bpp = 3;
+			config.options.use_scaling = 1;
+			config.options.scaled_width = width;
+			config.options.scaled_height = height;
+			image->w = width;
+			image->h = height;
 		}
-		int imageDataSize = image->w * image->h * bpp;
-		image->data = new unsigned char[imageDataSize];
-		uint8_t* result = NULL;
-		if (bpp == 4)
+		image->data = new unsigned char[image->getByteSize()];
+		config.options.use_threads = 1;
+		config.output.colorspace = colorspace;
+		config.output.is_external_memory = 1;
+		config.output.u.RGBA.rgba = image->data;
+		config.output.u.RGBA.stride = image->w * image->getBpp();
+		config.output.u.RGBA.size = image->getByteSize();
+		WebPIDecoder* decoder = WebPIDecode(NULL, 0, &config);
+		if (decoder == NULL)
 		{
-			result = WebPDecodeRGBAInto(data, size, image->data, imageDataSize, image->w * bpp);
+			hlog::error(logTag, "Could not create WEBP decoder!");
+			delete[] buffer;
+			delete image;
+			return NULL;
 		}
-		else
+		// the data is decoded in chunks so the whole file never has to be copied
+		code = WebPIAppend(decoder, buffer, size);
+		int read = 0;
+		while (code == VP8_STATUS_SUSPENDED)
 		{
-			result = WebPDecodeRGBInto(data, size, image->data, imageDataSize, image->w * bpp);
+			read = stream.readRaw(buffer, CHUNK_SIZE);
+			if (read <= 0)
+			{
+				break;
+			}
+			code = WebPIAppend(decoder, buffer, read);
 		}
-		delete[] data;
-		if (result == NULL || result != image->data)
+		WebPIDelete(decoder);
+		WebPFreeDecBuffer(&config.output);
+		delete[] buffer;
+		if (code != VP8_STATUS_OK)
 		{
-			hlog::error(logTag, "Could not decode WEBP file! Possibly not enough memory allocated.");
+			hlog::error(logTag, "Could not decode WEBP file!");
 			delete image;
-			image = NULL;
+			return NULL;
+		}
+		if (image->format != format)
+		{
+			unsigned char* convertedData = NULL;
+			if (april::Image::convertToFormat(image->w, image->h, image->data, image->format, &convertedData, format))
+			{
+				delete[] image->data;
+				image->data = convertedData;
+				image->format = format;
+			}
 		}
 		return image;
 	}
 
 	april::Image* ImageWebp::loadMetaData(hsbase& stream)
 	{
-		int size = (int)stream.size();
-		uint8_t* data = new uint8_t[size];
-		stream.readRaw(data, size);
+		unsigned char buffer[META_DATA_BUFFER_SIZE];
+		int size = 0;
 		WebPBitstreamFeatures features;
-		VP8StatusCode code = WebPGetFeatures(data, size, &features);
-		delete[] data;
+		VP8StatusCode code = _getFeatures(stream, buffer, META_DATA_BUFFER_SIZE, size, &features);
 		if (code != VP8_STATUS_OK || features.width <= 0 || features.height <= 0)
 		{
 			hlog::error(logTag, "Could not load WEBP meta data!");
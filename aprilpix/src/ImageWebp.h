@@ -27,6 +27,7 @@ namespace aprilpix
 		~ImageWebp();
 
 		static april::Image* load(hsbase& stream);
+		static april::Image* load(hsbase& stream, april::Image::Format format, int width = 0, int height = 0);
 		static april::Image* loadMetaData(hsbase& stream);
 #ifndef _WEBP_NO_ENCODE
 		static bool save(hsbase& stream, april::Image* image, april::Image::SaveParameters parameters);
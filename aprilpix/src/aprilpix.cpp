@@ -57,4 +57,14 @@ namespace aprilpix
 		return extensions;
 	}
 
+	april::Image* loadWebp(hsbase& stream, april::Image::Format format, int width, int height)
+	{
+#ifdef _WEBP
+		return ImageWebp::load(stream, format, width, height);
+#else
+		hlog::error(logTag, "WEBP support is not available!");
+		return NULL;
+#endif
+	}
+
 }
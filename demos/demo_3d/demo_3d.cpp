@@ -28,6 +28,7 @@
 #include <april/RenderSystem.h>
 #include <april/SystemDelegate.h>
 #include <april/UpdateDelegate.h>
+#include <april/VertexBuffer.h>
 #include <april/Window.h>
 #include <hltypes/hlog.h>
 
@@ -41,6 +42,7 @@ april::Cursor* cursor = NULL;
 april::Texture* texture = NULL;
 april::Texture* logo = NULL;
 april::TexturedVertex v[36];
+april::VertexBuffer* cube = NULL;
 gvec2f cameraPosition(90.0f, 60.0f);
 gvec2f clickPosition;
 
@@ -106,9 +108,9 @@ public:
 		april::rendersys->rotate(1.0f, 0.0f, 0.0f, hclamp(position.y * 0.5f, -90.0f, 90.0f));
 		april::rendersys->rotate(0.0f, 1.0f, 0.0f, position.x * 0.5f);
 		april::rendersys->setTexture(texture);
-		april::rendersys->render(april::RenderOperation::TriangleList, v, 36);
+		april::rendersys->render(april::RenderOperation::TriangleList, cube, 0, 36);
 		april::rendersys->setTexture(logo);
-		april::rendersys->render(april::RenderOperation::TriangleList, v, 36);
+		april::rendersys->render(april::RenderOperation::TriangleList, cube, 0, 36);
 		return true;
 	}
 
@@ -226,6 +228,7 @@ void __aprilApplicationInit()
 	_side[0].set(_v[4]);	_side[1].set(_v[0]);	_side[2].set(_v[6]);	_side[3].set(_v[2]);	_COPY_VERTICES(v, _side, 24);
 	// right
 	_side[0].set(_v[5]);	_side[1].set(_v[1]);	_side[2].set(_v[7]);	_side[3].set(_v[3]);	_COPY_VERTICES(v, _side, 30);
+	cube = april::rendersys->createVertexBuffer(v, 36);
 }
 
 void __aprilApplicationDestroy()
@@ -236,6 +239,8 @@ void __aprilApplicationDestroy()
 	texture = NULL;
 	april::rendersys->destroyTexture(logo);
 	logo = NULL;
+	april::rendersys->destroyVertexBuffer(cube);
+	cube = NULL;
 	april::destroy();
 	delete updateDelegate;
 	updateDelegate = NULL;
@@ -0,0 +1,163 @@
+/// @file
+/// @version 4.0
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <april/april.h>
+#include <april/Color.h>
+#include <april/Image.h>
+#include <april/RenderSystem.h>
+#include <april/Texture.h>
+#include <gtypes/Rectangle.h>
+#include <hltypes/hlog.h>
+#include <hltypes/hstring.h>
+
+#include "NullRenderSystem.h"
+#include "NullTexture.h"
+
+NullRenderSystem::NullRenderSystem() : april::RenderSystem(), renderedVertexCount(0)
+{
+	this->name = "Null";
+}
+
+NullRenderSystem::~NullRenderSystem()
+{
+	this->destroy(); // has to be called here
+}
+
+void NullRenderSystem::wakeRenderThread()
+{
+	this->_wakeAsyncWaiting();
+}
+
+bool NullRenderSystem::processAsyncCommands(float timeout)
+{
+	if (this->update(0.0f))
+	{
+		return true;
+	}
+	return this->_waitForQueuedAsyncCommands(timeout);
+}
+
+void NullRenderSystem::_deviceInit()
+{
+	this->renderedVertexCount = 0;
+}
+
+bool NullRenderSystem::_deviceCreate(RenderSystem::Options options)
+{
+	return true;
+}
+
+bool NullRenderSystem::_deviceDestroy()
+{
+	return true;
+}
+
+void NullRenderSystem::_deviceAssignWindow(april::Window* window)
+{
+}
+
+void NullRenderSystem::_deviceSetupCaps()
+{
+	this->caps.maxTextureSize = 8192;
+	this->caps.npotTextures = true;
+}
+
+void NullRenderSystem::_deviceSetup()
+{
+}
+
+april::Texture* NullRenderSystem::_deviceCreateTexture(bool fromResource)
+{
+	return new NullTexture(fromResource);
+}
+
+void NullRenderSystem::_setDeviceViewport(cgrecti rect)
+{
+}
+
+void NullRenderSystem::_setDeviceModelviewMatrix(const gmat4& matrix)
+{
+}
+
+void NullRenderSystem::_setDeviceProjectionMatrix(const gmat4& matrix)
+{
+}
+
+void NullRenderSystem::_setDeviceDepthBuffer(bool enabled, bool writeEnabled)
+{
+}
+
+void NullRenderSystem::_setDeviceRenderMode(bool useTexture, bool useColor)
+{
+}
+
+void NullRenderSystem::_setDeviceTexture(april::Texture* texture)
+{
+}
+
+void NullRenderSystem::_setDeviceTextureFilter(const april::Texture::Filter& textureFilter)
+{
+}
+
+void NullRenderSystem::_setDeviceTextureAddressMode(const april::Texture::AddressMode& textureAddressMode)
+{
+}
+
+void NullRenderSystem::_setDeviceBlendMode(const april::BlendMode& blendMode)
+{
+}
+
+void NullRenderSystem::_setDeviceColorMode(const april::ColorMode& colorMode, float colorModeFactor, bool useTexture, bool useColor, const april::Color& systemColor)
+{
+}
+
+void NullRenderSystem::_setDeviceRenderTarget(april::Texture* texture)
+{
+}
+
+void NullRenderSystem::_deviceClear(bool depth)
+{
+}
+
+void NullRenderSystem::_deviceClear(const april::Color& color, bool depth)
+{
+}
+
+void NullRenderSystem::_deviceClearDepth()
+{
+}
+
+void NullRenderSystem::_deviceRender(const april::RenderOperation& renderOperation, const april::PlainVertex* vertices, int count)
+{
+	this->renderedVertexCount += count;
+}
+
+void NullRenderSystem::_deviceRender(const april::RenderOperation& renderOperation, const april::TexturedVertex* vertices, int count)
+{
+	this->renderedVertexCount += count;
+}
+
+void NullRenderSystem::_deviceRender(const april::RenderOperation& renderOperation, const april::ColoredVertex* vertices, int count)
+{
+	this->renderedVertexCount += count;
+}
+
+void NullRenderSystem::_deviceRender(const april::RenderOperation& renderOperation, const april::ColoredTexturedVertex* vertices, int count)
+{
+	this->renderedVertexCount += count;
+}
+
+april::Image::Format NullRenderSystem::getNativeTextureFormat(april::Image::Format format) const
+{
+	return format;
+}
+
+unsigned int NullRenderSystem::getNativeColorUInt(const april::Color& color) const
+{
+	return ((color.a << 24) | (color.b << 16) | (color.g << 8) | color.r);
+}
@@ -0,0 +1,71 @@
+/// @file
+/// @version 4.0
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#ifndef NULL_RENDER_SYSTEM_H
+#define NULL_RENDER_SYSTEM_H
+
+#include <april/RenderSystem.h>
+#include <april/Window.h>
+#include <hltypes/hstring.h>
+
+#define LOG_TAG "demo_benchmark"
+
+// executes all async commands like a real render system, but never touches any device
+class NullRenderSystem : public april::RenderSystem
+{
+public:
+	friend class NullTexture;
+
+	NullRenderSystem();
+	~NullRenderSystem();
+
+	inline int getVRam() const { return 0; }
+	inline int64_t getRenderedVertexCount() const { return this->renderedVertexCount; }
+
+	april::Image::Format getNativeTextureFormat(april::Image::Format format) const;
+	unsigned int getNativeColorUInt(const april::Color& color) const;
+
+	// the role of the main thread's render loop, processes one async command queue, the timeout is in milliseconds
+	bool processAsyncCommands(float timeout);
+	// makes a waiting processAsyncCommands() call return
+	void wakeRenderThread();
+
+protected:
+	int64_t renderedVertexCount;
+
+	void _deviceInit();
+	bool _deviceCreate(Options options);
+	bool _deviceDestroy();
+	void _deviceAssignWindow(april::Window* window);
+	void _deviceSetupCaps();
+	void _deviceSetup();
+
+	april::Texture* _deviceCreateTexture(bool fromResource);
+
+	void _setDeviceViewport(cgrecti rect);
+	void _setDeviceModelviewMatrix(const gmat4& matrix);
+	void _setDeviceProjectionMatrix(const gmat4& matrix);
+	void _setDeviceDepthBuffer(bool enabled, bool writeEnabled);
+	void _setDeviceRenderMode(bool useTexture, bool useColor);
+	void _setDeviceTexture(april::Texture* texture);
+	void _setDeviceTextureFilter(const april::Texture::Filter& textureFilter);
+	void _setDeviceTextureAddressMode(const april::Texture::AddressMode& textureAddressMode);
+	void _setDeviceBlendMode(const april::BlendMode& blendMode);
+	void _setDeviceColorMode(const april::ColorMode& colorMode, float colorModeFactor, bool useTexture, bool useColor, const april::Color& systemColor);
+	void _setDeviceRenderTarget(april::Texture* texture);
+
+	void _deviceClear(bool depth);
+	void _deviceClear(const april::Color& color, bool depth);
+	void _deviceClearDepth();
+	void _deviceRender(const april::RenderOperation& renderOperation, const april::PlainVertex* vertices, int count);
+	void _deviceRender(const april::RenderOperation& renderOperation, const april::TexturedVertex* vertices, int count);
+	void _deviceRender(const april::RenderOperation& renderOperation, const april::ColoredVertex* vertices, int count);
+	void _deviceRender(const april::RenderOperation& renderOperation, const april::ColoredTexturedVertex* vertices, int count);
+
+};
+#endif
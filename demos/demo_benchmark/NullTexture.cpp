@@ -0,0 +1,74 @@
+/// @file
+/// @version 4.0
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <april/april.h>
+#include <april/Image.h>
+#include <april/RenderSystem.h>
+
+#include "NullRenderSystem.h"
+#include "NullTexture.h"
+
+NullTexture::NullTexture(bool fromResource) : Texture(fromResource)
+{
+}
+
+NullTexture::~NullTexture()
+{
+}
+
+void* NullTexture::getBackendId() const
+{
+	return (void*)this;
+}
+
+bool NullTexture::_deviceCreateTexture(unsigned char* data, int size)
+{
+	this->firstUpload = true;
+	return true;
+}
+
+bool NullTexture::_deviceDestroyTexture()
+{
+	this->firstUpload = true;
+	return true;
+}
+
+void NullTexture::_assignFormat()
+{
+}
+
+april::Texture::Lock NullTexture::_tryLockSystem(int x, int y, int w, int h)
+{
+	Lock lock;
+	april::Image::Format nativeFormat = april::rendersys->getNativeTextureFormat(this->format);
+	lock.activateLock(0, 0, w, h, x, y, new unsigned char[w * h * nativeFormat.getBpp()], w, h, nativeFormat);
+	lock.systemBuffer = lock.data;
+	return lock;
+}
+
+bool NullTexture::_unlockSystem(april::Texture::Lock& lock, bool update)
+{
+	if (lock.systemBuffer == NULL)
+	{
+		return false;
+	}
+	// nothing is uploaded anywhere, the data is simply discarded
+	this->firstUpload = false;
+	delete[] lock.data;
+	return update;
+}
+
+bool NullTexture::_uploadToGpu(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, april::Image::Format srcFormat)
+{
+	if (this->format == april::Image::Format::Compressed || this->format == april::Image::Format::Palette || this->type == Type::External)
+	{
+		return false;
+	}
+	this->firstUpload = false;
+	return true;
+}
@@ -0,0 +1,36 @@
+/// @file
+/// @version 4.0
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#ifndef NULL_TEXTURE_H
+#define NULL_TEXTURE_H
+
+#include <april/Texture.h>
+
+class NullRenderSystem;
+
+class NullTexture : public april::Texture
+{
+public:
+	friend class NullRenderSystem;
+
+	NullTexture(bool fromResource);
+	~NullTexture();
+
+	void* getBackendId() const;
+
+protected:
+	bool _deviceCreateTexture(unsigned char* data, int size);
+	bool _deviceDestroyTexture();
+	void _assignFormat();
+
+	april::Texture::Lock _tryLockSystem(int x, int y, int w, int h);
+	bool _unlockSystem(april::Texture::Lock& lock, bool update);
+	bool _uploadToGpu(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, april::Image::Format srcFormat);
+
+};
+#endif
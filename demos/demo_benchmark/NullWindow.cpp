@@ -0,0 +1,45 @@
+/// @file
+/// @version 4.0
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <april/Window.h>
+#include <hltypes/hstring.h>
+
+#include "NullWindow.h"
+
+NullWindow::NullWindow() : april::Window(), width(0), height(0)
+{
+	this->name = "Null";
+}
+
+NullWindow::~NullWindow()
+{
+	this->destroy();
+}
+
+int NullWindow::getWidth() const
+{
+	return this->width;
+}
+
+int NullWindow::getHeight() const
+{
+	return this->height;
+}
+
+void* NullWindow::getBackendId() const
+{
+	return NULL;
+}
+
+void NullWindow::_systemCreate(int width, int height, bool fullscreen, chstr title, april::Window::Options options)
+{
+	april::Window::_systemCreate(width, height, false, title, options);
+	this->width = width;
+	this->height = height;
+	this->inputMode = april::InputMode::Mouse;
+}
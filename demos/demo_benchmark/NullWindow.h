@@ -0,0 +1,32 @@
+/// @file
+/// @version 4.0
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#ifndef NULL_WINDOW_H
+#define NULL_WINDOW_H
+
+#include <april/Window.h>
+#include <hltypes/hstring.h>
+
+class NullWindow : public april::Window
+{
+public:
+	NullWindow();
+	~NullWindow();
+
+	int getWidth() const;
+	int getHeight() const;
+	void* getBackendId() const;
+
+protected:
+	int width;
+	int height;
+
+	void _systemCreate(int width, int height, bool fullscreen, chstr title, april::Window::Options options);
+
+};
+#endif
@@ -0,0 +1,589 @@
+/// @file
+/// @version 4.0
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+// Headless benchmark of the engine's hot paths. Runs without a window or a real render device and writes the results
+// as JSON so they can be compared between releases.
+// usage: demo_benchmark [output filename] [scale]
+// The exit code is non-zero if the results could not be written or one of the correctness checks failed.
+
+#ifndef __ANDROID__
+	#ifndef _UWP
+		#define RESOURCE_PATH "../../demos/media/"
+	#else
+		#define RESOURCE_PATH "media/"
+	#endif
+#elif defined(__APPLE__)
+	#define RESOURCE_PATH "media/"
+#else
+	#define RESOURCE_PATH "./"
+#endif
+
+#include <string.h>
+
+#include <april/april.h>
+#include <april/Application.h>
+#include <april/Color.h>
+#include <april/CommandList.h>
+#include <april/Image.h>
+#include <april/Platform.h>
+#include <april/RenderSystem.h>
+#include <april/Texture.h>
+#include <april/Timer.h>
+#include <april/Window.h>
+#include <aprilpix/aprilpix.h>
+#include <gtypes/Matrix4.h>
+#include <gtypes/Rectangle.h>
+#include <gtypes/Vector2.h>
+#include <hltypes/harray.h>
+#include <hltypes/hfile.h>
+#include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hmutex.h>
+#include <hltypes/hresource.h>
+#include <hltypes/hstream.h>
+#include <hltypes/hstring.h>
+#include <hltypes/hthread.h>
+
+#include "NullRenderSystem.h"
+#include "NullWindow.h"
+#include "util/quadInstances.h"
+#include "util/vertexTransform.h"
+
+#define DEFAULT_OUTPUT_FILENAME "benchmark.json"
+#define IMAGE_SIZE 512
+#define WINDOW_WIDTH 1024
+#define WINDOW_HEIGHT 768
+#define MIN_BENCHMARK_TIME 0.25
+#define VERTEX_COUNT 6000
+#define INSTANCE_COUNT 1000
+#define RENDER_THREAD_TIMEOUT 5000.0f // in milliseconds
+
+class Result
+{
+public:
+	hstr group;
+	hstr name;
+	bool supported;
+	int iterations;
+	double time;
+	double units;
+	hstr unit;
+
+	Result(chstr group, chstr name) : supported(false), iterations(0), time(0.0), units(0.0)
+	{
+		this->group = group;
+		this->name = name;
+	}
+
+};
+
+static april::Timer timer;
+static harray<Result> results;
+static int scale = 1;
+
+static double _getTime()
+{
+	return (timer.getTime() * timer.getResolution());
+}
+
+static hstr _escapeJson(chstr string)
+{
+	return string.replaced("\\", "\\\\").replaced("\"", "\\\"");
+}
+
+// repeats a function until enough time has passed to get a stable measurement
+static void _run(chstr group, chstr name, bool (*function)(void* data), void* data, double unitsPerIteration, chstr unit)
+{
+	Result result(group, name);
+	result.unit = unit;
+	result.supported = (*function)(data); // warm-up run, also checks whether the operation is supported
+	if (result.supported)
+	{
+		double start = _getTime();
+		double time = 0.0;
+		while (time < MIN_BENCHMARK_TIME * scale)
+		{
+			(*function)(data);
+			++result.iterations;
+			time = _getTime() - start;
+		}
+		result.time = time;
+		result.units = unitsPerIteration * result.iterations;
+		hlog::writef(LOG_TAG, "%s / %s: %.3f ms per iteration", group.cStr(), name.cStr(), time * 1000.0 / result.iterations);
+	}
+	else
+	{
+		hlog::writef(LOG_TAG, "%s / %s: not supported", group.cStr(), name.cStr());
+	}
+	results += result;
+}
+
+static harray<april::Image::Format> _getPixelFormats()
+{
+	harray<april::Image::Format> formats = april::Image::Format::getValues();
+	formats -= april::Image::Format::Invalid;
+	formats -= april::Image::Format::Compressed;
+	formats -= april::Image::Format::Palette;
+	return formats;
+}
+
+// image data
+
+class ImageData
+{
+public:
+	unsigned char* srcData;
+	april::Image::Format srcFormat;
+	unsigned char* destData;
+	april::Image::Format destFormat;
+
+	ImageData(april::Image::Format srcFormat, april::Image::Format destFormat) : srcFormat(srcFormat), destFormat(destFormat)
+	{
+		int size = IMAGE_SIZE * IMAGE_SIZE;
+		this->srcData = new unsigned char[size * srcFormat.getBpp()];
+		this->destData = new unsigned char[size * destFormat.getBpp()];
+		int srcSize = size * srcFormat.getBpp();
+		for_iter (i, 0, srcSize)
+		{
+			this->srcData[i] = (unsigned char)((i * 7 + (i >> 11)) & 0xFF); // varying alpha values so no blending path is trivial
+		}
+		memset(this->destData, 0x80, size * destFormat.getBpp());
+	}
+
+	~ImageData()
+	{
+		delete[] this->srcData;
+		delete[] this->destData;
+	}
+
+};
+
+static bool _convertToFormat(void* data)
+{
+	ImageData* image = (ImageData*)data;
+	return april::Image::convertToFormat(IMAGE_SIZE, IMAGE_SIZE, image->srcData, image->srcFormat, &image->destData, image->destFormat);
+}
+
+static bool _write(void* data)
+{
+	ImageData* image = (ImageData*)data;
+	return april::Image::write(0, 0, IMAGE_SIZE, IMAGE_SIZE, 0, 0, image->srcData, IMAGE_SIZE, IMAGE_SIZE, image->srcFormat,
+		image->destData, IMAGE_SIZE, IMAGE_SIZE, image->destFormat);
+}
+
+static bool _blit(void* data)
+{
+	ImageData* image = (ImageData*)data;
+	return april::Image::blit(0, 0, IMAGE_SIZE, IMAGE_SIZE, 0, 0, image->srcData, IMAGE_SIZE, IMAGE_SIZE, image->srcFormat,
+		image->destData, IMAGE_SIZE, IMAGE_SIZE, image->destFormat, 192);
+}
+
+static bool _writeStretch(void* data)
+{
+	ImageData* image = (ImageData*)data;
+	return april::Image::writeStretch(0, 0, IMAGE_SIZE / 2, IMAGE_SIZE / 2, 0, 0, IMAGE_SIZE, IMAGE_SIZE, image->srcData, IMAGE_SIZE, IMAGE_SIZE,
+		image->srcFormat, image->destData, IMAGE_SIZE, IMAGE_SIZE, image->destFormat);
+}
+
+static bool _blitStretch(void* data)
+{
+	ImageData* image = (ImageData*)data;
+	return april::Image::blitStretch(0, 0, IMAGE_SIZE / 2, IMAGE_SIZE / 2, 0, 0, IMAGE_SIZE, IMAGE_SIZE, image->srcData, IMAGE_SIZE, IMAGE_SIZE,
+		image->srcFormat, image->destData, IMAGE_SIZE, IMAGE_SIZE, image->destFormat, 192);
+}
+
+static void _benchmarkPixelOperations()
+{
+	harray<april::Image::Format> formats = _getPixelFormats();
+	double pixels = IMAGE_SIZE * IMAGE_SIZE * 0.000001;
+	hstr name;
+	foreach (april::Image::Format, it, formats)
+	{
+		foreach (april::Image::Format, it2, formats)
+		{
+			name = (*it).getName() + "->" + (*it2).getName();
+			ImageData data(*it, *it2);
+			if ((*it) != (*it2))
+			{
+				_run("convertToFormat", name, &_convertToFormat, &data, pixels, "MPixels");
+			}
+			_run("write", name, &_write, &data, pixels, "MPixels");
+			_run("blit", name, &_blit, &data, pixels, "MPixels");
+			_run("writeStretch", name, &_writeStretch, &data, pixels, "MPixels");
+			_run("blitStretch", name, &_blitStretch, &data, pixels, "MPixels");
+		}
+	}
+}
+
+// decoders
+
+class DecodeData
+{
+public:
+	hstream stream;
+	hstr extension;
+	double pixels;
+
+	DecodeData(chstr filename) : pixels(0.0)
+	{
+		hresource file;
+		file.open(filename);
+		this->stream.writeRaw(file);
+		this->stream.rewind();
+		this->extension = "." + hfile::extensionOf(filename);
+	}
+
+};
+
+static bool _decode(void* data)
+{
+	DecodeData* decode = (DecodeData*)data;
+	decode->stream.rewind();
+	april::Image* image = april::Image::createFromStream(decode->stream, decode->extension);
+	if (image == NULL)
+	{
+		return false;
+	}
+	decode->pixels = image->w * image->h * 0.000001;
+	delete image;
+	return true;
+}
+
+// compares the throughput of 2 already measured decoders
+static void _compareDecoders(chstr name, chstr referenceName)
+{
+	Result* result = NULL;
+	Result* reference = NULL;
+	foreach (Result, it, results)
+	{
+		if ((*it).group == "decode" && (*it).supported)
+		{
+			if ((*it).name == name)
+			{
+				result = &(*it);
+			}
+			else if ((*it).name == referenceName)
+			{
+				reference = &(*it);
+			}
+		}
+	}
+	if (result != NULL && reference != NULL)
+	{
+		hlog::writef(LOG_TAG, "decode / %s: %.2fx the speed of %s", name.cStr(),
+			(result->units / result->time) / (reference->units / reference->time), referenceName.cStr());
+	}
+}
+
+static void _benchmarkDecoders()
+{
+	harray<hstr> filenames;
+	filenames += "logo.png";
+	filenames += "texture.jpg";
+	filenames += "jpt_final.jpt";
+	filenames += "pvr_RGBA4.pvr";
+	filenames += "pvr_RGB2.pvr";
+	filenames += "pvr_RGB4.pvr";
+	filenames += "pvr_RGBA2.pvr";
+	filenames += "etc1.etcx";
+	filenames += "rgb_only.etcx";
+	filenames += "pix.webp";
+	foreach (hstr, it, filenames)
+	{
+		if (!hresource::exists(hstr(RESOURCE_PATH) + (*it)))
+		{
+			hlog::writef(LOG_TAG, "decode / %s: file not found", (*it).cStr());
+			continue;
+		}
+		DecodeData data(hstr(RESOURCE_PATH) + (*it));
+		_decode(&data); // to get the image size
+		_run("decode", (*it), &_decode, &data, data.pixels, "MPixels");
+	}
+	// etc1.etcx is the ETC1 encoded version of logo.png
+	_compareDecoders("etc1.etcx", "logo.png");
+}
+
+// async command queues
+
+#define DRAWS_PER_FRAME 1000
+#define FRAMES_PER_ITERATION 10
+
+static hmutex renderThreadMutex;
+static bool renderThreadStopping = false;
+
+static void _renderThreadUpdate(hthread* thread)
+{
+	NullRenderSystem* rendersys = (NullRenderSystem*)april::rendersys;
+	hmutex::ScopeLock lock;
+	while (true)
+	{
+		lock.acquire(&renderThreadMutex);
+		if (renderThreadStopping)
+		{
+			break;
+		}
+		lock.release();
+		rendersys->processAsyncCommands(RENDER_THREAD_TIMEOUT);
+	}
+}
+
+static hthread renderThread(&_renderThreadUpdate, "APRIL benchmark render");
+
+static void _stopRenderThread()
+{
+	hmutex::ScopeLock lock(&renderThreadMutex);
+	renderThreadStopping = true;
+	lock.release();
+	((NullRenderSystem*)april::rendersys)->wakeRenderThread();
+	renderThread.join();
+}
+
+static bool _renderFrames(void* data)
+{
+	static grectf drawRect(0.0f, 0.0f, (float)WINDOW_WIDTH, (float)WINDOW_HEIGHT);
+	april::Texture* texture = (april::Texture*)data;
+	grectf rect(0.0f, 0.0f, 32.0f, 32.0f);
+	for_iter (i, 0, FRAMES_PER_ITERATION)
+	{
+		april::rendersys->clear();
+		april::rendersys->setOrthoProjection(drawRect);
+		april::rendersys->setTexture(texture);
+		for_iter (j, 0, DRAWS_PER_FRAME)
+		{
+			rect.x = (float)((j * 37) % (WINDOW_WIDTH - 32));
+			rect.y = (float)((j * 53) % (WINDOW_HEIGHT - 32));
+			if (texture != NULL)
+			{
+				april::rendersys->drawTexturedRect(rect, grectf(0.0f, 0.0f, 1.0f, 1.0f), april::Color(255, 255, 255, j & 0xFF));
+			}
+			else
+			{
+				april::rendersys->drawFilledRect(rect, april::Color(j & 0xFF, 128, 255, 192));
+			}
+		}
+		april::rendersys->flushFrame(true);
+		april::rendersys->presentFrame();
+	}
+	april::rendersys->waitForAsyncCommands();
+	return true;
+}
+
+static void _benchmarkRendering()
+{
+	april::Texture* texture = april::rendersys->createTexture(64, 64, april::Color::White, april::Image::Format::RGBA, april::Texture::Type::Managed);
+	double draws = DRAWS_PER_FRAME * FRAMES_PER_ITERATION;
+	_run("asyncQueue", "drawFilledRect", &_renderFrames, NULL, draws, "draws");
+	_run("asyncQueue", "drawTexturedRect", &_renderFrames, texture, draws, "draws");
+	april::rendersys->destroyTexture(texture);
+	april::rendersys->waitForAsyncCommands(true);
+}
+
+// vertex processing
+// Layered2D is disabled in the render system, these are the per-vertex paths every 2D draw call goes through instead
+
+class VertexData
+{
+public:
+	gmat4 matrix;
+	april::PlainVertex plainVertices[VERTEX_COUNT];
+	april::ColoredVertex coloredVertices[VERTEX_COUNT];
+	april::TexturedVertex texturedVertices[VERTEX_COUNT];
+	april::ColoredTexturedVertex coloredTexturedVertices[VERTEX_COUNT];
+	april::QuadInstance instances[INSTANCE_COUNT];
+	april::ColoredTexturedVertex instanceVertices[INSTANCE_COUNT * APRIL_QUAD_INSTANCE_VERTICES_COUNT];
+
+	VertexData(bool projection)
+	{
+		this->matrix.setIdentity();
+		this->matrix.translate(100.0f, 50.0f, 0.0f);
+		this->matrix.rotate(0.0f, 0.0f, 1.0f, 30.0f);
+		this->matrix.scale(1.5f, 1.5f, 1.0f);
+		if (projection)
+		{
+			gmat4 perspective;
+			perspective.setPerspective(60.0f, (float)WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 1000.0f);
+			this->matrix = perspective * this->matrix;
+		}
+		for_iter (i, 0, VERTEX_COUNT)
+		{
+			this->plainVertices[i].set((float)((i * 37) % WINDOW_WIDTH), (float)((i * 53) % WINDOW_HEIGHT), 0.0f);
+			this->texturedVertices[i].set(this->plainVertices[i].x, this->plainVertices[i].y, 0.0f);
+			this->texturedVertices[i].u = (i & 1) * 1.0f;
+			this->texturedVertices[i].v = ((i >> 1) & 1) * 1.0f;
+		}
+		for_iter (i, 0, INSTANCE_COUNT)
+		{
+			this->instances[i].setTransform(gvec2f((float)((i * 37) % WINDOW_WIDTH), (float)((i * 53) % WINDOW_HEIGHT)), gvec2f(1.0f, 1.0f), (float)(i % 360));
+			this->instances[i].color = 0xFF000000 | (unsigned int)(i * 0x010203);
+		}
+	}
+
+};
+
+static bool _transformPlainVertices(void* data)
+{
+	VertexData* vertices = (VertexData*)data;
+	gvec2f minimum;
+	gvec2f maximum;
+	april::transformVertices(vertices->matrix, vertices->plainVertices, VERTEX_COUNT, 0xFFFFFFFF, vertices->coloredVertices, minimum, maximum);
+	return true;
+}
+
+static bool _transformTexturedVertices(void* data)
+{
+	VertexData* vertices = (VertexData*)data;
+	gvec2f minimum;
+	gvec2f maximum;
+	april::transformVertices(vertices->matrix, vertices->texturedVertices, VERTEX_COUNT, 0xFFFFFFFF, vertices->coloredTexturedVertices, minimum, maximum);
+	return true;
+}
+
+static bool _expandQuadInstances(void* data)
+{
+	VertexData* vertices = (VertexData*)data;
+	april::expandQuadInstances(grectf(-16.0f, -16.0f, 32.0f, 32.0f), 0.0f, vertices->instances, INSTANCE_COUNT, vertices->instanceVertices);
+	return true;
+}
+
+static void _benchmarkVertexProcessing()
+{
+	double vertices = VERTEX_COUNT * 0.000001;
+	// heap allocated, the arrays are too large for the stack
+	VertexData* affine = new VertexData(false);
+	VertexData* projection = new VertexData(true);
+	_run("transformVertices", "PlainVertex affine", &_transformPlainVertices, affine, vertices, "MVertices");
+	_run("transformVertices", "PlainVertex projection", &_transformPlainVertices, projection, vertices, "MVertices");
+	_run("transformVertices", "TexturedVertex affine", &_transformTexturedVertices, affine, vertices, "MVertices");
+	_run("transformVertices", "TexturedVertex projection", &_transformTexturedVertices, projection, vertices, "MVertices");
+	_run("expandQuadInstances", "QuadInstance", &_expandQuadInstances, affine, INSTANCE_COUNT * 0.000001, "MInstances");
+	delete affine;
+	delete projection;
+}
+
+// verification
+
+static bool verified = true;
+
+static void _verify(chstr name, bool result)
+{
+	if (!result)
+	{
+		hlog::error(LOG_TAG, "verify / " + name + ": failed");
+		verified = false;
+	}
+}
+
+static void _verifyCommandList()
+{
+	// recording must not change the frame stats, executing must add the recorded calls once
+	april::rendersys->clear();
+	april::rendersys->setOrthoProjection(grectf(0.0f, 0.0f, (float)WINDOW_WIDTH, (float)WINDOW_HEIGHT));
+	april::rendersys->drawFilledRect(grectf(0.0f, 0.0f, 32.0f, 32.0f), april::Color::White);
+	int renderCalls = april::rendersys->getStatCurrentFrameRenderCalls();
+	int vertexCount = april::rendersys->getStatCurrentFrameVertexCount();
+	april::rendersys->beginCommandList();
+	for_iter (i, 0, 3)
+	{
+		april::rendersys->drawFilledRect(grectf(i * 40.0f, 0.0f, 32.0f, 32.0f), april::Color::White);
+	}
+	april::CommandList* commandList = april::rendersys->endCommandList();
+	_verify("commandList record", commandList != NULL && commandList->getRenderCalls() == 3 && commandList->getVertexCount() > 0 &&
+		april::rendersys->getStatCurrentFrameRenderCalls() == renderCalls && april::rendersys->getStatCurrentFrameVertexCount() == vertexCount);
+	if (commandList != NULL)
+	{
+		april::rendersys->executeCommandList(commandList);
+		_verify("commandList execute", april::rendersys->getStatCurrentFrameRenderCalls() == renderCalls + commandList->getRenderCalls() &&
+			april::rendersys->getStatCurrentFrameVertexCount() == vertexCount + commandList->getVertexCount());
+		april::rendersys->destroyCommandList(commandList);
+	}
+	april::rendersys->flushFrame(true);
+	april::rendersys->presentFrame();
+	april::rendersys->waitForAsyncCommands(true);
+}
+
+// output
+
+static bool _writeResults(chstr filename)
+{
+	hfile file;
+	file.open(filename, hfaccess::Write);
+	if (!file.isOpen())
+	{
+		hlog::error(LOG_TAG, "Could not open output file: " + filename);
+		return false;
+	}
+	april::SystemInfo info = april::getSystemInfo();
+	file.write("{\n");
+	file.write(hsprintf("\t\"platform\": \"%s %s\",\n", APRIL_PLATFORM_NAME, APRIL_PLATFORM_ARCHITECTURE));
+	file.write(hsprintf("\t\"osVersion\": \"%s\",\n", _escapeJson(info.osVersion.toString()).cStr()));
+	file.write(hsprintf("\t\"cpuCores\": %d,\n", info.cpuCores));
+	file.write(hsprintf("\t\"imageSize\": %d,\n", IMAGE_SIZE));
+	file.write(hsprintf("\t\"scale\": %d,\n", scale));
+	file.write("\t\"results\": [\n");
+	for_iter (i, 0, results.size())
+	{
+		Result& result = results[i];
+		file.write(hsprintf("\t\t{\"group\": \"%s\", \"name\": \"%s\", \"supported\": %s", _escapeJson(result.group).cStr(),
+			_escapeJson(result.name).cStr(), result.supported ? "true" : "false"));
+		if (result.supported)
+		{
+			file.write(hsprintf(", \"iterations\": %d, \"time\": %.6f, \"timePerIteration\": %.9f, \"throughput\": %.3f, \"unit\": \"%s/s\"",
+				result.iterations, result.time, result.time / result.iterations, result.units / result.time, result.unit.cStr()));
+		}
+		file.write(i < results.size() - 1 ? "},\n" : "}\n");
+	}
+	file.write("\t]\n");
+	file.write("}\n");
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	hstr filename = DEFAULT_OUTPUT_FILENAME;
+	if (argc > 1)
+	{
+		filename = argv[1];
+	}
+	if (argc > 2)
+	{
+		scale = hmax((int)hstr(argv[2]), 1);
+	}
+	// no main loop is entered, the application object only has to exist
+	april::application = new april::Application(NULL, NULL);
+	april::init(new NullRenderSystem(), new NullWindow());
+	aprilpix::init();
+	// a separate thread plays the role of the main thread's render loop
+	renderThread.start();
+	april::createRenderSystem();
+	april::createWindow(WINDOW_WIDTH, WINDOW_HEIGHT, false, "APRIL: Benchmark");
+	_benchmarkPixelOperations();
+	_benchmarkDecoders();
+	_benchmarkRendering();
+	_benchmarkVertexProcessing();
+	_verifyCommandList();
+	bool result = _writeResults(filename);
+	if (result)
+	{
+		hlog::write(LOG_TAG, "Results written to: " + filename);
+	}
+	// same as april::destroy(), but the render thread has to be stopped before the systems are deleted
+	april::rendersys->waitForAsyncCommands(true);
+	april::window->unassign();
+	april::rendersys->destroy();
+	april::window->destroy();
+	april::rendersys->waitForAsyncCommands(true);
+	_stopRenderThread();
+	aprilpix::destroy();
+	delete april::window;
+	april::window = NULL;
+	delete april::rendersys;
+	april::rendersys = NULL;
+	delete april::application;
+	april::application = NULL;
+	return (result && verified ? 0 : 1);
+}
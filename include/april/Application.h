@@ -26,6 +26,7 @@
 
 namespace april
 {
+	class Semaphore;
 	class Window;
 
 	/// @brief Defines a generic application.
@@ -62,6 +63,8 @@ namespace april
 		/// @param[in] aprilApplicationInit Initialization callback.
 		/// @param[in] aprilApplicationDestroy Destruction callback.
 		Application(void (*aprilApplicationInit)(), void (*aprilApplicationDestroy)());
+		/// @brief Destructor.
+		~Application();
 
 		/// @brief Get/Set launch arguments.
 		HL_DEFINE_GETSET(harray<hstr>, args, Args);
@@ -144,8 +147,6 @@ namespace april
 		Timer timer;
 		/// @brief The current time since the last frame.
 		double timeDelta;
-		/// @brief The Timer object used for timing frame rendering to adjust the update thread sleep time.
-		Timer frameTimer;
 		/// @brief FPS of the last mesaure.
 		int fps;
 		/// @brief Current counter for FPS calculation.
@@ -171,18 +172,26 @@ namespace april
 		hmutex stateMutex;
 		/// @brief The time-delta mutex.
 		hmutex timeDeltaMutex;
-		/// @brief The frame timer mutex.
-		hmutex frameTimerMutex;
+		/// @brief Signaled whenever the application state changes.
+		Semaphore* stateSemaphore;
+		/// @brief Signaled when the update-thread has accepted a queued suspend.
+		Semaphore* suspendSemaphore;
 		/// @brief The message-box queue mutex.
 		hmutex messageBoxMutex;
 
 		/// @brief Set State.
 		/// @param[in] value New State.
 		void _setState(const State& value);
+		/// @brief Wakes up all threads waiting for a state change or thread handoff.
+		void _signalStateChange();
+		/// @brief Clears a queued update-thread suspend and wakes up the thread waiting for it.
+		void _unlockUpdateSuspend();
 		/// @brief Performs the update of one frame, but without any timer.
 		bool _updateSystem();
 		/// @brief Processes message box displays.
 		void _updateMessageBoxQueue();
+		/// @brief Waits until a new frame has been queued for rendering or until system events need to be processed again.
+		void _waitForQueuedFrame();
 		/// @brief Performs FPS counter update.
 		void _updateFps();
 
@@ -0,0 +1,66 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a recorded list of render commands.
+
+#ifndef APRIL_COMMAND_LIST_H
+#define APRIL_COMMAND_LIST_H
+
+#include <hltypes/harray.h>
+#include <hltypes/hltypesUtil.h>
+
+#include "aprilExport.h"
+
+namespace april
+{
+	class CommandListRenderCommand;
+	class DestroyCommandListCommand;
+	class RenderCommand;
+	class RenderSystem;
+
+	/// @brief Defines a recorded list of render commands that can be executed any number of times.
+	/// @note The list owns copies of all recorded vertices. Textures and vertex buffers used during recording have to stay alive as long as the list is used.
+	class aprilExport CommandList
+	{
+	public:
+		friend class CommandListRenderCommand;
+		friend class DestroyCommandListCommand;
+		friend class RenderSystem;
+
+		/// @brief Gets the number of recorded commands.
+		/// @return The number of recorded commands.
+		inline int getCommandCount() const { return this->commands.size(); }
+		/// @brief How many render calls were recorded.
+		HL_DEFINE_GET(int, renderCalls, RenderCalls);
+		/// @brief How many vertices were recorded.
+		HL_DEFINE_GET(int, vertexCount, VertexCount);
+
+	protected:
+		/// @brief Basic constructor.
+		CommandList();
+		/// @brief Destructor.
+		virtual ~CommandList();
+
+		/// @brief The recorded commands.
+		harray<RenderCommand*> commands;
+		/// @brief How many render calls were recorded.
+		int renderCalls;
+		/// @brief How many vertices were recorded.
+		int vertexCount;
+		/// @brief How many triangles were recorded.
+		int triangleCount;
+		/// @brief How many lines were recorded.
+		int lineCount;
+
+	};
+
+}
+
+#endif
@@ -138,6 +138,51 @@ namespace april
 
 		));
 
+		/// @brief Defines a linear color transformation as a 3x4 matrix.
+		/// @note Several transformations can be combined into one matrix so they are applied to the image data in a single pass.
+		class aprilExport ColorMatrix
+		{
+		public:
+			/// @brief The matrix values in row-major order.
+			/// @note Each row calculates the red, green or blue output channel from the red, green and blue input channels and a constant offset in the 0-255 range.
+			float data[12];
+
+			/// @brief Basic constructor.
+			/// @note Creates an identity matrix.
+			ColorMatrix();
+			/// @brief Constructor.
+			/// @param[in] data The matrix values in row-major order.
+			ColorMatrix(const float data[12]);
+
+			/// @brief Checks whether the matrix changes colors at all.
+			/// @return True if this is an identity matrix.
+			bool isIdentity() const;
+			/// @brief Checks whether every output channel depends only on the same input channel.
+			/// @return True if the matrix doesn't mix color channels.
+			/// @note Such matrices are applied with per-channel lookup tables.
+			bool isSeparable() const;
+
+			/// @brief Combines two matrices.
+			/// @param[in] other The matrix that is applied first.
+			/// @return A matrix that applies other first and then this matrix.
+			ColorMatrix operator*(const ColorMatrix& other) const;
+
+			/// @brief Creates a matrix that rotates colors around the grey axis of the RGB cube.
+			/// @param[in] degrees By how many degrees the colors should be rotated.
+			/// @return The created matrix.
+			/// @note This is a linear RGB operation and not the HSL hue rotation of rotateHue(). Both only match for grey pixels and rotations by multiples of 120 degrees. Use adjustHueSaturation() for the exact HSL operations in a single pass.
+			static ColorMatrix makeHueRotation(float degrees);
+			/// @brief Creates a matrix that scales the distance of the color channels from their average.
+			/// @param[in] factor The multiplier factor of the distance.
+			/// @return The created matrix.
+			/// @note This is a linear RGB operation and not the HSL saturation of saturate(). Both only match for grey pixels and a factor of 1. Use adjustHueSaturation() for the exact HSL operations in a single pass.
+			static ColorMatrix makeSaturation(float factor);
+			/// @brief Creates a matrix that inverts colors the same way invert() does.
+			/// @return The created matrix.
+			static ColorMatrix makeInversion();
+
+		};
+
 		/// @brief The raw image data.
 		unsigned char* data;
 		/// @brief Width of the image in pixels.
@@ -280,7 +325,6 @@ namespace april
 		/// @param[in] degrees By how many degrees the the should be rotated.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool rotateHue(int x, int y, int w, int h, float degrees);
 		/// @brief Changes the saturation level of pixels of a rectangle area on the image.
 		/// @param[in] x X-coordinate of the area to change.
@@ -290,8 +334,18 @@ namespace april
 		/// @param[in] factor The saturation multiplier factor.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool saturate(int x, int y, int w, int h, float factor);
+		/// @brief Rotates the pixel hue and changes the saturation level of pixels of a rectangle area on the image in a single pass.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] degrees By how many degrees the hue should be rotated.
+		/// @param[in] factor The saturation multiplier factor.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note The result is the same as calling rotateHue() and then saturate(), but the data is only processed once.
+		bool adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor);
 		/// @brief Inverts the pixel colors of a rectangle area on the image.
 		/// @param[in] x X-coordinate of the area to change.
 		/// @param[in] y Y-coordinate of the area to change.
@@ -299,6 +353,33 @@ namespace april
 		/// @param[in] h Height of the area to change.
 		/// @return True if successful.
 		bool invert(int x, int y, int w, int h);
+		/// @brief Multiplies the color channels of a rectangle area on the image with its alpha channel.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note Formats without an alpha channel are not changed.
+		bool premultiplyAlpha(int x, int y, int w, int h);
+		/// @brief Divides the color channels of a rectangle area on the image by its alpha channel.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @return True if successful.
+		/// @note Formats without an alpha channel are not changed.
+		bool unpremultiplyAlpha(int x, int y, int w, int h);
+		/// @brief Applies a color matrix to the pixels of a rectangle area on the image.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] matrix The color matrix.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note The alpha channel is not changed.
+		bool applyColorMatrix(int x, int y, int w, int h, const ColorMatrix& matrix);
 		/// @brief Inserts image data as alpha channel into this image.
 		/// @param[in] srcData The source raw image data.
 		/// @param[in] srcFormat The pixel format of source raw image data.
@@ -306,7 +387,6 @@ namespace april
 		/// @param[in] ambiguity How "hard" the alpha channel transition should be.
 		/// @return True if successful.
 		/// @note The image data in srcData must be the same width and height as the image.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool insertAlphaMap(unsigned char* srcData, Format srcFormat, unsigned char median, int ambiguity); // TODOa - this functionality might be removed since shaders are much faster
 		/// @brief Dilates the image.
 		/// @param[in] srcData The constructing image's raw image data.
@@ -519,25 +599,48 @@ namespace april
 		/// @param[in] degrees By how many degrees the the should be rotated.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool rotateHue(cgrecti rect, float degrees);
 		/// @brief Changes the saturation level of pixels of a rectangle area on the image.
 		/// @param[in] rect Rectangle area.
 		/// @param[in] factor The saturation multiplier factor.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool saturate(cgrecti rect, float factor);
+		/// @brief Rotates the pixel hue and changes the saturation level of pixels of a rectangle area on the image in a single pass.
+		/// @param[in] rect Rectangle area.
+		/// @param[in] degrees By how many degrees the hue should be rotated.
+		/// @param[in] factor The saturation multiplier factor.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @see adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor)
+		bool adjustHueSaturation(cgrecti rect, float degrees, float factor);
 		/// @brief Inverts the pixel colors of a rectangle area on the image.
 		/// @param[in] rect Rectangle area.
 		/// @return True if successful.
 		bool invert(cgrecti rect);
+		/// @brief Multiplies the color channels of a rectangle area on the image with its alpha channel.
+		/// @param[in] rect Rectangle area.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note Formats without an alpha channel are not changed.
+		bool premultiplyAlpha(cgrecti rect);
+		/// @brief Divides the color channels of a rectangle area on the image by its alpha channel.
+		/// @param[in] rect Rectangle area.
+		/// @return True if successful.
+		/// @note Formats without an alpha channel are not changed.
+		bool unpremultiplyAlpha(cgrecti rect);
+		/// @brief Applies a color matrix to the pixels of a rectangle area on the image.
+		/// @param[in] rect Rectangle area.
+		/// @param[in] matrix The color matrix.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note The alpha channel is not changed.
+		bool applyColorMatrix(cgrecti rect, const ColorMatrix& matrix);
 		/// @brief Inserts image data as alpha channel into this image.
 		/// @param[in] srcData The source raw image data.
 		/// @param[in] srcFormat The pixel format of source raw image data.
 		/// @return True if successful.
 		/// @note The image data in srcData must be the same width and height as the image.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool insertAlphaMap(unsigned char* srcData, Format srcFormat); // TODOa - this functionality might be removed since shaders are much faster
 		/// @brief Inserts image data as alpha channel into this image.
 		/// @param[in] image The source Image.
@@ -545,13 +648,11 @@ namespace april
 		/// @param[in] ambiguity How "hard" the alpha channel transition should be.
 		/// @return True if successful.
 		/// @note The pixel format of image must be the same this image's.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool insertAlphaMap(Image* image, unsigned char median, int ambiguity); // TODOa - this functionality might be removed since shaders are much faster
 		/// @brief Inserts image data as alpha channel into this image.
 		/// @param[in] image The source Image.
 		/// @return True if successful.
 		/// @note The pixel format of image must be the same this image's.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool insertAlphaMap(Image* image); // TODOa - this functionality might be removed since shaders are much faster
 		/// @brief Dilates the image.
 		/// @param[in] image The source Image.
@@ -772,6 +873,50 @@ namespace april
 		/// @note The parameter alpha is especially useful when blitting source images that don't have an alpha channel.
 		/// @note This is usually called internally only.
 		static bool blitStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha = 255);
+		/// @brief Does an image data block transfer of premultiplied alpha data onto premultiplied alpha raw image data.
+		/// @param[in] sx Source data X-coordinate.
+		/// @param[in] sy Source data Y-coordinate.
+		/// @param[in] sw Width of the area on the source to be copied.
+		/// @param[in] sh Height of the area on the source to be copied.
+		/// @param[in] dx Destination X-coordinate.
+		/// @param[in] dy Destination Y-coordinate.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @param[in,out] destData The destination raw image data.
+		/// @param[in] destWidth The width of destination raw image data.
+		/// @param[in] destHeight The height of destination raw image data.
+		/// @param[in] destFormat The pixel format of destination raw image data.
+		/// @param[in] alpha Alpha multiplier on the entire source image.
+		/// @return True if successful.
+		/// @note Pixels on the destination are composited with src + dest * (1 - srcAlpha), which matches BlendMode::PremultipliedAlpha.
+		/// @note Sources without an alpha channel are blitted the same way as with blit().
+		/// @note This is usually called internally only.
+		static bool blitPremultiplied(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha = 255);
+		/// @brief Does a stretched image data block transfer of premultiplied alpha data onto premultiplied alpha raw image data.
+		/// @param[in] sx Source data X-coordinate.
+		/// @param[in] sy Source data Y-coordinate.
+		/// @param[in] sw Width of the area on the source to be copied.
+		/// @param[in] sh Height of the area on the source to be copied.
+		/// @param[in] dx Destination X-coordinate.
+		/// @param[in] dy Destination Y-coordinate.
+		/// @param[in] dw Width of the destination area.
+		/// @param[in] dh Height of the destination area.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @param[in,out] destData The destination raw image data.
+		/// @param[in] destWidth The width of destination raw image data.
+		/// @param[in] destHeight The height of destination raw image data.
+		/// @param[in] destFormat The pixel format of destination raw image data.
+		/// @param[in] alpha Alpha multiplier on the entire source image.
+		/// @return True if successful.
+		/// @note Pixels on the destination are composited with src + dest * (1 - srcAlpha), which matches BlendMode::PremultipliedAlpha.
+		/// @note This is usually called internally only.
+		/// @see blitPremultiplied
+		static bool blitStretchPremultiplied(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha = 255);
 		/// @brief Rotates the pixel hue of a rectangle area on the raw image data.
 		/// @param[in] x X-coordinate of the area to change.
 		/// @param[in] y Y-coordinate of the area to change.
@@ -784,7 +929,6 @@ namespace april
 		/// @param[in] degrees By how many degrees the the should be rotated.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		/// @note This is usually called internally only.
 		static bool rotateHue(int x, int y, int w, int h, float degrees, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat);
 		/// @brief Changes the saturation level of pixels of a rectangle area on the raw image data.
@@ -799,9 +943,24 @@ namespace april
 		/// @param[in] factor The saturation multiplier factor.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		/// @note This is usually called internally only.
 		static bool saturate(int x, int y, int w, int h, float factor, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat);
+		/// @brief Rotates the pixel hue and changes the saturation level of pixels of a rectangle area on the raw image data in a single pass.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] degrees By how many degrees the hue should be rotated.
+		/// @param[in] factor The saturation multiplier factor.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note The result is the same as calling rotateHue() and then saturate(), but the data is only processed once and split into row bands on the worker pool.
+		/// @note This is usually called internally only.
+		static bool adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat);
 		/// @brief Inverts the pixel colors of a rectangle area on the raw image data.
 		/// @param[in] x X-coordinate of the area to change.
 		/// @param[in] y Y-coordinate of the area to change.
@@ -814,6 +973,45 @@ namespace april
 		/// @return True if successful.
 		/// @note This is usually called internally only.
 		static bool invert(int x, int y, int w, int h, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat);
+		/// @brief Multiplies the color channels of a rectangle area on the raw image data with its alpha channel.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @return True if successful.
+		/// @note This is usually called internally only.
+		static bool premultiplyAlpha(int x, int y, int w, int h, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat);
+		/// @brief Divides the color channels of a rectangle area on the raw image data by its alpha channel.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @return True if successful.
+		/// @note This is usually called internally only.
+		static bool unpremultiplyAlpha(int x, int y, int w, int h, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat);
+		/// @brief Applies a color matrix to the pixels of a rectangle area on the raw image data.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] matrix The color matrix.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note The alpha channel is not changed. Single-channel images are treated as greyscale.
+		/// @note This is usually called internally only.
+		static bool applyColorMatrix(int x, int y, int w, int h, const ColorMatrix& matrix, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat);
 		/// @brief Inserts raw image data as alpha channel into other raw image data.
 		/// @param[in] w Width of the raw image data.
 		/// @param[in] h Height of the raw image data.
@@ -825,7 +1023,6 @@ namespace april
 		/// @param[in] ambiguity How "hard" the alpha channel transition should be.
 		/// @return True if successful.
 		/// @note The image data in srcData must be the same width and height as the image.
-		/// @note This is an expensive operation and should be used sparingly.
 		/// @note This is usually called internally only.
 		static bool insertAlphaMap(int w, int h, unsigned char* srcData, Format srcFormat, unsigned char* destData, Format destFormat, unsigned char median, int ambiguity); // TODOa - this functionality might be removed since shaders are much faster
 		/// @brief Dilates the raw image data.
@@ -842,6 +1039,28 @@ namespace april
 		/// @note Currently this operation is only supported for single-channel 8-bit images.
 		/// @note This is usually called internally only.
 		static bool dilate(unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat);
+		/// @brief Gets the number of levels in a full mipmap chain including the base level.
+		/// @param[in] w Width of the base level.
+		/// @param[in] h Height of the base level.
+		/// @return The number of levels in a full mipmap chain including the base level.
+		static int getMipmapLevelCount(int w, int h);
+		/// @brief Gets the size of a full mipmap chain in bytes without the base level.
+		/// @param[in] w Width of the base level.
+		/// @param[in] h Height of the base level.
+		/// @param[in] format The pixel format of the raw image data.
+		/// @return Size of a full mipmap chain in bytes without the base level.
+		static int getMipmapsByteSize(int w, int h, Format format);
+		/// @brief Creates a full mipmap chain using a 2x2 box filter.
+		/// @param[in] w Width of the base level.
+		/// @param[in] h Height of the base level.
+		/// @param[in] srcData The raw image data of the base level.
+		/// @param[in] format The pixel format of the raw image data.
+		/// @param[in,out] destData The destination raw image data where all levels below the base level are stored one after another.
+		/// @return True if successful.
+		/// @note If destData has not been allocated yet, it will be allocated with the new operator.
+		/// @note Every level is half the size of the previous one, rounded down and at least 1 pixel.
+		/// @note Compressed and paletted formats are not supported.
+		static bool createMipmaps(int w, int h, unsigned char* srcData, Format format, unsigned char** destData);
 
 		/// @brief Converts raw image data from one format into another.
 		/// @param[in] w Width of the raw image data.
@@ -987,6 +1206,24 @@ namespace april
 		/// @param[in] stream The encoded image data stream.
 		/// @return The created Image object or NULL if failed.
 		static Image* _loadEtcx(hsbase& stream);
+		/// @brief Loads and decodes KTX file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @param[in] size The size within the data stream that actually belongs to this encoded file.
+		/// @return The created Image object or NULL if failed.
+		static Image* _loadKtx(hsbase& stream, int size);
+		/// @brief Loads and decodes KTX file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @return The created Image object or NULL if failed.
+		static Image* _loadKtx(hsbase& stream);
+		/// @brief Loads and decodes DDS file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @param[in] size The size within the data stream that actually belongs to this encoded file.
+		/// @return The created Image object or NULL if failed.
+		static Image* _loadDds(hsbase& stream, int size);
+		/// @brief Loads and decodes DDS file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @return The created Image object or NULL if failed.
+		static Image* _loadDds(hsbase& stream);
 		/// @brief Loads and decodes PVRZ file data.
 		/// @param[in] stream The encoded image data stream.
 		/// @param[in] size The size within the data stream that actually belongs to this encoded file.
@@ -1045,6 +1282,24 @@ namespace april
 		/// @param[in] stream The encoded image data stream.
 		/// @return The created Image object or NULL if failed.
 		static Image* _readMetaDataEtcx(hsbase& stream);
+		/// @brief Loads and decodes meta data from KTX file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @param[in] size The size within the data stream that actually belongs to this encoded file.
+		/// @return The created Image object or NULL if failed.
+		static Image* _readMetaDataKtx(hsbase& stream, int size);
+		/// @brief Loads and decodes meta data from KTX file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @return The created Image object or NULL if failed.
+		static Image* _readMetaDataKtx(hsbase& stream);
+		/// @brief Loads and decodes meta data from DDS file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @param[in] size The size within the data stream that actually belongs to this encoded file.
+		/// @return The created Image object or NULL if failed.
+		static Image* _readMetaDataDds(hsbase& stream, int size);
+		/// @brief Loads and decodes meta data from DDS file data.
+		/// @param[in] stream The encoded image data stream.
+		/// @return The created Image object or NULL if failed.
+		static Image* _readMetaDataDds(hsbase& stream);
 		/// @brief Loads and decodes meta data from PVRZ file data.
 		/// @param[in] stream The encoded image data stream.
 		/// @param[in] size The size within the data stream that actually belongs to this encoded file.
@@ -1155,6 +1410,25 @@ namespace april
 		/// @note This is a utility method called by convertToFormat to split a large method into a few smaller ones.
 		/// @see blit
 		static bool _blitFrom4Bpp(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha);
+		/// @brief Executes a raw image data block transfer from a premultiplied source pixel format with 4 byte-per-pixel to a premultiplied raw image data destination.
+		/// @param[in] sx Source data X-coordinate.
+		/// @param[in] sy Source data Y-coordinate.
+		/// @param[in] sw Width of the area on the source to be copied.
+		/// @param[in] sh Height of the area on the source to be copied.
+		/// @param[in] dx Destination X-coordinate.
+		/// @param[in] dy Destination Y-coordinate.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @param[in,out] destData The destination raw image data.
+		/// @param[in] destWidth The width of destination raw image data.
+		/// @param[in] destHeight The height of destination raw image data.
+		/// @param[in] destFormat The pixel format of destination raw image data.
+		/// @param[in] alpha Alpha multiplier on the entire source image.
+		/// @return True if successful.
+		/// @see blitPremultiplied
+		static bool _blitFrom4BppPremultiplied(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha);
 
 	};
 	
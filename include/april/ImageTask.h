@@ -0,0 +1,67 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a handle for an image operation running on a worker thread.
+
+#ifndef APRIL_IMAGE_TASK_H
+#define APRIL_IMAGE_TASK_H
+
+#include <hltypes/hmutex.h>
+
+#include "aprilExport.h"
+
+namespace april
+{
+	class Semaphore;
+
+	/// @brief Defines a handle for an image operation running on a worker thread.
+	/// @note The operation is started when the handle is created and it has to be deleted by whoever requested it.
+	class aprilExport ImageTask
+	{
+	public:
+		/// @brief Destructor.
+		/// @note Waits for the operation to finish.
+		virtual ~ImageTask();
+
+		/// @brief Checks whether the operation has finished.
+		/// @return True if the operation has finished.
+		bool isFinished();
+		/// @brief Waits for the operation to finish.
+		/// @return True if the operation was successful.
+		bool wait();
+
+	protected:
+		/// @brief Whether the operation has finished.
+		bool finished;
+		/// @brief Whether the operation was successful.
+		bool result;
+		/// @brief Mutex for the state of the operation.
+		hmutex mutex;
+		/// @brief Signaled when the operation has finished.
+		Semaphore* finishedSignal;
+
+		/// @brief Basic constructor.
+		ImageTask();
+
+		/// @brief Queues the operation on a worker thread.
+		void _start();
+		/// @brief Executes the operation.
+		/// @return True if the operation was successful.
+		/// @note This is called on a worker thread. Derived classes have to call wait() in their destructor.
+		virtual bool _execute() = 0;
+
+		/// @brief Executes the operation and signals that it has finished.
+		/// @param[in] data The ImageTask object.
+		static void _run(void* data);
+
+	};
+
+}
+#endif
@@ -70,9 +70,11 @@ namespace april
 		/// @brief Version of the OS.
 		hversion osVersion;
 		/// @brief Number of logical CPU cores (NOT physical!).
+		/// @note On Linux this only counts the cores the process is allowed to use, respecting the CPU affinity and cgroup CPU quotas.
 		int cpuCores;
 		/// @brief How many MB of RAM the system has installed.
 		/// @note On some platforms this information is not available directly and might return some values that are note entirely accurate.
+		/// @note On Linux this respects cgroup memory limits.
 		int ram;
 		/// @brief Current screen resolution.
 		gvec2i displayResolution;
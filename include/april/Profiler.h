@@ -0,0 +1,158 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a per-frame timeline profiler.
+
+#ifndef APRIL_PROFILER_H
+#define APRIL_PROFILER_H
+
+#include <stdint.h>
+
+#include <hltypes/harray.h>
+#include <hltypes/hsbase.h>
+#include <hltypes/hstring.h>
+
+#include "aprilExport.h"
+
+/// @brief How many zones are kept per thread before the oldest ones are overwritten.
+#ifndef APRIL_PROFILER_BUFFER_SIZE
+#define APRIL_PROFILER_BUFFER_SIZE 16384
+#endif
+
+/// @brief Profiling macros.
+/// @note The zones are only compiled when APRIL_PROFILER is defined. Otherwise they compile to nothing.
+#ifdef APRIL_PROFILER
+#define __APRIL_PROFILE_ZONE_NAME(line) __aprilProfileZone ## line
+#define __APRIL_PROFILE_ZONE(name, line) april::Profiler::Zone __APRIL_PROFILE_ZONE_NAME(line)(name)
+/// @brief Profiles the current scope.
+/// @note The name has to be a string literal or otherwise stay valid for the entire lifetime of the application.
+#define APRIL_PROFILE_ZONE(name) __APRIL_PROFILE_ZONE(name, __LINE__)
+/// @brief Marks the end of a frame.
+#define APRIL_PROFILE_FRAME() april::Profiler::markFrame()
+/// @brief Sets the name of the current thread.
+#define APRIL_PROFILE_THREAD(name) april::Profiler::setThreadName(name)
+/// @brief Releases the current thread's buffer so it can be reused by another thread.
+#define APRIL_PROFILE_THREAD_END() april::Profiler::releaseThread()
+#else
+#define APRIL_PROFILE_ZONE(name)
+#define APRIL_PROFILE_FRAME()
+#define APRIL_PROFILE_THREAD(name)
+#define APRIL_PROFILE_THREAD_END()
+#endif
+
+namespace april
+{
+	/// @brief Defines a low-overhead timeline profiler that records zones per thread.
+	/// @note Each thread writes into its own ring buffer without any locking. When APRIL_PROFILER is not defined, nothing is recorded.
+	class aprilExport Profiler
+	{
+	public:
+		/// @brief Records the time between its construction and destruction.
+		class aprilExport Zone
+		{
+		public:
+			/// @brief Basic constructor.
+			/// @param[in] name Name of the zone.
+			/// @note The name has to be a string literal or otherwise stay valid for the entire lifetime of the application.
+			Zone(const char* name);
+			/// @brief Destructor.
+			~Zone();
+
+		protected:
+			/// @brief Name of the zone.
+			const char* name;
+			/// @brief When the zone started in microseconds.
+			int64_t start;
+
+		};
+
+		/// @brief Summarized timings of one zone name within a frame.
+		struct aprilExport ZoneSummary
+		{
+		public:
+			/// @brief Name of the zone.
+			hstr name;
+			/// @brief How many times the zone was recorded.
+			int count;
+			/// @brief Total time spent in the zone in seconds.
+			double time;
+			/// @brief Longest single recording of the zone in seconds.
+			double maxTime;
+
+			/// @brief Basic constructor.
+			ZoneSummary();
+
+		};
+
+		/// @brief Checks whether profiling was compiled in.
+		/// @return True if APRIL_PROFILER was defined while building.
+		static bool isAvailable();
+		/// @brief Checks whether recording is enabled.
+		/// @return True if recording is enabled.
+		static bool isEnabled();
+		/// @brief Enables or disables recording.
+		/// @param[in] value Whether recording should be enabled.
+		/// @note Recording is disabled by default so builds with APRIL_PROFILER can be shipped.
+		static void setEnabled(bool value);
+		/// @brief Sets the name of the current thread that is displayed in exported traces.
+		/// @param[in] name Name of the thread.
+		static void setThreadName(chstr name);
+		/// @brief Releases the current thread's buffer so it can be reused by another thread.
+		/// @note This should be called when a short-lived thread finishes. Already recorded zones are kept.
+		static void releaseThread();
+		/// @brief Marks the end of a frame.
+		/// @note This is called internally after a frame was presented.
+		static void markFrame();
+		/// @brief Gets the index of the current frame.
+		/// @return The index of the current frame.
+		static int getFrameIndex();
+		/// @brief Gets the summarized timings of all zones that were recorded during the last complete frame.
+		/// @return The summarized timings of all zones that were recorded during the last complete frame.
+		/// @note Zones from all threads that started and ended within the last frame are taken into account.
+		static harray<ZoneSummary> getLastFrameSummary();
+		/// @brief Gets the duration of the last complete frame.
+		/// @return The duration of the last complete frame in seconds.
+		static double getLastFrameTime();
+		/// @brief Clears all recorded data.
+		/// @note This is not safe while other threads are recording zones.
+		static void clear();
+		/// @brief Exports all recorded zones in the Chrome trace event JSON format.
+		/// @param[in] stream The stream where to write the data.
+		/// @return True if successful.
+		/// @note The output can be loaded in chrome://tracing or Perfetto. Recorded data is freed in april::destroy() so this has to be called before.
+		static bool exportTrace(hsbase& stream);
+		/// @brief Exports all recorded zones in the Chrome trace event JSON format.
+		/// @param[in] filename The file where to write the data.
+		/// @return True if successful.
+		/// @note The output can be loaded in chrome://tracing or Perfetto. Recorded data is freed in april::destroy() so this has to be called before.
+		static bool exportTrace(chstr filename);
+
+		/// @brief Records a zone for the current thread.
+		/// @param[in] name Name of the zone.
+		/// @param[in] start When the zone started in microseconds.
+		/// @param[in] end When the zone ended in microseconds.
+		/// @note This is usually called internally only.
+		static void _addZone(const char* name, int64_t start, int64_t end);
+		/// @brief Disables recording and frees all thread buffers together with their recorded data.
+		/// @note This is called internally in april::destroy() when no other thread records zones anymore. Threads that recorded before get a new buffer when they record again.
+		static void _destroy();
+		/// @brief Gets the current profiler time.
+		/// @return The current profiler time in microseconds.
+		/// @note This is usually called internally only.
+		static int64_t _getTime();
+
+	protected:
+		/// @brief Whether recording is enabled.
+		static bool enabled;
+
+	};
+
+}
+#endif
@@ -0,0 +1,88 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a context for recording render calls on another thread.
+
+#ifndef APRIL_RENDER_CONTEXT_H
+#define APRIL_RENDER_CONTEXT_H
+
+#include <hltypes/harray.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hmutex.h>
+
+#include "aprilExport.h"
+
+namespace april
+{
+	class AsyncCommand;
+	class RenderState;
+	class RenderSystem;
+
+	/// @brief Defines a context with its own RenderState and command buffer that a thread can record render calls into.
+	/// @note The recorded commands are only queued for rendering when the context is submitted. Textures and vertex buffers used during recording have to stay alive until then.
+	class aprilExport RenderContext
+	{
+	public:
+		friend class RenderSystem;
+
+		/// @brief The order in which the context is submitted relative to other contexts.
+		HL_DEFINE_GETSET(int, order, Order);
+		/// @brief Whether a thread is currently recording into the context.
+		/// @return True if a thread is currently recording into the context.
+		bool isActive();
+		/// @brief Gets the number of recorded commands.
+		/// @return The number of recorded commands.
+		inline int getCommandCount() const { return this->commands.size(); }
+
+	protected:
+		/// @brief Basic constructor.
+		/// @param[in] state The RenderState the context starts with.
+		/// @param[in] order The order in which the context is submitted relative to other contexts.
+		RenderContext(const RenderState& state, int order);
+		/// @brief Destructor.
+		virtual ~RenderContext();
+
+		/// @brief The order in which the context is submitted relative to other contexts.
+		int order;
+		/// @brief Whether a thread is currently recording into the context.
+		bool active;
+		/// @brief Mutex that makes claiming the context for recording atomic.
+		hmutex activeMutex;
+		/// @brief The RenderState used while recording into the context.
+		RenderState* state;
+		/// @brief The recorded commands.
+		harray<AsyncCommand*> commands;
+		/// @brief How many render calls were recorded.
+		int renderCalls;
+		/// @brief How many vertices were recorded.
+		int vertexCount;
+		/// @brief How many triangles were recorded.
+		int triangleCount;
+		/// @brief How many lines were recorded.
+		int lineCount;
+		/// @brief How many render calls were culled during recording.
+		int culledRenderCalls;
+		/// @brief How many vertices were culled during recording.
+		int culledVertexCount;
+		/// @brief Whether viewport culling was enabled when the recording began.
+		bool viewportCulling;
+
+		/// @brief Resets the recorded stats.
+		void _resetStats();
+		/// @brief Sets whether a thread is recording into the context.
+		/// @param[in] value Whether a thread is recording into the context.
+		/// @return False if the context was already in the requested state.
+		bool _trySetActive(bool value);
+
+	};
+
+}
+
+#endif
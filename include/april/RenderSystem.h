@@ -25,10 +25,15 @@
 #include "aprilExport.h"
 #include "aprilUtil.h"
 #include "Color.h"
+#include "CommandList.h"
 #include "Image.h"
+#include "RenderContext.h"
 #include "Texture.h"
+#include "Timer.h"
+#include "VertexBuffer.h"
 
 #define APRIL_INTERMEDIATE_TEXTURE_VERTICES_COUNT 6
+#define APRIL_QUAD_INSTANCES_BATCH_SIZE 256
 
 namespace april
 {
@@ -39,19 +44,23 @@ namespace april
 	class ClearCommand;
 	class ClearColorCommand;
 	class ClearDepthCommand;
+	class CommandListRenderCommand;
 	class CreateCommand;
 	class DestroyCommand;
 	class Image;
 	class PixelShader;
 	class PresentFrameCommand;
+	class QuadInstanceRenderCommand;
 	class RenderCommand;
 	class RenderHelper;
 	class RenderState;
 	class ResetCommand;
+	class Semaphore;
 	class StateUpdateCommand;
 	class SuspendCommand;
 	class TakeScreenshotCommand;
 	class Texture;
+	class VertexBufferRenderCommand;
 	template <typename T> class VertexRenderCommand;
 	class VertexShader;
 	class Window;
@@ -65,9 +74,11 @@ namespace april
 		friend class ClearCommand;
 		friend class ClearColorCommand;
 		friend class ClearDepthCommand;
+		friend class CommandListRenderCommand;
 		friend class CreateCommand;
 		friend class DestroyCommand;
 		friend class PresentFrameCommand;
+		friend class QuadInstanceRenderCommand;
 		friend class RenderCommand;
 		friend class RenderHelper;
 		friend class RenderHelperLayered2D;
@@ -76,6 +87,7 @@ namespace april
 		friend class SuspendCommand;
 		friend class TakeScreenshotCommand;
 		friend class Texture;
+		friend class VertexBufferRenderCommand;
 		template <typename T> friend class VertexRenderCommand;
 		friend class Window;
 
@@ -163,8 +175,25 @@ namespace april
 			bool npotTextures;
 			/// @brief Whether External texture type is supported.
 			bool externalTextures;
+			/// @brief Whether mipmapped textures and Texture::Filter::Trilinear are supported.
+			bool mipmaps;
+			/// @brief Whether the GPU can generate mipmap chains itself.
+			/// @note When this is not supported, mipmap chains are created on the CPU.
+			bool mipmapGeneration;
 			/// @brief Supported texture pixel formats.
 			harray<Image::Format> textureFormats;
+			/// @brief Whether BC1, BC2 and BC3 (S3TC) block compressed textures can be uploaded directly.
+			/// @note When this is not supported, the data is decoded on the CPU.
+			bool bcTextures;
+			/// @brief Whether ETC1 block compressed textures can be uploaded directly.
+			/// @note When this is not supported, the data is decoded on the CPU.
+			bool etc1Textures;
+			/// @brief Whether ETC2 block compressed textures can be uploaded directly.
+			/// @note When this is not supported, the data is decoded on the CPU.
+			bool etc2Textures;
+			/// @brief Whether ASTC block compressed textures can be uploaded directly.
+			/// @note There is no CPU decoder for ASTC so these textures fail to load when this is not supported.
+			bool astcTextures;
 			/// @brief Whether render targets are supported properly. Also 
 			/// @note This also controls internal rendertarget usage for basic rendering.
 			bool renderTarget;
@@ -209,6 +238,29 @@ namespace april
 		HL_DEFINE_GET(RenderMode, renderMode, RenderMode);
 		/// @brief Gets how frames in advance can be updated.
 		HL_DEFINE_GET(int, frameAdvanceUpdates, FrameAdvanceUpdates);
+		/// @brief Whether render calls that lie completely outside of the viewport are dropped before they are queued.
+		/// @note This is disabled by default. A RenderContext uses the value from when beginRenderContext() was called.
+		HL_DEFINE_ISSET(viewportCulling, ViewportCulling);
+		/// @brief Whether opaque render calls are reordered by shader and texture before they are executed.
+		/// @note Only render calls with depth test, depth write and BlendMode::Overwrite are reordered and only among each other. This is disabled by default.
+		HL_DEFINE_ISSET(sortOpaqueDraws, SortOpaqueDraws);
+		/// @brief Whether the intermediate render texture is resized depending on the frame time to keep up the target frame rate.
+		/// @note This requires Options::intermediateRenderTexture and is disabled by default.
+		HL_DEFINE_ISSET(dynamicResolution, DynamicResolution);
+		/// @brief The frame rate that dynamic resolution tries to keep up.
+		HL_DEFINE_GETSET(int, dynamicResolutionTargetFps, DynamicResolutionTargetFps);
+		/// @brief The smallest scale of the intermediate render texture that dynamic resolution can use.
+		HL_DEFINE_GET(float, dynamicResolutionMinScale, DynamicResolutionMinScale);
+		/// @brief The largest scale of the intermediate render texture that dynamic resolution can use.
+		HL_DEFINE_GET(float, dynamicResolutionMaxScale, DynamicResolutionMaxScale);
+		/// @brief The scale of the intermediate render texture that is currently used.
+		/// @note Screenshots taken from the intermediate render texture have this scale as well.
+		HL_DEFINE_GET(float, intermediateRenderTextureScale, IntermediateRenderTextureScale);
+		/// @brief Sets the range of scales that dynamic resolution can use.
+		/// @param[in] minScale The smallest scale.
+		/// @param[in] maxScale The largest scale.
+		/// @note Both values are clamped to the range from 0.1 to 1.0.
+		void setDynamicResolutionScaleRange(float minScale, float maxScale);
 		/// @brief Gets how many times a frame should be duplicated during rendering.
 		/// @return How many times a frame should be duplicated during rendering.
 		int getFrameDuplicates();
@@ -223,6 +275,10 @@ namespace april
 		HL_DEFINE_GET(int, statCurrentFrameTextureSwitches, StatCurrentFrameTextureSwitches);
 		/// @brief Gets how many times the texture was switched during the last frame.
 		HL_DEFINE_GET(int, statLastFrameTextureSwitches, StatLastFrameTextureSwitches);
+		/// @brief Gets how many texture switches were saved by sorting opaque render calls during this frame.
+		HL_DEFINE_GET(int, statCurrentFrameSavedTextureSwitches, StatCurrentFrameSavedTextureSwitches);
+		/// @brief Gets how many texture switches were saved by sorting opaque render calls during the last frame.
+		HL_DEFINE_GET(int, statLastFrameSavedTextureSwitches, StatLastFrameSavedTextureSwitches);
 		/// @brief Gets how many vertices were rendered during this frame.
 		HL_DEFINE_GET(int, statCurrentFrameVertexCount, StatCurrentFrameVertexCount);
 		/// @brief Gets how many vertices were rendered during the last frame.
@@ -235,6 +291,17 @@ namespace april
 		HL_DEFINE_GET(int, statCurrentFrameLineCount, StatCurrentFrameLineCount);
 		/// @brief Gets how many lines were rendered during the last frame.
 		HL_DEFINE_GET(int, statLastFrameLineCount, StatLastFrameLineCount);
+		/// @brief Gets how many render calls were culled during this frame.
+		HL_DEFINE_GET(int, statCurrentFrameCulledRenderCalls, StatCurrentFrameCulledRenderCalls);
+		/// @brief Gets how many render calls were culled during the last frame.
+		HL_DEFINE_GET(int, statLastFrameCulledRenderCalls, StatLastFrameCulledRenderCalls);
+		/// @brief Gets how many vertices were culled during this frame.
+		HL_DEFINE_GET(int, statCurrentFrameCulledVertexCount, StatCurrentFrameCulledVertexCount);
+		/// @brief Gets how many vertices were culled during the last frame.
+		HL_DEFINE_GET(int, statLastFrameCulledVertexCount, StatLastFrameCulledVertexCount);
+		/// @brief Gets the time between the first input event and the presentation of the frame that processed it.
+		/// @note This value is in seconds and is updated only when a frame with new input was presented.
+		HL_DEFINE_GET(float, inputLatency, InputLatency);
 		/// @brief Gets how frames are queued for rendering.
 		int getAsyncQueuesCount();
 		/// @brief Gets all currently existing textures in the RenderSystem.
@@ -354,6 +421,50 @@ namespace april
 		/// @param[in] texture The Texture that should be destroyed.
 		/// @note After this call the Texture pointer becomes invalid.
 		void destroyTexture(Texture* texture);
+		/// @brief Starts recording the order in which textures are bound for the first time and prefetches the textures recorded in a previous session.
+		/// @param[in] name Filename of the profile, relative to getUserDataPath().
+		/// @return True if successful.
+		/// @note Recorded textures that don't exist yet are created and queued for async loading in the recorded order. Creating such a texture afterwards with the same type returns the prefetched one.
+		/// @see endTextureProfile
+		bool beginTextureProfile(chstr name);
+		/// @brief Stops recording and saves the texture profile.
+		/// @return True if successful.
+		/// @note Prefetched textures that were never requested are destroyed.
+		/// @see beginTextureProfile
+		bool endTextureProfile();
+
+		/// @brief Creates a VertexBuffer object.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @param[in] usage How often the vertices are expected to change.
+		/// @return The created VertexBuffer object or NULL if failed.
+		/// @note The vertices are copied so the array can be discarded after this call.
+		VertexBuffer* createVertexBuffer(const PlainVertex* vertices, int count, VertexBuffer::Usage usage = VertexBuffer::Usage::Static);
+		/// @brief Creates a VertexBuffer object.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @param[in] usage How often the vertices are expected to change.
+		/// @return The created VertexBuffer object or NULL if failed.
+		/// @note The vertices are copied so the array can be discarded after this call.
+		VertexBuffer* createVertexBuffer(const ColoredVertex* vertices, int count, VertexBuffer::Usage usage = VertexBuffer::Usage::Static);
+		/// @brief Creates a VertexBuffer object.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @param[in] usage How often the vertices are expected to change.
+		/// @return The created VertexBuffer object or NULL if failed.
+		/// @note The vertices are copied so the array can be discarded after this call.
+		VertexBuffer* createVertexBuffer(const TexturedVertex* vertices, int count, VertexBuffer::Usage usage = VertexBuffer::Usage::Static);
+		/// @brief Creates a VertexBuffer object.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @param[in] usage How often the vertices are expected to change.
+		/// @return The created VertexBuffer object or NULL if failed.
+		/// @note The vertices are copied so the array can be discarded after this call.
+		VertexBuffer* createVertexBuffer(const ColoredTexturedVertex* vertices, int count, VertexBuffer::Usage usage = VertexBuffer::Usage::Static);
+		/// @brief Destroys a VertexBuffer object.
+		/// @param[in] vertexBuffer The VertexBuffer that should be destroyed.
+		/// @note After this call the VertexBuffer pointer becomes invalid.
+		void destroyVertexBuffer(VertexBuffer* vertexBuffer);
 
 		/// @brief Creates a pixel shader from a resource file.
 		/// @param[in] filename The filename of the resource file.
@@ -536,6 +647,29 @@ namespace april
 		/// @param[in] vertices An array of vertices.
 		/// @param[in] count How many vertices from the array should be rendered.
 		void render(const RenderOperation& renderOperation, const ColoredTexturedVertex* vertices, int count);
+		/// @brief Renders vertices from a VertexBuffer to the backbuffer.
+		/// @param[in] renderOperation The RenderOperation that should be used to render the vertices.
+		/// @param[in] vertexBuffer The VertexBuffer containing the vertices.
+		/// @param[in] first Index of the first vertex that should be rendered.
+		/// @param[in] count How many vertices should be rendered.
+		/// @note Only the VertexBuffer is referenced in the render queue, the vertices are not copied. Vertices changed by VertexBuffer::update() since the last render call of the buffer are passed along with this one.
+		void render(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count);
+		/// @brief Renders vertices from a VertexBuffer to the backbuffer.
+		/// @param[in] renderOperation The RenderOperation that should be used to render the vertices.
+		/// @param[in] vertexBuffer The VertexBuffer containing the vertices.
+		/// @param[in] first Index of the first vertex that should be rendered.
+		/// @param[in] count How many vertices should be rendered.
+		/// @param[in] color Color to apply globally on all vertices.
+		/// @note Only the VertexBuffer is referenced in the render queue, the vertices are not copied. Vertices changed by VertexBuffer::update() since the last render call of the buffer are passed along with this one. The color is only applied if the vertices have no color.
+		void render(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count, const Color& color);
+		/// @brief Renders textured quads that share one base quad, but each have their own transformation, UV rectangle and color.
+		/// @param[in] rect The base quad in local coordinates.
+		/// @param[in] instances An array of quad instances.
+		/// @param[in] count How many instances from the array should be rendered.
+		/// @note Remember to call setTexture() before calling this. Only the instances are copied into the render queue, the vertices are generated during rendering.
+		/// @note No render system uses hardware instancing yet. The instances are expanded into triangle lists on the CPU in batches of APRIL_QUAD_INSTANCES_BATCH_SIZE.
+		/// @see setTexture
+		void renderInstanced(cgrectf rect, const QuadInstance* instances, int count);
 		
 		/// @brief Renders a rectangle.
 		/// @param[in] rect Position and size of the rectangle.
@@ -561,9 +695,57 @@ namespace april
 		/// @see setTexture
 		void drawTexturedRect(cgrectf rect, cgrectf src, const Color& color);
 
+		/// @brief Starts recording render calls into a CommandList instead of rendering them.
+		/// @return True if successful.
+		/// @note The modelview matrix is reset to identity until endCommandList() is called so the recorded transformations are relative.
+		/// @note Only render calls are recorded. Custom commands are discarded with an error until endCommandList() is called.
+		/// @see endCommandList
+		bool beginCommandList();
+		/// @brief Stops recording render calls.
+		/// @return The recorded CommandList or NULL if nothing was being recorded.
+		/// @note The modelview matrix from before beginCommandList() is restored.
+		/// @see beginCommandList
+		CommandList* endCommandList();
+		/// @brief Checks whether render calls are currently being recorded into a CommandList.
+		/// @return True if render calls are currently being recorded into a CommandList.
+		inline bool isRecordingCommandList() const { return (this->recordingCommandList != NULL); }
+		/// @brief Renders a previously recorded CommandList.
+		/// @param[in] commandList The CommandList to render.
+		/// @note The current viewport, projection and modelview matrix are applied on top of the recorded transformations. Only the CommandList is referenced in the render queue.
+		void executeCommandList(CommandList* commandList);
+		/// @brief Destroys a CommandList object.
+		/// @param[in] commandList The CommandList that should be destroyed.
+		/// @note After this call the CommandList pointer becomes invalid.
+		void destroyCommandList(CommandList* commandList);
+		/// @brief Creates a RenderContext that a thread can record render calls into.
+		/// @param[in] order The order in which the context is submitted relative to other contexts.
+		/// @return The created RenderContext.
+		/// @note The context starts with a copy of the current RenderState.
+		/// @note A texture must not be destroyed while another thread is recording into a context that uses it. Contexts that aren't being recorded into stop using the texture and their unsubmitted commands that use it are discarded.
+		RenderContext* createRenderContext(int order = 0);
+		/// @brief Destroys a RenderContext object.
+		/// @param[in] context The RenderContext that should be destroyed.
+		/// @note Commands that were recorded and not submitted are discarded. After this call the RenderContext pointer becomes invalid.
+		void destroyRenderContext(RenderContext* context);
+		/// @brief Starts recording all render calls of the calling thread into a RenderContext.
+		/// @param[in] context The RenderContext to record into.
+		/// @return True if successful.
+		/// @note State changes of the calling thread only affect the context's RenderState. Render calls bypass the render helper of the current RenderMode and don't wait for the render queue.
+		/// @see endRenderContext
+		bool beginRenderContext(RenderContext* context);
+		/// @brief Stops recording render calls of the calling thread.
+		/// @return True if successful.
+		/// @see beginRenderContext
+		bool endRenderContext();
+		/// @brief Queues all commands recorded in RenderContext objects for rendering.
+		/// @param[in] contexts The RenderContext objects to submit.
+		/// @note The contexts are submitted ordered by their order value and their array index and with a single lock of the render queue. No thread can be recording into them during this call.
+		/// @note This has to be called before presentFrame() by the thread that builds the frame.
+		void submitRenderContexts(const harray<RenderContext*>& contexts);
 		/// @brief Executes a custom command into the render-queue.
 		/// @param[in] function The function to call.
 		/// @param[in] args Arguments for the function.
+		/// @note This cannot be called while a command list is being recorded.
 		void executeCustomCommand(void (*function)(const harray<void*>& args), const harray<void*>& args = harray<void*>());
 		/// @brief Finds the actual filename of a texture resource file.
 		/// @param[in] filename Resource filename without the extension.
@@ -628,12 +810,39 @@ namespace april
 		RenderState* deviceState;
 		/// @brief Mutex required for registering and unregistering of textures that allows for multi-threaded access.
 		hmutex texturesMutex;
+		/// @brief Whether a texture profile is being recorded.
+		/// @note It's only changed while textureProfileMutex is locked, but it can be read without locking as a quick check.
+		bool textureProfileRecording;
+		/// @brief Full path of the texture profile that is being recorded.
+		hstr textureProfileFilename;
+		/// @brief The frame in which each texture of the recorded profile was bound for the first time.
+		hmap<hstr, int> textureProfileFrames;
+		/// @brief The entries of the recorded profile in the order the textures were bound for the first time.
+		harray<hstr> textureProfileEntries;
+		/// @brief How many frames were presented since the texture profile recording started.
+		int textureProfileFrame;
+		/// @brief Textures from the previous profile that were created ahead of time and not requested yet.
+		harray<Texture*> prefetchedTextures;
+		/// @brief Mutex for the texture profile.
+		hmutex textureProfileMutex;
+		/// @brief All currently existing vertex buffers.
+		harray<VertexBuffer*> vertexBuffers;
+		/// @brief Mutex required for registering and unregistering of vertex buffers that allows for multi-threaded access.
+		hmutex vertexBuffersMutex;
 		/// @brief Mutex required for async update/rendering.
 		hmutex asyncMutex;
 		/// @brief Special helper object that can handle rendering in a different way.
 		RenderHelper* renderHelper;
 		/// @brief Async command queue.
 		harray<AsyncCommandQueue*> asyncCommandQueues;
+		/// @brief The CommandList that render commands are currently being recorded into.
+		CommandList* recordingCommandList;
+		/// @brief The modelview matrix from before recording was started.
+		gmat4 recordingModelviewMatrix;
+		/// @brief All currently existing render contexts.
+		harray<RenderContext*> renderContexts;
+		/// @brief Mutex required for registering and unregistering of render contexts that allows for multi-threaded access.
+		hmutex renderContextsMutex;
 		/// @brief Last special async command queue.
 		AsyncCommandQueue* lastAsyncCommandQueue;
 		/// @brief Whether async commands are being processed right now.
@@ -642,6 +851,26 @@ namespace april
 		int frameAdvanceUpdates;
 		/// @brief How many times a frame should be duplicated during rendering.
 		int frameDuplicates;
+		/// @brief Whether render calls that lie completely outside of the viewport are dropped before they are queued.
+		bool viewportCulling;
+		/// @brief Whether opaque render calls are reordered by shader and texture before they are executed.
+		bool sortOpaqueDraws;
+		/// @brief Whether the intermediate render texture is resized depending on the frame time.
+		bool dynamicResolution;
+		/// @brief The frame rate that dynamic resolution tries to keep up.
+		int dynamicResolutionTargetFps;
+		/// @brief The smallest scale of the intermediate render texture that dynamic resolution can use.
+		float dynamicResolutionMinScale;
+		/// @brief The largest scale of the intermediate render texture that dynamic resolution can use.
+		float dynamicResolutionMaxScale;
+		/// @brief The scale of the intermediate render texture that is currently used.
+		float intermediateRenderTextureScale;
+		/// @brief Signaled whenever a complete async command queue has been queued for rendering.
+		Semaphore* asyncQueuedSemaphore;
+		/// @brief Signaled whenever an async command queue has been processed.
+		Semaphore* asyncProcessedSemaphore;
+		/// @brief The latency between the first input event and the presentation of the frame that processed it.
+		float inputLatency;
 		/// @brief Current special texture used as utility for rendering.
 		Texture* _currentIntermediateRenderTexture;
 		/// @brief Last special texture used as utility for rendering.
@@ -654,10 +883,26 @@ namespace april
 		int _intermediateRenderTextureIndex;
 		/// @brief Whether an update of the last intermediate render textures should occur after rendering.
 		bool _updateLastIntermediateRenderTexture;
+		/// @brief Whether the intermediate render texture is currently being rendered to the backbuffer.
+		bool _presentingIntermediateRenderTexture;
+		/// @brief Whether the viewport has to be set again, because the size of the intermediate render texture changed.
+		bool _intermediateViewportChanged;
+		/// @brief Measures the time between presented frames for dynamic resolution.
+		Timer _dynamicResolutionTimer;
+		/// @brief Smoothed time between presented frames in seconds.
+		double _dynamicResolutionFrameTime;
+		/// @brief How many frames were measured since the last scale change.
+		int _dynamicResolutionFrames;
+		/// @brief How many frames have to stay within the target frame time before the scale is increased.
+		int _dynamicResolutionUpscaleFrames;
+		/// @brief Whether the last scale change was an increase.
+		bool _dynamicResolutionUpscaled;
 		/// @brief Fixed RenderState for rendering the intermediate render texture.
 		RenderState* _intermediateState;
 		/// @brief Fixed vertices for rendering the intermediate render texture.
 		april::TexturedVertex _intermediateRenderVertices[APRIL_INTERMEDIATE_TEXTURE_VERTICES_COUNT];
+		/// @brief Vertices that quad instances are expanded into when rendering them.
+		april::ColoredTexturedVertex _quadInstanceVertices[APRIL_QUAD_INSTANCES_BATCH_SIZE * APRIL_QUAD_INSTANCE_VERTICES_COUNT];
 
 		/// @brief How many times a render call was called during this frame.
 		int statCurrentFrameRenderCalls;
@@ -667,6 +912,10 @@ namespace april
 		int statCurrentFrameTextureSwitches;
 		/// @brief How many times the texture was switched during the last frame.
 		int statLastFrameTextureSwitches;
+		/// @brief How many texture switches were saved by sorting opaque render calls during this frame.
+		int statCurrentFrameSavedTextureSwitches;
+		/// @brief How many texture switches were saved by sorting opaque render calls during the last frame.
+		int statLastFrameSavedTextureSwitches;
 		/// @brief How many vertices were rendered during this frame.
 		int statCurrentFrameVertexCount;
 		/// @brief How many vertices were rendered during the last frame.
@@ -679,6 +928,33 @@ namespace april
 		int statCurrentFrameLineCount;
 		/// @brief How many lines were rendered during the last frame.
 		int statLastFrameLineCount;
+		/// @brief How many render calls were culled during this frame.
+		int statCurrentFrameCulledRenderCalls;
+		/// @brief How many render calls were culled during the last frame.
+		int statLastFrameCulledRenderCalls;
+		/// @brief How many vertices were culled during this frame.
+		int statCurrentFrameCulledVertexCount;
+		/// @brief How many vertices were culled during the last frame.
+		int statLastFrameCulledVertexCount;
+
+		/// @brief Gets the RenderState that render calls of the calling thread use.
+		/// @return The RenderState of the RenderContext of the calling thread or the global RenderState.
+		RenderState* _getState() const;
+		/// @brief Gets the render helper that render calls of the calling thread use.
+		/// @return The render helper or NULL if there is none or the calling thread records into a RenderContext.
+		RenderHelper* _getRenderHelper() const;
+
+		/// @brief Records a texture in the texture profile if a profile is being recorded and the texture is bound for the first time.
+		/// @param[in] texture The Texture that is bound.
+		void _recordTextureProfile(Texture* texture);
+		/// @brief Takes a prefetched texture matching a texture that is being created.
+		/// @param[in] fromResource Whether the texture is loaded from a resource file or a normal file.
+		/// @param[in] filename Filename of the texture.
+		/// @param[in] type The texture type.
+		/// @param[in] loadMode The load mode requested for the texture.
+		/// @return The prefetched Texture or NULL if there is none.
+		/// @note The Texture takes over the requested load mode. Its async load may already be in progress or finished.
+		Texture* _takePrefetchedTexture(bool fromResource, chstr filename, Texture::Type type, Texture::LoadMode loadMode);
 
 		/// @brief Registers a created Texture in the system.
 		/// @param[in] texture The Texture to be registered.
@@ -720,6 +996,22 @@ namespace april
 		void _addUnloadTextureCommand(UnloadTextureCommand* command);
 		/// @brief Flushes all remaining async commands.
 		void _flushAsyncCommands();
+		/// @brief Waits until a complete async command queue is available for rendering.
+		/// @param[in] timeout Maximum time to wait in milliseconds.
+		/// @return True if a queue was signaled before the timeout ran out.
+		/// @note This is called on the rendering thread.
+		bool _waitForQueuedAsyncCommands(float timeout);
+		/// @brief Waits until an async command queue has been processed.
+		/// @param[in] timeout Maximum time to wait in milliseconds.
+		/// @return True if processing was signaled before the timeout ran out.
+		/// @note This is called on the update thread.
+		bool _waitForProcessedAsyncCommands(float timeout);
+		/// @brief Wakes up all threads waiting in async command handoff.
+		/// @note This is used when something else than the async command queues changes, e.g. the application state.
+		void _wakeAsyncWaiting();
+		/// @brief Updates the input latency after a frame with new input has been presented.
+		/// @param[in] inputTime The time when the first input event of the frame was queued.
+		void _updateInputLatency(double inputTime);
 
 		/// @brief Routing method for async creation.
 		/// @param[in] options The options to use.
@@ -762,6 +1054,10 @@ namespace april
 		/// @brief Creates the actual device VertexShader.
 		/// @return The created VertexShader object or NULL if not supported on this RenderSystem.
 		virtual VertexShader* _deviceCreateVertexShader();
+		/// @brief Creates the actual device VertexBuffer.
+		/// @return The created VertexBuffer object.
+		/// @note The default implementation keeps the vertices only in RAM.
+		virtual VertexBuffer* _deviceCreateVertexBuffer();
 
 		/// @brief Changes the device backbuffer resolution and fullscreen mode.
 		/// @param[in] width Width of the new backbuffer in pixels.
@@ -877,11 +1173,43 @@ namespace april
 		/// @see setTexture
 		/// @see drawTexturedRect
 		void _drawTexturedRectInternal(cgrectf rect, cgrectf src, const Color& color);
+		/// @brief Internally safe method for creating a VertexBuffer object.
+		/// @param[in] vertexType Which vertex class is stored in the buffer.
+		/// @param[in] vertexSize The byte size of one vertex.
+		/// @param[in] vertices The vertex data.
+		/// @param[in] count How many vertices there are.
+		/// @param[in] usage How often the vertices are expected to change.
+		/// @return The created VertexBuffer object or NULL if failed.
+		VertexBuffer* _createVertexBuffer(VertexBuffer::VertexType vertexType, int vertexSize, const void* vertices, int count, VertexBuffer::Usage usage);
+		/// @brief Renders vertices from a VertexBuffer to the backbuffer.
+		/// @param[in] renderOperation The RenderOperation that should be used to render the vertices.
+		/// @param[in] vertexBuffer The VertexBuffer containing the vertices.
+		/// @param[in] first Index of the first vertex that should be rendered.
+		/// @param[in] count How many vertices should be rendered.
+		/// @param[in] color Color to apply globally on all vertices.
+		/// @see render
+		void _renderInternal(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count, const Color& color);
 		/// @brief Increases all relevant rendering stats.
 		/// @param[in] renderOperation The RenderOperation that should be used to render the vertices.
 		/// @param[in] count How many vertices will be rendered.
 		/// @see render
 		void _increaseStats(const RenderOperation& renderOperation, int count);
+		/// @brief Checks whether a render call lies completely outside of the viewport and updates the culling stats.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array will be rendered.
+		/// @param[in] vertexSize The byte size of one vertex.
+		/// @return True if the render call can be dropped.
+		/// @note Culling is skipped while a CommandList is being recorded since the final transformation isn't known yet.
+		bool _cullRender(const PlainVertex* vertices, int count, int vertexSize);
+		/// @brief Makes render contexts stop using a texture that is being destroyed.
+		/// @param[in] texture The texture that is being destroyed.
+		/// @note Unsubmitted commands that use the texture are discarded. Contexts that another thread is recording into are skipped.
+		void _removeTextureFromRenderContexts(Texture* texture);
+		/// @brief Reorders consecutive opaque render commands by shader and texture.
+		/// @param[in] commands The commands of a queue.
+		/// @return How many texture switches were saved.
+		/// @note Clears, render target changes and blended render commands are never crossed.
+		int _sortOpaqueCommands(harray<AsyncCommand*>& commands);
 
 		/// @brief Clears the device backbuffer.
 		/// @param[in] depth If true, clears the depth-buffer as well.
@@ -913,6 +1241,19 @@ namespace april
 		/// @param[in] vertices An array of vertices.
 		/// @param[in] count How many vertices from the array should be rendered.
 		virtual void _deviceRender(const RenderOperation& renderOperation, const ColoredTexturedVertex* vertices, int count) = 0;
+		/// @brief Executes the final renders call for a VertexBuffer.
+		/// @param[in] renderOperation The RenderOperation that should be used to render the vertices.
+		/// @param[in] vertexBuffer The VertexBuffer containing the vertices.
+		/// @param[in] first Index of the first vertex that should be rendered.
+		/// @param[in] count How many vertices should be rendered.
+		/// @note The default implementation renders the RAM copy of the vertices.
+		virtual void _deviceRender(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count);
+		/// @brief Executes the final renders call for quad instances.
+		/// @param[in] rect The base quad in local coordinates.
+		/// @param[in] instances An array of quad instances.
+		/// @param[in] count How many instances from the array should be rendered.
+		/// @note The default implementation expands the instances into vertices in batches. Render systems that support hardware instancing can override this.
+		virtual void _deviceRenderInstanced(cgrectf rect, const QuadInstance* instances, int count);
 		/// @brief Flushes the currently rendered data to the backbuffer for display.
 		/// @param[in] systemEnabled Whether the system present is actually enabled.
 		virtual void _devicePresentFrame(bool systemEnabled);
@@ -930,8 +1271,9 @@ namespace april
 		/// @brief Updates the intermediate render textures.
 		void _updateIntermediateRenderTextures();
 		/// @brief Creates the intermediate render textures.
-		/// @param[in] width The texture width.
-		/// @param[in] height The texture height.
+		/// @param[in] width The backbuffer width.
+		/// @param[in] height The backbuffer height.
+		/// @note The current scale of the intermediate render texture is applied to the size.
 		/// @return True if successful.
 		bool _tryCreateIntermediateRenderTextures(int width, int height);
 		/// @brief Destroys the intermediate render texture.
@@ -939,9 +1281,24 @@ namespace april
 		bool _tryDestroyIntermediateRenderTextures();
 		/// @brief Renders the actual intermediate render texture.
 		void _presentIntermediateRenderTexture();
+		/// @brief Gets the size of the intermediate render texture for a given backbuffer size.
+		/// @param[in] width The backbuffer width.
+		/// @param[in] height The backbuffer height.
+		/// @return The texture size with the current scale applied.
+		gvec2i _getIntermediateRenderTextureSize(int width, int height) const;
+		/// @brief Gets the device viewport that is actually used for a RenderState.
+		/// @param[in] state The RenderState that is being applied.
+		/// @return The viewport scaled to the intermediate render texture if it's currently the render target.
+		grecti _getDeviceViewport(RenderState* state) const;
+		/// @brief Measures the frame time and changes the scale of the intermediate render texture if necessary.
+		/// @note The new scale is applied the next time the intermediate render textures are updated.
+		void _updateDynamicResolution();
 		/// @brief Unloads all textures. Used internally only.
 		/// @note Useful for clearing all memory or if something invalidates textures and cannot guarantee that they are loaded anymore.
 		void _deviceUnloadTextures();
+		/// @brief Unloads all vertex buffers from the GPU. Used internally only.
+		/// @note The vertices are kept in RAM and uploaded again the next time they are rendered.
+		void _deviceUnloadVertexBuffers();
 
 		/// @brief Calculates the number of primitives based on the number of vertices.
 		/// @param[in] renderOperation The RenderOperation that is used for rendering
@@ -30,6 +30,7 @@ namespace april
 {
 	class DestroyTextureCommand;
 	class Image;
+	class ImageTask;
 	class RenderSystem;
 	class ResetCommand;
 	class TextureAsync;
@@ -74,6 +75,10 @@ namespace april
 			/// @var static const Filter Filter::Linear
 			/// @brief Linear interpolation.
 			HL_ENUM_DECLARE(Filter, Linear);
+			/// @var static const Filter Filter::Trilinear
+			/// @brief Linear interpolation between pixels and between mipmap levels.
+			/// @note Requires mipmaps to be enabled. When the texture has no mipmaps, it behaves like Linear.
+			HL_ENUM_DECLARE(Filter, Trilinear);
 		));
 
 		/// @class AddressMode
@@ -120,6 +125,12 @@ namespace april
 		HL_DEFINE_GETSET(Filter, filter, Filter);
 		/// @brief The texture's UV coordinate address mode.
 		HL_DEFINE_GETSET(AddressMode, addressMode, AddressMode);
+		/// @brief Whether a mipmap chain is created for the texture.
+		/// @note This has to be set before the texture is loaded, otherwise it only takes effect on the next upload.
+		HL_DEFINE_ISSET(mipmapsEnabled, MipmapsEnabled);
+		/// @brief Whether the color channels are multiplied with the alpha channel when the image data is loaded.
+		/// @note This has to be set before the texture is loaded. Use BlendMode::PremultipliedAlpha to render such a texture. Compressed and palette data cannot be premultiplied and is loaded as it is with a warning.
+		HL_DEFINE_ISSET(premultipliedAlpha, PremultipliedAlpha);
 		/// @brief Whether the texture is locked for raw image data manipulation.
 		HL_DEFINE_IS(locked, Locked);
 		/// @brief Whether the texture is dirty and needs to be reuploaded to the GPU.
@@ -140,6 +151,10 @@ namespace april
 		/// @return Size of the image data in bytes.
 		/// @note The calculation is basically "width * height * bpp".
 		int getByteSize() const;
+		/// @brief Gets the filtering mode that is actually used for rendering.
+		/// @return The filtering mode that is actually used for rendering.
+		/// @note Filter::Trilinear falls back to Filter::Linear when no mipmaps have been uploaded.
+		Filter getEffectiveFilter() const;
 		/// @brief Gets the current VRAM consumption, RAM consumption and RAM consumption of the asynchronously loaded data.
 		/// @return The current VRAM consumption, RAM consumption and RAM consumption of the asynchronously loaded data.
 		/// @note This code is useful to check the full RAM consumption without requiring multiple mutex locks.
@@ -307,6 +322,7 @@ namespace april
 		/// @return True if successful.
 		/// @note Pixels on the destination will be overwritten will be blended with alpha-blending using the source pixels.
 		/// @note The parameter alpha is especially useful when blitting source images that don't have an alpha channel.
+		/// @note If the texture uses premultiplied alpha, the source data has to be premultiplied as well and is composited like BlendMode::PremultipliedAlpha.
 		bool blit(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha = 255);
 		/// @brief Does an image data block transfer onto the texture.
 		/// @param[in] sx Source data X-coordinate.
@@ -338,6 +354,7 @@ namespace april
 		/// @return True if successful.
 		/// @note Pixels on the destination will be overwritten will be blended with alpha-blending using the source pixels.
 		/// @note The parameter alpha is especially useful when blitting source images that don't have an alpha channel.
+		/// @note If the texture uses premultiplied alpha, the source data has to be premultiplied as well and is composited like BlendMode::PremultipliedAlpha.
 		bool blitStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha = 255);
 		/// @brief Does a stretched image data block transfer onto the texture.
 		/// @param[in] sx Source data X-coordinate.
@@ -354,6 +371,74 @@ namespace april
 		/// @note Pixels on the destination will be overwritten will be blended with alpha-blending using the source pixels.
 		/// @note The parameter alpha is especially useful when blitting source images that don't have an alpha channel.
 		bool blitStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, Texture* texture, unsigned char alpha = 255);
+		/// @brief Writes image data directly onto the texture on a worker thread.
+		/// @param[in] sx Source data X-coordinate.
+		/// @param[in] sy Source data Y-coordinate.
+		/// @param[in] sw Width of the area on the source to be copied.
+		/// @param[in] sh Height of the area on the source to be copied.
+		/// @param[in] dx Destination X-coordinate.
+		/// @param[in] dy Destination Y-coordinate.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @return Handle for the operation that has to be deleted when done or NULL if the texture cannot be changed.
+		/// @note The source data has to stay valid until the operation has finished. The texture must not be destroyed before that either.
+		/// @note Pixels on the destination will be overwritten.
+		/// @see write(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+		ImageTask* writeAsync(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat);
+		/// @brief Writes image data directly onto the texture on a worker thread while trying to stretch the pixels. Stretched pixels will be linearly interpolated.
+		/// @param[in] sx Source data X-coordinate.
+		/// @param[in] sy Source data Y-coordinate.
+		/// @param[in] sw Width of the area on the source to be copied.
+		/// @param[in] sh Height of the area on the source to be copied.
+		/// @param[in] dx Destination X-coordinate.
+		/// @param[in] dy Destination Y-coordinate.
+		/// @param[in] dw Width of the destination area.
+		/// @param[in] dh Height of the destination area.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @return Handle for the operation that has to be deleted when done or NULL if the texture cannot be changed.
+		/// @note The source data has to stay valid until the operation has finished. The texture must not be destroyed before that either.
+		/// @note Pixels on the destination will be overwritten.
+		/// @see writeStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+		ImageTask* writeStretchAsync(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat);
+		/// @brief Does an image data block transfer onto the texture on a worker thread.
+		/// @param[in] sx Source data X-coordinate.
+		/// @param[in] sy Source data Y-coordinate.
+		/// @param[in] sw Width of the area on the source to be copied.
+		/// @param[in] sh Height of the area on the source to be copied.
+		/// @param[in] dx Destination X-coordinate.
+		/// @param[in] dy Destination Y-coordinate.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @param[in] alpha Alpha multiplier on the entire source image.
+		/// @return Handle for the operation that has to be deleted when done or NULL if the texture cannot be changed.
+		/// @note The source data has to stay valid until the operation has finished. The texture must not be destroyed before that either.
+		/// @see blit(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
+		ImageTask* blitAsync(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha = 255);
+		/// @brief Does a stretched image data block transfer onto the texture on a worker thread.
+		/// @param[in] sx Source data X-coordinate.
+		/// @param[in] sy Source data Y-coordinate.
+		/// @param[in] sw Width of the area on the source to be copied.
+		/// @param[in] sh Height of the area on the source to be copied.
+		/// @param[in] dx Destination X-coordinate.
+		/// @param[in] dy Destination Y-coordinate.
+		/// @param[in] dw Width of the destination area.
+		/// @param[in] dh Height of the destination area.
+		/// @param[in] srcData The source raw image data.
+		/// @param[in] srcWidth The width of source raw image data.
+		/// @param[in] srcHeight The height of source raw image data.
+		/// @param[in] srcFormat The pixel format of source raw image data.
+		/// @param[in] alpha Alpha multiplier on the entire source image.
+		/// @return Handle for the operation that has to be deleted when done or NULL if the texture cannot be changed.
+		/// @note The source data has to stay valid until the operation has finished. The texture must not be destroyed before that either.
+		/// @see blitStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
+		ImageTask* blitStretchAsync(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha = 255);
 		/// @brief Rotates the pixel hue of a rectangle area on the texture.
 		/// @param[in] x X-coordinate of the area to change.
 		/// @param[in] y Y-coordinate of the area to change.
@@ -362,7 +447,6 @@ namespace april
 		/// @param[in] degrees By how many degrees the the should be rotated.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool rotateHue(int x, int y, int w, int h, float degrees);
 		/// @brief Changes the saturation level of pixels of a rectangle area on the texture.
 		/// @param[in] x X-coordinate of the area to change.
@@ -372,8 +456,18 @@ namespace april
 		/// @param[in] factor The saturation multiplier factor.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool saturate(int x, int y, int w, int h, float factor);
+		/// @brief Rotates the pixel hue and changes the saturation level of pixels of a rectangle area on the texture in a single pass.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] degrees By how many degrees the hue should be rotated.
+		/// @param[in] factor The saturation multiplier factor.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note The result is the same as calling rotateHue() and then saturate(), but the data is only processed and uploaded once.
+		bool adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor);
 		/// @brief Inverts the pixel colors of a rectangle area on the texture.
 		/// @param[in] x X-coordinate of the area to change.
 		/// @param[in] y Y-coordinate of the area to change.
@@ -381,6 +475,16 @@ namespace april
 		/// @param[in] h Height of the area to change.
 		/// @return True if successful.
 		bool invert(int x, int y, int w, int h);
+		/// @brief Applies a color matrix to the pixels of a rectangle area on the texture.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] matrix The color matrix.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note Only the changed area is uploaded to the GPU again.
+		bool applyColorMatrix(int x, int y, int w, int h, const Image::ColorMatrix& matrix);
 		/// @brief Inserts image data as alpha channel into this image.
 		/// @param[in] srcData The source raw image data.
 		/// @param[in] srcFormat The pixel format of source raw image data.
@@ -388,7 +492,6 @@ namespace april
 		/// @param[in] ambiguity How "hard" the alpha channel transition should be.
 		/// @return True if successful.
 		/// @note The image data in srcData must be the same width and height as the image.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool insertAlphaMap(unsigned char* srcData, Image::Format srcFormat, unsigned char median, int ambiguity);
 		/// @brief Inserts image data as alpha channel into this image.
 		/// @param[in] texture The source Texture object.
@@ -396,7 +499,6 @@ namespace april
 		/// @param[in] ambiguity How "hard" the alpha channel transition should be.
 		/// @return True if successful.
 		/// @note The image data in srcData must be the same width and height as the image.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool insertAlphaMap(Texture* texture, unsigned char median, int ambiguity);
 
 		/// @brief Gets the color of a specific pixel.
@@ -618,26 +720,38 @@ namespace april
 		/// @param[in] degrees By how many degrees the the should be rotated.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool rotateHue(cgrecti rect, float degrees);
 		/// @brief Changes the saturation level of pixels of a rectangle area on the image.
 		/// @param[in] rect Rectangle area.
 		/// @param[in] factor The saturation multiplier factor.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool saturate(cgrecti rect, float factor);
+		/// @brief Rotates the pixel hue and changes the saturation level of pixels of a rectangle area on the texture in a single pass.
+		/// @param[in] rect Rectangle area.
+		/// @param[in] degrees By how many degrees the hue should be rotated.
+		/// @param[in] factor The saturation multiplier factor.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @see adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor)
+		bool adjustHueSaturation(cgrecti rect, float degrees, float factor);
 		/// @brief Inverts the pixel colors of a rectangle area on the image.
 		/// @param[in] rect Rectangle area.
 		/// @return True if successful.
 		bool invert(cgrecti rect);
+		/// @brief Applies a color matrix to the pixels of a rectangle area on the texture.
+		/// @param[in] rect Rectangle area.
+		/// @param[in] matrix The color matrix.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		/// @note Only the changed area is uploaded to the GPU again.
+		bool applyColorMatrix(cgrecti rect, const Image::ColorMatrix& matrix);
 		/// @brief Inserts image data as alpha channel into this image.
 		/// @param[in] image The source Image.
 		/// @param[in] median The median value for insertion.
 		/// @param[in] ambiguity How "hard" the alpha channel transition should be.
 		/// @return True if successful.
 		/// @note The pixel format of image must be the same this image's.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool insertAlphaMap(Image* image, unsigned char median, int ambiguity); // TODOa - this functionality might be removed since shaders are much faster
 
 	protected:
@@ -719,16 +833,27 @@ namespace april
 		Filter filter;
 		/// @brief The texture's UV coordinate address mode.
 		AddressMode addressMode;
+		/// @brief Whether a mipmap chain is created for the texture.
+		bool mipmapsEnabled;
+		/// @brief Whether the color channels are multiplied with the alpha channel when the image data is loaded.
+		bool premultipliedAlpha;
+		/// @brief Whether the mipmap chain was uploaded to the GPU.
+		bool mipmapsUploaded;
 		/// @brief Whether the texture is locked for raw image data manipulation.
 		bool locked;
 		/// @brief Whether the texture is dirty and needs to be reuploaded to the GPU.
 		bool dirty;
+		/// @brief The area of the image data that was changed since the last upload.
+		grecti dirtyRect;
 		/// @brief The raw image data.
 		unsigned char* data;
 		/// @brief Mutex used for thread synchronization when using asynchronous loading.
 		hmutex asyncDataMutex;
 		/// @brief The raw image data that was loaded asynchronously and is waiting to be uploaded to the GPU.
 		unsigned char* dataAsync;
+		/// @brief The mipmap chain that was created asynchronously and is waiting to be uploaded to the GPU.
+		/// @note Only used when the RenderSystem cannot generate mipmaps on the GPU.
+		unsigned char* mipmapDataAsync;
 		/// @brief Whether asynchronous loading was queued.
 		bool asyncLoadQueued;
 		/// @brief Whether asynchronously loaded data was discared.
@@ -743,6 +868,9 @@ namespace april
 		/// @brief Whether a first upload to the GPU already happened.
 		/// @note Required because of how some RenderSystem implementations work (e.g. OpenGL and OpenGLES).
 		bool firstUpload;
+		/// @brief How many rows of the asynchronously loaded data were uploaded to the GPU so far.
+		/// @note This is -1 if no incremental upload is in progress.
+		int asyncUploadedRows;
 
 		/// @brief Constructor.
 		/// @param[in] fromResource Whether the texture was loaded from a resource file or a normal file.
@@ -794,6 +922,10 @@ namespace april
 		/// @brief Destroy the device texture.
 		/// @return True if successful.
 		virtual bool _deviceDestroyTexture() = 0;
+		/// @brief Allocates the storage of the device texture without uploading any data.
+		/// @return True if successful.
+		/// @note The default implementation is not supported which disables incremental uploads.
+		virtual bool _deviceAllocateTexture();
 		/// @brief Assigns the internal device format.
 		/// @note This is called internally.
 		virtual void _assignFormat() = 0;
@@ -815,6 +947,14 @@ namespace april
 		/// @note The calculation is basically "width * height * bpp".
 		/// @note This is called internally.
 		int _getByteSize() const;
+		/// @brief Gets the size of the mipmap chain in bytes without the base level.
+		/// @return Size of the mipmap chain in bytes without the base level.
+		/// @note This is called internally.
+		int _getMipmapsByteSize() const;
+		/// @brief Checks whether a mipmap chain can be used with this texture.
+		/// @return True if a mipmap chain can be used with this texture.
+		/// @note This is called internally.
+		bool _canUseMipmaps() const;
 		/// @brief Gets the readable flag.
 		/// @return True if the image data from the texture can be read.
 		virtual bool _isReadable() const;
@@ -842,6 +982,21 @@ namespace april
 		/// @brief Uploads the texture data to the GPU. Used internally only.
 		/// @return True if can be uploaded and successful.
 		bool _tryAsyncFinalUpload();
+		/// @brief Uploads the texture data to the GPU within a byte budget. Used internally only.
+		/// @param[in] maxBytes The max number of bytes uploaded per frame or 0 for no limit.
+		/// @param[in,out] remainingBytes The number of bytes that can still be uploaded in this frame.
+		/// @return True if can be uploaded and successful.
+		/// @note Textures larger than maxBytes are uploaded in horizontal strips over multiple frames.
+		bool _tryAsyncFinalUpload(int maxBytes, int& remainingBytes);
+		/// @brief Checks whether the asynchronously loaded data can be uploaded in horizontal strips.
+		/// @return True if the asynchronously loaded data can be uploaded in horizontal strips.
+		bool _canUploadIncrementally() const;
+		/// @brief Uploads the next horizontal strip of the asynchronously loaded data to the GPU. Used internally only.
+		/// @param[in] lock The lock of asyncLoadMutex.
+		/// @param[in,out] remainingBytes The number of bytes that can still be uploaded in this frame.
+		/// @return True if successful.
+		/// @note The first call only allocates the device texture. The texture is marked as uploaded after the last strip.
+		bool _uploadAsyncStrip(hmutex::ScopeLock& lock, int& remainingBytes);
 		/// @brief Makes sure that the texture has been uploaded to the GPU. Used internally only.
 		/// @return True if successful or already loaded.
 		bool _upload(hmutex::ScopeLock& lock);
@@ -950,7 +1105,6 @@ namespace april
 		/// @param[in] degrees By how many degrees the the should be rotated.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool _rawRotateHue(int x, int y, int w, int h, float degrees);
 		/// @brief Changes the saturation level of pixels of a rectangle area on the texture. Used internally only.
 		/// @param[in] x X-coordinate of the area to change.
@@ -960,8 +1114,17 @@ namespace april
 		/// @param[in] factor The saturation multiplier factor.
 		/// @return True if successful.
 		/// @note This is lossy operation.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool _rawSaturate(int x, int y, int w, int h, float factor);
+		/// @brief Rotates the pixel hue and changes the saturation level of pixels of a rectangle area on the texture in a single pass. Used internally only.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] degrees By how many degrees the hue should be rotated.
+		/// @param[in] factor The saturation multiplier factor.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		bool _rawAdjustHueSaturation(int x, int y, int w, int h, float degrees, float factor);
 		/// @brief Inverts the pixel colors of a rectangle area on the texture. Used internally only.
 		/// @param[in] x X-coordinate of the area to change.
 		/// @param[in] y Y-coordinate of the area to change.
@@ -969,6 +1132,15 @@ namespace april
 		/// @param[in] h Height of the area to change.
 		/// @return True if successful.
 		bool _rawInvert(int x, int y, int w, int h);
+		/// @brief Applies a color matrix to the pixels of a rectangle area on the texture. Used internally only.
+		/// @param[in] x X-coordinate of the area to change.
+		/// @param[in] y Y-coordinate of the area to change.
+		/// @param[in] w Width of the area to change.
+		/// @param[in] h Height of the area to change.
+		/// @param[in] matrix The color matrix.
+		/// @return True if successful.
+		/// @note This is lossy operation.
+		bool _rawApplyColorMatrix(int x, int y, int w, int h, const Image::ColorMatrix& matrix);
 		/// @brief Inserts image data as alpha channel into this image. Used internally only.
 		/// @param[in] srcData The source raw image data.
 		/// @param[in] srcFormat The pixel format of source raw image data.
@@ -976,7 +1148,6 @@ namespace april
 		/// @param[in] ambiguity How "hard" the alpha channel transition should be.
 		/// @return True if successful.
 		/// @note The image data in srcData must be the same width and height as the image.
-		/// @note This is an expensive operation and should be used sparingly.
 		bool _rawInsertAlphaMap(unsigned char* srcData, Image::Format srcFormat, unsigned char median, int ambiguity);
 
 		/// @brief Sets up dimensions and internal state of the texture to be power-of-two compliant.
@@ -1005,10 +1176,37 @@ namespace april
 		/// @param[in] update True if the image data should be reuploaded to the GPU.
 		/// @return True if successful.
 		virtual bool _unlockSystem(Lock& lock, bool update) = 0;
+		/// @brief Creates the mipmap chain on the GPU from the already uploaded base level.
+		/// @return True if successful.
+		/// @note The default implementation is not supported.
+		virtual bool _deviceGenerateMipmaps();
+		/// @brief Uploads one level of the mipmap chain to the GPU.
+		/// @param[in] level The mipmap level, starting with 1 for the first level below the base level.
+		/// @param[in] w Width of the mipmap level.
+		/// @param[in] h Height of the mipmap level.
+		/// @param[in] data The raw image data of the mipmap level.
+		/// @return True if successful.
+		/// @note The default implementation is not supported.
+		virtual bool _uploadMipmapToGpu(int level, int w, int h, unsigned char* data);
+		/// @brief Uploads or generates the mipmap chain after the base level was uploaded.
+		/// @param[in] data The raw image data of the base level. Used to create the mipmap chain on the CPU if needed and mipmapData is NULL.
+		/// @param[in] mipmapData The already created mipmap chain without the base level or NULL.
+		/// @return True if successful.
+		bool _uploadMipmaps(unsigned char* data, unsigned char* mipmapData);
+		/// @brief Applies the effective filter to the device again if the texture is currently bound.
+		/// @note Required after the mipmaps became available since the device state isn't aware that the effective filter changed.
+		void _updateDeviceFilter();
 		/// @brief Attempts to upload changed texture data to the GPU.
 		/// @return True if successful.
 		/// @note No upload will happen if no changes have been made or the texture is currently not loaded.
 		bool _tryUploadDataToGpu();
+		/// @brief Marks an area of the image data as changed so it is uploaded to the GPU again.
+		/// @param[in] x X-coordinate of the area.
+		/// @param[in] y Y-coordinate of the area.
+		/// @param[in] w Width of the area.
+		/// @param[in] h Height of the area.
+		/// @note The area is merged with any previously changed areas.
+		void _markDirty(int x, int y, int w, int h);
 		/// @brief Uploads local image data directly to the GPU.
 		/// @param[in] x X-coordinate of the rectangle.
 		/// @param[in] y Y-coordinate of the rectangle.
@@ -14,6 +14,7 @@
 #define APRIL_TIMER_H
 
 #define __HL_INCLUDE_PLATFORM_HEADERS
+#include <hltypes/hltypesUtil.h>
 #include <hltypes/hplatform.h>
 
 #include <stdint.h>
@@ -34,6 +35,9 @@ namespace april
 		
 		/// @brief Gets current time of timer.
 		double getTime() const;
+		/// @brief Gets the resolution of the timer.
+		/// @note Multiplying getTime() with this value gives the time in seconds.
+		HL_DEFINE_GET(double, resolution, Resolution);
 
 		/// @brief Calculates the difference since the last measurement.
 		/// @param[in] update Whether to update the measurement before retrieving.
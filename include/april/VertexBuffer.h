@@ -0,0 +1,203 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a generic vertex buffer.
+
+#ifndef APRIL_VERTEX_BUFFER_H
+#define APRIL_VERTEX_BUFFER_H
+
+#include <hltypes/harray.h>
+#include <hltypes/henum.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hmutex.h>
+
+#include "aprilExport.h"
+#include "aprilUtil.h"
+
+namespace april
+{
+	class DestroyVertexBufferCommand;
+	class RenderSystem;
+	class VertexBufferRenderCommand;
+
+	/// @brief Defines a generic vertex buffer.
+	/// @note The vertices are uploaded to the GPU once and then only referenced by render calls. Render systems without GPU vertex buffers render them from RAM.
+	class aprilExport VertexBuffer
+	{
+	public:
+		friend class DestroyVertexBufferCommand;
+		friend class RenderSystem;
+		friend class VertexBufferRenderCommand;
+
+		/// @class Usage
+		/// @brief Defines how often the vertices are expected to change.
+		HL_ENUM_CLASS_PREFIX_DECLARE(aprilExport, Usage,
+		(
+			/// @var static const Usage Usage::Static
+			/// @brief The vertices are set once and rarely or never updated.
+			HL_ENUM_DECLARE(Usage, Static);
+			/// @var static const Usage Usage::Dynamic
+			/// @brief The vertices are updated often.
+			HL_ENUM_DECLARE(Usage, Dynamic);
+		));
+
+		/// @class VertexType
+		/// @brief Defines which vertex class is stored in the buffer.
+		HL_ENUM_CLASS_PREFIX_DECLARE(aprilExport, VertexType,
+		(
+			/// @var static const VertexType VertexType::Plain
+			/// @brief PlainVertex.
+			HL_ENUM_DECLARE(VertexType, Plain);
+			/// @var static const VertexType VertexType::Colored
+			/// @brief ColoredVertex.
+			HL_ENUM_DECLARE(VertexType, Colored);
+			/// @var static const VertexType VertexType::Textured
+			/// @brief TexturedVertex.
+			HL_ENUM_DECLARE(VertexType, Textured);
+			/// @var static const VertexType VertexType::ColoredTextured
+			/// @brief ColoredTexturedVertex.
+			HL_ENUM_DECLARE(VertexType, ColoredTextured);
+		));
+
+		/// @brief How often the vertices are expected to change.
+		HL_DEFINE_GET(Usage, usage, Usage);
+		/// @brief Which vertex class is stored in the buffer.
+		HL_DEFINE_GET(VertexType, vertexType, VertexType);
+		/// @brief The byte size of one vertex.
+		HL_DEFINE_GET(int, vertexSize, VertexSize);
+		/// @brief How many vertices are stored in the buffer.
+		HL_DEFINE_GET(int, count, Count);
+		/// @brief Whether the vertices currently reside in a GPU buffer.
+		HL_DEFINE_IS(uploaded, Uploaded);
+
+		/// @brief Replaces vertices in the buffer.
+		/// @param[in] first Index of the first vertex to replace.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @return True if successful.
+		/// @note The vertex class has to be the one the buffer was created with. Only the changed vertices are uploaded again.
+		/// @note The changed vertices are handed to the next render call of this buffer so render calls that were queued earlier, including those of frames that are still waiting to be rendered, keep drawing the old vertices. Render calls recorded in a CommandList don't pick up changes.
+		bool update(int first, const PlainVertex* vertices, int count);
+		/// @brief Replaces vertices in the buffer.
+		/// @param[in] first Index of the first vertex to replace.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @return True if successful.
+		/// @note The vertex class has to be the one the buffer was created with. Only the changed vertices are uploaded again.
+		/// @note The changed vertices are handed to the next render call of this buffer so render calls that were queued earlier, including those of frames that are still waiting to be rendered, keep drawing the old vertices. Render calls recorded in a CommandList don't pick up changes.
+		bool update(int first, const ColoredVertex* vertices, int count);
+		/// @brief Replaces vertices in the buffer.
+		/// @param[in] first Index of the first vertex to replace.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @return True if successful.
+		/// @note The vertex class has to be the one the buffer was created with. Only the changed vertices are uploaded again.
+		/// @note The changed vertices are handed to the next render call of this buffer so render calls that were queued earlier, including those of frames that are still waiting to be rendered, keep drawing the old vertices. Render calls recorded in a CommandList don't pick up changes.
+		bool update(int first, const TexturedVertex* vertices, int count);
+		/// @brief Replaces vertices in the buffer.
+		/// @param[in] first Index of the first vertex to replace.
+		/// @param[in] vertices An array of vertices.
+		/// @param[in] count How many vertices from the array should be used.
+		/// @return True if successful.
+		/// @note The vertex class has to be the one the buffer was created with. Only the changed vertices are uploaded again.
+		/// @note The changed vertices are handed to the next render call of this buffer so render calls that were queued earlier, including those of frames that are still waiting to be rendered, keep drawing the old vertices. Render calls recorded in a CommandList don't pick up changes.
+		bool update(int first, const ColoredTexturedVertex* vertices, int count);
+
+	protected:
+		/// @brief Vertices replaced by update() that have not been applied to the RAM copy yet.
+		class Update
+		{
+		public:
+			/// @brief Index of the first replaced vertex.
+			int first;
+			/// @brief How many vertices were replaced.
+			int count;
+			/// @brief Copy of the new vertex data.
+			unsigned char* data;
+
+		};
+
+		/// @brief Basic constructor.
+		VertexBuffer();
+		/// @brief Destructor.
+		virtual ~VertexBuffer();
+
+		/// @brief How often the vertices are expected to change.
+		Usage usage;
+		/// @brief Which vertex class is stored in the buffer.
+		VertexType vertexType;
+		/// @brief The byte size of one vertex.
+		int vertexSize;
+		/// @brief How many vertices are stored in the buffer.
+		int count;
+		/// @brief Copy of the vertex data in RAM.
+		/// @note This is used to recreate the GPU buffer after the device was reset and to render on systems without GPU buffers. It is only accessed on the render thread once the buffer was created.
+		unsigned char* data;
+		/// @brief Index of the first vertex that has to be uploaded again.
+		int dirtyFirst;
+		/// @brief How many vertices have to be uploaded again.
+		int dirtyCount;
+		/// @brief Whether the vertices currently reside in a GPU buffer.
+		bool uploaded;
+		/// @brief Updates that still have to be handed to a render call.
+		harray<Update> pendingUpdates;
+		/// @brief Mutex for the pending updates.
+		hmutex pendingUpdatesMutex;
+
+		/// @brief Sets up the buffer with a copy of the vertices.
+		/// @param[in] vertexType Which vertex class is stored in the buffer.
+		/// @param[in] vertexSize The byte size of one vertex.
+		/// @param[in] vertices The vertex data.
+		/// @param[in] count How many vertices there are.
+		/// @param[in] usage How often the vertices are expected to change.
+		/// @return True if successful.
+		bool _create(VertexType vertexType, int vertexSize, const void* vertices, int count, Usage usage);
+		/// @brief Copies vertices that replace a range of the buffer and adds them to the pending updates.
+		/// @param[in] vertexType Which vertex class the vertices are.
+		/// @param[in] first Index of the first vertex to replace.
+		/// @param[in] vertices The vertex data.
+		/// @param[in] count How many vertices there are.
+		/// @return True if successful.
+		bool _update(VertexType vertexType, int first, const void* vertices, int count);
+		/// @brief Takes all pending updates so they can be handed to a render call.
+		/// @return The pending updates.
+		harray<Update> _takeUpdates();
+		/// @brief Replaces vertices in the RAM copy and marks them for upload.
+		/// @param[in] updates The updates that are applied. They are deleted afterwards.
+		/// @note This is called on the render thread.
+		void _applyUpdates(harray<Update>& updates);
+		/// @brief Makes sure the GPU buffer exists and contains all changed vertices.
+		/// @return True if the GPU buffer can be used for rendering.
+		/// @note This is called on the render thread.
+		bool _ensureUploaded();
+		/// @brief Destroys the GPU buffer while keeping the RAM copy so it can be recreated.
+		/// @note This is called on the render thread.
+		void _deviceUnloadBuffer();
+
+		/// @brief Creates the GPU buffer.
+		/// @param[in] data The vertex data.
+		/// @param[in] size The byte size of the vertex data.
+		/// @return True if successful.
+		virtual bool _deviceCreateBuffer(unsigned char* data, int size);
+		/// @brief Destroys the GPU buffer.
+		/// @return True if successful.
+		virtual bool _deviceDestroyBuffer();
+		/// @brief Uploads a part of the vertex data to the GPU buffer.
+		/// @param[in] offset The byte offset in the buffer.
+		/// @param[in] data The vertex data.
+		/// @param[in] size The byte size of the vertex data.
+		/// @return True if successful.
+		virtual bool _deviceUpdateBuffer(int offset, unsigned char* data, int size);
+
+	};
+
+}
+
+#endif
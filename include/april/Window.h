@@ -27,6 +27,8 @@
 #include "Keys.h"
 #include "Timer.h"
 
+#define APRIL_MAX_INDEXED_TOUCHES 16
+
 namespace april
 {
 	class Application;
@@ -448,8 +450,12 @@ namespace april
 		hmutex eventMutex;
 		/// @brief Whether multi-touch mode is currently active.
 		bool multiTouchActive;
-		/// @brief The current active indexed touches.
-		hmap<int, gvec2f> indexedTouches;
+		/// @brief The indices of the current active indexed touches, kept sorted in ascending order.
+		int indexedTouchIndices[APRIL_MAX_INDEXED_TOUCHES];
+		/// @brief The positions of the current active indexed touches, matching indexedTouchIndices.
+		gvec2f indexedTouchPositions[APRIL_MAX_INDEXED_TOUCHES];
+		/// @brief The number of current active indexed touches.
+		int indexedTouchesCount;
 		/// @brief Queued mouse events.
 		harray<MouseEvent> mouseEvents;
 		/// @brief Queued keyboard events.
@@ -464,6 +470,27 @@ namespace april
 		harray<MotionEvent> motionEvents;
 		/// @brief Queued generic events.
 		harray<GenericEvent> genericEvents;
+		/// @brief The Timer object used for measuring input latency.
+		Timer inputTimer;
+		/// @brief When the oldest currently queued input event was queued or negative if there is none.
+		double queuedInputTime;
+		/// @brief When the oldest input event processed since the last frame presentation was queued or negative if there is none.
+		double processedInputTime;
+		/// @brief Mouse events currently being processed.
+		/// @note Swapped with the queued events during processing so their allocated capacity can be reused without copying.
+		harray<MouseEvent> processedMouseEvents;
+		/// @brief Keyboard events currently being processed.
+		harray<KeyEvent> processedKeyEvents;
+		/// @brief Touch events currently being processed.
+		harray<TouchEvent> processedTouchEvents;
+		/// @brief Multi-touch events currently being processed.
+		harray<TouchesEvent> processedTouchesEvents;
+		/// @brief Controller events currently being processed.
+		harray<ControllerEvent> processedControllerEvents;
+		/// @brief Motion events currently being processed.
+		harray<MotionEvent> processedMotionEvents;
+		/// @brief Generic events currently being processed.
+		harray<GenericEvent> processedGenericEvents;
 		/// @brief The controller emulation keys.
 		/// @note This is useful when testing controller input functionality without actually using a controller.
 		hmap<Key, Button> controllerEmulationKeys;
@@ -506,6 +533,22 @@ namespace april
 
 		/// @brief Processes queued events.
 		void _processEvents();
+		/// @brief Finds the slot of an indexed touch.
+		/// @param[in] index The touch index.
+		/// @return The slot in indexedTouchIndices or the negated insertion slot minus 1 if the touch is not indexed.
+		int _findIndexedTouch(int index) const;
+		/// @brief Gets the current time used for measuring input latency.
+		/// @return The current time in seconds.
+		double _getInputTime() const;
+		/// @brief Marks that an input event has been queued.
+		/// @note This is not thread-safe and must be called while eventMutex is locked.
+		void _markInputQueued();
+		/// @brief Gets and resets the time of the oldest input event processed since the last frame presentation.
+		/// @return The time when the oldest processed input event was queued or negative if no input was processed.
+		double _takeProcessedInputTime();
+		/// @brief Gets the positions of all current active indexed touches, ordered by touch index.
+		/// @return The positions of all current active indexed touches.
+		harray<gvec2f> _getIndexedTouchPositions() const;
 
 		/// @brief Internally safe method for creating a Cursor object.
 		/// @param[in] fromResource Whether the Cursor should be created from a resource file or a normal file.
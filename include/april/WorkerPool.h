@@ -0,0 +1,52 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a shared pool of worker threads for splitting work into bands.
+
+#ifndef APRIL_WORKER_POOL_H
+#define APRIL_WORKER_POOL_H
+
+#include "aprilExport.h"
+
+namespace april
+{
+	/// @brief Shared pool of worker threads that image operations and decoders use to process their data in parallel.
+	/// @note The threads are created on first use and their count is limited by april::getMaxWorkerThreads().
+	class aprilExport WorkerPool
+	{
+	public:
+		/// @brief Processes the items in [start, end) of a job split with run().
+		typedef void (*BandFunction)(void* data, int start, int end);
+		/// @brief Processes a job queued with queue().
+		typedef void (*TaskFunction)(void* data);
+
+		/// @brief Splits [0, count) into bands that are processed by the worker threads and the calling thread.
+		/// @param[in] count How many items have to be processed.
+		/// @param[in] function The function that processes one band.
+		/// @param[in] data Data passed to the function.
+		/// @note Returns when all bands are done. Bands of the same call are processed in parallel so they must not write to the same memory.
+		/// @note Within a band the whole range is processed on the calling thread so nested operations don't split again.
+		static void run(int count, BandFunction function, void* data);
+		/// @brief Runs a function on a worker thread.
+		/// @param[in] function The function to run.
+		/// @param[in] data Data passed to the function.
+		/// @note Returns immediately. The function is responsible for releasing the data.
+		static void queue(TaskFunction function, void* data);
+		/// @brief Checks whether run() would split work into bands.
+		/// @return False within a band or if only one thread is available.
+		static bool canSplit();
+		/// @brief Stops and deletes all worker threads.
+		/// @note Already queued work is finished before the threads stop.
+		static void destroy();
+
+	};
+
+}
+#endif
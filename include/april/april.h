@@ -203,6 +203,13 @@ namespace april
 	/// @param[in] value The max number of async textures uploaded to the GPU per frame.
 	/// @note A value of 0 or less indicates all currently loaded textures.
 	aprilFnExport void setMaxAsyncTextureUploadsPerFrame(int value);
+	/// @brief Gets the max number of bytes of async texture data uploaded to the GPU per frame.
+	/// @return The max number of bytes of async texture data uploaded to the GPU per frame.
+	aprilFnExport int getMaxAsyncTextureUploadBytesPerFrame();
+	/// @brief Sets the max number of bytes of async texture data uploaded to the GPU per frame.
+	/// @param[in] value The max number of bytes of async texture data uploaded to the GPU per frame.
+	/// @note Textures larger than this are uploaded in horizontal strips over multiple frames. A value of 0 or less disables the limit.
+	aprilFnExport void setMaxAsyncTextureUploadBytesPerFrame(int value);
 	/// @brief Gets the max number of async textures concurrently loaded in RAM and waiting for upload.
 	/// @return The max number of async textures concurrently loaded in RAM and waiting for upload.
 	aprilFnExport int getMaxWaitingAsyncTextures();
@@ -210,6 +217,21 @@ namespace april
 	/// @param[in] value The max number of async textures concurrently loaded in RAM and waiting for upload.
 	/// @note A value of 0 or less indicates no limit.
 	aprilFnExport void setMaxWaitingAsyncTextures(int value);
+	/// @brief Gets the max number of threads used for parallel work like async texture decoding.
+	/// @return The max number of threads used for parallel work.
+	/// @note Unless set explicitly, this is the number of CPU cores the process can actually use.
+	aprilFnExport int getMaxWorkerThreads();
+	/// @brief Sets the max number of threads used for parallel work like async texture decoding.
+	/// @param[in] value The max number of threads used for parallel work.
+	/// @note A value of 0 or less indicates the number of CPU cores the process can actually use.
+	aprilFnExport void setMaxWorkerThreads(int value);
+	/// @brief Gets the minimum number of pixels from which Image operations are split across worker threads.
+	/// @return The minimum number of pixels from which Image operations are split across worker threads.
+	aprilFnExport int getParallelPixelThreshold();
+	/// @brief Sets the minimum number of pixels from which Image operations are split across worker threads.
+	/// @param[in] value The minimum number of pixels from which Image operations are split across worker threads.
+	/// @note A value of 0 or less disables splitting.
+	aprilFnExport void setParallelPixelThreshold(int value);
 	/// @brief Gets the exit code that should be used when exiting the application.
 	/// @return The exit code that should be used when exiting the application.
 	aprilFnExport int getExitCode();
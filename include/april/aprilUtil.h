@@ -23,6 +23,8 @@
 
 /// @brief Used internally for vector/rect/etc string representations.
 #define APRIL_HSTR_SEPARATOR ','
+/// @brief How many vertices a QuadInstance is expanded into.
+#define APRIL_QUAD_INSTANCE_VERTICES_COUNT 6
 
 namespace april
 {
@@ -79,6 +81,10 @@ namespace april
 		/// @var static const BlendMode BlendMode::Overwrite
 		/// @brief Overwrite data blending.
 		HL_ENUM_DECLARE(BlendMode, Overwrite);
+		/// @var static const BlendMode BlendMode::PremultipliedAlpha
+		/// @brief Alpha blending for textures with premultiplied alpha.
+		/// @note Colors have to be premultiplied as well. Additive blending can be done in the same state by using an alpha of 0.
+		HL_ENUM_DECLARE(BlendMode, PremultipliedAlpha);
 	));
 
 	/// @class ColorMode
@@ -327,6 +333,41 @@ namespace april
 		explicit inline ColoredTexturedVertex(cgvec3f position, unsigned int color, cgvec2f textureCoordinate) :				ColoredVertex(position, color), u(textureCoordinate.x), v(textureCoordinate.y) { }
 
 	};
+
+	/// @brief Represents one instance of a quad for instanced rendering.
+	/// @note This is much smaller than the 6 vertices a quad would otherwise need.
+	class aprilExport QuadInstance
+	{
+	public:
+		/// @brief The 2D transformation's X-axis X-component.
+		float a;
+		/// @brief The 2D transformation's X-axis Y-component.
+		float b;
+		/// @brief The 2D transformation's Y-axis X-component.
+		float c;
+		/// @brief The 2D transformation's Y-axis Y-component.
+		float d;
+		/// @brief The 2D transformation's X-translation.
+		float tx;
+		/// @brief The 2D transformation's Y-translation.
+		float ty;
+		/// @brief UV rectangle on the texture.
+		grectf src;
+		/// @brief The color of the instance.
+		/// @note The 'color' value is in native format, not RGBA MSB!)
+		unsigned int color;
+
+		/// @brief Basic constructor.
+		explicit inline QuadInstance() :	a(1.0f), b(0.0f), c(0.0f), d(1.0f), tx(0.0f), ty(0.0f), src(0.0f, 0.0f, 1.0f, 1.0f), color(0xFFFFFFFF) { }
+
+		/// @brief Sets the 2D transformation from a position, scale and rotation.
+		/// @param[in] position The translation.
+		/// @param[in] scale The scale.
+		/// @param[in] angle The rotation angle in degrees.
+		/// @note A corner (x,y) of the base quad ends up at (a * x + c * y + tx, b * x + d * y + ty).
+		void setTransform(cgvec2f position, cgvec2f scale, float angle);
+
+	};
 	
 	/// @brief Converts an RGB value to an HSL value.
 	/// @param[in] r Red value of the color.
@@ -16,11 +16,16 @@
 #include "Application.h"
 #include "main_base.h"
 #include "Platform.h"
+#include "Profiler.h"
 #include "RenderSystem.h"
+#include "Semaphore.h"
 #include "TextureAsync.h"
 #include "UpdateDelegate.h"
 #include "Window.h"
 
+// how long the main thread waits for a new frame before processing system events again, in milliseconds
+#define IDLE_TIMEOUT 5.0f
+
 namespace april
 {
 #ifdef __ANDROID__
@@ -54,6 +59,14 @@ namespace april
 	{
 		this->aprilApplicationInit = aprilApplicationInit;
 		this->aprilApplicationDestroy = aprilApplicationDestroy;
+		this->stateSemaphore = new Semaphore();
+		this->suspendSemaphore = new Semaphore();
+	}
+
+	Application::~Application()
+	{
+		delete this->stateSemaphore;
+		delete this->suspendSemaphore;
 	}
 	
 	Application::State Application::getState()
@@ -66,6 +79,26 @@ namespace april
 	{
 		hmutex::ScopeLock lock(&this->stateMutex);
 		this->state = value;
+		lock.release();
+		this->_signalStateChange();
+	}
+
+	void Application::_signalStateChange()
+	{
+		this->stateSemaphore->signal();
+		if (april::rendersys != NULL)
+		{
+			april::rendersys->_wakeAsyncWaiting();
+		}
+	}
+
+	void Application::_unlockUpdateSuspend()
+	{
+		if (this->updateSuspendQueued)
+		{
+			this->updateSuspendQueued = false;
+			this->suspendSemaphore->signal();
+		}
 	}
 	
 	bool Application::isAnyMessageBoxQueued()
@@ -76,6 +109,7 @@ namespace april
 
 	void Application::init()
 	{
+		APRIL_PROFILE_THREAD("Main");
 		this->_setState(State::Starting);
 		this->updateThread.start();
 	}
@@ -95,7 +129,7 @@ namespace april
 				}
 				return;
 			}
-			hthread::sleep(0.001f);
+			this->_waitForQueuedFrame();
 		}
 
 #else
@@ -106,7 +140,7 @@ namespace april
 			{
 				return;
 			}
-			hthread::sleep(0.001f);
+			this->_waitForQueuedFrame();
 		}
 #endif
 	}
@@ -125,7 +159,10 @@ namespace april
 		this->timer.update();
 		while (this->getState() == State::Running)
 		{
-			this->update();
+			if (!this->update())
+			{
+				this->_waitForQueuedFrame();
+			}
 		}
 		this->updateFinishing();
 	}
@@ -135,7 +172,10 @@ namespace april
 		// processing remaining commands from other thread
 		while (this->getState() == State::Stopping)
 		{
-			this->_updateSystem();
+			if (!this->_updateSystem())
+			{
+				this->_waitForQueuedFrame();
+			}
 		}
 		// finish everything up
 		this->_updateSystem();
@@ -168,9 +208,6 @@ namespace april
 		hmutex::ScopeLock lock(&this->timeDeltaMutex);
 		this->timeDelta += timeDelta;
 		lock.release();
-		lock.acquire(&this->frameTimerMutex);
-		this->frameTimer.update();
-		lock.release();
 		return april::rendersys->update((float)timeDelta);
 	}
 
@@ -201,6 +238,19 @@ namespace april
 		return false;
 	}
 
+	void Application::_waitForQueuedFrame()
+	{
+		if (april::rendersys != NULL)
+		{
+			// system events still need to be processed regularly on this thread so the wait is kept short
+			april::rendersys->_waitForQueuedAsyncCommands(IDLE_TIMEOUT);
+		}
+		else
+		{
+			hthread::sleep(0.001f);
+		}
+	}
+
 	void Application::_updateFps()
 	{
 		if (this->fpsTimer > 0.0)
@@ -226,6 +276,8 @@ namespace april
 		if (this->state == State::Starting || this->state == State::Running)
 		{
 			this->state = State::Stopping;
+			lock.release();
+			this->_signalStateChange();
 		}
 	}
 
@@ -235,10 +287,13 @@ namespace april
 		if (this->state == State::Stopping)
 		{
 			this->state = State::Stopped;
+			lock.release();
+			this->_signalStateChange();
+			lock.acquire(&this->stateMutex);
 			while (this->state == State::Stopped)
 			{
 				lock.release();
-				hthread::sleep(0.001f);
+				this->stateSemaphore->wait(HANDOFF_TIMEOUT);
 				lock.acquire(&this->stateMutex);
 			}
 		}
@@ -255,20 +310,17 @@ namespace april
 			hlog::error(logTag, "Could not attach Java thread! This will likely cause unexpected behavior and errors!");
 		}
 #endif
+		APRIL_PROFILE_THREAD("APRIL Async Update");
 		(*april::application->aprilApplicationInit)();
 		hmutex::ScopeLock lock(&april::application->stateMutex);
 		if (april::window != NULL && april::rendersys != NULL && april::application->state == State::Starting)
 		{
 			april::application->state = State::Running;
 			lock.release();
+			april::application->_signalStateChange();
 			float timeDelta = 0.0f;
 			UpdateDelegate* updateDelegate = NULL;
 			hmutex::ScopeLock lockTimeDelta;
-			float sleepTime = 0.0f;
-			// if this option can be changed in the future, this code needs to be adjusted for this
-			bool vSync = april::rendersys->getOptions().vSync;
-			// this might be changed in the future (assuming at least one display mode is available, this might not be safe)
-			float frameTime = 1000.0f / april::rendersys->getDisplayModes().first().refreshRate;
 			lock.acquire(&april::application->updateMutex);
 			while (april::application->getState() == State::Running)
 			{
@@ -281,37 +333,34 @@ namespace april
 				}
 				april::application->timeDelta = 0.0f;
 				lockTimeDelta.release();
-				if (!april::window->update(timeDelta))
-				{
-					april::application->finish();
-				}
-				april::window->setPresentFrameEnabled(false);
-				updateDelegate = april::window->getUpdateDelegate(); // constantly getting to make sure not to use an outdated object
-				if (updateDelegate != NULL)
 				{
-					updateDelegate->onPresentFrame();
-				}
-				else
-				{
-					april::rendersys->presentFrame();
-				}
-				april::window->setPresentFrameEnabled(true);
-				lock.release();
-				while (april::application->getState() == State::Running && april::rendersys->getAsyncQueuesCount() > april::rendersys->getFrameAdvanceUpdates())
-				{
-					if (vSync)
+					APRIL_PROFILE_ZONE("Command Recording");
+					if (!april::window->update(timeDelta))
+					{
+						april::application->finish();
+					}
+					april::window->setPresentFrameEnabled(false);
+					updateDelegate = april::window->getUpdateDelegate(); // constantly getting to make sure not to use an outdated object
+					if (updateDelegate != NULL)
 					{
-						lock.acquire(&april::application->frameTimerMutex);
-						sleepTime = frameTime - (float)april::application->frameTimer.diff(false) * 1000.0f;
-						lock.release();
-						hthread::sleep(hmax(sleepTime - 1.0f, 0.001f)); // using safe zone of 1ms
+						updateDelegate->onPresentFrame();
 					}
 					else
 					{
-						hthread::sleep(0.001f);
+						april::rendersys->presentFrame();
+					}
+					april::window->setPresentFrameEnabled(true);
+				}
+				lock.release();
+				{
+					APRIL_PROFILE_ZONE("Waiting For Render");
+					while (april::application->getState() == State::Running && april::rendersys->getAsyncQueuesCount() > april::rendersys->getFrameAdvanceUpdates())
+					{
+						// the rendering thread signals every processed queue so there is no need to estimate the frame time
+						april::rendersys->_waitForProcessedAsyncCommands(HANDOFF_TIMEOUT);
+						april::window->_processEvents();
+						april::application->_unlockUpdateSuspend();
 					}
-					april::window->_processEvents();
-					april::application->updateSuspendQueued = false; // make sure to unlock
 				}
 				lock.acquire(&april::application->updateMutex);
 			}
@@ -320,12 +369,13 @@ namespace april
 		{
 			april::application->state = State::Stopping;
 			lock.release();
+			april::application->_signalStateChange();
 			if (april::window != NULL)
 			{
 				april::window->_processEvents();
 			}
 		}
-		april::application->updateSuspendQueued = false; // make sure to unlock
+		april::application->_unlockUpdateSuspend();
 		bool initialized = (april::window != NULL);
 		(*april::application->aprilApplicationDestroy)();
 		if (!initialized)
@@ -354,9 +404,11 @@ namespace april
 			if (april::window->getOptions().suspendUpdateThread)
 			{
 				this->updateSuspendQueued = true;
+				april::rendersys->_wakeAsyncWaiting(); // the update thread could be waiting for the next frame to be processed
 				while (this->updateSuspendQueued)
 				{
-					hthread::sleep(0.001f);
+					// the timeout is only a safe-guard, the update thread signals when it lets go of the update mutex
+					this->suspendSemaphore->wait(HANDOFF_TIMEOUT);
 				}
 				this->updateMutex.lock();
 			}
@@ -0,0 +1,33 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <hltypes/harray.h>
+#include <hltypes/hltypesUtil.h>
+
+#include "CommandList.h"
+#include "RenderCommand.h"
+
+namespace april
+{
+	CommandList::CommandList() :
+		renderCalls(0),
+		vertexCount(0),
+		triangleCount(0),
+		lineCount(0)
+	{
+	}
+
+	CommandList::~CommandList()
+	{
+		foreach (RenderCommand*, it, this->commands)
+		{
+			delete (*it);
+		}
+	}
+
+}
@@ -0,0 +1,65 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <hltypes/hmutex.h>
+
+#include "ImageTask.h"
+#include "Semaphore.h"
+#include "WorkerPool.h"
+
+namespace april
+{
+	ImageTask::ImageTask() :
+		finished(false),
+		result(false)
+	{
+		this->finishedSignal = new Semaphore();
+	}
+
+	ImageTask::~ImageTask()
+	{
+		this->wait();
+		delete this->finishedSignal;
+	}
+
+	bool ImageTask::isFinished()
+	{
+		hmutex::ScopeLock lock(&this->mutex);
+		return this->finished;
+	}
+
+	bool ImageTask::wait()
+	{
+		hmutex::ScopeLock lock(&this->mutex);
+		if (!this->finished)
+		{
+			lock.release();
+			this->finishedSignal->wait();
+			// passes the signal on in case another thread is waiting as well
+			this->finishedSignal->signal();
+			lock.acquire(&this->mutex);
+		}
+		return this->result;
+	}
+
+	void ImageTask::_start()
+	{
+		WorkerPool::queue(&ImageTask::_run, this);
+	}
+
+	void ImageTask::_run(void* data)
+	{
+		ImageTask* task = (ImageTask*)data;
+		bool result = task->_execute();
+		hmutex::ScopeLock lock(&task->mutex);
+		task->result = result;
+		task->finished = true;
+		task->finishedSignal->signal();
+	}
+
+}
@@ -0,0 +1,432 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#if defined(APRIL_PROFILER) && defined(_WIN32)
+#define __HL_INCLUDE_PLATFORM_HEADERS
+#include <hltypes/hplatform.h>
+#endif
+#include <hltypes/harray.h>
+#include <hltypes/hfile.h>
+#include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hmap.h>
+#include <hltypes/hmutex.h>
+#include <hltypes/hsbase.h>
+#include <hltypes/hstring.h>
+
+#include "april.h"
+#include "Profiler.h"
+#include "Timer.h"
+
+#ifdef APRIL_PROFILER
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+#define FRAME_ZONE_NAME "Frame"
+#endif
+
+namespace april
+{
+#ifdef APRIL_PROFILER
+	struct ProfilerEvent
+	{
+		const char* name;
+		int64_t start;
+		int64_t end;
+	};
+
+	// only the owning thread writes into a buffer without locking, count is published after an event was written
+	struct ProfilerThreadBuffer
+	{
+		int id;
+		hstr name;
+		bool used;
+		volatile int64_t count;
+		ProfilerEvent events[APRIL_PROFILER_BUFFER_SIZE];
+	};
+
+	static Timer timer;
+	static hmutex buffersMutex;
+	static harray<ProfilerThreadBuffer*> buffers;
+	// increased whenever the buffers are destroyed so threads drop their stale buffer pointers
+	static volatile int64_t buffersGeneration = 0;
+	static THREAD_LOCAL ProfilerThreadBuffer* currentBuffer = NULL;
+	static THREAD_LOCAL int64_t currentBufferGeneration = 0;
+	static hmutex framesMutex;
+	static int frameIndex = 0;
+	static int64_t frameStart = -1;
+	static int64_t lastFrameStart = -1;
+	static int64_t lastFrameEnd = -1;
+
+	static inline int64_t _loadAcquire(volatile int64_t* value)
+	{
+#ifdef _WIN32
+		return InterlockedCompareExchange64((volatile LONG64*)value, 0, 0);
+#else
+		return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+	}
+
+	static inline void _storeRelease(volatile int64_t* target, int64_t value)
+	{
+#ifdef _WIN32
+		InterlockedExchange64((volatile LONG64*)target, value);
+#else
+		__atomic_store_n(target, value, __ATOMIC_RELEASE);
+#endif
+	}
+
+	static inline void _fenceAcquire()
+	{
+#ifdef _WIN32
+		MemoryBarrier();
+#else
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+	}
+
+	static void _dropStaleBuffer()
+	{
+		if (currentBuffer != NULL && currentBufferGeneration != _loadAcquire(&buffersGeneration))
+		{
+			currentBuffer = NULL;
+		}
+	}
+
+	static ProfilerThreadBuffer* _getCurrentBuffer()
+	{
+		_dropStaleBuffer();
+		if (currentBuffer == NULL)
+		{
+			hmutex::ScopeLock lock(&buffersMutex);
+			currentBufferGeneration = buffersGeneration;
+			foreach (ProfilerThreadBuffer*, it, buffers)
+			{
+				if (!(*it)->used)
+				{
+					currentBuffer = (*it);
+					break;
+				}
+			}
+			if (currentBuffer == NULL)
+			{
+				currentBuffer = new ProfilerThreadBuffer();
+				currentBuffer->id = buffers.size() + 1;
+				currentBuffer->name = "Thread " + hstr(currentBuffer->id);
+				currentBuffer->count = 0;
+				buffers += currentBuffer;
+			}
+			currentBuffer->used = true;
+		}
+		return currentBuffer;
+	}
+
+	static harray<ProfilerEvent> _getEvents(ProfilerThreadBuffer* buffer)
+	{
+		harray<ProfilerEvent> events;
+		int64_t count = _loadAcquire(&buffer->count);
+		int64_t first = hmax(count - APRIL_PROFILER_BUFFER_SIZE, (int64_t)0);
+		for (int64_t i = first; i < count; ++i)
+		{
+			events += buffer->events[i % APRIL_PROFILER_BUFFER_SIZE];
+		}
+		// the owning thread could have overwritten the oldest copied events in the meantime, including the one it is writing right now
+		_fenceAcquire();
+		int64_t valid = hmax(_loadAcquire(&buffer->count) - APRIL_PROFILER_BUFFER_SIZE + 1, first);
+		harray<ProfilerEvent> result;
+		for (int64_t i = valid; i < count; ++i)
+		{
+			result += events[(int)(i - first)];
+		}
+		return result;
+	}
+
+	static hstr _escapeJson(chstr string)
+	{
+		return string.replaced("\\", "\\\\").replaced("\"", "\\\"");
+	}
+#endif
+
+	bool Profiler::enabled = false;
+
+	Profiler::Zone::Zone(const char* name) :
+		name(name),
+		start(-1)
+	{
+		if (Profiler::enabled)
+		{
+			this->start = Profiler::_getTime();
+		}
+	}
+
+	Profiler::Zone::~Zone()
+	{
+		if (this->start >= 0)
+		{
+			Profiler::_addZone(this->name, this->start, Profiler::_getTime());
+		}
+	}
+
+	Profiler::ZoneSummary::ZoneSummary() :
+		count(0),
+		time(0.0),
+		maxTime(0.0)
+	{
+	}
+
+	bool Profiler::isAvailable()
+	{
+#ifdef APRIL_PROFILER
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	bool Profiler::isEnabled()
+	{
+		return Profiler::enabled;
+	}
+
+	void Profiler::setEnabled(bool value)
+	{
+#ifdef APRIL_PROFILER
+		Profiler::enabled = value;
+#else
+		if (value)
+		{
+			hlog::warn(logTag, "Profiler is not available, APRIL_PROFILER was not defined while building.");
+		}
+#endif
+	}
+
+	void Profiler::setThreadName(chstr name)
+	{
+#ifdef APRIL_PROFILER
+		ProfilerThreadBuffer* buffer = _getCurrentBuffer();
+		hmutex::ScopeLock lock(&buffersMutex);
+		buffer->name = name;
+#endif
+	}
+
+	void Profiler::releaseThread()
+	{
+#ifdef APRIL_PROFILER
+		hmutex::ScopeLock lock(&buffersMutex);
+		_dropStaleBuffer();
+		if (currentBuffer != NULL)
+		{
+			currentBuffer->used = false;
+			currentBuffer = NULL;
+		}
+#endif
+	}
+
+	void Profiler::markFrame()
+	{
+#ifdef APRIL_PROFILER
+		int64_t now = Profiler::_getTime();
+		hmutex::ScopeLock lock(&framesMutex);
+		if (Profiler::enabled && frameStart >= 0)
+		{
+			Profiler::_addZone(FRAME_ZONE_NAME, frameStart, now);
+			lastFrameStart = frameStart;
+			lastFrameEnd = now;
+		}
+		frameStart = now;
+		++frameIndex;
+#endif
+	}
+
+	int Profiler::getFrameIndex()
+	{
+#ifdef APRIL_PROFILER
+		hmutex::ScopeLock lock(&framesMutex);
+		return frameIndex;
+#else
+		return 0;
+#endif
+	}
+
+	double Profiler::getLastFrameTime()
+	{
+#ifdef APRIL_PROFILER
+		hmutex::ScopeLock lock(&framesMutex);
+		if (lastFrameStart >= 0)
+		{
+			return ((lastFrameEnd - lastFrameStart) * 0.000001);
+		}
+#endif
+		return 0.0;
+	}
+
+	harray<Profiler::ZoneSummary> Profiler::getLastFrameSummary()
+	{
+		harray<ZoneSummary> result;
+#ifdef APRIL_PROFILER
+		hmutex::ScopeLock lock(&framesMutex);
+		int64_t start = lastFrameStart;
+		int64_t end = lastFrameEnd;
+		lock.release();
+		if (start < 0)
+		{
+			return result;
+		}
+		lock.acquire(&buffersMutex);
+		harray<ProfilerThreadBuffer*> threadBuffers = buffers;
+		lock.release();
+		hmap<hstr, int> indices;
+		harray<ProfilerEvent> events;
+		double time = 0.0;
+		int index = 0;
+		foreach (ProfilerThreadBuffer*, it, threadBuffers)
+		{
+			events = _getEvents(*it);
+			foreach (ProfilerEvent, it2, events)
+			{
+				const ProfilerEvent& event = (*it2);
+				if (event.name == NULL || event.start < start || event.end > end || event.end < event.start)
+				{
+					continue;
+				}
+				if (!indices.hasKey(event.name))
+				{
+					indices[event.name] = result.size();
+					result += ZoneSummary();
+					result.last().name = event.name;
+				}
+				index = indices[event.name];
+				time = (event.end - event.start) * 0.000001;
+				++result[index].count;
+				result[index].time += time;
+				result[index].maxTime = hmax(result[index].maxTime, time);
+			}
+		}
+#endif
+		return result;
+	}
+
+	void Profiler::clear()
+	{
+#ifdef APRIL_PROFILER
+		hmutex::ScopeLock lock(&buffersMutex);
+		foreach (ProfilerThreadBuffer*, it, buffers)
+		{
+			_storeRelease(&(*it)->count, 0);
+		}
+		lock.release();
+		lock.acquire(&framesMutex);
+		frameStart = -1;
+		lastFrameStart = -1;
+		lastFrameEnd = -1;
+#endif
+	}
+
+	bool Profiler::exportTrace(hsbase& stream)
+	{
+#ifdef APRIL_PROFILER
+		if (!stream.isOpen())
+		{
+			return false;
+		}
+		hmutex::ScopeLock lock(&buffersMutex);
+		harray<ProfilerThreadBuffer*> threadBuffers = buffers;
+		harray<hstr> threadNames;
+		foreach (ProfilerThreadBuffer*, it, threadBuffers)
+		{
+			threadNames += (*it)->name;
+		}
+		lock.release();
+		stream.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		harray<ProfilerEvent> events;
+		bool first = true;
+		for_iter (i, 0, threadBuffers.size())
+		{
+			if (!first)
+			{
+				stream.write(",\n");
+			}
+			first = false;
+			stream.write(hsprintf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+				threadBuffers[i]->id, _escapeJson(threadNames[i]).cStr()));
+			events = _getEvents(threadBuffers[i]);
+			foreach (ProfilerEvent, it, events)
+			{
+				const ProfilerEvent& event = (*it);
+				if (event.name == NULL || event.end < event.start)
+				{
+					continue;
+				}
+				stream.write(hsprintf(",\n{\"name\":\"%s\",\"cat\":\"april\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%lld,\"dur\":%lld}",
+					_escapeJson(event.name).cStr(), threadBuffers[i]->id, (long long)event.start, (long long)(event.end - event.start)));
+			}
+		}
+		stream.write("\n]}\n");
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	bool Profiler::exportTrace(chstr filename)
+	{
+#ifdef APRIL_PROFILER
+		hfile file;
+		file.open(filename, hfaccess::Write);
+		return Profiler::exportTrace(file);
+#else
+		return false;
+#endif
+	}
+
+	void Profiler::_addZone(const char* name, int64_t start, int64_t end)
+	{
+#ifdef APRIL_PROFILER
+		ProfilerThreadBuffer* buffer = _getCurrentBuffer();
+		int64_t count = buffer->count;
+		ProfilerEvent& event = buffer->events[count % APRIL_PROFILER_BUFFER_SIZE];
+		event.name = name;
+		event.start = start;
+		event.end = end;
+		_storeRelease(&buffer->count, count + 1);
+#endif
+	}
+
+	void Profiler::_destroy()
+	{
+#ifdef APRIL_PROFILER
+		Profiler::enabled = false;
+		hmutex::ScopeLock lock(&buffersMutex);
+		foreach (ProfilerThreadBuffer*, it, buffers)
+		{
+			delete (*it);
+		}
+		buffers.clear();
+		// other threads still hold their buffer pointers and drop them when they notice the new generation
+		_storeRelease(&buffersGeneration, buffersGeneration + 1);
+		currentBuffer = NULL;
+		lock.release();
+		lock.acquire(&framesMutex);
+		frameStart = -1;
+		lastFrameStart = -1;
+		lastFrameEnd = -1;
+#endif
+	}
+
+	int64_t Profiler::_getTime()
+	{
+#ifdef APRIL_PROFILER
+		return (int64_t)(timer.getTime() * timer.getResolution() * 1000000.0);
+#else
+		return 0;
+#endif
+	}
+
+}
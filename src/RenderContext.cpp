@@ -0,0 +1,64 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <hltypes/harray.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hmutex.h>
+
+#include "AsyncCommand.h"
+#include "RenderContext.h"
+#include "RenderState.h"
+
+namespace april
+{
+	RenderContext::RenderContext(const RenderState& state, int order) :
+		order(order),
+		active(false),
+		viewportCulling(false)
+	{
+		this->state = new RenderState(state);
+		this->_resetStats();
+	}
+
+	RenderContext::~RenderContext()
+	{
+		foreach (AsyncCommand*, it, this->commands)
+		{
+			delete (*it);
+		}
+		delete this->state;
+	}
+
+	bool RenderContext::isActive()
+	{
+		hmutex::ScopeLock lock(&this->activeMutex);
+		return this->active;
+	}
+
+	bool RenderContext::_trySetActive(bool value)
+	{
+		hmutex::ScopeLock lock(&this->activeMutex);
+		if (this->active == value)
+		{
+			return false;
+		}
+		this->active = value;
+		return true;
+	}
+
+	void RenderContext::_resetStats()
+	{
+		this->renderCalls = 0;
+		this->vertexCount = 0;
+		this->triangleCount = 0;
+		this->lineCount = 0;
+		this->culledRenderCalls = 0;
+		this->culledVertexCount = 0;
+	}
+
+}
@@ -8,8 +8,10 @@
 
 #include <hltypes/hlog.h>
 
+#include "Profiler.h"
 #include "RenderHelperLayered2D.h"
 #include "RenderSystem.h"
+#include "vertexTransform.h"
 
 #define LINE_VERTEX_POOL_SIZE 8
 #define TRIANGLE_VERTEX_POOL_SIZE 6
@@ -187,6 +189,7 @@ namespace april
 
 	void RenderHelperLayered2D::flush()
 	{
+		APRIL_PROFILE_ZONE("RenderHelperLayered2D::flush");
 		this->_waitForCalculations();
 		hmutex::ScopeLock lock(&this->layersMutex);
 		if (this->layers.size() == 0)
@@ -280,6 +283,7 @@ namespace april
 
 	void RenderHelperLayered2D::_calculateRenderCall(RenderCall* renderCall)
 	{
+		APRIL_PROFILE_ZONE("RenderHelperLayered2D layering");
 		if (!renderCall->useTexture)
 		{
 			if (renderCall->plainVertices != NULL)
@@ -306,37 +310,8 @@ namespace april
 		}
 	}
 
-	void RenderHelperLayered2D::_makeBoundingRectColoredVertices()
-	{
-		this->_min.set(this->_coloredVertices[0].x, this->_coloredVertices[0].y);
-		this->_max = this->_min;
-		for_iter (i, 1, this->_coloredVerticesCount)
-		{
-			this->_min.x = hmin(this->_min.x, this->_coloredVertices[i].x);
-			this->_min.y = hmin(this->_min.y, this->_coloredVertices[i].y);
-			this->_max.x = hmax(this->_max.x, this->_coloredVertices[i].x);
-			this->_max.y = hmax(this->_max.y, this->_coloredVertices[i].y);
-		}
-		this->_boundingRect.set(this->_min, this->_max - this->_min);
-	}
-
-	void RenderHelperLayered2D::_makeBoundingRectColoredTexturedVertices()
-	{
-		this->_min.set(this->_coloredTexturedVertices[0].x, this->_coloredTexturedVertices[0].y);
-		this->_max = this->_min;
-		for_iter (i, 1, this->_coloredTexturedVerticesCount)
-		{
-			this->_min.x = hmin(this->_min.x, this->_coloredTexturedVertices[i].x);
-			this->_min.y = hmin(this->_min.y, this->_coloredTexturedVertices[i].y);
-			this->_max.x = hmax(this->_max.x, this->_coloredTexturedVertices[i].x);
-			this->_max.y = hmax(this->_max.y, this->_coloredTexturedVertices[i].y);
-		}
-		this->_boundingRect.set(this->_min, this->_max - this->_min);
-	}
-
 	void RenderHelperLayered2D::_addRenderLayer(RenderCall* renderCall)
 	{
-		this->_makeBoundingRectColoredVertices();
 		if (!this->_boundingRect.intersects(screenRect))
 		{
 			return;
@@ -352,7 +327,6 @@ namespace april
 
 	void RenderHelperLayered2D::_addRenderLayerTextured(RenderCall* renderCall)
 	{
-		this->_makeBoundingRectColoredTexturedVertices();
 		if (!this->_boundingRect.intersects(screenRect))
 		{
 			return;
@@ -519,11 +493,8 @@ namespace april
 		this->_updateColoredVerticesSize(count);
 		this->_nativeColor = april::rendersys->getNativeColorUInt(color);
 		this->_transformationMatrix = renderCall->state.projectionMatrix * renderCall->state.modelviewMatrix;
-		for_iter (i, 0, count)
-		{
-			this->_coloredVertices[i].set(this->_transformationMatrix * vertices[i].toGvec3f());
-			this->_coloredVertices[i].color = this->_nativeColor;
-		}
+		transformVertices(this->_transformationMatrix, vertices, count, this->_nativeColor, this->_coloredVertices, this->_min, this->_max);
+		this->_boundingRect.set(this->_min, this->_max - this->_min);
 	}
 
 	void RenderHelperLayered2D::_updateVertices(RenderCall* renderCall, TexturedVertex* vertices, int count, Color color)
@@ -531,35 +502,24 @@ namespace april
 		this->_updateColoredTexturedVerticesSize(count);
 		this->_nativeColor = april::rendersys->getNativeColorUInt(color);
 		this->_transformationMatrix = renderCall->state.projectionMatrix * renderCall->state.modelviewMatrix;
-		for_iter (i, 0, count)
-		{
-			this->_coloredTexturedVertices[i].set(this->_transformationMatrix * vertices[i].toGvec3f());
-			this->_coloredTexturedVertices[i].u = vertices[i].u;
-			this->_coloredTexturedVertices[i].v = vertices[i].v;
-			this->_coloredTexturedVertices[i].color = this->_nativeColor;
-		}
+		transformVertices(this->_transformationMatrix, vertices, count, this->_nativeColor, this->_coloredTexturedVertices, this->_min, this->_max);
+		this->_boundingRect.set(this->_min, this->_max - this->_min);
 	}
 
 	void RenderHelperLayered2D::_updateVertices(RenderCall* renderCall, ColoredVertex* vertices, int count)
 	{
 		this->_updateColoredVerticesSize(count);
-		memcpy(this->_coloredVertices, vertices, count * sizeof(ColoredVertex));
 		this->_transformationMatrix = renderCall->state.projectionMatrix * renderCall->state.modelviewMatrix;
-		for_iter (i, 0, count)
-		{
-			this->_coloredVertices[i].set(this->_transformationMatrix * vertices[i].toGvec3f());
-		}
+		transformVertices(this->_transformationMatrix, vertices, count, this->_coloredVertices, this->_min, this->_max);
+		this->_boundingRect.set(this->_min, this->_max - this->_min);
 	}
 
 	void RenderHelperLayered2D::_updateVertices(RenderCall* renderCall, ColoredTexturedVertex* vertices, int count)
 	{
 		this->_updateColoredTexturedVerticesSize(count);
-		memcpy(this->_coloredTexturedVertices, vertices, count * sizeof(ColoredTexturedVertex));
 		this->_transformationMatrix = renderCall->state.projectionMatrix * renderCall->state.modelviewMatrix;
-		for_iter (i, 0, count)
-		{
-			this->_coloredTexturedVertices[i].set(this->_transformationMatrix * vertices[i].toGvec3f());
-		}
+		transformVertices(this->_transformationMatrix, vertices, count, this->_coloredTexturedVertices, this->_min, this->_max);
+		this->_boundingRect.set(this->_min, this->_max - this->_min);
 	}
 
 	void RenderHelperLayered2D::_updateColoredVerticesSize(int count)
@@ -107,8 +107,6 @@ namespace april
 		void _waitForCalculations();
 		bool _tryForcedFlush(RenderOperation renderOperation);
 		void _calculateRenderCall(RenderCall* renderCall);
-		void _makeBoundingRectColoredVertices();
-		void _makeBoundingRectColoredTexturedVertices();
 		void _addRenderLayer(RenderCall* renderCall);
 		void _addRenderLayerTextured(RenderCall* renderCall);
 		Layer* _processIntersection(RenderCall* renderCall, Layer** currentValidLayer, Layer** lastValidLayer, int& intersectionIndex);
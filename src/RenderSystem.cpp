@@ -13,6 +13,7 @@
 #endif
 
 #include <hltypes/harray.h>
+#include <hltypes/hdir.h>
 #include <hltypes/hfile.h>
 #include <hltypes/hlog.h>
 #include <hltypes/hltypesUtil.h>
@@ -23,17 +24,36 @@
 #include "april.h"
 #include "aprilUtil.h"
 #include "AsyncCommands.h"
+#include "CommandList.h"
 #include "Image.h"
+#include "RenderContext.h"
 #include "RenderHelperLayered2D.h"
 #include "RenderSystem.h"
 #include "RenderState.h"
 #include "PixelShader.h"
 #include "Platform.h"
+#include "Profiler.h"
+#include "quadInstances.h"
+#include "Semaphore.h"
 #include "Texture.h"
 #include "TextureAsync.h"
+#include "VertexBuffer.h"
 #include "VertexShader.h"
+#include "viewportCulling.h"
 #include "Window.h"
 
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+#define DYNAMIC_RESOLUTION_SCALE_STEP 0.1f
+#define DYNAMIC_RESOLUTION_SLOW_FACTOR 1.1
+#define DYNAMIC_RESOLUTION_STALL_FACTOR 4.0
+#define DYNAMIC_RESOLUTION_DOWNSCALE_FRAMES 30
+#define DYNAMIC_RESOLUTION_UPSCALE_FRAMES 120
+#define DYNAMIC_RESOLUTION_MAX_UPSCALE_FRAMES 1920
+
 namespace april
 {
 	HL_ENUM_CLASS_DEFINE(RenderSystem::RenderMode,
@@ -42,9 +62,60 @@ namespace april
 		HL_ENUM_DEFINE(RenderSystem::RenderMode, Layered2D);
 	));
 
-	// optimizations, but they are not thread-safe
-	static PlainVertex pv[5];
-	static TexturedVertex tv[5];
+	// the RenderContext that the current thread records into
+	static THREAD_LOCAL RenderContext* currentRenderContext = NULL;
+
+	static bool _compareRenderContexts(RenderContext* first, RenderContext* second)
+	{
+		return (first->getOrder() < second->getOrder());
+	}
+
+	// opaque render commands are grouped by shader first, then by texture
+	static bool _compareOpaqueCommands(AsyncCommand* first, AsyncCommand* second)
+	{
+		RenderState* firstState = ((RenderCommand*)first)->getState();
+		RenderState* secondState = ((RenderCommand*)second)->getState();
+		if (firstState->useTexture != secondState->useTexture)
+		{
+			return secondState->useTexture;
+		}
+		if (firstState->useColor != secondState->useColor)
+		{
+			return secondState->useColor;
+		}
+		if (firstState->colorMode != secondState->colorMode)
+		{
+			return (firstState->colorMode.value < secondState->colorMode.value);
+		}
+		if (firstState->colorModeFactor != secondState->colorModeFactor)
+		{
+			return (firstState->colorModeFactor < secondState->colorModeFactor);
+		}
+		if (firstState->texture != secondState->texture)
+		{
+			return ((size_t)firstState->texture < (size_t)secondState->texture);
+		}
+		return (firstState->blendMode.value < secondState->blendMode.value);
+	}
+
+	// counts texture switches the same way RenderSystem::_updateDeviceState() does
+	static int _countTextureSwitches(AsyncCommand** commands, int count)
+	{
+		int result = 0;
+		RenderState* previousState = NULL;
+		RenderState* state = NULL;
+		for_iter (i, 0, count)
+		{
+			state = ((RenderCommand*)commands[i])->getState();
+			if (previousState != NULL && state->useTexture && state->texture != NULL &&
+				(previousState->texture != state->texture || !previousState->useTexture))
+			{
+				++result;
+			}
+			previousState = state;
+		}
+		return result;
+	}
 	
 	RenderSystem* rendersys = NULL;
 
@@ -93,7 +164,13 @@ namespace april
 		npotTexturesLimited(false),
 		npotTextures(false),
 		externalTextures(false),
+		mipmaps(false),
+		mipmapGeneration(false),
 		textureFormats(Image::Format::getValues()),
+		bcTextures(false),
+		etc1Textures(false),
+		etc2Textures(false),
+		astcTextures(false),
 		renderTarget(false)
 	{
 	}
@@ -138,19 +215,38 @@ namespace april
 		this->state = new RenderState();
 		this->deviceState = new RenderState();
 		this->lastAsyncCommandQueue = NULL;
+		this->recordingCommandList = NULL;
 		this->processingAsync = false;
 		this->frameAdvanceUpdates = 0;
 		this->frameDuplicates = 0;
+		this->viewportCulling = false;
+		this->sortOpaqueDraws = false;
+		this->dynamicResolution = false;
+		this->dynamicResolutionTargetFps = 60;
+		this->dynamicResolutionMinScale = 0.5f;
+		this->dynamicResolutionMaxScale = 1.0f;
+		this->intermediateRenderTextureScale = 1.0f;
+		this->textureProfileRecording = false;
+		this->textureProfileFrame = 0;
+		this->asyncQueuedSemaphore = new Semaphore();
+		this->asyncProcessedSemaphore = new Semaphore();
+		this->inputLatency = 0.0f;
 		this->statCurrentFrameRenderCalls = 0;
 		this->statLastFrameRenderCalls = 0;
 		this->statCurrentFrameTextureSwitches = 0;
 		this->statLastFrameTextureSwitches = 0;
+		this->statCurrentFrameSavedTextureSwitches = 0;
+		this->statLastFrameSavedTextureSwitches = 0;
 		this->statCurrentFrameVertexCount = 0;
 		this->statLastFrameVertexCount = 0;
 		this->statCurrentFrameTriangleCount = 0;
 		this->statLastFrameTriangleCount = 0;
 		this->statCurrentFrameLineCount = 0;
 		this->statLastFrameLineCount = 0;
+		this->statCurrentFrameCulledRenderCalls = 0;
+		this->statLastFrameCulledRenderCalls = 0;
+		this->statCurrentFrameCulledVertexCount = 0;
+		this->statLastFrameCulledVertexCount = 0;
 		this->_queuedFrameDuplicates = -1;
 		this->_renderTargetDuplicatesCount = 0;
 		this->_currentIntermediateRenderTexture = NULL;
@@ -158,6 +254,12 @@ namespace april
 		this->_intermediateRenderTextureCount = 1;
 		this->_intermediateRenderTextureIndex = 0;
 		this->_updateLastIntermediateRenderTexture = true;
+		this->_presentingIntermediateRenderTexture = false;
+		this->_intermediateViewportChanged = false;
+		this->_dynamicResolutionFrameTime = -1.0;
+		this->_dynamicResolutionFrames = 0;
+		this->_dynamicResolutionUpscaleFrames = DYNAMIC_RESOLUTION_UPSCALE_FRAMES;
+		this->_dynamicResolutionUpscaled = false;
 		this->_intermediateState = new RenderState();
 		// setting up the RenderState and other data for intermediate render texture
 		this->_intermediateState->blendMode = april::BlendMode::Overwrite;
@@ -180,6 +282,8 @@ namespace april
 		delete this->state;
 		delete this->deviceState;
 		delete this->_intermediateState;
+		delete this->asyncQueuedSemaphore;
+		delete this->asyncProcessedSemaphore;
 		if (this->renderHelper != NULL)
 		{
 			delete this->renderHelper;
@@ -221,12 +325,18 @@ namespace april
 		this->statLastFrameRenderCalls = 0;
 		this->statCurrentFrameTextureSwitches = 0;
 		this->statLastFrameTextureSwitches = 0;
+		this->statCurrentFrameSavedTextureSwitches = 0;
+		this->statLastFrameSavedTextureSwitches = 0;
 		this->statCurrentFrameVertexCount = 0;
 		this->statLastFrameVertexCount = 0;
 		this->statCurrentFrameTriangleCount = 0;
 		this->statLastFrameTriangleCount = 0;
 		this->statCurrentFrameLineCount = 0;
 		this->statLastFrameLineCount = 0;
+		this->statCurrentFrameCulledRenderCalls = 0;
+		this->statLastFrameCulledRenderCalls = 0;
+		this->statCurrentFrameCulledVertexCount = 0;
+		this->statLastFrameCulledVertexCount = 0;
 		this->_renderTargetDuplicatesCount = 0;
 		// create the actual device
 		this->_deviceInit();
@@ -274,6 +384,16 @@ namespace april
 			(*it)->_ensureAsyncCompleted(); // waiting for all async stuff to finish
 			delete (*it);
 		}
+		// deleting all vertex buffers
+		hmutex::ScopeLock lockVertexBuffers(&this->vertexBuffersMutex);
+		harray<VertexBuffer*> vertexBuffers = this->vertexBuffers;
+		this->vertexBuffers.clear();
+		lockVertexBuffers.release();
+		foreach (VertexBuffer*, it, vertexBuffers)
+		{
+			(*it)->_deviceUnloadBuffer();
+			delete (*it);
+		}
 		// misc
 		this->state->reset();
 		this->deviceState->reset();
@@ -291,12 +411,18 @@ namespace april
 		this->statLastFrameRenderCalls = 0;
 		this->statCurrentFrameTextureSwitches = 0;
 		this->statLastFrameTextureSwitches = 0;
+		this->statCurrentFrameSavedTextureSwitches = 0;
+		this->statLastFrameSavedTextureSwitches = 0;
 		this->statCurrentFrameVertexCount = 0;
 		this->statLastFrameVertexCount = 0;
 		this->statCurrentFrameTriangleCount = 0;
 		this->statLastFrameTriangleCount = 0;
 		this->statCurrentFrameLineCount = 0;
 		this->statLastFrameLineCount = 0;
+		this->statCurrentFrameCulledRenderCalls = 0;
+		this->statLastFrameCulledRenderCalls = 0;
+		this->statCurrentFrameCulledVertexCount = 0;
+		this->statLastFrameCulledVertexCount = 0;
 		this->_renderTargetDuplicatesCount = 0;
 		this->_deviceDestroy();
 		this->_deviceInit();
@@ -333,12 +459,18 @@ namespace april
 		this->statLastFrameRenderCalls = 0;
 		this->statCurrentFrameTextureSwitches = 0;
 		this->statLastFrameTextureSwitches = 0;
+		this->statCurrentFrameSavedTextureSwitches = 0;
+		this->statLastFrameSavedTextureSwitches = 0;
 		this->statCurrentFrameVertexCount = 0;
 		this->statLastFrameVertexCount = 0;
 		this->statCurrentFrameTriangleCount = 0;
 		this->statLastFrameTriangleCount = 0;
 		this->statCurrentFrameLineCount = 0;
 		this->statLastFrameLineCount = 0;
+		this->statCurrentFrameCulledRenderCalls = 0;
+		this->statLastFrameCulledRenderCalls = 0;
+		this->statCurrentFrameCulledVertexCount = 0;
+		this->statLastFrameCulledVertexCount = 0;
 	}
 
 	void RenderSystem::suspend()
@@ -373,6 +505,12 @@ namespace april
 		}
 	}
 
+	void RenderSystem::setDynamicResolutionScaleRange(float minScale, float maxScale)
+	{
+		this->dynamicResolutionMinScale = hclamp(minScale, 0.1f, 1.0f);
+		this->dynamicResolutionMaxScale = hclamp(maxScale, this->dynamicResolutionMinScale, 1.0f);
+	}
+
 	void RenderSystem::setRenderMode(RenderMode value, const hmap<hstr, hstr>& options)
 	{
 		if (this->renderMode != value)
@@ -474,39 +612,43 @@ namespace april
 	
 	grecti RenderSystem::getViewport() const
 	{
-		return this->state->viewport;
+		return this->_getState()->viewport;
 	}
 
 	void RenderSystem::setViewport(cgrecti value)
 	{
-		this->state->viewport = value;
-		this->state->viewportChanged = true;
+		RenderState* state = this->_getState();
+		state->viewport = value;
+		state->viewportChanged = true;
 	}
 
 	gmat4 RenderSystem::getModelviewMatrix() const
 	{
-		return this->state->modelviewMatrix;
+		return this->_getState()->modelviewMatrix;
 	}
 
 	void RenderSystem::setModelviewMatrix(cgmat4 value)
 	{
-		this->state->modelviewMatrix = value;
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix = value;
+		state->modelviewMatrixChanged = true;
 	}
 
 	gmat4 RenderSystem::getProjectionMatrix() const
 	{
-		return this->state->projectionMatrix;
+		return this->_getState()->projectionMatrix;
 	}
 
 	void RenderSystem::setProjectionMatrix(cgmat4 value)
 	{
-		this->state->projectionMatrix = value;
-		this->state->projectionMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->projectionMatrix = value;
+		state->projectionMatrixChanged = true;
 	}
 	
 	bool RenderSystem::update(float timeDelta)
 	{
+		APRIL_PROFILE_ZONE("RenderSystem::update");
 		bool result = false;
 		int previousRepeatCount = -1;
 		hmutex::ScopeLock lock(&this->asyncMutex);
@@ -552,12 +694,17 @@ namespace april
 			{
 				this->lastAsyncCommandQueue->clearRepeat();
 			}
+			this->asyncProcessedSemaphore->signal();
 		}
 		else if (this->asyncCommandQueues.size() >= 2)
 		{
 			AsyncCommandQueue* queue = this->asyncCommandQueues.removeFirst();
 			this->processingAsync = true;
 			lock.release();
+			if (this->sortOpaqueDraws)
+			{
+				this->statCurrentFrameSavedTextureSwitches += this->_sortOpaqueCommands(queue->commands);
+			}
 			foreach (AsyncCommand*, it, queue->commands)
 			{
 				(*it)->execute();
@@ -601,6 +748,7 @@ namespace april
 				(*it)->execute();
 			}
 			delete queue;
+			this->asyncProcessedSemaphore->signal();
 		}
 		else
 		{
@@ -662,7 +810,16 @@ namespace april
 		{
 			return NULL;
 		}
-		Texture* texture = this->_deviceCreateTexture(fromResource);
+		Texture* texture = NULL;
+		if (format == Image::Format::Invalid && loadMode != Texture::LoadMode::AsyncDeferredUpload)
+		{
+			texture = this->_takePrefetchedTexture(fromResource, name, type, loadMode);
+			if (texture != NULL)
+			{
+				return texture;
+			}
+		}
+		texture = this->_deviceCreateTexture(fromResource);
 		bool result = (format == Image::Format::Invalid ? texture->_create(name, type, loadMode) : texture->_create(name, format, type, loadMode));
 		if (result)
 		{
@@ -761,20 +918,237 @@ namespace april
 		{
 			throw Exception("Cannot call destroyTexture(), texture is NULL!");
 		}
-		if (this->renderHelper != NULL)
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper != NULL)
 		{
-			this->renderHelper->flush();
+			renderHelper->flush();
 		}
 		hmutex::ScopeLock lock(&this->texturesMutex);
 		this->textures -= texture;
 		lock.release();
+		lock.acquire(&this->textureProfileMutex);
+		if (this->prefetchedTextures.has(texture))
+		{
+			this->prefetchedTextures.remove(texture);
+		}
+		lock.release();
 		if (this->state->texture == texture)
 		{
 			this->state->texture = NULL;
 		}
+		this->_removeTextureFromRenderContexts(texture);
 		this->_addUnloadTextureCommand(new DestroyTextureCommand(texture));
 	}
 
+	bool RenderSystem::beginTextureProfile(chstr name)
+	{
+		hmutex::ScopeLock lock(&this->textureProfileMutex);
+		if (this->textureProfileRecording)
+		{
+			hlog::error(logTag, "Cannot begin texture profile, another texture profile is already being recorded!");
+			return false;
+		}
+		hstr filename = hdir::joinPath(april::getUserDataPath(), name);
+		this->textureProfileFilename = filename;
+		this->textureProfileFrames.clear();
+		this->textureProfileEntries.clear();
+		this->textureProfileFrame = 0;
+		this->textureProfileRecording = true;
+		lock.release();
+		if (!hfile::exists(filename))
+		{
+			return true;
+		}
+		hlog::write(logTag, "Prefetching textures from profile: " + filename);
+		// each line is "frame:resource:type:filename"
+		harray<hstr> lines = hfile::hread(filename).replaced("\r\n", "\n").split('\n', -1, true);
+		harray<Texture*> textures = this->getTextures();
+		harray<Texture::Type> types = Texture::Type::getValues();
+		types -= Texture::Type::RenderTarget;
+		harray<hstr> data;
+		bool fromResource = false;
+		int typeValue = 0;
+		Texture::Type type = Texture::Type::Immutable;
+		bool typeFound = false;
+		Texture* texture = NULL;
+		foreach (hstr, it, lines)
+		{
+			data = (*it).split(':', 3, true);
+			if (data.size() != 4 || !data[2].isInt())
+			{
+				continue;
+			}
+			fromResource = (data[1] == "1");
+			// the file could be damaged or come from a version with different types
+			typeValue = (int)data[2];
+			typeFound = false;
+			foreach (Texture::Type, it2, types)
+			{
+				if ((*it2).value == typeValue)
+				{
+					type = (*it2);
+					typeFound = true;
+					break;
+				}
+			}
+			if (!typeFound)
+			{
+				hlog::warn(logTag, "Skipping invalid texture profile entry: " + (*it));
+				continue;
+			}
+			texture = NULL;
+			foreach (Texture*, it2, textures)
+			{
+				if ((*it2)->filename == data[3] && (*it2)->fromResource == fromResource)
+				{
+					texture = (*it2);
+					break;
+				}
+			}
+			if (texture != NULL)
+			{
+				continue;
+			}
+			texture = this->_deviceCreateTexture(fromResource);
+			if (!texture->_create(data[3], type, Texture::LoadMode::Async) || !texture->loadAsync())
+			{
+				delete texture;
+				continue;
+			}
+			lock.acquire(&this->texturesMutex);
+			this->textures += texture;
+			lock.release();
+			lock.acquire(&this->textureProfileMutex);
+			this->prefetchedTextures += texture;
+			lock.release();
+			textures += texture;
+		}
+		return true;
+	}
+
+	bool RenderSystem::endTextureProfile()
+	{
+		hmutex::ScopeLock lock(&this->textureProfileMutex);
+		if (!this->textureProfileRecording)
+		{
+			hlog::error(logTag, "Cannot end texture profile, no texture profile is being recorded!");
+			return false;
+		}
+		this->textureProfileRecording = false;
+		hstr filename = this->textureProfileFilename;
+		harray<hstr> entries = this->textureProfileEntries;
+		harray<Texture*> prefetchedTextures = this->prefetchedTextures;
+		this->textureProfileFilename = "";
+		this->textureProfileFrames.clear();
+		this->textureProfileEntries.clear();
+		this->prefetchedTextures.clear();
+		lock.release();
+		foreach (Texture*, it, prefetchedTextures)
+		{
+			this->destroyTexture(*it);
+		}
+		hlog::write(logTag, "Saving texture profile: " + filename);
+		hdir::create(hdir::baseDir(filename));
+		hfile file;
+		file.open(filename, hfaccess::Write);
+		file.write(entries.joined('\n'));
+		file.close();
+		return true;
+	}
+
+	RenderState* RenderSystem::_getState() const
+	{
+		return (currentRenderContext != NULL ? currentRenderContext->state : this->state);
+	}
+
+	RenderHelper* RenderSystem::_getRenderHelper() const
+	{
+		return (currentRenderContext == NULL ? this->renderHelper : NULL);
+	}
+
+	void RenderSystem::_recordTextureProfile(Texture* texture)
+	{
+		// checked without locking first since this is called on every texture switch, it's checked again while locked
+		if (!this->textureProfileRecording || texture->filename == "")
+		{
+			return;
+		}
+		hmutex::ScopeLock lock(&this->textureProfileMutex);
+		if (!this->textureProfileRecording || this->textureProfileFrames.hasKey(texture->filename))
+		{
+			return;
+		}
+		this->textureProfileFrames[texture->filename] = this->textureProfileFrame;
+		this->textureProfileEntries += hsprintf("%d:%d:%d:", this->textureProfileFrame, (int)texture->fromResource, (int)texture->type.value) + texture->filename;
+	}
+
+	Texture* RenderSystem::_takePrefetchedTexture(bool fromResource, chstr filename, Texture::Type type, Texture::LoadMode loadMode)
+	{
+		hmutex::ScopeLock lock(&this->textureProfileMutex);
+		foreach (Texture*, it, this->prefetchedTextures)
+		{
+			if ((*it)->filename == filename && (*it)->fromResource == fromResource && (*it)->type == type)
+			{
+				Texture* texture = (*it);
+				this->prefetchedTextures.remove(texture);
+				// the first use waits for the async load to finish so OnDemand textures are loaded by then as well
+				texture->loadMode = loadMode;
+				return texture;
+			}
+		}
+		return NULL;
+	}
+
+	VertexBuffer* RenderSystem::createVertexBuffer(const PlainVertex* vertices, int count, VertexBuffer::Usage usage)
+	{
+		return this->_createVertexBuffer(VertexBuffer::VertexType::Plain, sizeof(PlainVertex), vertices, count, usage);
+	}
+
+	VertexBuffer* RenderSystem::createVertexBuffer(const ColoredVertex* vertices, int count, VertexBuffer::Usage usage)
+	{
+		return this->_createVertexBuffer(VertexBuffer::VertexType::Colored, sizeof(ColoredVertex), vertices, count, usage);
+	}
+
+	VertexBuffer* RenderSystem::createVertexBuffer(const TexturedVertex* vertices, int count, VertexBuffer::Usage usage)
+	{
+		return this->_createVertexBuffer(VertexBuffer::VertexType::Textured, sizeof(TexturedVertex), vertices, count, usage);
+	}
+
+	VertexBuffer* RenderSystem::createVertexBuffer(const ColoredTexturedVertex* vertices, int count, VertexBuffer::Usage usage)
+	{
+		return this->_createVertexBuffer(VertexBuffer::VertexType::ColoredTextured, sizeof(ColoredTexturedVertex), vertices, count, usage);
+	}
+
+	VertexBuffer* RenderSystem::_createVertexBuffer(VertexBuffer::VertexType vertexType, int vertexSize, const void* vertices, int count, VertexBuffer::Usage usage)
+	{
+		VertexBuffer* vertexBuffer = this->_deviceCreateVertexBuffer();
+		if (!vertexBuffer->_create(vertexType, vertexSize, vertices, count, usage))
+		{
+			delete vertexBuffer;
+			return NULL;
+		}
+		hmutex::ScopeLock lock(&this->vertexBuffersMutex);
+		this->vertexBuffers += vertexBuffer;
+		return vertexBuffer;
+	}
+
+	void RenderSystem::destroyVertexBuffer(VertexBuffer* vertexBuffer)
+	{
+		if (vertexBuffer == NULL)
+		{
+			throw Exception("Cannot call destroyVertexBuffer(), vertex buffer is NULL!");
+		}
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper != NULL)
+		{
+			renderHelper->flush();
+		}
+		hmutex::ScopeLock lock(&this->vertexBuffersMutex);
+		this->vertexBuffers -= vertexBuffer;
+		lock.release();
+		this->_addUnloadTextureCommand(new DestroyVertexBufferCommand(vertexBuffer));
+	}
+
 	PixelShader* RenderSystem::createPixelShaderFromResource(chstr filename)
 	{
 		return this->_createPixelShaderFromSource(true, filename);
@@ -847,6 +1221,11 @@ namespace april
 		return NULL;
 	}
 
+	VertexBuffer* RenderSystem::_deviceCreateVertexBuffer()
+	{
+		return new VertexBuffer();
+	}
+
 	void RenderSystem::destroyPixelShader(PixelShader* shader)
 	{
 		delete shader;
@@ -859,13 +1238,14 @@ namespace april
 
 	grectf RenderSystem::getOrthoProjection() const
 	{
+		RenderState* state = this->_getState();
 		grectf result;
-		if (this->state->projectionMatrix.data[0] != 0.0f && this->state->projectionMatrix.data[5] != 0.0f)
+		if (state->projectionMatrix.data[0] != 0.0f && state->projectionMatrix.data[5] != 0.0f)
 		{
-			result.w = 2.0f / this->state->projectionMatrix.data[0];
-			result.h = -2.0f / this->state->projectionMatrix.data[5];
-			result.x = (1.0f + this->state->projectionMatrix.data[12]) * result.w * 0.5f;
-			result.y = (1.0f - this->state->projectionMatrix.data[13]) * result.h * 0.5f;
+			result.w = 2.0f / state->projectionMatrix.data[0];
+			result.h = -2.0f / state->projectionMatrix.data[5];
+			result.x = (1.0f + state->projectionMatrix.data[12]) * result.w * 0.5f;
+			result.y = (1.0f - state->projectionMatrix.data[13]) * result.h * 0.5f;
 			result += result.getSize() * this->pixelOffset / april::window->getSize();
 		}
 		return result;
@@ -873,14 +1253,16 @@ namespace april
 
 	void RenderSystem::setOrthoProjection(cgrectf rect)
 	{
-		this->state->projectionMatrix.setOrthoProjection(rect - rect.getSize() * this->pixelOffset / april::window->getSize());
-		this->state->projectionMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->projectionMatrix.setOrthoProjection(rect - rect.getSize() * this->pixelOffset / april::window->getSize());
+		state->projectionMatrixChanged = true;
 	}
 
 	void RenderSystem::setOrthoProjection(cgrectf rect, float nearZ, float farZ)
 	{
-		this->state->projectionMatrix.setOrthoProjection(rect - rect.getSize() * this->pixelOffset / april::window->getSize(), nearZ, farZ);
-		this->state->projectionMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->projectionMatrix.setOrthoProjection(rect - rect.getSize() * this->pixelOffset / april::window->getSize(), nearZ, farZ);
+		state->projectionMatrixChanged = true;
 	}
 
 	void RenderSystem::setOrthoProjection(cgvec2f size)
@@ -895,10 +1277,11 @@ namespace april
 
 	void RenderSystem::setDepthBuffer(bool enabled, bool writeEnabled)
 	{
+		RenderState* state = this->_getState();
 		if (this->options.depthBuffer)
 		{
-			this->state->depthBuffer = enabled;
-			this->state->depthBufferWrite = writeEnabled;
+			state->depthBuffer = enabled;
+			state->depthBufferWrite = writeEnabled;
 		}
 		else
 		{
@@ -908,30 +1291,31 @@ namespace april
 
 	void RenderSystem::setTexture(Texture* texture)
 	{
-		this->state->texture = texture;
+		this->_getState()->texture = texture;
 	}
 
 	void RenderSystem::setBlendMode(const BlendMode& blendMode)
 	{
-		this->state->blendMode = blendMode;
+		this->_getState()->blendMode = blendMode;
 	}
 
 	void RenderSystem::setColorMode(const ColorMode& colorMode, float colorModeFactor)
 	{
-		this->state->colorMode = colorMode;
-		this->state->colorModeFactor = colorModeFactor;
+		RenderState* state = this->_getState();
+		state->colorMode = colorMode;
+		state->colorModeFactor = colorModeFactor;
 	}
 
 	Texture* RenderSystem::getRenderTarget()
 	{
-		return this->state->renderTarget;
+		return this->_getState()->renderTarget;
 	}
 
 	void RenderSystem::setRenderTarget(Texture* texture)
 	{
 		if (this->caps.renderTarget)
 		{
-			this->state->renderTarget = texture;
+			this->_getState()->renderTarget = texture;
 		}
 		else
 		{
@@ -946,87 +1330,103 @@ namespace april
 
 	void RenderSystem::setIdentityTransform()
 	{
-		this->state->modelviewMatrix.setIdentity();
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.setIdentity();
+		state->modelviewMatrixChanged = true;
 	}
 	
 	void RenderSystem::translate(float x, float y, float z)
 	{
-		this->state->modelviewMatrix.translate(x, y, z);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.translate(x, y, z);
+		state->modelviewMatrixChanged = true;
 	}
 	
 	void RenderSystem::translate(cgvec3f vector)
 	{
-		this->state->modelviewMatrix.translate(vector);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.translate(vector);
+		state->modelviewMatrixChanged = true;
 	}
 
 	void RenderSystem::translate(cgvec2f vector)
 	{
-		this->state->modelviewMatrix.translate(vector.x, vector.y, 0.0f);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.translate(vector.x, vector.y, 0.0f);
+		state->modelviewMatrixChanged = true;
 	}
 
 	void RenderSystem::rotate(float angle)
 	{
-		this->state->modelviewMatrix.rotate(0.0f, 0.0f, -1.0f, angle);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.rotate(0.0f, 0.0f, -1.0f, angle);
+		state->modelviewMatrixChanged = true;
 	}
 
 	void RenderSystem::rotate(float ax, float ay, float az, float angle)
 	{
-		this->state->modelviewMatrix.rotate(ax, ay, az, angle);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.rotate(ax, ay, az, angle);
+		state->modelviewMatrixChanged = true;
 	}	
 	
 	void RenderSystem::rotate(cgvec3f axis, float angle)
 	{
-		this->state->modelviewMatrix.rotate(axis, angle);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.rotate(axis, angle);
+		state->modelviewMatrixChanged = true;
 	}
 
 	void RenderSystem::scale(float factor)
 	{
-		this->state->modelviewMatrix.scale(factor);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.scale(factor);
+		state->modelviewMatrixChanged = true;
 	}
 	
 	void RenderSystem::scale(float factorX, float factorY, float factorZ)
 	{
-		this->state->modelviewMatrix.scale(factorX, factorY, factorZ);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.scale(factorX, factorY, factorZ);
+		state->modelviewMatrixChanged = true;
 	}
 	
 	void RenderSystem::scale(cgvec3f vector)
 	{
-		this->state->modelviewMatrix.scale(vector);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.scale(vector);
+		state->modelviewMatrixChanged = true;
 	}
 
 	void RenderSystem::scale(cgvec2f vector)
 	{
-		this->state->modelviewMatrix.scale(vector.x, vector.y, 1.0f);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.scale(vector.x, vector.y, 1.0f);
+		state->modelviewMatrixChanged = true;
 	}
 
 	void RenderSystem::lookAt(cgvec3f eye, cgvec3f target, cgvec3f up)
 	{
-		this->state->modelviewMatrix.lookAt(eye, target, up);
-		this->state->modelviewMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->modelviewMatrix.lookAt(eye, target, up);
+		state->modelviewMatrixChanged = true;
 	}
 		
 	void RenderSystem::setPerspective(float fov, float aspect, float nearZ, float farZ)
 	{
-		this->state->projectionMatrix.setPerspective(fov, aspect, nearZ, farZ);
-		this->state->projectionMatrixChanged = true;
+		RenderState* state = this->_getState();
+		state->projectionMatrix.setPerspective(fov, aspect, nearZ, farZ);
+		state->projectionMatrixChanged = true;
 	}
 
 	void RenderSystem::_updateDeviceState(RenderState* state, bool forceUpdate, bool ignoreRenderTarget)
 	{
+		APRIL_PROFILE_ZONE("RenderSystem::_updateDeviceState");
+		bool renderTargetChanged = false;
 		// render target
 		if (!ignoreRenderTarget && (forceUpdate || this->deviceState->renderTarget != state->renderTarget))
 		{
+			renderTargetChanged = true;
 			if (this->caps.renderTarget)
 			{
 				if (state->renderTarget != NULL)
@@ -1043,10 +1443,16 @@ namespace april
 			this->deviceState->renderTarget = state->renderTarget;
 		}
 		// viewport
-		if (forceUpdate || (state->viewportChanged && this->deviceState->viewport != state->viewport))
+		// the intermediate render texture can be smaller than the backbuffer so the viewport has to be set again when switching to and from it
+		if (forceUpdate || this->_intermediateViewportChanged || (renderTargetChanged && this->_currentIntermediateRenderTexture != NULL) ||
+			(state->viewportChanged && this->deviceState->viewport != state->viewport))
 		{
-			this->_setDeviceViewport(state->viewport);
+			this->_setDeviceViewport(this->_getDeviceViewport(state));
 			this->deviceState->viewport = state->viewport;
+			if (state != this->_intermediateState)
+			{
+				this->_intermediateViewportChanged = false;
+			}
 		}
 		// modelview matrix
 		if (forceUpdate || (state->modelviewMatrixChanged && this->deviceState->modelviewMatrix != state->modelviewMatrix))
@@ -1078,11 +1484,12 @@ namespace april
 			if (state->texture != NULL && state->useTexture)
 			{
 				++this->statCurrentFrameTextureSwitches;
+				this->_recordTextureProfile(state->texture);
 				state->texture->_ensureAsyncCompleted();
 				state->texture->_ensureUploaded();
 				// do not change this order, it can cause heavy issues with render targets
 				this->_setDeviceTexture(state->texture);
-				this->_setDeviceTextureFilter(state->texture->getFilter());
+				this->_setDeviceTextureFilter(state->texture->getEffectiveFilter());
 				this->_setDeviceTextureAddressMode(state->texture->getAddressMode());
 			}
 			else
@@ -1115,11 +1522,34 @@ namespace april
 
 	void RenderSystem::_addAsyncCommand(AsyncCommand* command)
 	{
+		RenderState* state = this->_getState();
 		if (command->isUseState())
 		{
-			this->state->viewportChanged = false;
-			this->state->modelviewMatrixChanged = false;
-			this->state->projectionMatrixChanged = false;
+			state->viewportChanged = false;
+			state->modelviewMatrixChanged = false;
+			state->projectionMatrixChanged = false;
+		}
+		// commands of a RenderContext are only queued when the context is submitted, no locking is required
+		if (currentRenderContext != NULL && !command->isFinalizer())
+		{
+			currentRenderContext->commands += command;
+			return;
+		}
+		if (this->recordingCommandList != NULL && !command->isFinalizer())
+		{
+			RenderCommand* renderCommand = dynamic_cast<RenderCommand*>(command);
+			if (renderCommand != NULL)
+			{
+				this->recordingCommandList->commands += renderCommand;
+				return;
+			}
+			// other commands would end up in the render queue ahead of the recorded render calls
+			if (!command->isSystemCommand())
+			{
+				hlog::error(logTag, "Cannot queue this command while a command list is being recorded, it was discarded!");
+				delete command;
+				return;
+			}
 		}
 		hmutex::ScopeLock lock(&this->asyncMutex);
 		if (this->asyncCommandQueues.size() == 0)
@@ -1130,6 +1560,8 @@ namespace april
 		if (command->isFinalizer())
 		{
 			this->asyncCommandQueues += new AsyncCommandQueue();
+			lock.release();
+			this->asyncQueuedSemaphore->signal();
 		}
 	}
 
@@ -1170,6 +1602,31 @@ namespace april
 			delete (*it);
 		}
 		TextureAsync::update();
+		this->asyncProcessedSemaphore->signal();
+	}
+
+	bool RenderSystem::_waitForQueuedAsyncCommands(float timeout)
+	{
+		return this->asyncQueuedSemaphore->wait(timeout);
+	}
+
+	bool RenderSystem::_waitForProcessedAsyncCommands(float timeout)
+	{
+		return this->asyncProcessedSemaphore->wait(timeout);
+	}
+
+	void RenderSystem::_wakeAsyncWaiting()
+	{
+		this->asyncQueuedSemaphore->signal();
+		this->asyncProcessedSemaphore->signal();
+	}
+
+	void RenderSystem::_updateInputLatency(double inputTime)
+	{
+		if (april::window != NULL)
+		{
+			this->inputLatency = (float)hmax(april::window->_getInputTime() - inputTime, 0.0);
+		}
 	}
 
 	void RenderSystem::waitForAsyncCommands(bool forced)
@@ -1179,28 +1636,31 @@ namespace april
 			this->frameDuplicates > 0 && this->lastAsyncCommandQueue != NULL && this->lastAsyncCommandQueue->getRepeatCount() <= 0)
 		{
 			this->asyncCommandQueues += new AsyncCommandQueue();
+			this->asyncQueuedSemaphore->signal();
 		}
 		while (this->asyncCommandQueues.size() > 1 || this->processingAsync ||
 			(this->frameDuplicates > 0 && this->lastAsyncCommandQueue != NULL && this->lastAsyncCommandQueue->getRepeatCount() > 0))
 		{
 			lock.release();
-			hthread::sleep(0.001f);
+			// the timeout is only a safe-guard, the rendering thread signals every processed queue
+			this->asyncProcessedSemaphore->wait(HANDOFF_TIMEOUT);
 			lock.acquire(&this->asyncMutex);
 		}
 	}
 
 	void RenderSystem::clear(bool depth)
 	{
-		if (this->renderHelper != NULL)
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper != NULL)
 		{
-			this->renderHelper->clear();
+			renderHelper->clear();
 			return;
 		}
 		if (!this->options.depthBuffer)
 		{
 			depth = false;
 		}
-		this->_addAsyncCommand(new ClearCommand(*this->state, depth));
+		this->_addAsyncCommand(new ClearCommand(*this->_getState(), depth));
 	}
 
 	void RenderSystem::clear(Color color, bool depth)
@@ -1209,20 +1669,21 @@ namespace april
 		{
 			depth = false;
 		}
-		this->_addAsyncCommand(new ClearColorCommand(*this->state, color, depth));
+		this->_addAsyncCommand(new ClearColorCommand(*this->_getState(), color, depth));
 	}
 
 	void RenderSystem::clearDepth()
 	{
 		if (this->options.depthBuffer)
 		{
-			this->_addAsyncCommand(new ClearDepthCommand(*this->state));
+			this->_addAsyncCommand(new ClearDepthCommand(*this->_getState()));
 		}
 	}
 
 	void RenderSystem::render(const RenderOperation& renderOperation, const PlainVertex* vertices, int count)
 	{
-		if (this->renderHelper == NULL || !this->renderHelper->render(renderOperation, vertices, count))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->render(renderOperation, vertices, count))
 		{
 			this->_renderInternal(renderOperation, vertices, count);
 		}
@@ -1234,7 +1695,8 @@ namespace april
 		{
 			return;
 		}
-		if (this->renderHelper == NULL || !this->renderHelper->render(renderOperation, vertices, count, color))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->render(renderOperation, vertices, count, color))
 		{
 			this->_renderInternal(renderOperation, vertices, count, color);
 		}
@@ -1242,7 +1704,8 @@ namespace april
 
 	void RenderSystem::render(const RenderOperation& renderOperation, const TexturedVertex* vertices, int count)
 	{
-		if (this->renderHelper == NULL || !this->renderHelper->render(renderOperation, vertices, count))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->render(renderOperation, vertices, count))
 		{
 			this->_renderInternal(renderOperation, vertices, count);
 		}
@@ -1254,7 +1717,8 @@ namespace april
 		{
 			return;
 		}
-		if (this->renderHelper == NULL || !this->renderHelper->render(renderOperation, vertices, count, color))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->render(renderOperation, vertices, count, color))
 		{
 			this->_renderInternal(renderOperation, vertices, count, color);
 		}
@@ -1262,7 +1726,8 @@ namespace april
 
 	void RenderSystem::render(const RenderOperation& renderOperation, const ColoredVertex* vertices, int count)
 	{
-		if (this->renderHelper == NULL || !this->renderHelper->render(renderOperation, vertices, count))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->render(renderOperation, vertices, count))
 		{
 			this->_renderInternal(renderOperation, vertices, count);
 		}
@@ -1270,19 +1735,60 @@ namespace april
 
 	void RenderSystem::render(const RenderOperation& renderOperation, const ColoredTexturedVertex* vertices, int count)
 	{
-		if (this->renderHelper == NULL || !this->renderHelper->render(renderOperation, vertices, count))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->render(renderOperation, vertices, count))
 		{
 			this->_renderInternal(renderOperation, vertices, count);
 		}
 	}
 
+	void RenderSystem::render(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count)
+	{
+		this->render(renderOperation, vertexBuffer, first, count, Color::White);
+	}
+
+	void RenderSystem::render(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count, const Color& color)
+	{
+		if (color.a == 0)
+		{
+			return;
+		}
+		// render helpers batch vertices, so everything they have queued has to be rendered first
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper != NULL)
+		{
+			renderHelper->flush();
+		}
+		this->_renderInternal(renderOperation, vertexBuffer, first, count, color);
+	}
+
+	void RenderSystem::renderInstanced(cgrectf rect, const QuadInstance* instances, int count)
+	{
+		RenderState* state = this->_getState();
+		if (count <= 0)
+		{
+			return;
+		}
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper != NULL)
+		{
+			renderHelper->flush();
+		}
+		this->_increaseStats(RenderOperation::TriangleList, count * APRIL_QUAD_INSTANCE_VERTICES_COUNT);
+		state->useTexture = true;
+		state->useColor = true;
+		state->systemColor = Color::White;
+		this->_addAsyncCommand(new QuadInstanceRenderCommand(*state, rect, instances, count));
+	}
+
 	void RenderSystem::drawRect(cgrectf rect, const Color& color)
 	{
 		if (color.a == 0)
 		{
 			return;
 		}
-		if (this->renderHelper == NULL || !this->renderHelper->drawRect(rect, color))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->drawRect(rect, color))
 		{
 			this->_drawRectInternal(rect, color);
 		}
@@ -1294,7 +1800,8 @@ namespace april
 		{
 			return;
 		}
-		if (this->renderHelper == NULL || !this->renderHelper->drawFilledRect(rect, color))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->drawFilledRect(rect, color))
 		{
 			this->_drawFilledRectInternal(rect, color);
 		}
@@ -1302,7 +1809,8 @@ namespace april
 
 	void RenderSystem::drawTexturedRect(cgrectf rect, cgrectf src)
 	{
-		if (this->renderHelper == NULL || !this->renderHelper->drawTexturedRect(rect, src))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->drawTexturedRect(rect, src))
 		{
 			this->_drawTexturedRectInternal(rect, src);
 		}
@@ -1314,7 +1822,8 @@ namespace april
 		{
 			return;
 		}
-		if (this->renderHelper == NULL || !this->renderHelper->drawTexturedRect(rect, src, color))
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper == NULL || !renderHelper->drawTexturedRect(rect, src, color))
 		{
 			this->_drawTexturedRectInternal(rect, src, color);
 		}
@@ -1322,64 +1831,116 @@ namespace april
 
 	void RenderSystem::_renderInternal(const RenderOperation& renderOperation, const PlainVertex* vertices, int count)
 	{
+		RenderState* state = this->_getState();
+		if (this->_cullRender(vertices, count, sizeof(PlainVertex)))
+		{
+			return;
+		}
 		this->_increaseStats(renderOperation, count);
-		this->state->useTexture = false;
-		this->state->useColor = false;
-		this->state->systemColor = Color::White;
-		this->_addAsyncCommand(new VertexRenderCommand<PlainVertex>(*this->state, renderOperation, vertices, count));
+		state->useTexture = false;
+		state->useColor = false;
+		state->systemColor = Color::White;
+		this->_addAsyncCommand(new VertexRenderCommand<PlainVertex>(*state, renderOperation, vertices, count));
 	}
 
 	void RenderSystem::_renderInternal(const RenderOperation& renderOperation, const PlainVertex* vertices, int count, const Color& color)
 	{
+		RenderState* state = this->_getState();
 		if (color.a == 0)
 		{
 			return;
 		}
+		if (this->_cullRender(vertices, count, sizeof(PlainVertex)))
+		{
+			return;
+		}
 		this->_increaseStats(renderOperation, count);
-		this->state->useTexture = false;
-		this->state->useColor = false;
-		this->state->systemColor = color;
-		this->_addAsyncCommand(new VertexRenderCommand<PlainVertex>(*this->state, renderOperation, vertices, count));
+		state->useTexture = false;
+		state->useColor = false;
+		state->systemColor = color;
+		this->_addAsyncCommand(new VertexRenderCommand<PlainVertex>(*state, renderOperation, vertices, count));
 	}
 
 	void RenderSystem::_renderInternal(const RenderOperation& renderOperation, const TexturedVertex* vertices, int count)
 	{
+		RenderState* state = this->_getState();
+		if (this->_cullRender(vertices, count, sizeof(TexturedVertex)))
+		{
+			return;
+		}
 		this->_increaseStats(renderOperation, count);
-		this->state->useTexture = true;
-		this->state->useColor = false;
-		this->state->systemColor = Color::White;
-		this->_addAsyncCommand(new VertexRenderCommand<TexturedVertex>(*this->state, renderOperation, vertices, count));
+		state->useTexture = true;
+		state->useColor = false;
+		state->systemColor = Color::White;
+		this->_addAsyncCommand(new VertexRenderCommand<TexturedVertex>(*state, renderOperation, vertices, count));
 	}
 
 	void RenderSystem::_renderInternal(const RenderOperation& renderOperation, const TexturedVertex* vertices, int count, const Color& color)
 	{
+		RenderState* state = this->_getState();
 		if (color.a == 0)
 		{
 			return;
 		}
+		if (this->_cullRender(vertices, count, sizeof(TexturedVertex)))
+		{
+			return;
+		}
 		this->_increaseStats(renderOperation, count);
-		this->state->useTexture = true;
-		this->state->useColor = false;
-		this->state->systemColor = color;
-		this->_addAsyncCommand(new VertexRenderCommand<TexturedVertex>(*this->state, renderOperation, vertices, count));
+		state->useTexture = true;
+		state->useColor = false;
+		state->systemColor = color;
+		this->_addAsyncCommand(new VertexRenderCommand<TexturedVertex>(*state, renderOperation, vertices, count));
 	}
 
 	void RenderSystem::_renderInternal(const RenderOperation& renderOperation, const ColoredVertex* vertices, int count)
 	{
+		RenderState* state = this->_getState();
+		if (this->_cullRender(vertices, count, sizeof(ColoredVertex)))
+		{
+			return;
+		}
 		this->_increaseStats(renderOperation, count);
-		this->state->useTexture = false;
-		this->state->useColor = true;
-		this->state->systemColor = Color::White;
-		this->_addAsyncCommand(new VertexRenderCommand<ColoredVertex>(*this->state, renderOperation, vertices, count));
+		state->useTexture = false;
+		state->useColor = true;
+		state->systemColor = Color::White;
+		this->_addAsyncCommand(new VertexRenderCommand<ColoredVertex>(*state, renderOperation, vertices, count));
 	}
 
 	void RenderSystem::_renderInternal(const RenderOperation& renderOperation, const ColoredTexturedVertex* vertices, int count)
 	{
+		RenderState* state = this->_getState();
+		if (this->_cullRender(vertices, count, sizeof(ColoredTexturedVertex)))
+		{
+			return;
+		}
+		this->_increaseStats(renderOperation, count);
+		state->useTexture = true;
+		state->useColor = true;
+		state->systemColor = Color::White;
+		this->_addAsyncCommand(new VertexRenderCommand<ColoredTexturedVertex>(*state, renderOperation, vertices, count));
+	}
+
+	void RenderSystem::_renderInternal(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count, const Color& color)
+	{
+		RenderState* state = this->_getState();
+		if (first < 0 || count <= 0 || first + count > vertexBuffer->count)
+		{
+			hlog::errorf(logTag, "Cannot render vertex buffer, vertices %d to %d are out of range (%d)!", first, first + count - 1, vertexBuffer->count);
+			return;
+		}
+		VertexBuffer::VertexType vertexType = vertexBuffer->vertexType;
 		this->_increaseStats(renderOperation, count);
-		this->state->useTexture = true;
-		this->state->useColor = true;
-		this->state->systemColor = Color::White;
-		this->_addAsyncCommand(new VertexRenderCommand<ColoredTexturedVertex>(*this->state, renderOperation, vertices, count));
+		state->useTexture = (vertexType == VertexBuffer::VertexType::Textured || vertexType == VertexBuffer::VertexType::ColoredTextured);
+		state->useColor = (vertexType == VertexBuffer::VertexType::Colored || vertexType == VertexBuffer::VertexType::ColoredTextured);
+		state->systemColor = (state->useColor ? Color::White : color);
+		// recorded commands are executed out of order with the render queue so they can't carry updates
+		harray<VertexBuffer::Update> updates;
+		if (currentRenderContext != NULL || this->recordingCommandList == NULL)
+		{
+			updates = vertexBuffer->_takeUpdates();
+		}
+		this->_addAsyncCommand(new VertexBufferRenderCommand(*state, renderOperation, vertexBuffer, first, count, updates));
 	}
 
 	void RenderSystem::_drawRectInternal(cgrectf rect, const Color& color)
@@ -1388,6 +1949,7 @@ namespace april
 		{
 			return;
 		}
+		PlainVertex pv[5];
 		pv[0].x = pv[3].x = pv[4].x = rect.x;
 		pv[0].y = pv[1].y = pv[4].y = rect.y;
 		pv[1].x = pv[2].x = rect.x + rect.w;
@@ -1401,6 +1963,7 @@ namespace april
 		{
 			return;
 		}
+		PlainVertex pv[4];
 		pv[0].x = pv[2].x = rect.x;
 		pv[0].y = pv[1].y = rect.y;
 		pv[1].x = pv[3].x = rect.x + rect.w;
@@ -1410,6 +1973,7 @@ namespace april
 	
 	void RenderSystem::_drawTexturedRectInternal(cgrectf rect, cgrectf src)
 	{
+		TexturedVertex tv[4];
 		tv[0].x = tv[2].x = rect.x;
 		tv[0].y = tv[1].y = rect.y;
 		tv[0].u = tv[2].u = src.x;
@@ -1427,6 +1991,7 @@ namespace april
 		{
 			return;
 		}
+		TexturedVertex tv[4];
 		tv[0].x = tv[2].x = rect.x;
 		tv[0].y = tv[1].y = rect.y;
 		tv[0].u = tv[2].u = src.x;
@@ -1440,6 +2005,20 @@ namespace april
 
 	void RenderSystem::_increaseStats(const RenderOperation& renderOperation, int count)
 	{
+		if (currentRenderContext != NULL)
+		{
+			++currentRenderContext->renderCalls;
+			currentRenderContext->vertexCount += count;
+			if (renderOperation.isTriangle())
+			{
+				currentRenderContext->triangleCount += this->_numPrimitives(renderOperation, count);
+			}
+			else if (renderOperation.isLine())
+			{
+				currentRenderContext->lineCount += this->_numPrimitives(renderOperation, count);
+			}
+			return;
+		}
 		++this->statCurrentFrameRenderCalls;
 		this->statCurrentFrameVertexCount += count;
 		if (renderOperation.isTriangle())
@@ -1452,6 +2031,356 @@ namespace april
 		}
 	}
 
+	bool RenderSystem::_cullRender(const PlainVertex* vertices, int count, int vertexSize)
+	{
+		RenderState* state = this->_getState();
+		// render contexts don't record into command lists and use the flag from when the recording began
+		bool culling = (currentRenderContext != NULL ? currentRenderContext->viewportCulling : (this->viewportCulling && this->recordingCommandList == NULL));
+		if (!culling)
+		{
+			return false;
+		}
+		if (!isOutsideClipSpace(state->projectionMatrix * state->modelviewMatrix, vertices, count, vertexSize))
+		{
+			return false;
+		}
+		if (currentRenderContext != NULL)
+		{
+			++currentRenderContext->culledRenderCalls;
+			currentRenderContext->culledVertexCount += count;
+			return true;
+		}
+		++this->statCurrentFrameCulledRenderCalls;
+		this->statCurrentFrameCulledVertexCount += count;
+		return true;
+	}
+
+	int RenderSystem::_sortOpaqueCommands(harray<AsyncCommand*>& commands)
+	{
+		int result = 0;
+		int size = commands.size();
+		int start = 0;
+		int end = 0;
+		Texture* renderTarget = NULL;
+		AsyncCommand** data = (AsyncCommand**)commands;
+		while (start < size)
+		{
+			if (!data[start]->isReorderable())
+			{
+				++start;
+				continue;
+			}
+			renderTarget = ((RenderCommand*)data[start])->getState()->renderTarget;
+			end = start + 1;
+			while (end < size && data[end]->isReorderable() && ((RenderCommand*)data[end])->getState()->renderTarget == renderTarget)
+			{
+				++end;
+			}
+			if (end - start > 1)
+			{
+				result += _countTextureSwitches(&data[start], end - start);
+				std::stable_sort(&data[start], &data[end], &_compareOpaqueCommands);
+				result -= _countTextureSwitches(&data[start], end - start);
+				// the changed flags were only valid in the original order
+				for_iter (i, start, end)
+				{
+					RenderState* state = ((RenderCommand*)data[i])->getState();
+					state->viewportChanged = true;
+					state->modelviewMatrixChanged = true;
+					state->projectionMatrixChanged = true;
+				}
+			}
+			start = end;
+		}
+		return result;
+	}
+
+	bool RenderSystem::beginCommandList()
+	{
+		if (this->recordingCommandList != NULL)
+		{
+			hlog::error(logTag, "Cannot begin command list, another command list is already being recorded!");
+			return false;
+		}
+		if (currentRenderContext != NULL)
+		{
+			hlog::error(logTag, "Cannot begin command list, the current thread is recording into a render context!");
+			return false;
+		}
+		if (this->renderHelper != NULL)
+		{
+			this->renderHelper->flush();
+		}
+		this->recordingModelviewMatrix = this->state->modelviewMatrix;
+		this->setIdentityTransform();
+		this->recordingCommandList = new CommandList();
+		this->recordingCommandList->renderCalls = this->statCurrentFrameRenderCalls;
+		this->recordingCommandList->vertexCount = this->statCurrentFrameVertexCount;
+		this->recordingCommandList->triangleCount = this->statCurrentFrameTriangleCount;
+		this->recordingCommandList->lineCount = this->statCurrentFrameLineCount;
+		return true;
+	}
+
+	CommandList* RenderSystem::endCommandList()
+	{
+		if (this->recordingCommandList == NULL)
+		{
+			hlog::error(logTag, "Cannot end command list, no command list is being recorded!");
+			return NULL;
+		}
+		if (this->renderHelper != NULL)
+		{
+			this->renderHelper->flush();
+		}
+		CommandList* commandList = this->recordingCommandList;
+		this->recordingCommandList = NULL;
+		// recorded calls are counted when the list is executed, the list keeps the difference since beginCommandList()
+		int delta = this->statCurrentFrameRenderCalls - commandList->renderCalls;
+		this->statCurrentFrameRenderCalls -= delta;
+		commandList->renderCalls = delta;
+		delta = this->statCurrentFrameVertexCount - commandList->vertexCount;
+		this->statCurrentFrameVertexCount -= delta;
+		commandList->vertexCount = delta;
+		delta = this->statCurrentFrameTriangleCount - commandList->triangleCount;
+		this->statCurrentFrameTriangleCount -= delta;
+		commandList->triangleCount = delta;
+		delta = this->statCurrentFrameLineCount - commandList->lineCount;
+		this->statCurrentFrameLineCount -= delta;
+		commandList->lineCount = delta;
+		this->setModelviewMatrix(this->recordingModelviewMatrix);
+		return commandList;
+	}
+
+	void RenderSystem::executeCommandList(CommandList* commandList)
+	{
+		if (commandList == NULL)
+		{
+			throw Exception("Cannot call executeCommandList(), command list is NULL!");
+		}
+		if (commandList == this->recordingCommandList)
+		{
+			hlog::error(logTag, "Cannot execute a command list while it is being recorded!");
+			return;
+		}
+		RenderHelper* renderHelper = this->_getRenderHelper();
+		if (renderHelper != NULL)
+		{
+			renderHelper->flush();
+		}
+		if (currentRenderContext != NULL)
+		{
+			currentRenderContext->renderCalls += commandList->renderCalls;
+			currentRenderContext->vertexCount += commandList->vertexCount;
+			currentRenderContext->triangleCount += commandList->triangleCount;
+			currentRenderContext->lineCount += commandList->lineCount;
+		}
+		else
+		{
+			this->statCurrentFrameRenderCalls += commandList->renderCalls;
+			this->statCurrentFrameVertexCount += commandList->vertexCount;
+			this->statCurrentFrameTriangleCount += commandList->triangleCount;
+			this->statCurrentFrameLineCount += commandList->lineCount;
+		}
+		this->_addAsyncCommand(new CommandListRenderCommand(*this->_getState(), commandList));
+	}
+
+	void RenderSystem::destroyCommandList(CommandList* commandList)
+	{
+		if (commandList == NULL)
+		{
+			throw Exception("Cannot call destroyCommandList(), command list is NULL!");
+		}
+		if (commandList == this->recordingCommandList)
+		{
+			this->endCommandList();
+		}
+		this->_addUnloadTextureCommand(new DestroyCommandListCommand(commandList));
+	}
+
+	RenderContext* RenderSystem::createRenderContext(int order)
+	{
+		RenderContext* context = new RenderContext(*this->state, order);
+		context->state->viewportChanged = true;
+		context->state->modelviewMatrixChanged = true;
+		context->state->projectionMatrixChanged = true;
+		hmutex::ScopeLock lock(&this->renderContextsMutex);
+		this->renderContexts += context;
+		return context;
+	}
+
+	void RenderSystem::destroyRenderContext(RenderContext* context)
+	{
+		if (context == NULL)
+		{
+			throw Exception("Cannot call destroyRenderContext(), context is NULL!");
+		}
+		if (context->isActive())
+		{
+			throw Exception("Cannot call destroyRenderContext(), a thread is still recording into the context!");
+		}
+		hmutex::ScopeLock lock(&this->renderContextsMutex);
+		this->renderContexts -= context;
+		lock.release();
+		delete context;
+	}
+
+	bool RenderSystem::beginRenderContext(RenderContext* context)
+	{
+		if (context == NULL)
+		{
+			throw Exception("Cannot call beginRenderContext(), context is NULL!");
+		}
+		if (currentRenderContext != NULL)
+		{
+			hlog::error(logTag, "Cannot begin render context, the current thread is already recording into a render context!");
+			return false;
+		}
+		if (!context->_trySetActive(true))
+		{
+			hlog::error(logTag, "Cannot begin render context, another thread is already recording into it!");
+			return false;
+		}
+		// the recording thread must not read the flags of the RenderSystem later while they could be changed
+		context->viewportCulling = this->viewportCulling;
+		currentRenderContext = context;
+		return true;
+	}
+
+	bool RenderSystem::endRenderContext()
+	{
+		if (currentRenderContext == NULL)
+		{
+			hlog::error(logTag, "Cannot end render context, the current thread is not recording into a render context!");
+			return false;
+		}
+		currentRenderContext->_trySetActive(false);
+		currentRenderContext = NULL;
+		return true;
+	}
+
+	void RenderSystem::submitRenderContexts(const harray<RenderContext*>& contexts)
+	{
+		if (currentRenderContext != NULL)
+		{
+			hlog::error(logTag, "Cannot submit render contexts while the current thread is recording into a render context!");
+			return;
+		}
+		harray<RenderContext*> orderedContexts;
+		foreach (RenderContext*, it, contexts)
+		{
+			if ((*it)->isActive())
+			{
+				hlog::error(logTag, "Cannot submit render context, a thread is still recording into it!");
+			}
+			else if ((*it)->commands.size() > 0)
+			{
+				orderedContexts += (*it);
+			}
+		}
+		if (orderedContexts.size() == 0)
+		{
+			return;
+		}
+		RenderContext** data = (RenderContext**)orderedContexts;
+		std::stable_sort(data, data + orderedContexts.size(), &_compareRenderContexts);
+		// render helpers batch vertices, so everything they have queued has to be rendered first
+		if (this->renderHelper != NULL)
+		{
+			this->renderHelper->flush();
+		}
+		harray<AsyncCommand*> commands;
+		foreach (RenderContext*, it, orderedContexts)
+		{
+			commands += (*it)->commands;
+			(*it)->commands.clear();
+			this->statCurrentFrameRenderCalls += (*it)->renderCalls;
+			this->statCurrentFrameVertexCount += (*it)->vertexCount;
+			this->statCurrentFrameTriangleCount += (*it)->triangleCount;
+			this->statCurrentFrameLineCount += (*it)->lineCount;
+			this->statCurrentFrameCulledRenderCalls += (*it)->culledRenderCalls;
+			this->statCurrentFrameCulledVertexCount += (*it)->culledVertexCount;
+			(*it)->_resetStats();
+			// the device state doesn't match the context's RenderState anymore when it records the next time
+			(*it)->state->viewportChanged = true;
+			(*it)->state->modelviewMatrixChanged = true;
+			(*it)->state->projectionMatrixChanged = true;
+		}
+		hmutex::ScopeLock lock(&this->asyncMutex);
+		if (this->asyncCommandQueues.size() == 0)
+		{
+			this->asyncCommandQueues += new AsyncCommandQueue();
+		}
+		this->asyncCommandQueues.last()->commands += commands;
+		lock.release();
+		// the device state doesn't match the global RenderState anymore after the contexts were rendered
+		this->state->viewportChanged = true;
+		this->state->modelviewMatrixChanged = true;
+		this->state->projectionMatrixChanged = true;
+	}
+
+	void RenderSystem::_removeTextureFromRenderContexts(Texture* texture)
+	{
+		hmutex::ScopeLock lock(&this->renderContextsMutex);
+		RenderCommand* renderCommand = NULL;
+		RenderState* commandState = NULL;
+		bool viewportChanged = false;
+		bool modelviewMatrixChanged = false;
+		bool projectionMatrixChanged = false;
+		int discarded = 0;
+		foreach (RenderContext*, it, this->renderContexts)
+		{
+			// contexts that another thread records into can't be modified safely, this case is a usage error
+			if ((*it) != currentRenderContext && (*it)->isActive())
+			{
+				continue;
+			}
+			if ((*it)->state->texture == texture)
+			{
+				(*it)->state->texture = NULL;
+			}
+			// the changed flags of discarded commands are passed on to the next command that uses the state
+			viewportChanged = false;
+			modelviewMatrixChanged = false;
+			projectionMatrixChanged = false;
+			int i = 0;
+			while (i < (*it)->commands.size())
+			{
+				renderCommand = dynamic_cast<RenderCommand*>((*it)->commands[i]);
+				if (renderCommand == NULL)
+				{
+					++i;
+					continue;
+				}
+				commandState = renderCommand->getState();
+				if (commandState->texture == texture)
+				{
+					viewportChanged |= commandState->viewportChanged;
+					modelviewMatrixChanged |= commandState->modelviewMatrixChanged;
+					projectionMatrixChanged |= commandState->projectionMatrixChanged;
+					delete renderCommand;
+					(*it)->commands.removeAt(i);
+					++discarded;
+					continue;
+				}
+				commandState->viewportChanged |= viewportChanged;
+				commandState->modelviewMatrixChanged |= modelviewMatrixChanged;
+				commandState->projectionMatrixChanged |= projectionMatrixChanged;
+				viewportChanged = false;
+				modelviewMatrixChanged = false;
+				projectionMatrixChanged = false;
+				++i;
+			}
+			// nothing recorded after the discarded commands, so the next recorded command has to apply the changes
+			(*it)->state->viewportChanged |= viewportChanged;
+			(*it)->state->modelviewMatrixChanged |= modelviewMatrixChanged;
+			(*it)->state->projectionMatrixChanged |= projectionMatrixChanged;
+		}
+		if (discarded > 0)
+		{
+			hlog::warnf(logTag, "Texture '%s' was destroyed before %d render commands using it were submitted, the commands were discarded.", texture->getFilename().cStr(), discarded);
+		}
+	}
+
 	void RenderSystem::executeCustomCommand(void (*function)(const harray<void*>& args), const harray<void*>& args)
 	{
 		this->_addAsyncCommand(new CustomCommand(function, args));
@@ -1537,6 +2466,17 @@ namespace april
 		}
 	}
 
+	void RenderSystem::_deviceUnloadVertexBuffers()
+	{
+		hmutex::ScopeLock lock(&this->vertexBuffersMutex);
+		harray<VertexBuffer*> vertexBuffers = this->vertexBuffers;
+		lock.release();
+		foreach (VertexBuffer*, it, vertexBuffers)
+		{
+			(*it)->_deviceUnloadBuffer();
+		}
+	}
+
 	void RenderSystem::waitForAsyncTextures(float timeout) const
 	{
 		float time = timeout;
@@ -1559,27 +2499,72 @@ namespace april
 			this->statCurrentFrameRenderCalls = 0;
 			this->statLastFrameTextureSwitches = this->statCurrentFrameTextureSwitches;
 			this->statCurrentFrameTextureSwitches = 0;
+			this->statLastFrameSavedTextureSwitches = this->statCurrentFrameSavedTextureSwitches;
+			this->statCurrentFrameSavedTextureSwitches = 0;
 			this->statLastFrameVertexCount = this->statCurrentFrameVertexCount;
 			this->statCurrentFrameVertexCount = 0;
 			this->statLastFrameTriangleCount = this->statCurrentFrameTriangleCount;
 			this->statCurrentFrameTriangleCount = 0;
 			this->statLastFrameLineCount = this->statCurrentFrameLineCount;
 			this->statCurrentFrameLineCount = 0;
+			this->statLastFrameCulledRenderCalls = this->statCurrentFrameCulledRenderCalls;
+			this->statCurrentFrameCulledRenderCalls = 0;
+			this->statLastFrameCulledVertexCount = this->statCurrentFrameCulledVertexCount;
+			this->statCurrentFrameCulledVertexCount = 0;
 		}
 	}
 
 	void RenderSystem::takeScreenshot(Image::Format format, bool backBufferOnly)
 	{
-		this->_addAsyncCommand(new TakeScreenshotCommand(*this->state, format, backBufferOnly));
+		this->_addAsyncCommand(new TakeScreenshotCommand(*this->_getState(), format, backBufferOnly));
 	}
 
 	void RenderSystem::presentFrame()
 	{
-		this->_addAsyncCommand(new PresentFrameCommand(*this->state, april::window->isPresentFrameEnabled()));
+		this->_addAsyncCommand(new PresentFrameCommand(*this->state, april::window->isPresentFrameEnabled(), april::window->_takeProcessedInputTime()));
+	}
+
+	void RenderSystem::_deviceRender(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count)
+	{
+		hmutex::ScopeLock lock(&vertexBuffer->dataMutex);
+		unsigned char* vertices = &vertexBuffer->data[first * vertexBuffer->vertexSize];
+		if (vertexBuffer->vertexType == VertexBuffer::VertexType::Plain)
+		{
+			this->_deviceRender(renderOperation, (PlainVertex*)vertices, count);
+		}
+		else if (vertexBuffer->vertexType == VertexBuffer::VertexType::Colored)
+		{
+			this->_deviceRender(renderOperation, (ColoredVertex*)vertices, count);
+		}
+		else if (vertexBuffer->vertexType == VertexBuffer::VertexType::Textured)
+		{
+			this->_deviceRender(renderOperation, (TexturedVertex*)vertices, count);
+		}
+		else if (vertexBuffer->vertexType == VertexBuffer::VertexType::ColoredTextured)
+		{
+			this->_deviceRender(renderOperation, (ColoredTexturedVertex*)vertices, count);
+		}
+	}
+
+	void RenderSystem::_deviceRenderInstanced(cgrectf rect, const QuadInstance* instances, int count)
+	{
+		int size = 0;
+		for_iter_step (i, 0, count, APRIL_QUAD_INSTANCES_BATCH_SIZE)
+		{
+			size = hmin(count - i, APRIL_QUAD_INSTANCES_BATCH_SIZE);
+			expandQuadInstances(rect, 0.0f, &instances[i], size, this->_quadInstanceVertices);
+			this->_deviceRender(RenderOperation::TriangleList, this->_quadInstanceVertices, size * APRIL_QUAD_INSTANCE_VERTICES_COUNT);
+		}
 	}
 
 	void RenderSystem::_devicePresentFrame(bool systemEnabled)
 	{
+		// checked without locking first since this is called every frame, the frame counter only matters while recording
+		if (this->textureProfileRecording)
+		{
+			hmutex::ScopeLock lock(&this->textureProfileMutex);
+			++this->textureProfileFrame;
+		}
 		// TODO - remove this entirely with Layered2D
 		//this->flushFrame(true);
 		april::window->_presentFrame(systemEnabled);
@@ -1616,6 +2601,7 @@ namespace april
 			int height = april::window->getHeight();
 			if (width > 0 && height > 0)
 			{
+				gvec2i size = this->_getIntermediateRenderTextureSize(width, height);
 				// creating the texture the first time
 				if (this->_currentIntermediateRenderTexture == NULL)
 				{
@@ -1629,7 +2615,7 @@ namespace april
 					// updating the texture size when necessary
 					int oldWidth = this->_currentIntermediateRenderTexture->getWidth();
 					int oldHeight = this->_currentIntermediateRenderTexture->getHeight();
-					if (width != oldWidth || height != oldHeight)
+					if (size.x != oldWidth || size.y != oldHeight)
 					{
 						harray<Texture*> oldTextures = this->_intermediateRenderTextures;
 						this->_intermediateRenderTextures.clear();
@@ -1652,6 +2638,8 @@ namespace april
 								(*it)->_deviceUnloadTexture();
 								delete (*it);
 							}
+							// copying the data above already applied the viewport of a different state
+							this->_intermediateViewportChanged = true;
 						}
 						else
 						{
@@ -1677,12 +2665,20 @@ namespace april
 		bool result = false;
 		hmutex::ScopeLock lock;
 		Texture* texture = NULL;
+		gvec2i size = this->_getIntermediateRenderTextureSize(width, height);
 		for_iter (i, 0, this->_intermediateRenderTextureCount)
 		{
 			texture = this->_deviceCreateTexture(false);
-			texture->setFilter(Texture::Filter::Nearest); // optimization since they are rendered pixel perfect anyway
+			if (size.x == width && size.y == height)
+			{
+				texture->setFilter(Texture::Filter::Nearest); // optimization since they are rendered pixel perfect anyway
+			}
+			else
+			{
+				texture->setFilter(Texture::Filter::Linear); // scaled textures have to be filtered when upscaling
+			}
 			this->_intermediateRenderTextures += texture;
-			result = texture->_createRenderTarget(width, height);
+			result = texture->_createRenderTarget(size.x, size.y);
 			if (result)
 			{
 				texture->_loadAsync();
@@ -1697,6 +2693,7 @@ namespace april
 		{
 			this->_currentIntermediateRenderTexture = this->_intermediateRenderTextures.first();
 			this->_lastIntermediateRenderTexture = this->_intermediateRenderTextures.last();
+			this->_intermediateViewportChanged = true;
 		}
 		else
 		{
@@ -1741,24 +2738,113 @@ namespace april
 			{
 				this->_lastIntermediateRenderTexture = this->_currentIntermediateRenderTexture;
 			}
-			int width = this->_currentIntermediateRenderTexture->getWidth();
-			//this->_currentIntermediateRenderTexture = NULL;
-			int height = this->_currentIntermediateRenderTexture->getHeight();
+			// the texture is stretched over the whole backbuffer in case it was scaled
+			int width = april::window->getWidth();
+			int height = april::window->getHeight();
 			this->_intermediateState->viewport.setSize(width, height);
 			this->_intermediateState->projectionMatrix.setOrthoProjection(grectf(1.0f - 2.0f * this->pixelOffset / width, 1.0f - 2.0f * this->pixelOffset / height, 2.0f, 2.0f));
 			this->_intermediateState->texture = this->_lastIntermediateRenderTexture;
+			this->_presentingIntermediateRenderTexture = true;
 			this->_updateDeviceState(this->_intermediateState, true, true);
 			this->_deviceClear(false);
 			this->_deviceRender(RenderOperation::TriangleList, this->_intermediateRenderVertices, APRIL_INTERMEDIATE_TEXTURE_VERTICES_COUNT);
+			this->_presentingIntermediateRenderTexture = false;
 			if (this->_updateLastIntermediateRenderTexture)
 			{
 				this->_intermediateRenderTextureIndex = (this->_intermediateRenderTextureIndex + 1) % this->_intermediateRenderTextures.size();
 				this->_currentIntermediateRenderTexture = this->_intermediateRenderTextures[this->_intermediateRenderTextureIndex];
+				this->_updateDynamicResolution();
 			}
 			// don't restore state with _updateDeviceState() here, calling functions must handle that
 		}
 	}
 
+	gvec2i RenderSystem::_getIntermediateRenderTextureSize(int width, int height) const
+	{
+		if (this->intermediateRenderTextureScale == 1.0f)
+		{
+			return gvec2i(width, height);
+		}
+		return gvec2i(hmax(hround(width * this->intermediateRenderTextureScale), 1), hmax(hround(height * this->intermediateRenderTextureScale), 1));
+	}
+
+	grecti RenderSystem::_getDeviceViewport(RenderState* state) const
+	{
+		if (state == this->_intermediateState || this->_currentIntermediateRenderTexture == NULL || this->deviceState->renderTarget != NULL || april::window == NULL)
+		{
+			return state->viewport;
+		}
+		int width = april::window->getWidth();
+		int height = april::window->getHeight();
+		int textureWidth = this->_currentIntermediateRenderTexture->getWidth();
+		int textureHeight = this->_currentIntermediateRenderTexture->getHeight();
+		if (width <= 0 || height <= 0 || (width == textureWidth && height == textureHeight))
+		{
+			return state->viewport;
+		}
+		// edges are scaled instead of the size so adjacent viewports stay adjacent
+		float scaleX = (float)textureWidth / width;
+		float scaleY = (float)textureHeight / height;
+		int left = hround(state->viewport.x * scaleX);
+		int top = hround(state->viewport.y * scaleY);
+		return grecti(left, top, hround((state->viewport.x + state->viewport.w) * scaleX) - left, hround((state->viewport.y + state->viewport.h) * scaleY) - top);
+	}
+
+	void RenderSystem::_updateDynamicResolution()
+	{
+		double frameTime = this->_dynamicResolutionTimer.diff();
+		float scale = this->intermediateRenderTextureScale;
+		if (!this->dynamicResolution || this->dynamicResolutionTargetFps <= 0)
+		{
+			this->intermediateRenderTextureScale = 1.0f;
+			this->_dynamicResolutionFrameTime = -1.0;
+			this->_dynamicResolutionFrames = 0;
+			return;
+		}
+		double targetFrameTime = 1.0 / this->dynamicResolutionTargetFps;
+		// long stalls such as loading are not caused by the fill-rate and are ignored
+		if (frameTime > targetFrameTime * DYNAMIC_RESOLUTION_STALL_FACTOR)
+		{
+			return;
+		}
+		this->_dynamicResolutionFrameTime = (this->_dynamicResolutionFrameTime >= 0.0 ? this->_dynamicResolutionFrameTime * 0.9 + frameTime * 0.1 : frameTime);
+		// positive values count consecutive frames within the target frame time, negative values count consecutive slow frames
+		if (this->_dynamicResolutionFrameTime > targetFrameTime * DYNAMIC_RESOLUTION_SLOW_FACTOR)
+		{
+			this->_dynamicResolutionFrames = hmin(this->_dynamicResolutionFrames, 0) - 1;
+		}
+		else
+		{
+			this->_dynamicResolutionFrames = hmax(this->_dynamicResolutionFrames, 0) + 1;
+		}
+		scale = hclamp(scale, this->dynamicResolutionMinScale, this->dynamicResolutionMaxScale);
+		if (this->_dynamicResolutionFrames <= -DYNAMIC_RESOLUTION_DOWNSCALE_FRAMES && scale > this->dynamicResolutionMinScale)
+		{
+			scale = hmax(scale - DYNAMIC_RESOLUTION_SCALE_STEP, this->dynamicResolutionMinScale);
+			// going back down right after going up means the higher scale can't be held so it's tried less often
+			if (this->_dynamicResolutionUpscaled)
+			{
+				this->_dynamicResolutionUpscaleFrames = hmin(this->_dynamicResolutionUpscaleFrames * 2, DYNAMIC_RESOLUTION_MAX_UPSCALE_FRAMES);
+			}
+			this->_dynamicResolutionUpscaled = false;
+		}
+		else if (this->_dynamicResolutionFrames >= this->_dynamicResolutionUpscaleFrames && scale < this->dynamicResolutionMaxScale)
+		{
+			scale = hmin(scale + DYNAMIC_RESOLUTION_SCALE_STEP, this->dynamicResolutionMaxScale);
+			this->_dynamicResolutionUpscaled = true;
+			if (scale >= this->dynamicResolutionMaxScale)
+			{
+				this->_dynamicResolutionUpscaleFrames = DYNAMIC_RESOLUTION_UPSCALE_FRAMES;
+			}
+		}
+		if (this->intermediateRenderTextureScale != scale)
+		{
+			this->intermediateRenderTextureScale = scale;
+			this->_dynamicResolutionFrameTime = -1.0;
+			this->_dynamicResolutionFrames = 0;
+		}
+	}
+
 	unsigned int RenderSystem::_numPrimitives(const RenderOperation& renderOperation, int count) const
 	{
 		if (renderOperation == RenderOperation::TriangleList)	return count / 3;
@@ -16,6 +16,7 @@
 #include "april.h"
 #include "Color.h"
 #include "Image.h"
+#include "ImageTask.h"
 #include "RenderSystem.h"
 #include "Texture.h"
 #include "TextureAsync.h"
@@ -35,6 +36,7 @@ namespace april
 	(
 		HL_ENUM_DEFINE(Texture::Filter, Nearest);
 		HL_ENUM_DEFINE(Texture::Filter, Linear);
+		HL_ENUM_DEFINE(Texture::Filter, Trilinear);
 	));
 
 	HL_ENUM_CLASS_DEFINE(Texture::AddressMode,
@@ -111,14 +113,20 @@ namespace april
 		this->compressedSize = 0; // used in compressed textures only
 		this->filter = Filter::Linear;
 		this->addressMode = AddressMode::Clamp;
+		this->mipmapsEnabled = false;
+		this->premultipliedAlpha = false;
+		this->mipmapsUploaded = false;
 		this->locked = false;
 		this->dirty = false;
+		this->dirtyRect.set(0, 0, 0, 0);
 		this->data = NULL;
 		this->dataAsync = NULL;
+		this->mipmapDataAsync = NULL;
 		this->asyncLoadQueued = false;
 		this->asyncLoadDiscarded = false;
 		this->fromResource = fromResource;
 		this->firstUpload = true;
+		this->asyncUploadedRows = -1;
 	}
 
 	bool Texture::_create(chstr filename, Texture::Type type, Texture::LoadMode loadMode)
@@ -214,6 +222,10 @@ namespace april
 		{
 			delete[] this->dataAsync;
 		}
+		if (this->mipmapDataAsync != NULL)
+		{
+			delete[] this->mipmapDataAsync;
+		}
 		hmutex::ScopeLock lockData(&this->asyncDataMutex);
 		if (this->data != NULL)
 		{
@@ -226,6 +238,7 @@ namespace april
 		this->_deviceDestroyTexture();
 		hmutex::ScopeLock lock(&this->asyncLoadMutex);
 		this->uploaded = false;
+		this->mipmapsUploaded = false;
 		if (this->asyncLoadQueued)
 		{
 			this->asyncLoadDiscarded = true;
@@ -235,7 +248,13 @@ namespace april
 			delete[] this->dataAsync;
 			this->dataAsync = NULL;
 		}
+		if (this->mipmapDataAsync != NULL)
+		{
+			delete[] this->mipmapDataAsync;
+			this->mipmapDataAsync = NULL;
+		}
 		this->firstUpload = true;
+		this->asyncUploadedRows = -1;
 	}
 
 	int Texture::getWidth() const
@@ -283,6 +302,39 @@ namespace april
 		return (this->width * this->height * this->format.getBpp());
 	}
 
+	int Texture::_getMipmapsByteSize() const
+	{
+		if (this->compressedSize > 0)
+		{
+			return 0;
+		}
+		return Image::getMipmapsByteSize(this->width, this->height, this->format);
+	}
+
+	bool Texture::_canUseMipmaps() const
+	{
+		if (!this->mipmapsEnabled || this->type == Type::External || this->type == Type::RenderTarget || this->width <= 0 || this->height <= 0)
+		{
+			return false;
+		}
+		if (this->format == Image::Format::Compressed || this->format == Image::Format::Palette || this->format == Image::Format::Invalid)
+		{
+			return false;
+		}
+		RenderSystem::Caps caps = april::rendersys->getCaps();
+		// without full NPOT support, mipmaps are only available for power-of-two sizes
+		return (caps.mipmaps && (caps.npotTextures || (hpotCeil(this->width) == this->width && hpotCeil(this->height) == this->height)));
+	}
+
+	Texture::Filter Texture::getEffectiveFilter() const
+	{
+		if (this->filter == Filter::Trilinear && !this->mipmapsUploaded)
+		{
+			return Filter::Linear;
+		}
+		return this->filter;
+	}
+
 	int Texture::getCurrentAllRamSize()
 	{
 		int byteSize = this->_getByteSize();
@@ -292,13 +344,22 @@ namespace april
 		if (this->width > 0 && this->height > 0 && this->format != Image::Format::Invalid && this->uploaded)
 		{
 			result += byteSize;
+			if (this->mipmapsUploaded)
+			{
+				result += this->_getMipmapsByteSize();
+			}
 		}
 		// async RAM
 		bool asyncRamUsed = (!this->asyncLoadQueued && this->dataAsync != NULL && !this->uploaded);
+		bool asyncMipmapsRamUsed = (asyncRamUsed && this->mipmapDataAsync != NULL);
 		lock.release();
 		if (asyncRamUsed && this->width > 0 && this->height > 0 && this->format != Image::Format::Invalid)
 		{
 			result += byteSize;
+			if (asyncMipmapsRamUsed)
+			{
+				result += this->_getMipmapsByteSize();
+			}
 		}
 		// RAM
 		if (this->type != Type::Immutable && this->type != Type::RenderTarget)
@@ -320,7 +381,12 @@ namespace april
 		{
 			return this->compressedSize;
 		}
-		return (this->width * this->height * this->format.getBpp());
+		int result = this->width * this->height * this->format.getBpp();
+		if (this->mipmapsUploaded)
+		{
+			result += this->_getMipmapsByteSize();
+		}
+		return result;
 	}
 
 	int Texture::getCurrentRamSize()
@@ -343,6 +409,7 @@ namespace april
 		{
 			return 0;
 		}
+		bool mipmapsUsed = (this->mipmapDataAsync != NULL);
 		lock.release();
 		if (this->width == 0 || this->height == 0 || this->format == Image::Format::Invalid)
 		{
@@ -352,7 +419,12 @@ namespace april
 		{
 			return this->compressedSize;
 		}
-		return (this->width * this->height * this->format.getBpp());
+		int result = this->width * this->height * this->format.getBpp();
+		if (mipmapsUsed)
+		{
+			result += this->_getMipmapsByteSize();
+		}
+		return result;
 	}
 
 	bool Texture::isUploaded()
@@ -506,6 +578,12 @@ namespace april
 	}
 
 	bool Texture::_tryAsyncFinalUpload()
+	{
+		int remainingBytes = 0;
+		return this->_tryAsyncFinalUpload(0, remainingBytes);
+	}
+
+	bool Texture::_tryAsyncFinalUpload(int maxBytes, int& remainingBytes)
 	{
 		if (!april::rendersys->canUseLowLevelCalls())
 		{
@@ -516,19 +594,119 @@ namespace april
 		{
 			return false;
 		}
+		if (maxBytes > 0)
+		{
+			int size = this->_getByteSize();
+			if (this->asyncUploadedRows >= 0 || (size > maxBytes && this->_canUploadIncrementally()))
+			{
+				return this->_uploadAsyncStrip(lock, remainingBytes);
+			}
+			if (size > remainingBytes && remainingBytes < maxBytes)
+			{
+				return false; // doesn't fit into this frame anymore
+			}
+			remainingBytes -= size;
+		}
 		this->_upload(lock);
 		return true;
 	}
 
+	bool Texture::_canUploadIncrementally() const
+	{
+		if (this->data != NULL || this->dataAsync == NULL || this->type == Type::RenderTarget || this->type == Type::External ||
+			this->format == Image::Format::Compressed || this->format == Image::Format::Palette || this->width <= 0 || this->height <= 1)
+		{
+			return false;
+		}
+		return !Image::needsConversion(this->format, april::rendersys->getNativeTextureFormat(this->format));
+	}
+
+	bool Texture::_uploadAsyncStrip(hmutex::ScopeLock& lock, int& remainingBytes)
+	{
+		if (this->asyncUploadedRows < 0)
+		{
+			hlog::write(logTag, "Uploading async texture incrementally: " + this->_getInternalName());
+			this->asyncLoadDiscarded = false; // a possible previous unload call must be canceled
+			this->_assignFormat();
+			// only the storage is created in the first frame
+			if (!this->_deviceCreateTexture(NULL, 0) || !this->_deviceAllocateTexture())
+			{
+				this->_deviceDestroyTexture();
+				return this->_upload(lock);
+			}
+			this->asyncUploadedRows = 0;
+			return true;
+		}
+		unsigned char* currentData = this->dataAsync;
+		int row = this->asyncUploadedRows;
+		int rowSize = this->width * this->format.getBpp();
+		int rows = hclamp(remainingBytes / rowSize, 1, this->height - row);
+		lock.release();
+		bool result = this->_uploadToGpu(0, row, this->width, rows, 0, row, currentData, this->width, this->height, this->format);
+		lock.acquire(&this->asyncLoadMutex);
+		if (!result)
+		{
+			// the remaining data is uploaded at once instead
+			this->_deviceDestroyTexture();
+			this->asyncUploadedRows = -1;
+			return this->_upload(lock);
+		}
+		remainingBytes -= rows * rowSize;
+		this->asyncUploadedRows += rows;
+		if (this->asyncUploadedRows < this->height)
+		{
+			return true;
+		}
+		this->asyncUploadedRows = -1;
+		unsigned char* currentMipmapData = this->mipmapDataAsync;
+		this->mipmapDataAsync = NULL;
+		lock.release();
+		this->_uploadMipmaps(currentData, currentMipmapData);
+		if (currentMipmapData != NULL)
+		{
+			delete[] currentMipmapData;
+		}
+		lock.acquire(&this->asyncDataMutex);
+		this->dirty = false;
+		this->dirtyRect.set(0, 0, 0, 0);
+		if (this->type != Type::Immutable)
+		{
+			if (this->data != NULL)
+			{
+				delete[] this->data;
+			}
+			this->data = currentData;
+			lock.release();
+		}
+		else
+		{
+			lock.release();
+			delete[] currentData;
+			// the used format will be the native format, because there is no intermediate data
+			this->format = april::rendersys->getNativeTextureFormat(this->format);
+		}
+		this->_tryUploadDataToGpu(); // upload any additional changes
+		lock.acquire(&this->asyncLoadMutex);
+		this->dataAsync = NULL; // not needed anymore and makes isReadyForUpload() return false now
+		this->uploaded = true;
+		return true;
+	}
+
 	bool Texture::_upload(hmutex::ScopeLock& lock)
 	{
 		if (!april::rendersys->canUseLowLevelCalls())
 		{
 			return false;
 		}
+		if (this->asyncUploadedRows >= 0) // an incremental upload is in progress and has to be finished now
+		{
+			int remainingBytes = this->_getByteSize();
+			return this->_uploadAsyncStrip(lock, remainingBytes);
+		}
 		this->asyncLoadDiscarded = false; // a possible previous unload call must be canceled
 		int size = 0;
 		unsigned char* currentData = NULL;
+		unsigned char* currentMipmapData = NULL;
 		// no lock required since it only checks for existence, not for manipulation of data
 		if (this->data != NULL) // reload from memory
 		{
@@ -541,6 +719,8 @@ namespace april
 			hlog::write(logTag, "Uploading async texture: " + this->_getInternalName());
 			currentData = this->dataAsync;
 			size = this->getByteSize();
+			currentMipmapData = this->mipmapDataAsync;
+			this->mipmapDataAsync = NULL;
 		}
 		else
 		{
@@ -576,6 +756,10 @@ namespace april
 				hlog::error(logTag, "Failed to load texture: " + this->_getInternalName());
 				return false;
 			}
+			if (this->premultipliedAlpha && !image->premultiplyAlpha(0, 0, image->w, image->h))
+			{
+				hlog::warnf(logTag, "Cannot premultiply alpha of texture '%s' with format '%s', the data is used as it is!", this->_getInternalName().cStr(), image->format.getName().cStr());
+			}
 			this->width = image->w;
 			this->height = image->h;
 			this->format = image->format;
@@ -598,6 +782,10 @@ namespace april
 		bool result = this->_deviceCreateTexture(currentData, size);
 		if (!result)
 		{
+			if (currentMipmapData != NULL)
+			{
+				delete[] currentMipmapData;
+			}
 			lock.acquire(&this->asyncDataMutex);
 			if (currentData != NULL && this->data != currentData)
 			{
@@ -613,6 +801,7 @@ namespace april
 		{
 			lock.acquire(&this->asyncDataMutex);
 			this->dirty = false;
+			this->dirtyRect.set(0, 0, 0, 0);
 			if (this->firstUpload)
 			{
 				if (Image::needsConversion(this->format, april::rendersys->getNativeTextureFormat(this->format)) ||
@@ -625,6 +814,11 @@ namespace april
 						this->_unlockSystem(lock, true);
 					}
 				}
+				this->_uploadMipmaps(currentData, currentMipmapData);
+			}
+			if (currentMipmapData != NULL)
+			{
+				delete[] currentMipmapData;
 			}
 			if (this->type != Type::Immutable || this->filename == "")
 			{
@@ -783,6 +977,11 @@ namespace april
 			this->asyncLoadDiscarded = false;
 			return;
 		}
+		// done here so it doesn't have to be done on the render thread during upload
+		if (this->premultipliedAlpha && !image->premultiplyAlpha(0, 0, image->w, image->h))
+		{
+			hlog::warnf(logTag, "Cannot premultiply alpha of async texture '%s' with format '%s', the data is used as it is!", this->_getInternalName().cStr(), image->format.getName().cStr());
+		}
 		this->width = image->w;
 		this->height = image->h;
 		this->format = image->format;
@@ -796,12 +995,23 @@ namespace april
 		{
 			hlog::warnf(logTag, "Texture size for '%s' is %d,%d while the reported system max texture size is %d!", this->_getInternalName().cStr(), this->width, this->height, maxTextureSize);
 		}
+		// creating the mipmap chain here so it doesn't have to be done on the render thread during upload
+		unsigned char* mipmapData = NULL;
+		if (this->_canUseMipmaps() && !april::rendersys->getCaps().mipmapGeneration)
+		{
+			Image::createMipmaps(image->w, image->h, image->data, image->format, &mipmapData);
+		}
 		lock.acquire(&this->asyncLoadMutex);
 		if (this->asyncLoadQueued && !this->asyncLoadDiscarded)
 		{
 			this->_assignFormat();
 			this->dataAsync = image->data;
 			image->data = NULL;
+			this->mipmapDataAsync = mipmapData;
+		}
+		else if (mipmapData != NULL)
+		{
+			delete[] mipmapData;
 		}
 		this->asyncLoadQueued = false;
 		this->asyncLoadDiscarded = false;
@@ -860,7 +1070,7 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		memset(this->data, 0, this->getByteSize());
-		this->dirty = true;
+		this->_markDirty(0, 0, this->width, this->height);
 		return true;
 	}
 
@@ -896,7 +1106,10 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::setPixel(x, y, color, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(x, y, 1, 1);
+		}
 		return result;
 	}
 
@@ -936,7 +1149,10 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::fillRect(x, y, w, h, color, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(x, y, w, h);
+		}
 		return result;
 	}
 
@@ -955,7 +1171,10 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::blitRect(x, y, w, h, color, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(x, y, w, h);
+		}
 		return result;
 	}
 
@@ -1005,7 +1224,10 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::write(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(dx, dy, sw, sh);
+		}
 		return result;
 	}
 
@@ -1046,7 +1268,10 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::writeStretch(sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(dx, dy, dw, dh);
+		}
 		return result;
 	}
 
@@ -1079,15 +1304,26 @@ namespace april
 			hlog::warn(logTag, "Cannot alter texture: " + this->_getInternalName());
 			return false;
 		}
-		return this->_rawBlit(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat);
+		return this->_rawBlit(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, alpha);
 	}
 
 	bool Texture::_rawBlit(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
 	{
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
-		bool result = Image::blit(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		bool result = false;
+		if (this->premultipliedAlpha)
+		{
+			result = Image::blitPremultiplied(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format, alpha);
+		}
+		else
+		{
+			result = Image::blit(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format, alpha);
+		}
+		if (result)
+		{
+			this->_markDirty(dx, dy, sw, sh);
+		}
 		return result;
 	}
 
@@ -1110,7 +1346,7 @@ namespace april
 		}
 		texture->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&texture->asyncDataMutex);
-		return this->blit(sx, sy, sw, sh, dx, dy, texture->data, texture->width, texture->height, texture->format);
+		return this->blit(sx, sy, sw, sh, dx, dy, texture->data, texture->width, texture->height, texture->format, alpha);
 	}
 
 	bool Texture::blitStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
@@ -1120,15 +1356,26 @@ namespace april
 			hlog::warn(logTag, "Cannot alter texture: " + this->_getInternalName());
 			return false;
 		}
-		return this->_rawBlitStretch(sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat);
+		return this->_rawBlitStretch(sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat, alpha);
 	}
 
 	bool Texture::_rawBlitStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
 	{
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
-		bool result = Image::blitStretch(sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		bool result = false;
+		if (this->premultipliedAlpha)
+		{
+			result = Image::blitStretchPremultiplied(sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format, alpha);
+		}
+		else
+		{
+			result = Image::blitStretch(sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat, this->data, this->width, this->height, this->format, alpha);
+		}
+		if (result)
+		{
+			this->_markDirty(dx, dy, dw, dh);
+		}
 		return result;
 	}
 
@@ -1151,7 +1398,104 @@ namespace april
 		}
 		texture->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&texture->asyncDataMutex);
-		return this->blitStretch(sx, sy, sw, sh, dx, dy, dw, dh, texture->data, texture->width, texture->height, texture->format);
+		return this->blitStretch(sx, sy, sw, sh, dx, dy, dw, dh, texture->data, texture->width, texture->height, texture->format, alpha);
+	}
+
+	class TextureWriteTask : public ImageTask
+	{
+	public:
+		TextureWriteTask(Texture* texture, int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight,
+			Image::Format srcFormat, bool blit, unsigned char alpha);
+		~TextureWriteTask();
+
+	protected:
+		Texture* texture;
+		int sx;
+		int sy;
+		int sw;
+		int sh;
+		int dx;
+		int dy;
+		int dw;
+		int dh;
+		unsigned char* srcData;
+		int srcWidth;
+		int srcHeight;
+		Image::Format srcFormat;
+		bool blit;
+		unsigned char alpha;
+
+		bool _execute();
+
+	};
+
+	TextureWriteTask::TextureWriteTask(Texture* texture, int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight,
+		Image::Format srcFormat, bool blit, unsigned char alpha) :
+		ImageTask(),
+		texture(texture),
+		sx(sx),
+		sy(sy),
+		sw(sw),
+		sh(sh),
+		dx(dx),
+		dy(dy),
+		dw(dw),
+		dh(dh),
+		srcData(srcData),
+		srcWidth(srcWidth),
+		srcHeight(srcHeight),
+		srcFormat(srcFormat),
+		blit(blit),
+		alpha(alpha)
+	{
+		this->_start();
+	}
+
+	TextureWriteTask::~TextureWriteTask()
+	{
+		this->wait();
+	}
+
+	bool TextureWriteTask::_execute()
+	{
+		// the public methods are used since they already lock the data and mark the dirty area for the upload
+		if (this->blit)
+		{
+			return this->texture->blitStretch(this->sx, this->sy, this->sw, this->sh, this->dx, this->dy, this->dw, this->dh,
+				this->srcData, this->srcWidth, this->srcHeight, this->srcFormat, this->alpha);
+		}
+		return this->texture->writeStretch(this->sx, this->sy, this->sw, this->sh, this->dx, this->dy, this->dw, this->dh,
+			this->srcData, this->srcWidth, this->srcHeight, this->srcFormat);
+	}
+
+	ImageTask* Texture::writeAsync(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		return this->writeStretchAsync(sx, sy, sw, sh, dx, dy, sw, sh, srcData, srcWidth, srcHeight, srcFormat);
+	}
+
+	ImageTask* Texture::writeStretchAsync(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		if (!this->_isWritable())
+		{
+			hlog::warn(logTag, "Cannot write texture: " + this->_getInternalName());
+			return NULL;
+		}
+		return new TextureWriteTask(this, sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat, false, 255);
+	}
+
+	ImageTask* Texture::blitAsync(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
+	{
+		return this->blitStretchAsync(sx, sy, sw, sh, dx, dy, sw, sh, srcData, srcWidth, srcHeight, srcFormat, alpha);
+	}
+
+	ImageTask* Texture::blitStretchAsync(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
+	{
+		if (!this->_isAlterable())
+		{
+			hlog::warn(logTag, "Cannot alter texture: " + this->_getInternalName());
+			return NULL;
+		}
+		return new TextureWriteTask(this, sx, sy, sw, sh, dx, dy, dw, dh, srcData, srcWidth, srcHeight, srcFormat, true, alpha);
 	}
 
 	bool Texture::rotateHue(int x, int y, int w, int h, float degrees)
@@ -1169,7 +1513,10 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::rotateHue(x, y, w, h, degrees, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(x, y, w, h);
+		}
 		return result;
 	}
 
@@ -1188,7 +1535,32 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::saturate(x, y, w, h, factor, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(x, y, w, h);
+		}
+		return result;
+	}
+
+	bool Texture::adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor)
+	{
+		if (!this->_isAlterable())
+		{
+			hlog::warn(logTag, "Cannot alter texture: " + this->_getInternalName());
+			return false;
+		}
+		return this->_rawAdjustHueSaturation(x, y, w, h, degrees, factor);
+	}
+
+	bool Texture::_rawAdjustHueSaturation(int x, int y, int w, int h, float degrees, float factor)
+	{
+		this->waitForAsyncLoad();
+		hmutex::ScopeLock lock(&this->asyncDataMutex);
+		bool result = Image::adjustHueSaturation(x, y, w, h, degrees, factor, this->data, this->width, this->height, this->format);
+		if (result)
+		{
+			this->_markDirty(x, y, w, h);
+		}
 		return result;
 	}
 
@@ -1207,7 +1579,32 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::invert(x, y, w, h, this->data, this->width, this->height, this->format);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(x, y, w, h);
+		}
+		return result;
+	}
+
+	bool Texture::applyColorMatrix(int x, int y, int w, int h, const Image::ColorMatrix& matrix)
+	{
+		if (!this->_isAlterable())
+		{
+			hlog::warn(logTag, "Cannot alter texture: " + this->_getInternalName());
+			return false;
+		}
+		return this->_rawApplyColorMatrix(x, y, w, h, matrix);
+	}
+
+	bool Texture::_rawApplyColorMatrix(int x, int y, int w, int h, const Image::ColorMatrix& matrix)
+	{
+		this->waitForAsyncLoad();
+		hmutex::ScopeLock lock(&this->asyncDataMutex);
+		bool result = Image::applyColorMatrix(x, y, w, h, matrix, this->data, this->width, this->height, this->format);
+		if (result)
+		{
+			this->_markDirty(x, y, w, h);
+		}
 		return result;
 	}
 
@@ -1226,7 +1623,10 @@ namespace april
 		this->waitForAsyncLoad();
 		hmutex::ScopeLock lock(&this->asyncDataMutex);
 		bool result = Image::insertAlphaMap(this->width, this->height, srcData, srcFormat, this->data, this->format, median, ambiguity);
-		this->dirty |= result;
+		if (result)
+		{
+			this->_markDirty(0, 0, this->width, this->height);
+		}
 		return result;
 	}
 
@@ -1385,11 +1785,21 @@ namespace april
 		return this->saturate(rect.x, rect.y, rect.w, rect.h, factor);
 	}
 
+	bool Texture::adjustHueSaturation(cgrecti rect, float degrees, float factor)
+	{
+		return this->adjustHueSaturation(rect.x, rect.y, rect.w, rect.h, degrees, factor);
+	}
+
 	bool Texture::invert(cgrecti rect)
 	{
 		return this->invert(rect.x, rect.y, rect.w, rect.h);
 	}
 
+	bool Texture::applyColorMatrix(cgrecti rect, const Image::ColorMatrix& matrix)
+	{
+		return this->applyColorMatrix(rect.x, rect.y, rect.w, rect.h, matrix);
+	}
+
 	bool Texture::insertAlphaMap(Image* image, unsigned char median, int ambiguity)
 	{
 		// safety checks are done in the other insertAlphaMap()
@@ -1445,12 +1855,37 @@ namespace april
 		if (this->dirty)
 		{
 			this->dirty = false;
-			this->_uploadDataToGpu(0, 0, this->width, this->height);
+			grecti rect = this->dirtyRect;
+			this->dirtyRect.set(0, 0, 0, 0);
+			// the mipmaps only have to be created again if the base level actually changed
+			if (this->_uploadDataToGpu(rect.x, rect.y, rect.w, rect.h) && this->mipmapsUploaded)
+			{
+				this->_uploadMipmaps(this->data, NULL);
+			}
 			return true;
 		}
 		return false;
 	}
 
+	void Texture::_markDirty(int x, int y, int w, int h)
+	{
+		if (!Image::correctRect(x, y, w, h, this->width, this->height) || w == 0 || h == 0)
+		{
+			return;
+		}
+		if (this->dirty && this->dirtyRect.w > 0 && this->dirtyRect.h > 0)
+		{
+			int right = hmax(x + w, this->dirtyRect.x + this->dirtyRect.w);
+			int bottom = hmax(y + h, this->dirtyRect.y + this->dirtyRect.h);
+			x = hmin(x, this->dirtyRect.x);
+			y = hmin(y, this->dirtyRect.y);
+			w = right - x;
+			h = bottom - y;
+		}
+		this->dirtyRect.set(x, y, w, h);
+		this->dirty = true;
+	}
+
 	bool Texture::_uploadDataToGpu(int x, int y, int w, int h)
 	{
 		if ((!Image::needsConversion(this->format, april::rendersys->getNativeTextureFormat(this->format)) &&
@@ -1468,4 +1903,97 @@ namespace april
 		return result;
 	}
 
+	bool Texture::_deviceAllocateTexture()
+	{
+		return false;
+	}
+
+	bool Texture::_deviceGenerateMipmaps()
+	{
+		return false;
+	}
+
+	bool Texture::_uploadMipmapToGpu(int level, int w, int h, unsigned char* data)
+	{
+		return false;
+	}
+
+	bool Texture::_uploadMipmaps(unsigned char* data, unsigned char* mipmapData)
+	{
+		this->mipmapsUploaded = false;
+		if (!this->_canUseMipmaps())
+		{
+			return false;
+		}
+		if (mipmapData == NULL && this->_deviceGenerateMipmaps())
+		{
+			this->mipmapsUploaded = true;
+			this->_updateDeviceFilter();
+			return true;
+		}
+		bool created = false;
+		if (mipmapData == NULL)
+		{
+			if (data == NULL || !Image::createMipmaps(this->width, this->height, data, this->format, &mipmapData))
+			{
+				hlog::warn(logTag, "Could not create mipmaps: " + this->_getInternalName());
+				return false;
+			}
+			created = true;
+		}
+		Image::Format nativeFormat = april::rendersys->getNativeTextureFormat(this->format);
+		bool convert = Image::needsConversion(this->format, nativeFormat);
+		int bpp = this->format.getBpp();
+		int levelCount = Image::getMipmapLevelCount(this->width, this->height);
+		int w = this->width;
+		int h = this->height;
+		unsigned char* levelData = mipmapData;
+		unsigned char* nativeData = NULL;
+		bool result = true;
+		for_iter (i, 1, levelCount)
+		{
+			w = hmax(w / 2, 1);
+			h = hmax(h / 2, 1);
+			if (convert)
+			{
+				nativeData = NULL;
+				result = Image::convertToFormat(w, h, levelData, this->format, &nativeData, nativeFormat);
+				if (result)
+				{
+					result = this->_uploadMipmapToGpu(i, w, h, nativeData);
+					delete[] nativeData;
+				}
+			}
+			else
+			{
+				result = this->_uploadMipmapToGpu(i, w, h, levelData);
+			}
+			if (!result)
+			{
+				hlog::warn(logTag, "Could not upload mipmaps: " + this->_getInternalName());
+				break;
+			}
+			levelData += w * h * bpp;
+		}
+		if (created)
+		{
+			delete[] mipmapData;
+		}
+		this->mipmapsUploaded = result;
+		if (result)
+		{
+			this->_updateDeviceFilter();
+		}
+		return result;
+	}
+
+	void Texture::_updateDeviceFilter()
+	{
+		// uploads bind the texture with the filter that was usable at that time, the device state would skip applying it again
+		if (april::rendersys->deviceState->texture == this)
+		{
+			april::rendersys->_setDeviceTextureFilter(this->getEffectiveFilter());
+		}
+	}
+
 }
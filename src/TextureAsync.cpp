@@ -17,6 +17,7 @@
 
 #include "april.h"
 #include "Platform.h"
+#include "Profiler.h"
 #include "Texture.h"
 #include "TextureAsync.h"
 
@@ -40,14 +41,21 @@ namespace april
 			return;
 		}
 		TextureAsync::_updateThreads();
+		APRIL_PROFILE_ZONE("TextureAsync upload");
 		// upload all ready textures to the GPU
 		int maxCount = april::getMaxAsyncTextureUploadsPerFrame();
 		int count = 0;
+		int maxBytes = april::getMaxAsyncTextureUploadBytesPerFrame();
+		int remainingBytes = maxBytes;
 		harray<Texture*> textures = april::rendersys->getTextures();
 		foreach (Texture*, it, textures)
 		{
+			if (maxBytes > 0 && remainingBytes <= 0)
+			{
+				break; // only 'maxBytes' bytes per frame!
+			}
 			// only async on-demand textures shouldn't be loaded, this is checked in _isAsyncUploadQueued()
-			if ((*it)->_tryAsyncFinalUpload())
+			if ((*it)->_tryAsyncFinalUpload(maxBytes, remainingBytes))
 			{
 				++count;
 				if (maxCount > 0 && count >= maxCount)
@@ -141,11 +149,13 @@ namespace april
 		bool running = true;
 		hmutex::ScopeLock lock;
 		int maxWaitingCount = 0;
-		SystemInfo info = getSystemInfo();
+		int maxWorkerThreads = 0;
+		APRIL_PROFILE_THREAD("APRIL async loader");
 		while (running)
 		{
 			running = false;
 			maxWaitingCount = getMaxWaitingAsyncTextures(); // keep this value up to date in every iteration
+			maxWorkerThreads = getMaxWorkerThreads();
 			// check for new queued textures
 			lock.acquire(&TextureAsync::queueMutex);
 			if (TextureAsync::textures.size() > TextureAsync::streams.size())
@@ -155,7 +165,10 @@ namespace april
 				{
 					texture = TextureAsync::textures[TextureAsync::streams.size()];
 					lock.release();
-					stream = texture->_prepareAsyncStream();
+					{
+						APRIL_PROFILE_ZONE("TextureAsync read");
+						stream = texture->_prepareAsyncStream();
+					}
 					lock.acquire(&TextureAsync::queueMutex);
 					index = TextureAsync::textures.indexOf(texture); // it's possible that the queue was rearranged in the meantime
 					if (stream != NULL)
@@ -193,7 +206,7 @@ namespace april
 			if (size > 0)
 			{
 				running = true;
-				size = hmin(size, info.cpuCores) - TextureAsync::decoderThreads.size();
+				size = hmin(size, maxWorkerThreads) - TextureAsync::decoderThreads.size();
 				for_iter (i, 0, size)
 				{
 					decoderThread = new hthread(&TextureAsync::_decode, "APRIL async decoder");
@@ -217,12 +230,14 @@ namespace april
 				}
 			}
 		}
+		APRIL_PROFILE_THREAD_END();
 	}
 
 	void TextureAsync::_decode(hthread* thread)
 	{
 		Texture* texture = NULL;
 		hstream* stream = NULL;
+		APRIL_PROFILE_THREAD("APRIL async decoder");
 		hmutex::ScopeLock lock(&TextureAsync::queueMutex);
 		while (TextureAsync::streams.size() > 0)
 		{
@@ -241,10 +256,15 @@ namespace april
 			texture = TextureAsync::textures.removeFirst();
 			stream = TextureAsync::streams.removeFirst();
 			lock.release();
-			texture->_decodeFromAsyncStream(stream);
+			{
+				APRIL_PROFILE_ZONE("TextureAsync decode");
+				texture->_decodeFromAsyncStream(stream);
+			}
 			delete stream;
 			lock.acquire(&TextureAsync::queueMutex);
 		}
+		lock.release();
+		APRIL_PROFILE_THREAD_END();
 	}
 
 }
@@ -0,0 +1,202 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <string.h>
+
+#include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
+
+#include "april.h"
+#include "VertexBuffer.h"
+
+namespace april
+{
+	HL_ENUM_CLASS_DEFINE(VertexBuffer::Usage,
+	(
+		HL_ENUM_DEFINE(VertexBuffer::Usage, Static);
+		HL_ENUM_DEFINE(VertexBuffer::Usage, Dynamic);
+	));
+
+	HL_ENUM_CLASS_DEFINE(VertexBuffer::VertexType,
+	(
+		HL_ENUM_DEFINE(VertexBuffer::VertexType, Plain);
+		HL_ENUM_DEFINE(VertexBuffer::VertexType, Colored);
+		HL_ENUM_DEFINE(VertexBuffer::VertexType, Textured);
+		HL_ENUM_DEFINE(VertexBuffer::VertexType, ColoredTextured);
+	));
+
+	VertexBuffer::VertexBuffer()
+	{
+		this->usage = Usage::Static;
+		this->vertexType = VertexType::Plain;
+		this->vertexSize = 0;
+		this->count = 0;
+		this->data = NULL;
+		this->dirtyFirst = 0;
+		this->dirtyCount = 0;
+		this->uploaded = false;
+	}
+
+	VertexBuffer::~VertexBuffer()
+	{
+		hmutex::ScopeLock lock(&this->pendingUpdatesMutex);
+		foreach (Update, it, this->pendingUpdates)
+		{
+			delete[] (*it).data;
+		}
+		this->pendingUpdates.clear();
+		lock.release();
+		if (this->data != NULL)
+		{
+			delete[] this->data;
+		}
+	}
+
+	bool VertexBuffer::_create(VertexType vertexType, int vertexSize, const void* vertices, int count, Usage usage)
+	{
+		if (vertices == NULL || count <= 0)
+		{
+			hlog::error(logTag, "Cannot create vertex buffer without vertices!");
+			return false;
+		}
+		this->vertexType = vertexType;
+		this->vertexSize = vertexSize;
+		this->count = count;
+		this->usage = usage;
+		this->data = new unsigned char[count * vertexSize];
+		memcpy(this->data, vertices, count * vertexSize);
+		this->dirtyFirst = 0;
+		this->dirtyCount = count;
+		return true;
+	}
+
+	bool VertexBuffer::update(int first, const PlainVertex* vertices, int count)
+	{
+		return this->_update(VertexType::Plain, first, vertices, count);
+	}
+
+	bool VertexBuffer::update(int first, const ColoredVertex* vertices, int count)
+	{
+		return this->_update(VertexType::Colored, first, vertices, count);
+	}
+
+	bool VertexBuffer::update(int first, const TexturedVertex* vertices, int count)
+	{
+		return this->_update(VertexType::Textured, first, vertices, count);
+	}
+
+	bool VertexBuffer::update(int first, const ColoredTexturedVertex* vertices, int count)
+	{
+		return this->_update(VertexType::ColoredTextured, first, vertices, count);
+	}
+
+	bool VertexBuffer::_update(VertexType vertexType, int first, const void* vertices, int count)
+	{
+		if (this->vertexType != vertexType)
+		{
+			hlog::errorf(logTag, "Cannot update vertex buffer, it contains '%s' vertices, not '%s' vertices!", this->vertexType.getName().cStr(), vertexType.getName().cStr());
+			return false;
+		}
+		if (first < 0 || count <= 0 || first + count > this->count)
+		{
+			hlog::errorf(logTag, "Cannot update vertex buffer, vertices %d to %d are out of range (%d)!", first, first + count - 1, this->count);
+			return false;
+		}
+		// the RAM copy belongs to the render thread, earlier render calls might still have to draw the old vertices
+		Update update;
+		update.first = first;
+		update.count = count;
+		update.data = new unsigned char[count * this->vertexSize];
+		memcpy(update.data, vertices, count * this->vertexSize);
+		hmutex::ScopeLock lock(&this->pendingUpdatesMutex);
+		this->pendingUpdates += update;
+		return true;
+	}
+
+	harray<VertexBuffer::Update> VertexBuffer::_takeUpdates()
+	{
+		hmutex::ScopeLock lock(&this->pendingUpdatesMutex);
+		harray<Update> result = this->pendingUpdates;
+		this->pendingUpdates.clear();
+		return result;
+	}
+
+	void VertexBuffer::_applyUpdates(harray<Update>& updates)
+	{
+		int end = 0;
+		foreach (Update, it, updates)
+		{
+			memcpy(&this->data[(*it).first * this->vertexSize], (*it).data, (*it).count * this->vertexSize);
+			delete[] (*it).data;
+			if (this->dirtyCount > 0)
+			{
+				end = hmax(this->dirtyFirst + this->dirtyCount, (*it).first + (*it).count);
+				this->dirtyFirst = hmin(this->dirtyFirst, (*it).first);
+				this->dirtyCount = end - this->dirtyFirst;
+			}
+			else
+			{
+				this->dirtyFirst = (*it).first;
+				this->dirtyCount = (*it).count;
+			}
+		}
+		updates.clear();
+	}
+
+	bool VertexBuffer::_ensureUploaded()
+	{
+		if (!this->uploaded)
+		{
+			this->uploaded = this->_deviceCreateBuffer(this->data, this->count * this->vertexSize);
+			if (this->uploaded)
+			{
+				this->dirtyFirst = 0;
+				this->dirtyCount = 0;
+			}
+			return this->uploaded;
+		}
+		if (this->dirtyCount > 0)
+		{
+			int offset = this->dirtyFirst * this->vertexSize;
+			if (!this->_deviceUpdateBuffer(offset, &this->data[offset], this->dirtyCount * this->vertexSize))
+			{
+				return false;
+			}
+			this->dirtyFirst = 0;
+			this->dirtyCount = 0;
+		}
+		return true;
+	}
+
+	void VertexBuffer::_deviceUnloadBuffer()
+	{
+		if (this->uploaded)
+		{
+			this->_deviceDestroyBuffer();
+			this->uploaded = false;
+		}
+		this->dirtyFirst = 0;
+		this->dirtyCount = this->count;
+	}
+
+	bool VertexBuffer::_deviceCreateBuffer(unsigned char* data, int size)
+	{
+		return false;
+	}
+
+	bool VertexBuffer::_deviceDestroyBuffer()
+	{
+		return true;
+	}
+
+	bool VertexBuffer::_deviceUpdateBuffer(int offset, unsigned char* data, int size)
+	{
+		return false;
+	}
+
+}
@@ -24,6 +24,7 @@
 #include "MotionDelegate.h"
 #include "MouseDelegate.h"
 #include "Platform.h"
+#include "Profiler.h"
 #include "RenderSystem.h"
 #include "SetWindowResolutionCommand.h"
 #include "SystemDelegate.h"
@@ -95,6 +96,9 @@ namespace april
 		this->virtualKeyboardVisible = false;
 		this->virtualKeyboardHeightRatio = 0.0f;
 		this->multiTouchActive = false;
+		this->indexedTouchesCount = 0;
+		this->queuedInputTime = -1.0;
+		this->processedInputTime = -1.0;
 		this->inputMode = InputMode::Mouse;
 		this->virtualKeyboard = NULL;
 		this->updateDelegate = NULL;
@@ -145,6 +149,7 @@ namespace april
 			}
 		}
 		this->multiTouchActive = false;
+		this->indexedTouchesCount = 0;
 		this->cursor = NULL;
 		this->virtualKeyboardVisible = false;
 		this->virtualKeyboardHeightRatio = 0.0f;
@@ -168,6 +173,7 @@ namespace april
 		this->setVirtualKeyboard(NULL);
 		this->paused = false;
 		this->multiTouchActive = false;
+		this->indexedTouchesCount = 0;
 		this->cursor = NULL;
 		this->virtualKeyboardVisible = false;
 		this->virtualKeyboardHeightRatio = 0.0f;
@@ -180,11 +186,13 @@ namespace april
 		this->controllerDelegate = NULL;
 		this->motionDelegate = NULL;
 		this->systemDelegate = NULL;
+		hmutex::ScopeLock lock(&this->eventMutex);
 		this->mouseEvents.clear();
 		this->keyEvents.clear();
 		this->touchEvents.clear();
 		this->touchesEvents.clear();
 		this->controllerEvents.clear();
+		lock.release();
 		this->controllerEmulationKeys.clear();
 	}
 
@@ -356,6 +364,7 @@ namespace april
 
 	bool Window::update(float timeDelta)
 	{
+		APRIL_PROFILE_ZONE("Window::update");
 		this->_processEvents();
 		if (!this->focused)
 		{
@@ -370,22 +379,31 @@ namespace april
 
 	void Window::_processEvents()
 	{
+		// swapping the queued events with the processed ones avoids copying and keeps already allocated memory for the next frame
 		hmutex::ScopeLock lock(&this->eventMutex);
-		harray<GenericEvent> genericEvents = this->genericEvents;
-		harray<MouseEvent> mouseEvents = this->mouseEvents;
-		harray<KeyEvent> keyEvents = this->keyEvents;
-		harray<TouchEvent> touchEvents = this->touchEvents;
-		harray<TouchesEvent> touchesEvents = this->touchesEvents;
-		harray<ControllerEvent> controllerEvents = this->controllerEvents;
-		harray<MotionEvent> motionEvents = this->motionEvents;
-		this->genericEvents.clear();
-		this->mouseEvents.clear();
-		this->keyEvents.clear();
-		this->touchEvents.clear();
-		this->touchesEvents.clear();
-		this->controllerEvents.clear();
-		this->motionEvents.clear();
+		this->processedGenericEvents.swap(this->genericEvents);
+		this->processedMouseEvents.swap(this->mouseEvents);
+		this->processedKeyEvents.swap(this->keyEvents);
+		this->processedTouchEvents.swap(this->touchEvents);
+		this->processedTouchesEvents.swap(this->touchesEvents);
+		this->processedControllerEvents.swap(this->controllerEvents);
+		this->processedMotionEvents.swap(this->motionEvents);
+		if (this->queuedInputTime >= 0.0)
+		{
+			if (this->processedInputTime < 0.0)
+			{
+				this->processedInputTime = this->queuedInputTime;
+			}
+			this->queuedInputTime = -1.0;
+		}
 		lock.release();
+		harray<GenericEvent>& genericEvents = this->processedGenericEvents;
+		harray<MouseEvent>& mouseEvents = this->processedMouseEvents;
+		harray<KeyEvent>& keyEvents = this->processedKeyEvents;
+		harray<TouchEvent>& touchEvents = this->processedTouchEvents;
+		harray<TouchesEvent>& touchesEvents = this->processedTouchesEvents;
+		harray<ControllerEvent>& controllerEvents = this->processedControllerEvents;
+		harray<MotionEvent>& motionEvents = this->processedMotionEvents;
 		GenericEvent sizeEvent(GenericEvent::Type::SizeChange);
 		bool receivedMemoryWarning = false;
 		for_iter (i, 0, genericEvents.size())
@@ -485,6 +503,65 @@ namespace april
 		{
 			this->handleMotionInput(motionEvents[i].type, motionEvents[i].motionVector);
 		}
+		// clearing keeps the capacity
+		genericEvents.clear();
+		mouseEvents.clear();
+		keyEvents.clear();
+		touchEvents.clear();
+		touchesEvents.clear();
+		controllerEvents.clear();
+		motionEvents.clear();
+	}
+
+	double Window::_getInputTime() const
+	{
+		return (this->inputTimer.getTime() * this->inputTimer.getResolution());
+	}
+
+	void Window::_markInputQueued()
+	{
+		if (this->queuedInputTime < 0.0)
+		{
+			this->queuedInputTime = this->_getInputTime();
+		}
+	}
+
+	double Window::_takeProcessedInputTime()
+	{
+		double result = this->processedInputTime;
+		this->processedInputTime = -1.0;
+		return result;
+	}
+
+	int Window::_findIndexedTouch(int index) const
+	{
+		int low = 0;
+		int high = this->indexedTouchesCount - 1;
+		int middle = 0;
+		while (low <= high)
+		{
+			middle = (low + high) / 2;
+			if (this->indexedTouchIndices[middle] < index)
+			{
+				low = middle + 1;
+			}
+			else if (this->indexedTouchIndices[middle] > index)
+			{
+				high = middle - 1;
+			}
+			else
+			{
+				return middle;
+			}
+		}
+		return (-low - 1);
+	}
+
+	harray<gvec2f> Window::_getIndexedTouchPositions() const
+	{
+		harray<gvec2f> result;
+		result.add(this->indexedTouchPositions, this->indexedTouchesCount);
+		return result;
 	}
 
 	void Window::terminateMainLoop()
@@ -868,77 +945,97 @@ namespace april
 	void Window::queueMouseInput(MouseEvent::Type type, cgvec2f position, Key keyCode)
 	{
 		hmutex::ScopeLock lock(&this->eventMutex);
+		this->_markInputQueued();
 		this->mouseEvents += MouseEvent(type, position, keyCode);
 	}
 
 	void Window::queueKeyInput(KeyEvent::Type type, Key keyCode, unsigned int charCode)
 	{
 		hmutex::ScopeLock lock(&this->eventMutex);
+		this->_markInputQueued();
 		this->keyEvents += KeyEvent(type, keyCode, charCode);
 	}
 
 	void Window::queueTouchInput(TouchEvent::Type type, int index, cgvec2f position)
 	{
 		hmutex::ScopeLock lock(&this->eventMutex);
-		harray<int> indices = this->indexedTouches.keys();
-		indices.sort();
-		harray<gvec2f> previousTouches = this->indexedTouches.values(indices);
+		int previousCount = this->indexedTouchesCount;
+		gvec2f previousFirst = (previousCount > 0 ? this->indexedTouchPositions[0] : gvec2f());
+		int slot = this->_findIndexedTouch(index);
 		if (type == TouchEvent::Type::Down)
 		{
-			if (this->indexedTouches.hasKey(index)) // DOWN event of an already indexed touch, never happened so far
+			if (slot >= 0) // DOWN event of an already indexed touch, never happened so far
 			{
 				return;
 			}
-			this->indexedTouches[index] = position;
-		}
-		else if (type == TouchEvent::Type::Up)
-		{
-			if (!this->indexedTouches.hasKey(index)) // redundant UP event, can happen
+			if (this->indexedTouchesCount >= APRIL_MAX_INDEXED_TOUCHES)
 			{
+				hlog::warnf(logTag, "Cannot index touch %d, maximum of %d simultaneous touches reached!", index, APRIL_MAX_INDEXED_TOUCHES);
 				return;
 			}
-			this->indexedTouches.removeKey(index);
+			slot = -slot - 1;
+			for (int i = this->indexedTouchesCount; i > slot; --i)
+			{
+				this->indexedTouchIndices[i] = this->indexedTouchIndices[i - 1];
+				this->indexedTouchPositions[i] = this->indexedTouchPositions[i - 1];
+			}
+			this->indexedTouchIndices[slot] = index;
+			this->indexedTouchPositions[slot] = position;
+			++this->indexedTouchesCount;
 		}
 		else if (type == TouchEvent::Type::Move)
 		{
-			if (!this->indexedTouches.hasKey(index)) // MOVE event of an unindexed touch, never happened so far
+			if (slot < 0) // MOVE event of an unindexed touch, never happened so far
 			{
 				return;
 			}
-			this->indexedTouches[index] = position;
+			this->indexedTouchPositions[slot] = position;
 		}
-		else if (type == TouchEvent::Type::Cancel) // canceling a particular pointer, required by specific systems (e.g. UWP)
+		else if (type == TouchEvent::Type::Up || type == TouchEvent::Type::Cancel) // canceling a particular pointer is required by specific systems (e.g. UWP)
 		{
-			if (!this->indexedTouches.hasKey(index))
+			if (slot < 0) // redundant UP event, can happen
 			{
 				return;
 			}
-			this->indexedTouches.removeKey(index);
+			--this->indexedTouchesCount;
+			for_iter (i, slot, this->indexedTouchesCount)
+			{
+				this->indexedTouchIndices[i] = this->indexedTouchIndices[i + 1];
+				this->indexedTouchPositions[i] = this->indexedTouchPositions[i + 1];
+			}
 		}
-		indices = this->indexedTouches.keys();
-		indices.sort();
-		harray<gvec2f> currentTouches = this->indexedTouches.values(indices);
-		if (this->multiTouchActive || currentTouches.size() > 1)
+		if (this->multiTouchActive || this->indexedTouchesCount > 1)
 		{
-			if (!this->multiTouchActive && previousTouches.size() == 1)
+			if (!this->multiTouchActive && previousCount == 1)
 			{
 				// cancel (notify the app) that the previously called mouse-down event is canceled so multi-touch can be properly processed
-				this->mouseEvents += MouseEvent(MouseEvent::Type::Cancel, previousTouches.first(), Key::MouseL);
+				this->mouseEvents += MouseEvent(MouseEvent::Type::Cancel, previousFirst, Key::MouseL);
 			}
-			this->multiTouchActive = (currentTouches.size() > 0);
+			this->multiTouchActive = (this->indexedTouchesCount > 0);
 		}
 		else
 		{
 			this->mouseEvents += MouseEvent(MouseEvent::Type::fromName(type.getName()), position, Key::MouseL);
 		}
+		this->_markInputQueued();
 		this->touchEvents += TouchEvent(type, index, position);
-		this->touchesEvents.clear();
-		this->touchesEvents += TouchesEvent(currentTouches);
+		// only the latest touches state is relevant so the previous one is simply overwritten
+		if (this->touchesEvents.size() > 0)
+		{
+			harray<gvec2f>& touches = this->touchesEvents[0].touches;
+			touches.clear();
+			touches.add(this->indexedTouchPositions, this->indexedTouchesCount);
+		}
+		else
+		{
+			this->touchesEvents += TouchesEvent(this->_getIndexedTouchPositions());
+		}
 	}
 
 	void Window::queueControllerInput(ControllerEvent::Type type, int controllerIndex, Button buttonCode, float axisValue)
 	{
 		hmutex::ScopeLock lock(&this->eventMutex);
+		this->_markInputQueued();
 		this->controllerEvents += ControllerEvent(type, controllerIndex, buttonCode, axisValue);
 	}
 
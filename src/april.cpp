@@ -24,6 +24,7 @@
 #include "Application.h"
 #include "april.h"
 #include "Platform.h"
+#include "Profiler.h"
 #include "RenderSystem.h"
 #ifdef _DIRECTX9
 #include "DirectX9_RenderSystem.h"
@@ -62,6 +63,8 @@
 #ifdef _EGL
 #include "egl.h"
 #endif
+#include "WorkerPool.h"
+#include "zlibUtil.h"
 
 #ifdef _WIN32
 	#ifdef _DIRECTX9
@@ -165,18 +168,21 @@ namespace april
 	static hversion version(5, 2, 0);
 
 #ifdef _IOS
-	static harray<hstr> extensions = hstr(".jpt,.png,.jpg,.pvrz,.pvr").split(',');
+	static harray<hstr> extensions = hstr(".jpt,.png,.jpg,.pvrz,.pvr,.etcx,.ktx2,.ktx,.dds").split(',');
 #elif __ANDROID__
-	static harray<hstr> extensions = hstr(".jpt,.png,.jpg,.etcx").split(',');
+	static harray<hstr> extensions = hstr(".jpt,.png,.jpg,.etcx,.ktx2,.ktx,.dds").split(',');
 #else
-	static harray<hstr> extensions = hstr(".jpt,.png,.jpg").split(',');
+	static harray<hstr> extensions = hstr(".jpt,.png,.jpg,.etcx,.ktx2,.ktx,.dds").split(',');
 #endif
 	static int maxAsyncTextureUploadsPerFrame = 0;
+	static int maxAsyncTextureUploadBytesPerFrame = 0;
 #if defined(__ANDROID__) || defined(_IOS) || defined(_UWP) && defined(_WINHONE)
 	static int maxWaitingAsyncTextures = 8; // to limit RAM consumption
 #else
 	static int maxWaitingAsyncTextures = 0;
 #endif
+	static int maxWorkerThreads = 0;
+	static int parallelPixelThreshold = 65536;
 	static int exitCode = 0;
 	hmap<hstr, april::Color> symbolicColors;
 
@@ -447,6 +453,9 @@ namespace april
 			april::egl = NULL;
 		}
 #endif
+		WorkerPool::destroy();
+		Profiler::_destroy();
+		zlibDestroyInflaters();
 	}
 	
 	void addTextureExtension(chstr extension)
@@ -476,6 +485,16 @@ namespace april
 		maxAsyncTextureUploadsPerFrame = value;
 	}
 
+	int getMaxAsyncTextureUploadBytesPerFrame()
+	{
+		return maxAsyncTextureUploadBytesPerFrame;
+	}
+
+	void setMaxAsyncTextureUploadBytesPerFrame(int value)
+	{
+		maxAsyncTextureUploadBytesPerFrame = value;
+	}
+
 	int getMaxWaitingAsyncTextures()
 	{
 		return maxWaitingAsyncTextures;
@@ -486,6 +505,30 @@ namespace april
 		maxWaitingAsyncTextures = value;
 	}
 
+	int getMaxWorkerThreads()
+	{
+		if (maxWorkerThreads > 0)
+		{
+			return maxWorkerThreads;
+		}
+		return hmax(april::getSystemInfo().cpuCores, 1);
+	}
+
+	void setMaxWorkerThreads(int value)
+	{
+		maxWorkerThreads = value;
+	}
+
+	int getParallelPixelThreshold()
+	{
+		return parallelPixelThreshold;
+	}
+
+	void setParallelPixelThreshold(int value)
+	{
+		parallelPixelThreshold = value;
+	}
+
 	int getExitCode()
 	{
 		return exitCode;
@@ -50,6 +50,7 @@ namespace april
 		HL_ENUM_DEFINE(BlendMode, Add);
 		HL_ENUM_DEFINE(BlendMode, Subtract);
 		HL_ENUM_DEFINE(BlendMode, Overwrite);
+		HL_ENUM_DEFINE(BlendMode, PremultipliedAlpha);
 	));
 
 	HL_ENUM_CLASS_DEFINE(ColorMode,
@@ -61,6 +62,18 @@ namespace april
 		HL_ENUM_DEFINE(ColorMode, Sepia);
 	));
 
+	void QuadInstance::setTransform(cgvec2f position, cgvec2f scale, float angle)
+	{
+		float cosAngle = (float)hcos(angle);
+		float sinAngle = (float)hsin(angle);
+		this->a = cosAngle * scale.x;
+		this->b = sinAngle * scale.x;
+		this->c = -sinAngle * scale.y;
+		this->d = cosAngle * scale.y;
+		this->tx = position.x;
+		this->ty = position.y;
+	}
+
 	void rgbToHsl(unsigned char r, unsigned char g, unsigned char b, float* h, float* s, float* l)
 	{
 		unsigned char min = (unsigned char)hmin(hmin(r, g), b);
@@ -25,6 +25,7 @@ namespace april
 		virtual bool isUseState() const { return false; }
 		virtual bool isSystemCommand() const { return false; }
 		virtual bool isRepeatable() const { return false; }
+		virtual bool isReorderable() const { return false; }
 
 		virtual void execute() = 0;
 
@@ -18,13 +18,17 @@
 #include "ClearCommand.h"
 #include "ClearDepthCommand.h"
 #include "ClearColorCommand.h"
+#include "CommandListRenderCommand.h"
 #include "CreateCommand.h"
 #include "CreateWindowCommand.h"
 #include "CustomCommand.h"
 #include "DestroyCommand.h"
+#include "DestroyCommandListCommand.h"
 #include "DestroyTextureCommand.h"
+#include "DestroyVertexBufferCommand.h"
 #include "DestroyWindowCommand.h"
 #include "PresentFrameCommand.h"
+#include "QuadInstanceRenderCommand.h"
 #include "RenderCommand.h"
 #include "ResetCommand.h"
 #include "StateUpdateCommand.h"
@@ -32,6 +36,7 @@
 #include "TakeScreenshotCommand.h"
 #include "UnassignWindowCommand.h"
 #include "UnloadTextureCommand.h"
+#include "VertexBufferRenderCommand.h"
 #include "VertexRenderCommand.h"
 
 #endif
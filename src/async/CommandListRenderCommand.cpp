@@ -0,0 +1,47 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <hltypes/hltypesUtil.h>
+
+#include "CommandList.h"
+#include "CommandListRenderCommand.h"
+
+namespace april
+{
+	CommandListRenderCommand::CommandListRenderCommand(const RenderState& state, CommandList* commandList) :
+		RenderCommand(state)
+	{
+		this->commandList = commandList;
+		this->state.viewportChanged = true;
+		this->state.modelviewMatrixChanged = true;
+		this->state.projectionMatrixChanged = true;
+	}
+	
+	void CommandListRenderCommand::execute()
+	{
+		RenderState* state = NULL;
+		RenderState recordedState;
+		foreach (RenderCommand*, it, this->commandList->commands)
+		{
+			// recorded transformations are relative so the current ones are applied on top
+			state = (*it)->getState();
+			recordedState = *state;
+			state->viewport = this->state.viewport;
+			state->viewportChanged = true;
+			state->modelviewMatrix = this->state.modelviewMatrix * recordedState.modelviewMatrix;
+			state->modelviewMatrixChanged = true;
+			state->projectionMatrix = this->state.projectionMatrix;
+			state->projectionMatrixChanged = true;
+			(*it)->execute();
+			*state = recordedState;
+		}
+		// following commands expect the device to have the current transformations
+		RenderCommand::execute();
+	}
+	
+}
@@ -0,0 +1,36 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a command list render command.
+
+#ifndef APRIL_COMMAND_LIST_RENDER_COMMAND_H
+#define APRIL_COMMAND_LIST_RENDER_COMMAND_H
+
+#include "RenderCommand.h"
+#include "RenderState.h"
+
+namespace april
+{
+	class CommandList;
+
+	class CommandListRenderCommand : public RenderCommand
+	{
+	public:
+		CommandListRenderCommand(const RenderState& state, CommandList* commandList);
+
+		void execute();
+
+	protected:
+		CommandList* commandList;
+
+	};
+	
+}
+#endif
@@ -0,0 +1,35 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include "CommandList.h"
+#include "DestroyCommandListCommand.h"
+
+namespace april
+{
+	DestroyCommandListCommand::DestroyCommandListCommand(CommandList* commandList) :
+		UnloadTextureCommand(NULL),
+		executed(false)
+	{
+		this->commandList = commandList;
+	}
+
+	DestroyCommandListCommand::~DestroyCommandListCommand()
+	{
+		this->execute(); // to prevent potential memory leaks
+	}
+
+	void DestroyCommandListCommand::execute()
+	{
+		if (!this->executed)
+		{
+			delete this->commandList;
+		}
+		this->executed = true;
+	}
+
+}
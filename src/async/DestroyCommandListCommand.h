@@ -0,0 +1,40 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a destroy command list command.
+
+#ifndef APRIL_DESTROY_COMMAND_LIST_COMMAND_H
+#define APRIL_DESTROY_COMMAND_LIST_COMMAND_H
+
+#include "UnloadTextureCommand.h"
+
+namespace april
+{
+	class CommandList;
+
+	// queued together with texture unloads so it's delayed until repeated frames don't use the list anymore
+	class DestroyCommandListCommand : public UnloadTextureCommand
+	{
+	public:
+		DestroyCommandListCommand(CommandList* commandList);
+		~DestroyCommandListCommand();
+
+		bool isSystemCommand() const { return true; }
+
+		void execute();
+
+	protected:
+		CommandList* commandList;
+		bool executed;
+
+	};
+
+}
+#endif
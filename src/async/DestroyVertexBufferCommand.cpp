@@ -0,0 +1,36 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include "DestroyVertexBufferCommand.h"
+#include "VertexBuffer.h"
+
+namespace april
+{
+	DestroyVertexBufferCommand::DestroyVertexBufferCommand(VertexBuffer* vertexBuffer) :
+		UnloadTextureCommand(NULL),
+		executed(false)
+	{
+		this->vertexBuffer = vertexBuffer;
+	}
+
+	DestroyVertexBufferCommand::~DestroyVertexBufferCommand()
+	{
+		this->execute(); // to prevent potential memory leaks
+	}
+
+	void DestroyVertexBufferCommand::execute()
+	{
+		if (!this->executed)
+		{
+			this->vertexBuffer->_deviceUnloadBuffer();
+			delete this->vertexBuffer;
+		}
+		this->executed = true;
+	}
+
+}
@@ -0,0 +1,40 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a destroy vertex buffer command.
+
+#ifndef APRIL_DESTROY_VERTEX_BUFFER_COMMAND_H
+#define APRIL_DESTROY_VERTEX_BUFFER_COMMAND_H
+
+#include "UnloadTextureCommand.h"
+
+namespace april
+{
+	class VertexBuffer;
+
+	// queued together with texture unloads so it's delayed until repeated frames don't use the buffer anymore
+	class DestroyVertexBufferCommand : public UnloadTextureCommand
+	{
+	public:
+		DestroyVertexBufferCommand(VertexBuffer* vertexBuffer);
+		~DestroyVertexBufferCommand();
+
+		bool isSystemCommand() const { return true; }
+
+		void execute();
+
+	protected:
+		VertexBuffer* vertexBuffer;
+		bool executed;
+
+	};
+
+}
+#endif
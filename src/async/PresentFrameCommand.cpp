@@ -9,20 +9,31 @@
 #include <hltypes/hlog.h>
 
 #include "PresentFrameCommand.h"
+#include "Profiler.h"
 #include "RenderSystem.h"
 
 namespace april
 {
-	PresentFrameCommand::PresentFrameCommand(const RenderState& state, bool systemEnabled) :
+	PresentFrameCommand::PresentFrameCommand(const RenderState& state, bool systemEnabled, double inputTime) :
 		RenderCommand(state)
 	{
 		this->systemEnabled = systemEnabled;
+		this->inputTime = inputTime;
 	}
 	
 	void PresentFrameCommand::execute()
 	{
 		RenderCommand::execute();
-		april::rendersys->_devicePresentFrame(this->systemEnabled);
+		{
+			APRIL_PROFILE_ZONE("Present");
+			april::rendersys->_devicePresentFrame(this->systemEnabled);
+		}
+		APRIL_PROFILE_FRAME();
+		if (this->inputTime >= 0.0)
+		{
+			april::rendersys->_updateInputLatency(this->inputTime);
+			this->inputTime = -1.0; // repeated frames don't contain new input
+		}
 		april::rendersys->_updateDeviceState(&this->state, true);
 	}
 	
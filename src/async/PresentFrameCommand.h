@@ -20,7 +20,7 @@ namespace april
 	class PresentFrameCommand : public RenderCommand
 	{
 	public:
-		PresentFrameCommand(const RenderState& state, bool systemEnabled);
+		PresentFrameCommand(const RenderState& state, bool systemEnabled, double inputTime = -1.0);
 
 		bool isFinalizer() const { return true; }
 		bool isRepeatable() const { return true; }
@@ -29,6 +29,7 @@ namespace april
 
 	protected:
 		bool systemEnabled;
+		double inputTime;
 
 	};
 	
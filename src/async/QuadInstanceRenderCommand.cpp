@@ -0,0 +1,27 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include "QuadInstanceRenderCommand.h"
+#include "RenderSystem.h"
+
+namespace april
+{
+	QuadInstanceRenderCommand::QuadInstanceRenderCommand(const RenderState& state, cgrectf rect, const QuadInstance* instances, int count) :
+		RenderCommand(state)
+	{
+		this->rect = rect;
+		this->instances.add(instances, count);
+	}
+	
+	void QuadInstanceRenderCommand::execute()
+	{
+		RenderCommand::execute();
+		april::rendersys->_deviceRenderInstanced(this->rect, (QuadInstance*)this->instances, this->instances.size());
+	}
+	
+}
@@ -0,0 +1,39 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a quad instance render command.
+
+#ifndef APRIL_QUAD_INSTANCE_RENDER_COMMAND_H
+#define APRIL_QUAD_INSTANCE_RENDER_COMMAND_H
+
+#include <gtypes/Rectangle.h>
+#include <hltypes/harray.h>
+
+#include "aprilUtil.h"
+#include "RenderCommand.h"
+#include "RenderState.h"
+
+namespace april
+{
+	class QuadInstanceRenderCommand : public RenderCommand
+	{
+	public:
+		QuadInstanceRenderCommand(const RenderState& state, cgrectf rect, const QuadInstance* instances, int count);
+
+		void execute();
+
+	protected:
+		grectf rect;
+		harray<QuadInstance> instances;
+
+	};
+	
+}
+#endif
@@ -21,5 +21,10 @@ namespace april
 	{
 		april::rendersys->_updateDeviceState(&this->state);
 	}
+
+	bool RenderCommand::_isOpaque() const
+	{
+		return (this->state.depthBuffer && this->state.depthBufferWrite && this->state.blendMode == BlendMode::Overwrite);
+	}
 	
 }
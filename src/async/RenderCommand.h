@@ -32,6 +32,8 @@ namespace april
 	protected:
 		RenderState state;
 
+		bool _isOpaque() const;
+
 	};
 	
 }
@@ -23,6 +23,7 @@ namespace april
 	
 	void ResetCommand::execute()
 	{
+		april::rendersys->_deviceUnloadVertexBuffers();
 		april::rendersys->_deviceReset();
 		april::rendersys->_deviceSetup();
 		StateUpdateCommand::execute();
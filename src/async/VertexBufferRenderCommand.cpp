@@ -0,0 +1,46 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <hltypes/hltypesUtil.h>
+
+#include "RenderSystem.h"
+#include "VertexBuffer.h"
+#include "VertexBufferRenderCommand.h"
+
+namespace april
+{
+	VertexBufferRenderCommand::VertexBufferRenderCommand(const RenderState& state, const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count,
+		const harray<VertexBuffer::Update>& updates) : RenderCommand(state)
+	{
+		this->renderOperation = renderOperation;
+		this->vertexBuffer = vertexBuffer;
+		this->first = first;
+		this->count = count;
+		this->updates = updates;
+	}
+
+	VertexBufferRenderCommand::~VertexBufferRenderCommand()
+	{
+		foreach (VertexBuffer::Update, it, this->updates)
+		{
+			delete[] (*it).data;
+		}
+	}
+	
+	void VertexBufferRenderCommand::execute()
+	{
+		RenderCommand::execute();
+		// repeated frames must not apply the updates again, they would overwrite newer ones
+		if (this->updates.size() > 0)
+		{
+			this->vertexBuffer->_applyUpdates(this->updates);
+		}
+		april::rendersys->_deviceRender(this->renderOperation, this->vertexBuffer, this->first, this->count);
+	}
+	
+}
@@ -0,0 +1,46 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a vertex buffer render command.
+
+#ifndef APRIL_VERTEX_BUFFER_RENDER_COMMAND_H
+#define APRIL_VERTEX_BUFFER_RENDER_COMMAND_H
+
+#include <hltypes/harray.h>
+
+#include "RenderCommand.h"
+#include "RenderState.h"
+#include "VertexBuffer.h"
+
+namespace april
+{
+	class VertexBufferRenderCommand : public RenderCommand
+	{
+	public:
+		VertexBufferRenderCommand(const RenderState& state, const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count,
+			const harray<VertexBuffer::Update>& updates);
+		~VertexBufferRenderCommand();
+
+		// the updates have to be applied in the order the render calls were made
+		bool isReorderable() const { return (this->updates.size() == 0 && this->_isOpaque()); }
+
+		void execute();
+
+	protected:
+		RenderOperation renderOperation;
+		VertexBuffer* vertexBuffer;
+		int first;
+		int count;
+		harray<VertexBuffer::Update> updates;
+
+	};
+	
+}
+#endif
@@ -31,6 +31,8 @@ namespace april
 			this->vertices.add(vertices, count);
 		}
 
+		bool isReorderable() const { return this->_isOpaque(); }
+
 		void execute()
 		{
 			RenderCommand::execute();
@@ -8,6 +8,14 @@
 
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLIT_NEON
+#include <arm_neon.h>
+#endif
+
 #include <hltypes/hfile.h>
 #include <hltypes/hlog.h>
 #include <hltypes/hltypesUtil.h>
@@ -19,6 +27,7 @@
 #include "Color.h"
 #include "Image.h"
 #include "RenderSystem.h"
+#include "WorkerPool.h"
 
 #ifdef __APPLE__
 #include <TargetConditionals.h>
@@ -29,8 +38,6 @@
 #undef RGB
 #endif
 
-#define MAX_WRITE_SIZE 65536
-
 #define CHECK_SHIFT_FORMATS(format1, format2) (\
 	((format1) == Format::RGBA || (format1) == Format::RGBX || (format1) == Format::BGRA || (format1) == Format::BGRX) && \
 	((format2) == Format::ARGB || (format2) == Format::XRGB || (format2) == Format::ABGR || (format2) == Format::XBGR) \
@@ -266,6 +273,79 @@ namespace april
 
 	));
 
+	Image::ColorMatrix::ColorMatrix()
+	{
+		memset(this->data, 0, sizeof(this->data));
+		this->data[0] = this->data[5] = this->data[10] = 1.0f;
+	}
+
+	Image::ColorMatrix::ColorMatrix(const float data[12])
+	{
+		memcpy(this->data, data, sizeof(this->data));
+	}
+
+	bool Image::ColorMatrix::isIdentity() const
+	{
+		static ColorMatrix identity;
+		return (memcmp(this->data, identity.data, sizeof(this->data)) == 0);
+	}
+
+	bool Image::ColorMatrix::isSeparable() const
+	{
+		return (this->data[1] == 0.0f && this->data[2] == 0.0f && this->data[4] == 0.0f && this->data[6] == 0.0f && this->data[8] == 0.0f && this->data[9] == 0.0f);
+	}
+
+	Image::ColorMatrix Image::ColorMatrix::operator*(const ColorMatrix& other) const
+	{
+		ColorMatrix result;
+		const float* a = this->data;
+		const float* b = other.data;
+		for_iter (i, 0, 3)
+		{
+			for_iter (j, 0, 4)
+			{
+				result.data[i * 4 + j] = a[i * 4] * b[j] + a[i * 4 + 1] * b[4 + j] + a[i * 4 + 2] * b[8 + j];
+			}
+			result.data[i * 4 + 3] += a[i * 4 + 3];
+		}
+		return result;
+	}
+
+	Image::ColorMatrix Image::ColorMatrix::makeHueRotation(float degrees)
+	{
+		// rotation around the (1, 1, 1) axis
+		float c = (float)hcos(degrees);
+		float s = (float)hsin(degrees) * 0.57735027f;
+		float k = (1.0f - c) * 0.33333333f;
+		ColorMatrix result;
+		result.data[0] = result.data[5] = result.data[10] = c + k;
+		result.data[1] = result.data[6] = result.data[8] = k - s;
+		result.data[2] = result.data[4] = result.data[9] = k + s;
+		return result;
+	}
+
+	Image::ColorMatrix Image::ColorMatrix::makeSaturation(float factor)
+	{
+		float k = (1.0f - factor) * 0.33333333f;
+		ColorMatrix result;
+		for_iter (i, 0, 3)
+		{
+			for_iter (j, 0, 3)
+			{
+				result.data[i * 4 + j] = (i == j ? k + factor : k);
+			}
+		}
+		return result;
+	}
+
+	Image::ColorMatrix Image::ColorMatrix::makeInversion()
+	{
+		ColorMatrix result;
+		result.data[0] = result.data[5] = result.data[10] = -1.0f;
+		result.data[3] = result.data[7] = result.data[11] = 255.0f;
+		return result;
+	}
+
 	hmap<hstr, Image* (*)(hsbase&)> Image::customLoaders;
 	hmap<hstr, Image* (*)(hsbase&)> Image::customMetaDataLoaders;
 	hmap<hstr, bool (*)(hsbase&, Image*, Image::SaveParameters)> Image::customSavers;
@@ -385,6 +465,31 @@ namespace april
 		return (this->isValid() && Image::saturate(x, y, w, h, factor, this->data, this->w, this->h, this->format));
 	}
 
+	bool Image::adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor)
+	{
+		return (this->isValid() && Image::adjustHueSaturation(x, y, w, h, degrees, factor, this->data, this->w, this->h, this->format));
+	}
+
+	bool Image::invert(int x, int y, int w, int h)
+	{
+		return (this->isValid() && Image::invert(x, y, w, h, this->data, this->w, this->h, this->format));
+	}
+
+	bool Image::premultiplyAlpha(int x, int y, int w, int h)
+	{
+		return (this->isValid() && Image::premultiplyAlpha(x, y, w, h, this->data, this->w, this->h, this->format));
+	}
+
+	bool Image::unpremultiplyAlpha(int x, int y, int w, int h)
+	{
+		return (this->isValid() && Image::unpremultiplyAlpha(x, y, w, h, this->data, this->w, this->h, this->format));
+	}
+
+	bool Image::applyColorMatrix(int x, int y, int w, int h, const ColorMatrix& matrix)
+	{
+		return (this->isValid() && Image::applyColorMatrix(x, y, w, h, matrix, this->data, this->w, this->h, this->format));
+	}
+
 	bool Image::insertAlphaMap(unsigned char* srcData, Format srcFormat, unsigned char median, int ambiguity)
 	{
 		return (this->isValid() && Image::insertAlphaMap(this->w, this->h, srcData, srcFormat, this->data, this->format, median, ambiguity));
@@ -538,7 +643,7 @@ namespace april
 
 	bool Image::blitStretch(cgrecti srcRect, cgrecti destRect, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char alpha)
 	{
-		return this->blitStretch(srcRect.x, srcRect.y, srcRect.w, srcRect.h, destRect.x, destRect.y, destRect.w, destRect.h, srcData, srcWidth, srcHeight, srcFormat);
+		return this->blitStretch(srcRect.x, srcRect.y, srcRect.w, srcRect.h, destRect.x, destRect.y, destRect.w, destRect.h, srcData, srcWidth, srcHeight, srcFormat, alpha);
 	}
 
 	bool Image::blitStretch(cgrecti srcRect, cgrecti destRect, Image* other, unsigned char alpha)
@@ -556,6 +661,31 @@ namespace april
 		return this->saturate(rect.x, rect.y, rect.w, rect.h, factor);
 	}
 
+	bool Image::adjustHueSaturation(cgrecti rect, float degrees, float factor)
+	{
+		return this->adjustHueSaturation(rect.x, rect.y, rect.w, rect.h, degrees, factor);
+	}
+
+	bool Image::invert(cgrecti rect)
+	{
+		return this->invert(rect.x, rect.y, rect.w, rect.h);
+	}
+
+	bool Image::premultiplyAlpha(cgrecti rect)
+	{
+		return this->premultiplyAlpha(rect.x, rect.y, rect.w, rect.h);
+	}
+
+	bool Image::unpremultiplyAlpha(cgrecti rect)
+	{
+		return this->unpremultiplyAlpha(rect.x, rect.y, rect.w, rect.h);
+	}
+
+	bool Image::applyColorMatrix(cgrecti rect, const ColorMatrix& matrix)
+	{
+		return this->applyColorMatrix(rect.x, rect.y, rect.w, rect.h, matrix);
+	}
+
 	bool Image::insertAlphaMap(unsigned char* srcData, Format srcFormat)
 	{
 		return (this->insertAlphaMap(srcData, srcFormat, 0, 0));
@@ -608,13 +738,21 @@ namespace april
 			return Image::_loadPvrz(file);
 		}
 #endif
-#ifdef __ANDROID__
 		if (filename.lowered().endsWith(".etcx"))
 		{
 			file.open(filename);
 			return Image::_loadEtcx(file);
 		}
-#endif
+		if (filename.lowered().endsWith(".ktx") || filename.lowered().endsWith(".ktx2"))
+		{
+			file.open(filename);
+			return Image::_loadKtx(file);
+		}
+		if (filename.lowered().endsWith(".dds"))
+		{
+			file.open(filename);
+			return Image::_loadDds(file);
+		}
 		foreach_m (Image* (*)(hsbase&), it, Image::customLoaders)
 		{
 			if (filename.lowered().endsWith(it->first.lowered()))
@@ -672,13 +810,21 @@ namespace april
 			return Image::_loadPvrz(file);
 		}
 #endif
-#ifdef __ANDROID__
 		if (filename.lowered().endsWith(".etcx"))
 		{
 			file.open(filename);
 			return Image::_loadEtcx(file);
 		}
-#endif
+		if (filename.lowered().endsWith(".ktx") || filename.lowered().endsWith(".ktx2"))
+		{
+			file.open(filename);
+			return Image::_loadKtx(file);
+		}
+		if (filename.lowered().endsWith(".dds"))
+		{
+			file.open(filename);
+			return Image::_loadDds(file);
+		}
 		foreach_m (Image* (*)(hsbase&), it, Image::customLoaders)
 		{
 			if (filename.lowered().endsWith(it->first.lowered()))
@@ -730,12 +876,18 @@ namespace april
 			return Image::_loadPvrz(stream);
 		}
 #endif
-#ifdef __ANDROID__
 		if (logicalExtension.lowered().endsWith(".etcx"))
 		{
 			return Image::_loadEtcx(stream);
 		}
-#endif
+		if (logicalExtension.lowered().endsWith(".ktx") || logicalExtension.lowered().endsWith(".ktx2"))
+		{
+			return Image::_loadKtx(stream);
+		}
+		if (logicalExtension.lowered().endsWith(".dds"))
+		{
+			return Image::_loadDds(stream);
+		}
 		foreach_m (Image* (*)(hsbase&), it, Image::customLoaders)
 		{
 			if (logicalExtension.lowered().endsWith(it->first.lowered()))
@@ -870,13 +1022,21 @@ namespace april
 			return Image::_readMetaDataPvrz(file);
 		}
 #endif
-#ifdef __ANDROID__
 		if (filename.lowered().endsWith(".etcx"))
 		{
 			file.open(filename);
 			return Image::_readMetaDataEtcx(file);
 		}
-#endif
+		if (filename.lowered().endsWith(".ktx") || filename.lowered().endsWith(".ktx2"))
+		{
+			file.open(filename);
+			return Image::_readMetaDataKtx(file);
+		}
+		if (filename.lowered().endsWith(".dds"))
+		{
+			file.open(filename);
+			return Image::_readMetaDataDds(file);
+		}
 		foreach_m (Image* (*)(hsbase&), it, Image::customMetaDataLoaders)
 		{
 			if (filename.lowered().endsWith(it->first.lowered()))
@@ -918,13 +1078,21 @@ namespace april
 			return Image::_readMetaDataPvrz(file);
 		}
 #endif
-#ifdef __ANDROID__
 		if (filename.lowered().endsWith(".etcx"))
 		{
 			file.open(filename);
 			return Image::_readMetaDataEtcx(file);
 		}
-#endif
+		if (filename.lowered().endsWith(".ktx") || filename.lowered().endsWith(".ktx2"))
+		{
+			file.open(filename);
+			return Image::_readMetaDataKtx(file);
+		}
+		if (filename.lowered().endsWith(".dds"))
+		{
+			file.open(filename);
+			return Image::_readMetaDataDds(file);
+		}
 		foreach_m (Image* (*)(hsbase&), it, Image::customMetaDataLoaders)
 		{
 			if (filename.lowered().endsWith(it->first.lowered()))
@@ -960,12 +1128,18 @@ namespace april
 			return Image::_readMetaDataPvrz(stream);
 		}
 #endif
-#ifdef __ANDROID__
 		if (logicalExtension.lowered().endsWith(".etcx"))
 		{
 			return Image::_readMetaDataEtcx(stream);
 		}
-#endif
+		if (logicalExtension.lowered().endsWith(".ktx") || logicalExtension.lowered().endsWith(".ktx2"))
+		{
+			return Image::_readMetaDataKtx(stream);
+		}
+		if (logicalExtension.lowered().endsWith(".dds"))
+		{
+			return Image::_readMetaDataDds(stream);
+		}
 		foreach_m (Image* (*)(hsbase&), it, Image::customMetaDataLoaders)
 		{
 			if (logicalExtension.lowered().endsWith(it->first.lowered()))
@@ -1050,12 +1224,132 @@ namespace april
 		return result;
 	}
 
+	// rectangle operations on big areas are split into bands of rows that are processed on the worker threads
+	struct ImageBandData
+	{
+		int sx;
+		int sy;
+		int sw;
+		int dx;
+		int dy;
+		unsigned char* srcData;
+		int srcWidth;
+		int srcHeight;
+		Image::Format srcFormat;
+		unsigned char* destData;
+		int destWidth;
+		int destHeight;
+		Image::Format destFormat;
+		Color color;
+		unsigned char alpha;
+		float degrees;
+		float factor;
+		bool result;
+	};
+
+	static bool _isParallel(int w, int h)
+	{
+		int threshold = april::getParallelPixelThreshold();
+		return (threshold > 0 && h > 1 && w * h >= threshold && WorkerPool::canSplit());
+	}
+
+	static void _fillRectBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::fillRect(band->dx, band->dy + start, band->sw, end - start, band->color, band->destData, band->destWidth, band->destHeight, band->destFormat))
+		{
+			band->result = false;
+		}
+	}
+
+	static void _writeBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::write(band->sx, band->sy + start, band->sw, end - start, band->dx, band->dy + start, band->srcData, band->srcWidth, band->srcHeight, band->srcFormat,
+			band->destData, band->destWidth, band->destHeight, band->destFormat))
+		{
+			band->result = false;
+		}
+	}
+
+	static void _blitBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::blit(band->sx, band->sy + start, band->sw, end - start, band->dx, band->dy + start, band->srcData, band->srcWidth, band->srcHeight, band->srcFormat,
+			band->destData, band->destWidth, band->destHeight, band->destFormat, band->alpha))
+		{
+			band->result = false;
+		}
+	}
+
+	static void _blitPremultipliedBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::blitPremultiplied(band->sx, band->sy + start, band->sw, end - start, band->dx, band->dy + start, band->srcData, band->srcWidth, band->srcHeight, band->srcFormat,
+			band->destData, band->destWidth, band->destHeight, band->destFormat, band->alpha))
+		{
+			band->result = false;
+		}
+	}
+
+	static void _invertBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::invert(band->sx, band->sy + start, band->sw, end - start, band->srcData, band->srcWidth, band->srcHeight, band->srcFormat))
+		{
+			band->result = false;
+		}
+	}
+
+	static void _premultiplyAlphaBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::premultiplyAlpha(band->sx, band->sy + start, band->sw, end - start, band->srcData, band->srcWidth, band->srcHeight, band->srcFormat))
+		{
+			band->result = false;
+		}
+	}
+
+	static void _unpremultiplyAlphaBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::unpremultiplyAlpha(band->sx, band->sy + start, band->sw, end - start, band->srcData, band->srcWidth, band->srcHeight, band->srcFormat))
+		{
+			band->result = false;
+		}
+	}
+
+	static void _convertToFormatBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		unsigned char* destData = &band->destData[start * band->sw * band->destFormat.getBpp()];
+		if (!Image::convertToFormat(band->sw, end - start, &band->srcData[start * band->sw * band->srcFormat.getBpp()], band->srcFormat, &destData, band->destFormat, false))
+		{
+			band->result = false;
+		}
+	}
+
 	bool Image::fillRect(int x, int y, int w, int h, const Color& color, unsigned char* destData, int destWidth, int destHeight, Format destFormat)
 	{
 		if (!Image::correctRect(x, y, w, h, destWidth, destHeight))
 		{
 			return false;
 		}
+		if (_isParallel(w, h))
+		{
+			ImageBandData band;
+			band.sw = w;
+			band.dx = x;
+			band.dy = y;
+			band.destData = destData;
+			band.destWidth = destWidth;
+			band.destHeight = destHeight;
+			band.destFormat = destFormat;
+			band.color = color;
+			band.result = true;
+			WorkerPool::run(h, &_fillRectBand, &band);
+			return band.result;
+		}
 		int destBpp = destFormat.getBpp();
 		int i = (x + y * destWidth) * destBpp;
 		int copyWidth = w * destBpp;
@@ -1125,6 +1419,308 @@ namespace april
 		return true;
 	}
 
+	// exactly (value + 127) / 255 for values up to 255 * 255
+	static inline unsigned int _div255(unsigned int value)
+	{
+		value += 128;
+		return ((value + (value >> 8)) >> 8);
+	}
+
+	// blends one pixel with straight alpha, the channel indices are resolved by the caller
+	static inline void _blendPixel(const unsigned char* src, unsigned char* dest, int sr, int sg, int sb, int dr, int dg, int db, int da, unsigned int a0)
+	{
+		if (da < 0) // destination without alpha
+		{
+			unsigned int a1 = 255 - a0;
+			dest[dr] = _div255(src[sr] * a0 + dest[dr] * a1);
+			dest[dg] = _div255(src[sg] * a0 + dest[dg] * a1);
+			dest[db] = _div255(src[sb] * a0 + dest[db] * a1);
+			return;
+		}
+		unsigned int a1 = _div255((255 - a0) * dest[da]);
+		unsigned int resultAlpha = a0 + a1;
+		unsigned int half = resultAlpha / 2;
+		dest[da] = resultAlpha;
+		dest[dr] = (src[sr] * a0 + dest[dr] * a1 + half) / resultAlpha;
+		dest[dg] = (src[sg] * a0 + dest[dg] * a1 + half) / resultAlpha;
+		dest[db] = (src[sb] * a0 + dest[db] * a1 + half) / resultAlpha;
+	}
+
+#ifdef BLIT_SSE2
+	// blends 4 pixels at a time if source and destination have the same channel order, returns how many pixels were processed
+	static int _blendRow4Bpp(const unsigned char* src, unsigned char* dest, int count, int sa, bool destAlpha, unsigned int alpha)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi32(0xFF);
+		const __m128i round = _mm_set1_epi16(128);
+		const __m128i alphaMask = _mm_set1_epi32(0xFF << (sa * 8));
+		const __m128i multiplier = _mm_set1_epi32(alpha);
+		const __m128i shift = _mm_cvtsi32_si128(sa * 8);
+		__m128i s;
+		__m128i d;
+		__m128i a;
+		__m128i a8;
+		__m128i lo;
+		__m128i hi;
+		unsigned int alphas[4];
+		int c = (sa == 0 ? 1 : 0); // first color channel
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16, dest += 16)
+		{
+			s = _mm_loadu_si128((const __m128i*)src);
+			a = _mm_and_si128(_mm_srl_epi32(s, shift), full);
+			if (alpha < 255)
+			{
+				a = _mm_add_epi32(_mm_mullo_epi16(a, multiplier), _mm_set1_epi32(128));
+				a = _mm_srli_epi32(_mm_add_epi32(a, _mm_srli_epi32(a, 8)), 8);
+			}
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xFFFF) // transparent span
+			{
+				continue;
+			}
+			d = _mm_loadu_si128((const __m128i*)dest);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, full)) == 0xFFFF) // opaque span
+			{
+				if (!destAlpha)
+				{
+					s = _mm_or_si128(_mm_andnot_si128(alphaMask, s), _mm_and_si128(alphaMask, d));
+				}
+				_mm_storeu_si128((__m128i*)dest, s);
+				continue;
+			}
+			// the division by the resulting alpha is only avoided if the destination is opaque
+			if (destAlpha && _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(d, alphaMask), alphaMask)) != 0xFFFF)
+			{
+				_mm_storeu_si128((__m128i*)alphas, a);
+				for_iter (i, 0, 4)
+				{
+					if (alphas[i] > 0)
+					{
+						_blendPixel(&src[i * 4], &dest[i * 4], c, c + 1, c + 2, c, c + 1, c + 2, sa, alphas[i]);
+					}
+				}
+				continue;
+			}
+			// spreads alpha to all 4 channels
+			a8 = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+			a8 = _mm_or_si128(a8, _mm_slli_epi32(a8, 16));
+			lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(a8, zero)),
+				_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(_mm_xor_si128(a8, _mm_set1_epi8((char)0xFF)), zero))), round);
+			hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(a8, zero)),
+				_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(_mm_xor_si128(a8, _mm_set1_epi8((char)0xFF)), zero))), round);
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+			// the destination's alpha is either opaque and stays that way or there is no alpha channel
+			s = _mm_or_si128(_mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi)), _mm_and_si128(alphaMask, d));
+			_mm_storeu_si128((__m128i*)dest, s);
+		}
+		return x;
+	}
+#elif defined(BLIT_NEON)
+	// blends 4 pixels at a time if source and destination have the same channel order, returns how many pixels were processed
+	static int _blendRow4Bpp(const unsigned char* src, unsigned char* dest, int count, int sa, bool destAlpha, unsigned int alpha)
+	{
+		const uint32x4_t full = vdupq_n_u32(0xFF);
+		const uint16x8_t round = vdupq_n_u16(128);
+		const uint8x16_t alphaMask = vreinterpretq_u8_u32(vdupq_n_u32(0xFF << (sa * 8)));
+		uint8x16_t s;
+		uint8x16_t d;
+		uint32x4_t a;
+		uint32x2_t check;
+		uint8x16_t a8;
+		uint8x16_t ia8;
+		uint16x8_t lo;
+		uint16x8_t hi;
+		unsigned int alphas[4];
+		int c = (sa == 0 ? 1 : 0); // first color channel
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16, dest += 16)
+		{
+			s = vld1q_u8(src);
+			a = vandq_u32(vshlq_u32(vreinterpretq_u32_u8(s), vdupq_n_s32(-sa * 8)), full);
+			if (alpha < 255)
+			{
+				a = vaddq_u32(vmulq_n_u32(a, alpha), vdupq_n_u32(128));
+				a = vshrq_n_u32(vaddq_u32(a, vshrq_n_u32(a, 8)), 8);
+			}
+			check = vorr_u32(vget_low_u32(a), vget_high_u32(a));
+			if ((vget_lane_u32(check, 0) | vget_lane_u32(check, 1)) == 0) // transparent span
+			{
+				continue;
+			}
+			d = vld1q_u8(dest);
+			check = vand_u32(vget_low_u32(a), vget_high_u32(a));
+			if ((vget_lane_u32(check, 0) & vget_lane_u32(check, 1)) == 0xFF) // opaque span
+			{
+				vst1q_u8(dest, destAlpha ? s : vbslq_u8(alphaMask, d, s));
+				continue;
+			}
+			// the division by the resulting alpha is only avoided if the destination is opaque
+			if (destAlpha && (dest[sa] & dest[sa + 4] & dest[sa + 8] & dest[sa + 12]) != 0xFF)
+			{
+				vst1q_u32(alphas, a);
+				for_iter (i, 0, 4)
+				{
+					if (alphas[i] > 0)
+					{
+						_blendPixel(&src[i * 4], &dest[i * 4], c, c + 1, c + 2, c, c + 1, c + 2, sa, alphas[i]);
+					}
+				}
+				continue;
+			}
+			// spreads alpha to all 4 channels
+			a8 = vreinterpretq_u8_u32(vmulq_n_u32(a, 0x01010101));
+			ia8 = vmvnq_u8(a8);
+			lo = vaddq_u16(vmlal_u8(vmull_u8(vget_low_u8(s), vget_low_u8(a8)), vget_low_u8(d), vget_low_u8(ia8)), round);
+			hi = vaddq_u16(vmlal_u8(vmull_u8(vget_high_u8(s), vget_high_u8(a8)), vget_high_u8(d), vget_high_u8(ia8)), round);
+			lo = vsraq_n_u16(lo, lo, 8);
+			hi = vsraq_n_u16(hi, hi, 8);
+			// the destination's alpha is either opaque and stays that way or there is no alpha channel
+			vst1q_u8(dest, vbslq_u8(alphaMask, d, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8))));
+		}
+		return x;
+	}
+#endif
+
+	// composites one premultiplied pixel with src + dest * (255 - a) / 255, the channel indices are resolved by the caller
+	static inline void _blendPremultipliedPixel(const unsigned char* src, unsigned char* dest, int sr, int sg, int sb, int sa, int dr, int dg, int db, int da, unsigned int alpha)
+	{
+		unsigned int r = src[sr];
+		unsigned int g = src[sg];
+		unsigned int b = src[sb];
+		unsigned int a = src[sa];
+		if (alpha < 255)
+		{
+			r = _div255(r * alpha);
+			g = _div255(g * alpha);
+			b = _div255(b * alpha);
+			a = _div255(a * alpha);
+		}
+		unsigned int a1 = 255 - a;
+		// premultiplied colors can exceed their alpha when used for additive blending so the result is saturated
+		dest[dr] = hmin(r + _div255(dest[dr] * a1), 255U);
+		dest[dg] = hmin(g + _div255(dest[dg] * a1), 255U);
+		dest[db] = hmin(b + _div255(dest[db] * a1), 255U);
+		if (da >= 0)
+		{
+			dest[da] = a + _div255(dest[da] * a1);
+		}
+	}
+
+#ifdef BLIT_SSE2
+	// composites 4 premultiplied pixels at a time if source and destination have the same channel order, returns how many pixels were processed
+	static int _blendRowPremultiplied4Bpp(const unsigned char* src, unsigned char* dest, int count, int sa, bool destAlpha, unsigned int alpha)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi32(0xFF);
+		const __m128i round = _mm_set1_epi16(128);
+		const __m128i alphaMask = _mm_set1_epi32(0xFF << (sa * 8));
+		const __m128i multiplier = _mm_set1_epi16(alpha);
+		const __m128i shift = _mm_cvtsi32_si128(sa * 8);
+		__m128i s;
+		__m128i d;
+		__m128i a8;
+		__m128i lo;
+		__m128i hi;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16, dest += 16)
+		{
+			s = _mm_loadu_si128((const __m128i*)src);
+			if (alpha < 255)
+			{
+				lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), multiplier), round);
+				hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), multiplier), round);
+				lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+				hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+				s = _mm_packus_epi16(lo, hi);
+			}
+			// premultiplied pixels with zero alpha can still add color, so only fully zero pixels are skipped
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF) // transparent span
+			{
+				continue;
+			}
+			d = _mm_loadu_si128((const __m128i*)dest);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), alphaMask)) == 0xFFFF) // opaque span
+			{
+				if (!destAlpha)
+				{
+					s = _mm_or_si128(_mm_andnot_si128(alphaMask, s), _mm_and_si128(alphaMask, d));
+				}
+				_mm_storeu_si128((__m128i*)dest, s);
+				continue;
+			}
+			// spreads the inverted alpha to all 4 channels
+			a8 = _mm_and_si128(_mm_srl_epi32(s, shift), full);
+			a8 = _mm_or_si128(a8, _mm_slli_epi32(a8, 8));
+			a8 = _mm_xor_si128(_mm_or_si128(a8, _mm_slli_epi32(a8, 16)), _mm_set1_epi8((char)0xFF));
+			lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(a8, zero)), round);
+			hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(a8, zero)), round);
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+			s = _mm_adds_epu8(s, _mm_packus_epi16(lo, hi));
+			if (!destAlpha)
+			{
+				s = _mm_or_si128(_mm_andnot_si128(alphaMask, s), _mm_and_si128(alphaMask, d));
+			}
+			_mm_storeu_si128((__m128i*)dest, s);
+		}
+		return x;
+	}
+#elif defined(BLIT_NEON)
+	// composites 4 premultiplied pixels at a time if source and destination have the same channel order, returns how many pixels were processed
+	static int _blendRowPremultiplied4Bpp(const unsigned char* src, unsigned char* dest, int count, int sa, bool destAlpha, unsigned int alpha)
+	{
+		const uint32x4_t full = vdupq_n_u32(0xFF);
+		const uint16x8_t round = vdupq_n_u16(128);
+		const uint8x16_t alphaMask = vreinterpretq_u8_u32(vdupq_n_u32(0xFF << (sa * 8)));
+		const uint8x8_t multiplier = vdup_n_u8((unsigned char)alpha);
+		uint8x16_t s;
+		uint8x16_t d;
+		uint8x16_t ia8;
+		uint64x2_t check;
+		uint32x4_t opaque;
+		uint32x2_t opaqueCheck;
+		uint16x8_t lo;
+		uint16x8_t hi;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16, dest += 16)
+		{
+			s = vld1q_u8(src);
+			if (alpha < 255)
+			{
+				lo = vaddq_u16(vmull_u8(vget_low_u8(s), multiplier), round);
+				hi = vaddq_u16(vmull_u8(vget_high_u8(s), multiplier), round);
+				lo = vsraq_n_u16(lo, lo, 8);
+				hi = vsraq_n_u16(hi, hi, 8);
+				s = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+			}
+			// premultiplied pixels with zero alpha can still add color, so only fully zero pixels are skipped
+			check = vreinterpretq_u64_u8(s);
+			if ((vgetq_lane_u64(check, 0) | vgetq_lane_u64(check, 1)) == 0) // transparent span
+			{
+				continue;
+			}
+			d = vld1q_u8(dest);
+			opaque = vceqq_u32(vreinterpretq_u32_u8(vandq_u8(s, alphaMask)), vreinterpretq_u32_u8(alphaMask));
+			opaqueCheck = vand_u32(vget_low_u32(opaque), vget_high_u32(opaque));
+			if ((vget_lane_u32(opaqueCheck, 0) & vget_lane_u32(opaqueCheck, 1)) == 0xFFFFFFFF) // opaque span
+			{
+				vst1q_u8(dest, destAlpha ? s : vbslq_u8(alphaMask, d, s));
+				continue;
+			}
+			// spreads the inverted alpha to all 4 channels
+			ia8 = vmvnq_u8(vreinterpretq_u8_u32(vmulq_n_u32(vandq_u32(vshlq_u32(vreinterpretq_u32_u8(s), vdupq_n_s32(-sa * 8)), full), 0x01010101)));
+			lo = vaddq_u16(vmull_u8(vget_low_u8(d), vget_low_u8(ia8)), round);
+			hi = vaddq_u16(vmull_u8(vget_high_u8(d), vget_high_u8(ia8)), round);
+			lo = vsraq_n_u16(lo, lo, 8);
+			hi = vsraq_n_u16(hi, hi, 8);
+			s = vqaddq_u8(s, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+			vst1q_u8(dest, destAlpha ? s : vbslq_u8(alphaMask, d, s));
+		}
+		return x;
+	}
+#endif
+
 	bool Image::blitRect(int x, int y, int w, int h, const Color& color, unsigned char* destData, int destWidth, int destHeight, Format destFormat)
 	{
 		if (!Image::correctRect(x, y, w, h, destWidth, destHeight))
@@ -1136,27 +1732,35 @@ namespace april
 		{
 			return true;
 		}
+		// fully opaque, so nothing has to be blended
+		if (color.a == 255)
+		{
+			return Image::fillRect(x, y, w, h, color, destData, destWidth, destHeight, destFormat);
+		}
 		int destBpp = destFormat.getBpp();
+		int destStride = destWidth * destBpp;
+		unsigned char* destRow = &destData[(x + y * destWidth) * destBpp];
 		unsigned char* dest = NULL;
-		int i = 0;
+		unsigned char* destEnd = NULL;
 		int j = 0;
-		unsigned char a0 = color.a;
-		unsigned char invertedAlpha = 255 - a0;
-		int pmr = (int)color.r * a0; // premultiplied red
+		unsigned int a0 = color.a;
+		unsigned int invertedAlpha = 255 - a0;
+		unsigned int pmr = color.r * a0; // premultiplied red
 		if (destBpp == 1)
 		{
 			for_iterx (j, 0, h)
 			{
-				for_iterx (i, 0, w)
+				destEnd = destRow + w;
+				for (dest = destRow; dest < destEnd; ++dest)
 				{
-					dest = &destData[((x + i) + (y + i) * destWidth) * destBpp];
-					dest[0] = (pmr + dest[0] * invertedAlpha) / 255;
+					dest[0] = _div255(pmr + dest[0] * invertedAlpha);
 				}
+				destRow += destStride;
 			}
 			return true;
 		}
-		int pmg = (int)color.g * a0; // premultiplied green
-		int pmb = (int)color.b * a0; // premultiplied blue
+		unsigned int pmg = color.g * a0; // premultiplied green
+		unsigned int pmb = color.b * a0; // premultiplied blue
 		int dr = -1;
 		int dg = -1;
 		int db = -1;
@@ -1165,32 +1769,38 @@ namespace april
 			destFormat.getChannelIndices(&dr, &dg, &db, NULL);
 			for_iterx (j, 0, h)
 			{
-				for_iterx (i, 0, w)
+				destEnd = destRow + w * destBpp;
+				for (dest = destRow; dest < destEnd; dest += destBpp)
 				{
-					dest = &destData[((x + i) + (y + j) * destWidth) * destBpp];
-					dest[dr] = (pmr + dest[dr] * invertedAlpha) / 255;
-					dest[dg] = (pmg + dest[dg] * invertedAlpha) / 255;
-					dest[db] = (pmb + dest[db] * invertedAlpha) / 255;
+					dest[dr] = _div255(pmr + dest[dr] * invertedAlpha);
+					dest[dg] = _div255(pmg + dest[dg] * invertedAlpha);
+					dest[db] = _div255(pmb + dest[db] * invertedAlpha);
 				}
+				destRow += destStride;
 			}
 			return true;
 		}
 		int da = -1;
 		if (destBpp == 4) // 4 BPP with alpha
 		{
-			unsigned char a1 = 0;
+			unsigned int a1 = 0;
+			unsigned int resultAlpha = 0;
+			unsigned int half = 0;
 			destFormat.getChannelIndices(&dr, &dg, &db, &da);
 			for_iterx (j, 0, h)
 			{
-				for_iterx (i, 0, w)
+				destEnd = destRow + w * destBpp;
+				for (dest = destRow; dest < destEnd; dest += destBpp)
 				{
-					dest = &destData[((x + i) + (y + j) * destWidth) * destBpp];
-					a1 = invertedAlpha * dest[da] / 255;
-					dest[da] = a0 + a1;
-					dest[dr] = (pmr + dest[dr] * a1) / dest[da];
-					dest[dg] = (pmg + dest[dg] * a1) / dest[da];
-					dest[db] = (pmb + dest[db] * a1) / dest[da];
+					a1 = _div255(invertedAlpha * dest[da]);
+					resultAlpha = a0 + a1;
+					half = resultAlpha / 2;
+					dest[da] = resultAlpha;
+					dest[dr] = (pmr + dest[dr] * a1 + half) / resultAlpha;
+					dest[dg] = (pmg + dest[dg] * a1 + half) / resultAlpha;
+					dest[db] = (pmb + dest[db] * a1 + half) / resultAlpha;
 				}
+				destRow += destStride;
 			}
 			return true;
 		}
@@ -1204,6 +1814,27 @@ namespace april
 		{
 			return false;
 		}
+		// overlapping areas within the same data have to be processed in order
+		if (srcData != destData && _isParallel(sw, sh))
+		{
+			ImageBandData band;
+			band.sx = sx;
+			band.sy = sy;
+			band.sw = sw;
+			band.dx = dx;
+			band.dy = dy;
+			band.srcData = srcData;
+			band.srcWidth = srcWidth;
+			band.srcHeight = srcHeight;
+			band.srcFormat = srcFormat;
+			band.destData = destData;
+			band.destWidth = destWidth;
+			band.destHeight = destHeight;
+			band.destFormat = destFormat;
+			band.result = true;
+			WorkerPool::run(sh, &_writeBand, &band);
+			return band.result;
+		}
 		int srcBpp = srcFormat.getBpp();
 		int destBpp = destFormat.getBpp();
 		if (srcFormat == Format::Alpha && destFormat != Format::Alpha)
@@ -1244,250 +1875,198 @@ namespace april
 		return true;
 	}
 
-	static float _srcXs[MAX_WRITE_SIZE];
-	static int _x0s[MAX_WRITE_SIZE];
-	static int _x1s[MAX_WRITE_SIZE];
-	static float _rx0s[MAX_WRITE_SIZE];
-	static float _rx1s[MAX_WRITE_SIZE];
-	static float _srcYs[MAX_WRITE_SIZE];
-	static int _y0s[MAX_WRITE_SIZE];
-	static int _y1s[MAX_WRITE_SIZE];
-	static float _ry0s[MAX_WRITE_SIZE];
-	static float _ry1s[MAX_WRITE_SIZE];
+	struct ImageStretchData
+	{
+		int sy;
+		int sh;
+		int dx;
+		int dy;
+		int dw;
+		unsigned char* srcData;
+		int srcWidth;
+		int srcBpp;
+		unsigned char* destData;
+		int destWidth;
+		int destBpp;
+		int destOffset;
+		int channels;
+		float fh;
+		int* x0s;
+		int* x1s;
+		float* rx0s;
+		float* rx1s;
+	};
 
-	bool Image::writeStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat,
-		unsigned char* destData, int destWidth, int destHeight, Format destFormat)
+	// the tables for the columns are prepared once and shared, the rows are interpolated in bands
+	static void _writeStretchRows(void* data, int start, int end)
 	{
-		if (!Image::correctRect(sx, sy, sw, sh, srcWidth, srcHeight, dx, dy, dw, dh, destWidth, destHeight))
-		{
-			return false;
-		}
-		if (sw == dw && sh == dh)
-		{
-			return Image::write(sx, sy, sw, sh, dx, dh, srcData, srcWidth, srcHeight, srcFormat, destData, destWidth, destHeight, destFormat);
-		}
-		if (dw > MAX_WRITE_SIZE || dh > MAX_WRITE_SIZE)
-		{
-			hlog::errorf(logTag, "Cannot call Image::writeStretch() with dimensions bigger than %d!", MAX_WRITE_SIZE);
-			return false;
-		}
-		int bpp = destFormat.getBpp();
-		float fw = (dw > sw ? (sw - 1.0f) / dw : (float)sw / dw);
-		float fh = (dh > sh ? (sh - 1.0f) / dh : (float)sh / dh);
+		ImageStretchData* stretch = (ImageStretchData*)data;
+		unsigned char* srcData = stretch->srcData;
+		int srcWidth = stretch->srcWidth;
+		int srcBpp = stretch->srcBpp;
+		int channels = stretch->channels;
+		int* x0s = stretch->x0s;
+		int* x1s = stretch->x1s;
+		float* rx0s = stretch->rx0s;
+		float* rx1s = stretch->rx1s;
 		unsigned char* dest = NULL;
 		unsigned char* ctl = NULL;
 		unsigned char* ctr = NULL;
 		unsigned char* cbl = NULL;
 		unsigned char* cbr = NULL;
-		// preparing some data first
+		float srcY = 0.0f;
+		int y0 = 0;
+		int y1 = 0;
+		float ry0 = 0.0f;
+		float ry1 = 0.0f;
 		int x = 0;
 		int y = 0;
-		for_iterx (y, 0, dh)
-		{
-			_srcYs[y] = sy + y * fh;
-			_y0s[y] = (int)_srcYs[y];
-			_ry0s[y] = _srcYs[y] - _y0s[y];
-			_y1s[y] = hmin(_y0s[y] + 1, sy + sh - 1);
-			_ry1s[y] = 1.0f - _ry0s[y];
-		}
-		for_iterx (x, 0, dw)
-		{
-			_srcXs[x] = sx + x * fw;
-			_x0s[x] = (int)_srcXs[x];
-			_rx0s[x] = _srcXs[x] - _x0s[x];
-			_x1s[x] = hmin(_x0s[x] + 1, sx + sw - 1);
-			_rx1s[x] = 1.0f - _rx0s[x];
-		}
-		// the interpolated writing
-		if (srcFormat == Format::Alpha && destFormat != Format::Alpha)
-		{
-			if (bpp == 4)
+		int c = 0;
+		for_iterx (y, start, end)
+		{
+			srcY = stretch->sy + y * stretch->fh;
+			y0 = (int)srcY;
+			ry0 = srcY - y0;
+			y1 = hmin(y0 + 1, stretch->sy + stretch->sh - 1);
+			ry1 = 1.0f - ry0;
+			dest = &stretch->destData[(stretch->dx + (stretch->dy + y) * stretch->destWidth) * stretch->destBpp + stretch->destOffset];
+			for_iterx (x, 0, stretch->dw)
 			{
-				if (CHECK_ALPHA_FORMAT(destFormat))
+				// linear interpolation
+				ctl = &srcData[(x0s[x] + y0 * srcWidth) * srcBpp];
+				if (rx0s[x] != 0.0f && ry0 != 0.0f)
 				{
-					int da = -1;
-					destFormat.getChannelIndices(NULL, NULL, NULL, &da);
-					for_iterx (y, 0, dh)
+					ctr = &srcData[(x1s[x] + y0 * srcWidth) * srcBpp];
+					cbl = &srcData[(x0s[x] + y1 * srcWidth) * srcBpp];
+					cbr = &srcData[(x1s[x] + y1 * srcWidth) * srcBpp];
+					for_iterx (c, 0, channels)
 					{
-						for_iterx (x, 0, dw)
-						{
-							dest = &destData[((dx + x) + (dy + y) * destWidth) * bpp];
-							// linear interpolation
-							ctl = &srcData[(_x0s[x] + _y0s[y] * srcWidth) * bpp];
-							if (_rx0s[x] != 0.0f && _ry0s[y] != 0.0f)
-							{
-								ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-								cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-								cbr = &srcData[(_x1s[x] + _y1s[y] * srcWidth) * bpp];
-								dest[da] = (unsigned char)(((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]) * _rx1s[x] + (ctr[0] * _ry1s[y] + cbr[0] * _ry0s[y]) * _rx0s[x]));
-							}
-							else if (_rx0s[x] != 0.0f)
-							{
-								ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-								dest[da] = (unsigned char)((ctl[0] * _rx1s[x] + ctr[0] * _rx0s[x]));
-							}
-							else if (_ry0s[y] != 0.0f)
-							{
-								cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-								dest[da] = (unsigned char)((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]));
-							}
-							else
-							{
-								dest[da] = ctl[0];
-							}
-						}
+						dest[c] = (unsigned char)(((ctl[c] * ry1 + cbl[c] * ry0) * rx1s[x] + (ctr[c] * ry1 + cbr[c] * ry0) * rx0s[x]));
 					}
 				}
-				return true;
-			}
-			return false;
-		}
-		bool createNew = Image::needsConversion(srcFormat, destFormat);
-		if (createNew)
-		{
-			unsigned char* data = srcData;
-			srcData = new unsigned char[sw * sh * bpp];
-			if (!Image::write(sx, sy, sw, sh, 0, 0, data, srcWidth, srcHeight, srcFormat, srcData, sw, sh, destFormat))
-			{
-				delete[] srcData;
-				return false;
-			}
-			// changed size of data, needs to readjust
-#ifndef __clang_analyzer__
-			sx = 0;
-			sy = 0;
-			srcHeight = sh;
-			srcWidth = sw;
-#endif
-		}
-		bool result = false;
-		if (bpp == 1)
-		{
-			for_iterx (y, 0, dh)
-			{
-				for_iterx (x, 0, dw)
+				else if (rx0s[x] != 0.0f)
 				{
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * bpp];
-					// linear interpolation
-					ctl = &srcData[(_x0s[x] + _y0s[y] * srcWidth) * bpp];
-					if (_rx0s[x] != 0.0f && _ry0s[y] != 0.0f)
-					{
-						ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-						cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-						cbr = &srcData[(_x1s[x] + _y1s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)(((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]) * _rx1s[x] + (ctr[0] * _ry1s[y] + cbr[0] * _ry0s[y]) * _rx0s[x]));
-					}
-					else if (_rx0s[x] != 0.0f)
+					ctr = &srcData[(x1s[x] + y0 * srcWidth) * srcBpp];
+					for_iterx (c, 0, channels)
 					{
-						ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)((ctl[0] * _rx1s[x] + ctr[0] * _rx0s[x]));
+						dest[c] = (unsigned char)((ctl[c] * rx1s[x] + ctr[c] * rx0s[x]));
 					}
-					else if (_ry0s[y] != 0.0f)
+				}
+				else if (ry0 != 0.0f)
+				{
+					cbl = &srcData[(x0s[x] + y1 * srcWidth) * srcBpp];
+					for_iterx (c, 0, channels)
 					{
-						cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]));
+						dest[c] = (unsigned char)((ctl[c] * ry1 + cbl[c] * ry0));
 					}
-					else
+				}
+				else
+				{
+					for_iterx (c, 0, channels)
 					{
-						dest[0] = ctl[0];
+						dest[c] = ctl[c];
 					}
 				}
+				dest += stretch->destBpp;
 			}
-			result = true;
 		}
-		else if (bpp == 3)
+	}
+
+	bool Image::writeStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat,
+		unsigned char* destData, int destWidth, int destHeight, Format destFormat)
+	{
+		if (!Image::correctRect(sx, sy, sw, sh, srcWidth, srcHeight, dx, dy, dw, dh, destWidth, destHeight))
+		{
+			return false;
+		}
+		if (sw == dw && sh == dh)
+		{
+			return Image::write(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, destData, destWidth, destHeight, destFormat);
+		}
+		int bpp = destFormat.getBpp();
+		ImageStretchData stretch;
+		stretch.destOffset = 0;
+		stretch.channels = bpp;
+		bool createNew = false;
+		if (srcFormat == Format::Alpha && destFormat != Format::Alpha)
 		{
-			for_iterx (y, 0, dh)
+			if (bpp != 4)
 			{
-				for_iterx (x, 0, dw)
-				{
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * bpp];
-					// linear interpolation
-					ctl = &srcData[(_x0s[x] + _y0s[y] * srcWidth) * bpp];
-					if (_rx0s[x] != 0.0f && _ry0s[y] != 0.0f)
-					{
-						ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-						cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-						cbr = &srcData[(_x1s[x] + _y1s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)(((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]) * _rx1s[x] + (ctr[0] * _ry1s[y] + cbr[0] * _ry0s[y]) * _rx0s[x]));
-						dest[1] = (unsigned char)(((ctl[1] * _ry1s[y] + cbl[1] * _ry0s[y]) * _rx1s[x] + (ctr[1] * _ry1s[y] + cbr[1] * _ry0s[y]) * _rx0s[x]));
-						dest[2] = (unsigned char)(((ctl[2] * _ry1s[y] + cbl[2] * _ry0s[y]) * _rx1s[x] + (ctr[2] * _ry1s[y] + cbr[2] * _ry0s[y]) * _rx0s[x]));
-					}
-					else if (_rx0s[x] != 0.0f)
-					{
-						ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)((ctl[0] * _rx1s[x] + ctr[0] * _rx0s[x]));
-						dest[1] = (unsigned char)((ctl[1] * _rx1s[x] + ctr[1] * _rx0s[x]));
-						dest[2] = (unsigned char)((ctl[2] * _rx1s[x] + ctr[2] * _rx0s[x]));
-					}
-					else if (_ry0s[y] != 0.0f)
-					{
-						cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]));
-						dest[1] = (unsigned char)((ctl[1] * _ry1s[y] + cbl[1] * _ry0s[y]));
-						dest[2] = (unsigned char)((ctl[2] * _ry1s[y] + cbl[2] * _ry0s[y]));
-					}
-					else
-					{
-						dest[0] = ctl[0];
-						dest[1] = ctl[1];
-						dest[2] = ctl[2];
-					}
-				}
+				return false;
 			}
-			result = true;
+			if (!CHECK_ALPHA_FORMAT(destFormat))
+			{
+				return true;
+			}
+			// only the alpha channel is interpolated
+			destFormat.getChannelIndices(NULL, NULL, NULL, &stretch.destOffset);
+			stretch.channels = 1;
 		}
-		else if (bpp == 4)
+		else
 		{
-			for_iterx (y, 0, dh)
+			createNew = Image::needsConversion(srcFormat, destFormat);
+			if (createNew)
 			{
-				for_iterx (x, 0, dw)
+				unsigned char* data = srcData;
+				srcData = new unsigned char[sw * sh * bpp];
+				if (!Image::write(sx, sy, sw, sh, 0, 0, data, srcWidth, srcHeight, srcFormat, srcData, sw, sh, destFormat))
 				{
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * bpp];
-					// linear interpolation
-					ctl = &srcData[(_x0s[x] + _y0s[y] * srcWidth) * bpp];
-					if (_rx0s[x] != 0.0f && _ry0s[y] != 0.0f)
-					{
-						ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-						cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-						cbr = &srcData[(_x1s[x] + _y1s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)(((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]) * _rx1s[x] + (ctr[0] * _ry1s[y] + cbr[0] * _ry0s[y]) * _rx0s[x]));
-						dest[1] = (unsigned char)(((ctl[1] * _ry1s[y] + cbl[1] * _ry0s[y]) * _rx1s[x] + (ctr[1] * _ry1s[y] + cbr[1] * _ry0s[y]) * _rx0s[x]));
-						dest[2] = (unsigned char)(((ctl[2] * _ry1s[y] + cbl[2] * _ry0s[y]) * _rx1s[x] + (ctr[2] * _ry1s[y] + cbr[2] * _ry0s[y]) * _rx0s[x]));
-						dest[3] = (unsigned char)(((ctl[3] * _ry1s[y] + cbl[3] * _ry0s[y]) * _rx1s[x] + (ctr[3] * _ry1s[y] + cbr[3] * _ry0s[y]) * _rx0s[x]));
-					}
-					else if (_rx0s[x] != 0.0f)
-					{
-						ctr = &srcData[(_x1s[x] + _y0s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)((ctl[0] * _rx1s[x] + ctr[0] * _rx0s[x]));
-						dest[1] = (unsigned char)((ctl[1] * _rx1s[x] + ctr[1] * _rx0s[x]));
-						dest[2] = (unsigned char)((ctl[2] * _rx1s[x] + ctr[2] * _rx0s[x]));
-						dest[3] = (unsigned char)((ctl[3] * _rx1s[x] + ctr[3] * _rx0s[x]));
-					}
-					else if (_ry0s[y] != 0.0f)
-					{
-						cbl = &srcData[(_x0s[x] + _y1s[y] * srcWidth) * bpp];
-						dest[0] = (unsigned char)((ctl[0] * _ry1s[y] + cbl[0] * _ry0s[y]));
-						dest[1] = (unsigned char)((ctl[1] * _ry1s[y] + cbl[1] * _ry0s[y]));
-						dest[2] = (unsigned char)((ctl[2] * _ry1s[y] + cbl[2] * _ry0s[y]));
-						dest[3] = (unsigned char)((ctl[3] * _ry1s[y] + cbl[3] * _ry0s[y]));
-					}
-					else
-					{
-						dest[0] = ctl[0];
-						dest[1] = ctl[1];
-						dest[2] = ctl[2];
-						dest[3] = ctl[3];
-					}
+					delete[] srcData;
+					return false;
 				}
+				// changed size of data, needs to readjust
+#ifndef __clang_analyzer__
+				sx = 0;
+				sy = 0;
+				srcHeight = sh;
+				srcWidth = sw;
+#endif
+				srcFormat = destFormat;
 			}
-			result = true;
 		}
+		float fw = (dw > sw ? (sw - 1.0f) / dw : (float)sw / dw);
+		stretch.sy = sy;
+		stretch.sh = sh;
+		stretch.dx = dx;
+		stretch.dy = dy;
+		stretch.dw = dw;
+		stretch.srcData = srcData;
+		stretch.srcWidth = srcWidth;
+		stretch.srcBpp = srcFormat.getBpp();
+		stretch.destData = destData;
+		stretch.destWidth = destWidth;
+		stretch.destBpp = bpp;
+		stretch.fh = (dh > sh ? (sh - 1.0f) / dh : (float)sh / dh);
+		// preparing some data first
+		stretch.x0s = new int[dw * 2];
+		stretch.x1s = &stretch.x0s[dw];
+		stretch.rx0s = new float[dw * 2];
+		stretch.rx1s = &stretch.rx0s[dw];
+		float srcX = 0.0f;
+		for_iter (x, 0, dw)
+		{
+			srcX = sx + x * fw;
+			stretch.x0s[x] = (int)srcX;
+			stretch.rx0s[x] = srcX - stretch.x0s[x];
+			stretch.x1s[x] = hmin(stretch.x0s[x] + 1, sx + sw - 1);
+			stretch.rx1s[x] = 1.0f - stretch.rx0s[x];
+		}
+		// the interpolated writing
+		if (_isParallel(dw, dh))
+		{
+			WorkerPool::run(dh, &_writeStretchRows, &stretch);
+		}
+		else
+		{
+			_writeStretchRows(&stretch, 0, dh);
+		}
+		delete[] stretch.x0s;
+		delete[] stretch.rx0s;
 		if (createNew)
 		{
 			delete[] srcData;
 		}
-		return result;
+		return true;
 	}
 
 	bool Image::blit(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat,
@@ -1507,6 +2086,28 @@ namespace april
 		{
 			return true;
 		}
+		// overlapping areas within the same data have to be processed in order
+		if (srcData != destData && _isParallel(sw, sh))
+		{
+			ImageBandData band;
+			band.sx = sx;
+			band.sy = sy;
+			band.sw = sw;
+			band.dx = dx;
+			band.dy = dy;
+			band.srcData = srcData;
+			band.srcWidth = srcWidth;
+			band.srcHeight = srcHeight;
+			band.srcFormat = srcFormat;
+			band.destData = destData;
+			band.destWidth = destWidth;
+			band.destHeight = destHeight;
+			band.destFormat = destFormat;
+			band.alpha = alpha;
+			band.result = true;
+			WorkerPool::run(sh, &_blitBand, &band);
+			return band.result;
+		}
 		int srcBpp = srcFormat.getBpp();
 		if (srcBpp == 1)
 		{
@@ -1540,23 +2141,29 @@ namespace april
 		{
 			return false;
 		}
+		int srcStride = srcWidth * srcBpp;
+		int destStride = destWidth * destBpp;
+		unsigned char* srcRow = &srcData[(sx + sy * srcWidth) * srcBpp];
+		unsigned char* destRow = &destData[(dx + dy * destWidth) * destBpp];
 		unsigned char* src = NULL;
 		unsigned char* dest = NULL;
-		unsigned char a1;
-		unsigned int c;
+		unsigned int a0 = alpha;
+		unsigned int a1 = 255 - alpha;
+		unsigned int c = 0;
 		int x = 0;
 		int y = 0;
-		a1 = 255 - alpha;
 		if (destBpp == 1)
 		{
 			for_iterx (y, 0, sh)
 			{
+				src = srcRow;
+				dest = destRow;
 				for_iterx (x, 0, sw)
 				{
-					src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-					dest[0] = (src[0] * alpha + dest[0] * a1) / 255;
+					dest[x] = _div255(src[x] * a0 + dest[x] * a1);
 				}
+				srcRow += srcStride;
+				destRow += destStride;
 			}
 			return true;
 		}
@@ -1570,15 +2177,17 @@ namespace april
 				destFormat.getChannelIndices(&dr, &dg, &db, NULL);
 				for_iterx (y, 0, sh)
 				{
+					dest = destRow;
 					for_iterx (x, 0, sw)
 					{
-						src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-						dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-						c = src[0] * alpha;
-						dest[dr] = (c + dest[dr] * a1) / 255;
-						dest[dg] = (c + dest[dg] * a1) / 255;
-						dest[db] = (c + dest[db] * a1) / 255;
+						c = srcRow[x] * a0;
+						dest[dr] = _div255(c + dest[dr] * a1);
+						dest[dg] = _div255(c + dest[dg] * a1);
+						dest[db] = _div255(c + dest[db] * a1);
+						dest += destBpp;
 					}
+					srcRow += srcStride;
+					destRow += destStride;
 				}
 			}
 			return true;
@@ -1591,28 +2200,32 @@ namespace april
 			{
 				for_iterx (y, 0, sh)
 				{
+					dest = destRow;
 					for_iterx (x, 0, sw)
 					{
-						src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-						dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-						c = src[0] * alpha;
-						dest[dr] = (c + dest[dr] * a1) / 255;
-						dest[dg] = (c + dest[dg] * a1) / 255;
-						dest[db] = (c + dest[db] * a1) / 255;
-						dest[da] = alpha + dest[da] * a1 / 255;
+						c = srcRow[x] * a0;
+						dest[dr] = _div255(c + dest[dr] * a1);
+						dest[dg] = _div255(c + dest[dg] * a1);
+						dest[db] = _div255(c + dest[db] * a1);
+						dest[da] = a0 + _div255(dest[da] * a1);
+						dest += destBpp;
 					}
+					srcRow += srcStride;
+					destRow += destStride;
 				}
 			}
 			else
 			{
 				for_iterx (y, 0, sh)
 				{
+					dest = destRow;
 					for_iterx (x, 0, sw)
 					{
-						src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-						dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-						dest[da] = (src[0] * alpha + dest[da] * a1) / 255;
+						dest[da] = _div255(srcRow[x] * a0 + dest[da] * a1);
+						dest += destBpp;
 					}
+					srcRow += srcStride;
+					destRow += destStride;
 				}
 			}
 			return true;
@@ -1624,9 +2237,14 @@ namespace april
 	{
 		static int srcBpp = 3;
 		int destBpp = destFormat.getBpp();
+		int srcStride = srcWidth * srcBpp;
+		int destStride = destWidth * destBpp;
+		unsigned char* srcRow = &srcData[(sx + sy * srcWidth) * srcBpp];
+		unsigned char* destRow = &destData[(dx + dy * destWidth) * destBpp];
 		unsigned char* src = NULL;
 		unsigned char* dest = NULL;
-		unsigned char a1 = 255 - alpha;
+		unsigned int a0 = alpha;
+		unsigned int a1 = 255 - alpha;
 		int x = 0;
 		int y = 0;
 		int sr = -1;
@@ -1635,12 +2253,14 @@ namespace april
 			srcFormat.getChannelIndices(&sr, NULL, NULL, NULL);
 			for_iterx (y, 0, sh)
 			{
+				src = srcRow;
 				for_iterx (x, 0, sw)
 				{
-					src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-					dest[0] = (src[sr] * alpha + dest[0] * a1) / 255;
+					destRow[x] = _div255(src[sr] * a0 + destRow[x] * a1);
+					src += srcBpp;
 				}
+				srcRow += srcStride;
+				destRow += destStride;
 			}
 			return true;
 		}
@@ -1650,51 +2270,52 @@ namespace april
 		int dr = -1;
 		int dg = -1;
 		int db = -1;
+		int da = -1;
 		if (destBpp == 3 || !CHECK_ALPHA_FORMAT(destFormat)) // 3 BPP and 4 BPP without alpha
 		{
 			destFormat.getChannelIndices(&dr, &dg, &db, NULL);
-			for_iterx (y, 0, sh)
-			{
-				for_iterx (x, 0, sw)
-				{
-					src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-					dest[dr] = (src[sr] * alpha + dest[dr] * a1) / 255;
-					dest[dg] = (src[sg] * alpha + dest[dg] * a1) / 255;
-					dest[db] = (src[sb] * alpha + dest[db] * a1) / 255;
-				}
-			}
-			return true;
 		}
-		int da = -1;
-		if (destBpp == 4) // 4 BPP with alpha
+		else if (destBpp == 4) // 4 BPP with alpha
 		{
 			destFormat.getChannelIndices(&dr, &dg, &db, &da);
-			for_iterx (y, 0, sh)
+		}
+		else
+		{
+			return false;
+		}
+		for_iterx (y, 0, sh)
+		{
+			src = srcRow;
+			dest = destRow;
+			for_iterx (x, 0, sw)
 			{
-				for_iterx (x, 0, sw)
+				dest[dr] = _div255(src[sr] * a0 + dest[dr] * a1);
+				dest[dg] = _div255(src[sg] * a0 + dest[dg] * a1);
+				dest[db] = _div255(src[sb] * a0 + dest[db] * a1);
+				if (da >= 0)
 				{
-					src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-					dest[dr] = (src[sr] * alpha + dest[dr] * a1) / 255;
-					dest[dg] = (src[sg] * alpha + dest[dg] * a1) / 255;
-					dest[db] = (src[sb] * alpha + dest[db] * a1) / 255;
-					dest[da] = alpha + dest[da] * a1 / 255;
+					dest[da] = a0 + _div255(dest[da] * a1);
 				}
+				src += srcBpp;
+				dest += destBpp;
 			}
-			return true;
+			srcRow += srcStride;
+			destRow += destStride;
 		}
-		return false;
+		return true;
 	}
 	
 	bool Image::_blitFrom4Bpp(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha)
 	{
 		static int srcBpp = 4;
 		int destBpp = destFormat.getBpp();
+		int srcStride = srcWidth * srcBpp;
+		int destStride = destWidth * destBpp;
+		unsigned char* srcRow = &srcData[(sx + sy * srcWidth) * srcBpp];
+		unsigned char* destRow = &destData[(dx + dy * destWidth) * destBpp];
 		unsigned char* src = NULL;
 		unsigned char* dest = NULL;
-		unsigned char a0 = 0;
-		unsigned char a1 = 0;
+		unsigned int a0 = 0;
 		int x = 0;
 		int y = 0;
 		int sr = -1;
@@ -1704,16 +2325,18 @@ namespace april
 			srcFormat.getChannelIndices(&sr, NULL, NULL, &sa);
 			for_iterx (y, 0, sh)
 			{
+				src = srcRow;
 				for_iterx (x, 0, sw)
 				{
-					src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-					a0 = src[sa] * alpha / 255;
+					a0 = (alpha == 255 ? src[sa] : _div255(src[sa] * alpha));
 					if (a0 > 0)
 					{
-						dest[0] = (src[sr] * a0 + dest[0] * (255 - a0)) / 255;
+						destRow[x] = _div255(src[sr] * a0 + destRow[x] * (255 - a0));
 					}
+					src += srcBpp;
 				}
+				srcRow += srcStride;
+				destRow += destStride;
 			}
 			return true;
 		}
@@ -1723,51 +2346,65 @@ namespace april
 		int dr = -1;
 		int dg = -1;
 		int db = -1;
+		int da = -1;
 		if (destBpp == 3 || !CHECK_ALPHA_FORMAT(destFormat)) // 3 BPP and 4 BPP without alpha
 		{
 			destFormat.getChannelIndices(&dr, &dg, &db, NULL);
-			for_iterx (y, 0, sh)
-			{
-				for_iterx (x, 0, sw)
-				{
-					src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-					a0 = src[sa] * alpha / 255;
-					if (a0 > 0)
-					{
-						a1 = (255 - a0);
-						dest[dr] = (src[sr] * a0 + dest[dr] * a1) / 255;
-						dest[dg] = (src[sg] * a0 + dest[dg] * a1) / 255;
-						dest[db] = (src[sb] * a0 + dest[db] * a1) / 255;
-					}
-				}
-			}
-			return true;
 		}
-		int da = -1;
-		if (destBpp == 4) // 4 BPP with alpha
+		else if (destBpp == 4) // 4 BPP with alpha
 		{
 			destFormat.getChannelIndices(&dr, &dg, &db, &da);
-			for_iterx (y, 0, sh)
+		}
+		else
+		{
+			return false;
+		}
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+		bool vectorized = false;
+		if (destBpp == 4 && sr == dr && sg == dg && sb == db)
+		{
+			int dxa = -1; // alpha or unused channel of the destination
+			destFormat.getChannelIndices(NULL, NULL, NULL, &dxa);
+			vectorized = (sa == dxa);
+		}
+#endif
+		for_iterx (y, 0, sh)
+		{
+			src = srcRow;
+			dest = destRow;
+			x = 0;
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+			if (vectorized)
 			{
-				for_iterx (x, 0, sw)
+				x = _blendRow4Bpp(src, dest, sw, sa, (da >= 0), alpha);
+				src += x * srcBpp;
+				dest += x * destBpp;
+			}
+#endif
+			for (; x < sw; ++x)
+			{
+				a0 = (alpha == 255 ? src[sa] : _div255(src[sa] * alpha));
+				if (a0 == 255) // opaque pixel
 				{
-					src = &srcData[((sx + x) + (sy + y) * srcWidth) * srcBpp];
-					dest = &destData[((dx + x) + (dy + y) * destWidth) * destBpp];
-					a0 = src[sa] * alpha / 255;
-					if (a0 > 0)
+					dest[dr] = src[sr];
+					dest[dg] = src[sg];
+					dest[db] = src[sb];
+					if (da >= 0)
 					{
-						a1 = (255 - a0) * dest[da] / 255;
-						dest[da] = a0 + a1;
-						dest[dr] = (src[sr] * a0 + dest[dr] * a1) / dest[da];
-						dest[dg] = (src[sg] * a0 + dest[dg] * a1) / dest[da];
-						dest[db] = (src[sb] * a0 + dest[db] * a1) / dest[da];
+						dest[da] = 255;
 					}
 				}
+				else if (a0 > 0)
+				{
+					_blendPixel(src, dest, sr, sg, sb, dr, dg, db, da, a0);
+				}
+				src += srcBpp;
+				dest += destBpp;
 			}
-			return true;
+			srcRow += srcStride;
+			destRow += destStride;
 		}
-		return false;
+		return true;
 	}
 
 	bool Image::blitStretch(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat,
@@ -1779,7 +2416,7 @@ namespace april
 		}
 		if (sw == dw && sh == dh)
 		{
-			return Image::blit(sx, sy, sw, sh, dx, dh, srcData, srcWidth, srcHeight, srcFormat, destData, destWidth, destHeight, destFormat, alpha);
+			return Image::blit(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, destData, destWidth, destHeight, destFormat, alpha);
 		}
 		unsigned char* stretched = new unsigned char[dw * dh * srcFormat.getBpp()];
 		bool result = Image::writeStretch(sx, sy, sw, sh, 0, 0, dw, dh, srcData, srcWidth, srcHeight, srcFormat, stretched, dw, dh, srcFormat);
@@ -1791,196 +2428,957 @@ namespace april
 		return result;
 	}
 
-	bool Image::rotateHue(int x, int y, int w, int h, float degrees, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	bool Image::blitPremultiplied(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat,
+		unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha)
 	{
-		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
+		// without source alpha both compositing modes produce the same result
+		if (srcFormat.getBpp() != 4 || !CHECK_ALPHA_FORMAT(srcFormat))
 		{
-			return false;
+			return Image::blit(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, destData, destWidth, destHeight, destFormat, alpha);
 		}
-		int srcBpp = srcFormat.getBpp();
-		if (srcBpp == 1)
+		if (!Image::correctRect(sx, sy, sw, sh, srcWidth, srcHeight, dx, dy, destWidth, destHeight))
 		{
-			return true;
+			return false;
 		}
-		float range = hmodf(degrees / 360.0f, 1.0f);
-		if (range == 0.0f)
+		// it's invisible anyway, so let's say it's successful
+		if (alpha == 0)
 		{
 			return true;
 		}
-		int sr = -1;
-		int sg = -1;
-		int sb = -1;
-		srcFormat.getChannelIndices(&sr, &sg, &sb, NULL);
-		float _h;
-		float _s;
-		float _l;
-		int i;
-		for_iter (dy, 0, h)
-		{
-			for_iter (dx, 0, w)
-			{
-				i = ((x + dx) + (y + dy) * srcWidth) * srcBpp;
-				april::rgbToHsl(srcData[i + sr], srcData[i + sg], srcData[i + sb], &_h, &_s, &_l);
-				april::hslToRgb(hmodf(_h + range, 1.0f), _s, _l, &srcData[i + sr], &srcData[i + sg], &srcData[i + sb]);
-			}
-		}
-		return true;
+		// overlapping areas within the same data have to be processed in order
+		if (srcData != destData && _isParallel(sw, sh))
+		{
+			ImageBandData band;
+			band.sx = sx;
+			band.sy = sy;
+			band.sw = sw;
+			band.dx = dx;
+			band.dy = dy;
+			band.srcData = srcData;
+			band.srcWidth = srcWidth;
+			band.srcHeight = srcHeight;
+			band.srcFormat = srcFormat;
+			band.destData = destData;
+			band.destWidth = destWidth;
+			band.destHeight = destHeight;
+			band.destFormat = destFormat;
+			band.alpha = alpha;
+			band.result = true;
+			WorkerPool::run(sh, &_blitPremultipliedBand, &band);
+			return band.result;
+		}
+		return Image::_blitFrom4BppPremultiplied(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, destData, destWidth, destHeight, destFormat, alpha);
 	}
 
-	bool Image::saturate(int x, int y, int w, int h, float factor, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	bool Image::blitStretchPremultiplied(int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat,
+		unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha)
 	{
-		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
+		if (!Image::correctRect(sx, sy, sw, sh, srcWidth, srcHeight, dx, dy, dw, dh, destWidth, destHeight))
 		{
 			return false;
 		}
-		int srcBpp = srcFormat.getBpp();
-		if (srcBpp == 1)
+		if (sw == dw && sh == dh)
 		{
-			return true;
+			return Image::blitPremultiplied(sx, sy, sw, sh, dx, dy, srcData, srcWidth, srcHeight, srcFormat, destData, destWidth, destHeight, destFormat, alpha);
 		}
-		int sr = -1;
-		int sg = -1;
-		int sb = -1;
-		srcFormat.getChannelIndices(&sr, &sg, &sb, NULL);
-		float _h;
-		float _s;
-		float _l;
-		int i;
-		for_iter (dy, 0, h)
+		// interpolating premultiplied data is correct as it is
+		unsigned char* stretched = new unsigned char[dw * dh * srcFormat.getBpp()];
+		bool result = Image::writeStretch(sx, sy, sw, sh, 0, 0, dw, dh, srcData, srcWidth, srcHeight, srcFormat, stretched, dw, dh, srcFormat);
+		if (result)
 		{
-			for_iter (dx, 0, w)
-			{
-				i = ((x + dx) + (y + dy) * srcWidth) * srcBpp;
-				april::rgbToHsl(srcData[i + sr], srcData[i + sg], srcData[i + sb], &_h, &_s, &_l);
-				april::hslToRgb(_h, hclamp(_s * factor, 0.0f, 1.0f), _l, &srcData[i + sr], &srcData[i + sg], &srcData[i + sb]);
-			}
+			result = Image::blitPremultiplied(0, 0, dw, dh, dx, dy, stretched, dw, dh, srcFormat, destData, destWidth, destHeight, destFormat, alpha);
 		}
-		return true;
+		delete[] stretched;
+		return result;
 	}
 
-	bool Image::invert(int x, int y, int w, int h, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	bool Image::_blitFrom4BppPremultiplied(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Format destFormat, unsigned char alpha)
 	{
-		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
-		{
-			return false;
-		}
-		int i;
-		int srcBpp = srcFormat.getBpp();
-		if (srcBpp == 1)
+		static int srcBpp = 4;
+		int destBpp = destFormat.getBpp();
+		int srcStride = srcWidth * srcBpp;
+		int destStride = destWidth * destBpp;
+		unsigned char* srcRow = &srcData[(sx + sy * srcWidth) * srcBpp];
+		unsigned char* destRow = &destData[(dx + dy * destWidth) * destBpp];
+		unsigned char* src = NULL;
+		unsigned char* dest = NULL;
+		unsigned int r = 0;
+		unsigned int a = 0;
+		int x = 0;
+		int y = 0;
+		int sr = -1;
+		int sa = -1;
+		if (destBpp == 1)
 		{
-			for_iter (dy, 0, h)
+			srcFormat.getChannelIndices(&sr, NULL, NULL, &sa);
+			for_iterx (y, 0, sh)
 			{
-				for_iter (dx, 0, w)
+				src = srcRow;
+				for_iterx (x, 0, sw)
 				{
-					i = ((x + dx) + (y + dy) * srcWidth);
-					srcData[i] = 255 - srcData[i];
+					r = (alpha == 255 ? src[sr] : _div255(src[sr] * alpha));
+					a = (alpha == 255 ? src[sa] : _div255(src[sa] * alpha));
+					destRow[x] = hmin(r + _div255(destRow[x] * (255 - a)), 255U);
+					src += srcBpp;
 				}
+				srcRow += srcStride;
+				destRow += destStride;
 			}
 			return true;
 		}
-		int sr = -1;
 		int sg = -1;
 		int sb = -1;
-		srcFormat.getChannelIndices(&sr, &sg, &sb, NULL);
-		for_iter (dy, 0, h)
+		srcFormat.getChannelIndices(&sr, &sg, &sb, &sa);
+		int dr = -1;
+		int dg = -1;
+		int db = -1;
+		int da = -1;
+		if (destBpp == 3 || !CHECK_ALPHA_FORMAT(destFormat)) // 3 BPP and 4 BPP without alpha
+		{
+			destFormat.getChannelIndices(&dr, &dg, &db, NULL);
+		}
+		else if (destBpp == 4) // 4 BPP with alpha
+		{
+			destFormat.getChannelIndices(&dr, &dg, &db, &da);
+		}
+		else
+		{
+			return false;
+		}
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+		bool vectorized = false;
+		if (destBpp == 4 && sr == dr && sg == dg && sb == db)
 		{
-			for_iter (dx, 0, w)
+			int dxa = -1; // alpha or unused channel of the destination
+			destFormat.getChannelIndices(NULL, NULL, NULL, &dxa);
+			vectorized = (sa == dxa);
+		}
+#endif
+		for_iterx (y, 0, sh)
+		{
+			src = srcRow;
+			dest = destRow;
+			x = 0;
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+			if (vectorized)
 			{
-				i = ((x + dx) + (y + dy) * srcWidth) * srcBpp;
-				srcData[i + sr] = 255 - srcData[i + sr];
-				srcData[i + sg] = 255 - srcData[i + sg];
-				srcData[i + sb] = 255 - srcData[i + sb];
+				x = _blendRowPremultiplied4Bpp(src, dest, sw, sa, (da >= 0), alpha);
+				src += x * srcBpp;
+				dest += x * destBpp;
 			}
+#endif
+			for (; x < sw; ++x)
+			{
+				_blendPremultipliedPixel(src, dest, sr, sg, sb, sa, dr, dg, db, da, alpha);
+				src += srcBpp;
+				dest += destBpp;
+			}
+			srcRow += srcStride;
+			destRow += destStride;
 		}
 		return true;
 	}
 
-	bool Image::insertAlphaMap(int w, int h, unsigned char* srcData, Image::Format srcFormat, unsigned char* destData, Image::Format destFormat, unsigned char median, int ambiguity)
+	// rotates the hue by an offset in sixths of the hue circle which keeps the lightness and the saturation of the pixel
+	static inline void _rotatePixelHue(unsigned char* pixel, int sr, int sg, int sb, float offset)
 	{
-		if (!CHECK_ALPHA_FORMAT(destFormat)) // not a format that supports an alpha channel
+		int r = pixel[sr];
+		int g = pixel[sg];
+		int b = pixel[sb];
+		int max = hmax(hmax(r, g), b);
+		int min = hmin(hmin(r, g), b);
+		int chroma = max - min;
+		if (chroma == 0)
 		{
-			return false;
+			return;
 		}
-		int srcBpp = srcFormat.getBpp();
-		if (srcBpp == 1 || srcBpp == 3 || srcBpp == 4)
+		// the hue is represented as a position on the hue circle that is 6 * chroma long
+		int position = 0;
+		if (max == r)
 		{
-			int destBpp = destFormat.getBpp();
-			int sr = -1;
-			srcFormat.getChannelIndices(&sr, NULL, NULL, NULL);
-			int da = -1;
-			destFormat.getChannelIndices(NULL, NULL, NULL, &da);
-			unsigned char* src = NULL;
-			unsigned char* dest = NULL;
-			int i = 0;
-			int x = 0;
-			int y = 0;
-			if (ambiguity == 0)
-			{
-				for_iterx (y, 0, h)
-				{
-					for_iterx (x, 0, w)
-					{
-						i = (x + y * w);
-						// takes the red second color channel for alpha value
-						destData[i * destBpp + da] = srcData[i * srcBpp + sr];
-					}
-				}
-			}
-			else
-			{
-				int min = (int)median - ambiguity / 2;
-				int max = (int)median + ambiguity / 2;
-				for_iterx (y, 0, h)
-				{
-					for_iterx (x, 0, w)
-					{
-						i = (x + y * w);
-						src = &srcData[i * srcBpp];
-						dest = &destData[i * destBpp];
-						// takes the red second color channel for alpha value
-						if (src[sr] < min)
-						{
-							dest[da] = 255;
-						}
-						else if (src[sr] >= max)
-						{
-							dest[da] = 0;
-						}
-						else
-						{
-							dest[da] = (max - src[sr]) * 255 / ambiguity;
-						}
-					}
+			position = g - b + (g < b ? chroma * 6 : 0);
+		}
+		else if (max == g)
+		{
+			position = b - r + chroma * 2;
+		}
+		else
+		{
+			position = r - g + chroma * 4;
+		}
+		position += (int)(offset * chroma + 0.5f);
+		if (position >= chroma * 6)
+		{
+			position -= chroma * 6;
+		}
+		int sector = position / chroma;
+		int step = position - sector * chroma;
+		switch (sector)
+		{
+		case 0:		r = max;			g = min + step;		b = min;			break;
+		case 1:		r = max - step;		g = max;			b = min;			break;
+		case 2:		r = min;			g = max;			b = min + step;		break;
+		case 3:		r = min;			g = max - step;		b = max;			break;
+		case 4:		r = min + step;		g = min;			b = max;			break;
+		default:	r = max;			g = min;			b = max - step;		break;
+		}
+		pixel[sr] = r;
+		pixel[sg] = g;
+		pixel[sb] = b;
+	}
+
+	// scales the distance of all channels from the lightness which changes the saturation while keeping the lightness and the hue of the pixel
+	static inline void _saturatePixel(unsigned char* pixel, int sr, int sg, int sb, float factor)
+	{
+		int r = pixel[sr];
+		int g = pixel[sg];
+		int b = pixel[sb];
+		int max = hmax(hmax(r, g), b);
+		int min = hmin(hmin(r, g), b);
+		int chroma = max - min;
+		if (chroma == 0)
+		{
+			return;
+		}
+		int lightness2 = max + min; // twice the lightness
+		int maxChroma = hmin(lightness2, 510 - lightness2); // saturation of 1.0
+		float scale = hclamp(chroma * factor, 0.0f, (float)maxChroma) / chroma;
+		pixel[sr] = (unsigned char)((lightness2 + (r * 2 - lightness2) * scale) * 0.5f + 0.5f);
+		pixel[sg] = (unsigned char)((lightness2 + (g * 2 - lightness2) * scale) * 0.5f + 0.5f);
+		pixel[sb] = (unsigned char)((lightness2 + (b * 2 - lightness2) * scale) * 0.5f + 0.5f);
+	}
+
+	static void _adjustHueSaturationBand(void* data, int start, int end)
+	{
+		ImageBandData* band = (ImageBandData*)data;
+		if (!Image::adjustHueSaturation(band->sx, band->sy + start, band->sw, end - start, band->degrees, band->factor, band->srcData, band->srcWidth, band->srcHeight, band->srcFormat))
+		{
+			band->result = false;
+		}
+	}
+
+	bool Image::rotateHue(int x, int y, int w, int h, float degrees, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		return Image::adjustHueSaturation(x, y, w, h, degrees, 1.0f, srcData, srcWidth, srcHeight, srcFormat);
+	}
+
+	bool Image::saturate(int x, int y, int w, int h, float factor, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		return Image::adjustHueSaturation(x, y, w, h, 0.0f, factor, srcData, srcWidth, srcHeight, srcFormat);
+	}
+
+	bool Image::adjustHueSaturation(int x, int y, int w, int h, float degrees, float factor, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
+		{
+			return false;
+		}
+		int srcBpp = srcFormat.getBpp();
+		if (srcBpp == 1)
+		{
+			return true;
+		}
+		float range = hmodf(degrees / 360.0f, 1.0f);
+		if (range < 0.0f)
+		{
+			range += 1.0f;
+		}
+		bool hue = (range != 0.0f);
+		bool saturation = (factor != 1.0f);
+		if (!hue && !saturation)
+		{
+			return true;
+		}
+		if (_isParallel(w, h))
+		{
+			ImageBandData band;
+			band.sx = x;
+			band.sy = y;
+			band.sw = w;
+			band.srcData = srcData;
+			band.srcWidth = srcWidth;
+			band.srcHeight = srcHeight;
+			band.srcFormat = srcFormat;
+			band.degrees = degrees;
+			band.factor = factor;
+			band.result = true;
+			WorkerPool::run(h, &_adjustHueSaturationBand, &band);
+			return band.result;
+		}
+		float offset = range * 6.0f;
+		int sr = -1;
+		int sg = -1;
+		int sb = -1;
+		srcFormat.getChannelIndices(&sr, &sg, &sb, NULL);
+		int srcStride = srcWidth * srcBpp;
+		unsigned char* srcRow = &srcData[(x + y * srcWidth) * srcBpp];
+		unsigned char* src = NULL;
+		unsigned char* srcEnd = NULL;
+		for_iter (j, 0, h)
+		{
+			srcEnd = srcRow + w * srcBpp;
+			// both operations keep the lightness and each keeps what the other one changes, so they are applied in the same pass
+			if (hue && saturation)
+			{
+				for (src = srcRow; src < srcEnd; src += srcBpp)
+				{
+					_rotatePixelHue(src, sr, sg, sb, offset);
+					_saturatePixel(src, sr, sg, sb, factor);
 				}
 			}
+			else if (hue)
+			{
+				for (src = srcRow; src < srcEnd; src += srcBpp)
+				{
+					_rotatePixelHue(src, sr, sg, sb, offset);
+				}
+			}
+			else
+			{
+				for (src = srcRow; src < srcEnd; src += srcBpp)
+				{
+					_saturatePixel(src, sr, sg, sb, factor);
+				}
+			}
+			srcRow += srcStride;
+		}
+		return true;
+	}
+
+	bool Image::invert(int x, int y, int w, int h, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
+		{
+			return false;
+		}
+		if (_isParallel(w, h))
+		{
+			ImageBandData band;
+			band.sx = x;
+			band.sy = y;
+			band.sw = w;
+			band.srcData = srcData;
+			band.srcWidth = srcWidth;
+			band.srcHeight = srcHeight;
+			band.srcFormat = srcFormat;
+			band.result = true;
+			WorkerPool::run(h, &_invertBand, &band);
+			return band.result;
+		}
+		int srcBpp = srcFormat.getBpp();
+		int srcStride = srcWidth * srcBpp;
+		unsigned char* srcRow = &srcData[(x + y * srcWidth) * srcBpp];
+		if (srcBpp == 4)
+		{
+			// the color channels of a whole pixel are inverted at once, alpha and the padding byte of X formats stay untouched
+			int sa = 0;
+			srcFormat.getChannelIndices(NULL, NULL, NULL, &sa);
+			unsigned char maskBytes[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+			maskBytes[sa] = 0;
+			unsigned int mask = 0;
+			memcpy(&mask, maskBytes, 4);
+			unsigned int* src = NULL;
+			for_iter (j, 0, h)
+			{
+				src = (unsigned int*)srcRow;
+				for_iter (i, 0, w)
+				{
+					src[i] ^= mask;
+				}
+				srcRow += srcStride;
+			}
 			return true;
 		}
-		return false;
+		// all channels are color channels
+		int rowSize = w * srcBpp;
+		for_iter (j, 0, h)
+		{
+			for_iter (i, 0, rowSize)
+			{
+				srcRow[i] ^= 0xFF;
+			}
+			srcRow += srcStride;
+		}
+		return true;
 	}
 
-	bool Image::dilate(unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Image::Format destFormat)
+#ifdef BLIT_SSE2
+	// premultiplies 4 pixels at a time, returns how many pixels were processed
+	static int _premultiplyRow4Bpp(unsigned char* src, int count, int sa)
 	{
-		if (destData == NULL || destWidth * destHeight == 0)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi32(0xFF);
+		const __m128i round = _mm_set1_epi16(128);
+		const __m128i alphaMask = _mm_set1_epi32(0xFF << (sa * 8));
+		__m128i s;
+		__m128i a;
+		__m128i a8;
+		__m128i lo;
+		__m128i hi;
+		int mask = 0;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16)
+		{
+			s = _mm_loadu_si128((__m128i*)src);
+			a = _mm_and_si128(_mm_srli_epi32(s, sa * 8), full);
+			mask = _mm_movemask_epi8(_mm_cmpeq_epi32(a, full));
+			if (mask == 0xFFFF) // opaque span
+			{
+				continue;
+			}
+			mask = _mm_movemask_epi8(_mm_cmpeq_epi32(a, zero));
+			if (mask == 0xFFFF) // transparent span
+			{
+				_mm_storeu_si128((__m128i*)src, zero);
+				continue;
+			}
+			// spreads alpha to all color channels while the alpha channel is multiplied with 255 so it stays the same
+			a8 = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+			a8 = _mm_or_si128(_mm_or_si128(a8, _mm_slli_epi32(a8, 16)), alphaMask);
+			lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(a8, zero)), round);
+			hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(a8, zero)), round);
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+			_mm_storeu_si128((__m128i*)src, _mm_packus_epi16(lo, hi));
+		}
+		return x;
+	}
+
+	// calculates (x * 255 + a / 2) / a like the scalar path, all values stay below 2^24 so they are exact as floats
+	static inline __m128i _unpremultiplyPixel(__m128i pixel, unsigned int a, __m128i alphaMask)
+	{
+		if (a == 0 || a == 255)
+		{
+			return pixel;
+		}
+		const __m128 one = _mm_set1_ps(1.0f);
+		__m128 alpha = _mm_set1_ps((float)a);
+		__m128 n = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(pixel), _mm_set1_ps(255.0f)), _mm_set1_ps((float)(a / 2)));
+		__m128 q = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(n, _mm_set1_ps(1.0f / a))));
+		// the rounded reciprocal can make the quotient off by one so it's fixed up exactly
+		q = _mm_add_ps(q, _mm_and_ps(_mm_cmple_ps(_mm_mul_ps(_mm_add_ps(q, one), alpha), n), one));
+		q = _mm_sub_ps(q, _mm_and_ps(_mm_cmpgt_ps(_mm_mul_ps(q, alpha), n), one));
+		return _mm_or_si128(_mm_andnot_si128(alphaMask, _mm_cvttps_epi32(q)), _mm_and_si128(alphaMask, pixel));
+	}
+
+	// unpremultiplies 4 pixels at a time, returns how many pixels were processed
+	static int _unpremultiplyRow4Bpp(unsigned char* src, int count, int sa)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi32(0xFF);
+		int alphaLanes[4] = {0, 0, 0, 0};
+		alphaLanes[sa] = -1;
+		const __m128i alphaMask = _mm_loadu_si128((__m128i*)alphaLanes);
+		__m128i s;
+		__m128i a;
+		__m128i lo;
+		__m128i hi;
+		int mask = 0;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16)
+		{
+			s = _mm_loadu_si128((__m128i*)src);
+			a = _mm_and_si128(_mm_srli_epi32(s, sa * 8), full);
+			mask = _mm_movemask_epi8(_mm_cmpeq_epi32(a, full));
+			if (mask == 0xFFFF || _mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xFFFF) // opaque or transparent span
+			{
+				continue;
+			}
+			lo = _mm_unpacklo_epi8(s, zero);
+			hi = _mm_unpackhi_epi8(s, zero);
+			// the color channels are saturated when packed back
+			lo = _mm_packs_epi32(_unpremultiplyPixel(_mm_unpacklo_epi16(lo, zero), src[sa], alphaMask),
+				_unpremultiplyPixel(_mm_unpackhi_epi16(lo, zero), src[sa + 4], alphaMask));
+			hi = _mm_packs_epi32(_unpremultiplyPixel(_mm_unpacklo_epi16(hi, zero), src[sa + 8], alphaMask),
+				_unpremultiplyPixel(_mm_unpackhi_epi16(hi, zero), src[sa + 12], alphaMask));
+			_mm_storeu_si128((__m128i*)src, _mm_packus_epi16(lo, hi));
+		}
+		return x;
+	}
+#elif defined(BLIT_NEON)
+	// premultiplies 4 pixels at a time, returns how many pixels were processed
+	static int _premultiplyRow4Bpp(unsigned char* src, int count, int sa)
+	{
+		const uint32x4_t full = vdupq_n_u32(0xFF);
+		const uint8x16_t alphaMask = vreinterpretq_u8_u32(vdupq_n_u32(0xFF << (sa * 8)));
+		uint8x16_t s;
+		uint32x4_t a;
+		uint32x2_t check;
+		uint8x16_t a8;
+		uint16x8_t lo;
+		uint16x8_t hi;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16)
+		{
+			s = vld1q_u8(src);
+			a = vandq_u32(vshlq_u32(vreinterpretq_u32_u8(s), vdupq_n_s32(-sa * 8)), full);
+			check = vand_u32(vget_low_u32(a), vget_high_u32(a));
+			if ((vget_lane_u32(check, 0) & vget_lane_u32(check, 1)) == 0xFF) // opaque span
+			{
+				continue;
+			}
+			check = vorr_u32(vget_low_u32(a), vget_high_u32(a));
+			if ((vget_lane_u32(check, 0) | vget_lane_u32(check, 1)) == 0) // transparent span
+			{
+				vst1q_u8(src, vdupq_n_u8(0));
+				continue;
+			}
+			// spreads alpha to all color channels while the alpha channel is multiplied with 255 so it stays the same
+			a8 = vorrq_u8(vreinterpretq_u8_u32(vmulq_n_u32(a, 0x01010101)), alphaMask);
+			lo = vaddq_u16(vmull_u8(vget_low_u8(s), vget_low_u8(a8)), vdupq_n_u16(128));
+			hi = vaddq_u16(vmull_u8(vget_high_u8(s), vget_high_u8(a8)), vdupq_n_u16(128));
+			lo = vsraq_n_u16(lo, lo, 8);
+			hi = vsraq_n_u16(hi, hi, 8);
+			vst1q_u8(src, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+		}
+		return x;
+	}
+
+	// calculates (x * 255 + a / 2) / a like the scalar path
+	static inline uint16x4_t _unpremultiplyPixel(uint16x4_t pixel, unsigned int a, uint32x4_t alphaMask)
+	{
+		if (a == 0 || a == 255)
+		{
+			return pixel;
+		}
+		uint32x4_t p = vmovl_u16(pixel);
+		uint32x4_t n = vmlaq_n_u32(vdupq_n_u32(a / 2), p, 255);
+		uint32x4_t q = vcvtq_u32_f32(vmulq_n_f32(vcvtq_f32_u32(n), 1.0f / a));
+		// the rounded reciprocal can make the quotient off by one so it's fixed up exactly
+		q = vaddq_u32(q, vshrq_n_u32(vcleq_u32(vmulq_n_u32(vaddq_u32(q, vdupq_n_u32(1)), a), n), 31));
+		q = vsubq_u32(q, vshrq_n_u32(vcgtq_u32(vmulq_n_u32(q, a), n), 31));
+		return vqmovn_u32(vbslq_u32(alphaMask, p, q));
+	}
+
+	// unpremultiplies 4 pixels at a time, returns how many pixels were processed
+	static int _unpremultiplyRow4Bpp(unsigned char* src, int count, int sa)
+	{
+		const uint32x4_t full = vdupq_n_u32(0xFF);
+		unsigned int alphaLanes[4] = {0, 0, 0, 0};
+		alphaLanes[sa] = 0xFFFFFFFF;
+		const uint32x4_t alphaMask = vld1q_u32(alphaLanes);
+		uint8x16_t s;
+		uint32x4_t a;
+		uint32x2_t check;
+		uint16x8_t lo;
+		uint16x8_t hi;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, src += 16)
+		{
+			s = vld1q_u8(src);
+			a = vandq_u32(vshlq_u32(vreinterpretq_u32_u8(s), vdupq_n_s32(-sa * 8)), full);
+			check = vand_u32(vget_low_u32(a), vget_high_u32(a));
+			if ((vget_lane_u32(check, 0) & vget_lane_u32(check, 1)) == 0xFF) // opaque span
+			{
+				continue;
+			}
+			check = vorr_u32(vget_low_u32(a), vget_high_u32(a));
+			if ((vget_lane_u32(check, 0) | vget_lane_u32(check, 1)) == 0) // transparent span
+			{
+				continue;
+			}
+			lo = vmovl_u8(vget_low_u8(s));
+			hi = vmovl_u8(vget_high_u8(s));
+			// the color channels are saturated when narrowed back
+			lo = vcombine_u16(_unpremultiplyPixel(vget_low_u16(lo), src[sa], alphaMask),
+				_unpremultiplyPixel(vget_high_u16(lo), src[sa + 4], alphaMask));
+			hi = vcombine_u16(_unpremultiplyPixel(vget_low_u16(hi), src[sa + 8], alphaMask),
+				_unpremultiplyPixel(vget_high_u16(hi), src[sa + 12], alphaMask));
+			vst1q_u8(src, vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)));
+		}
+		return x;
+	}
+#endif
+
+	bool Image::premultiplyAlpha(int x, int y, int w, int h, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
 		{
 			return false;
 		}
-		// both images must be single-channel 8-bit images, currently other formats are not supported
-		if ((srcFormat != Format::Alpha && srcFormat != Format::Greyscale) || (destFormat != Format::Alpha && destFormat != Format::Greyscale))
+		// without an alpha channel every pixel is opaque
+		if (!CHECK_ALPHA_FORMAT(srcFormat))
+		{
+			return (srcFormat != Format::Compressed && srcFormat != Format::Palette);
+		}
+		if (_isParallel(w, h))
+		{
+			ImageBandData band;
+			band.sx = x;
+			band.sy = y;
+			band.sw = w;
+			band.srcData = srcData;
+			band.srcWidth = srcWidth;
+			band.srcHeight = srcHeight;
+			band.srcFormat = srcFormat;
+			band.result = true;
+			WorkerPool::run(h, &_premultiplyAlphaBand, &band);
+			return band.result;
+		}
+		int sr = 0;
+		int sg = 0;
+		int sb = 0;
+		int sa = 0;
+		srcFormat.getChannelIndices(&sr, &sg, &sb, &sa);
+		int srcStride = srcWidth * 4;
+		unsigned char* srcRow = &srcData[(x + y * srcWidth) * 4];
+		unsigned char* src = NULL;
+		unsigned int a = 0;
+		int i = 0;
+		for_iter (j, 0, h)
+		{
+			i = 0;
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+			i = _premultiplyRow4Bpp(srcRow, w, sa);
+#endif
+			for (src = &srcRow[i * 4]; i < w; ++i, src += 4)
+			{
+				a = src[sa];
+				if (a < 255)
+				{
+					src[sr] = _div255(src[sr] * a);
+					src[sg] = _div255(src[sg] * a);
+					src[sb] = _div255(src[sb] * a);
+				}
+			}
+			srcRow += srcStride;
+		}
+		return true;
+	}
+
+	bool Image::unpremultiplyAlpha(int x, int y, int w, int h, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
 		{
 			return false;
 		}
-		if (srcWidth % 2 == 0 || srcHeight % 2 == 0) // has to have odd-numbered dimensions with a central pixel
+		// without an alpha channel every pixel is opaque
+		if (!CHECK_ALPHA_FORMAT(srcFormat))
+		{
+			return (srcFormat != Format::Compressed && srcFormat != Format::Palette);
+		}
+		if (_isParallel(w, h))
+		{
+			ImageBandData band;
+			band.sx = x;
+			band.sy = y;
+			band.sw = w;
+			band.srcData = srcData;
+			band.srcWidth = srcWidth;
+			band.srcHeight = srcHeight;
+			band.srcFormat = srcFormat;
+			band.result = true;
+			WorkerPool::run(h, &_unpremultiplyAlphaBand, &band);
+			return band.result;
+		}
+		int sr = 0;
+		int sg = 0;
+		int sb = 0;
+		int sa = 0;
+		srcFormat.getChannelIndices(&sr, &sg, &sb, &sa);
+		int srcStride = srcWidth * 4;
+		unsigned char* srcRow = &srcData[(x + y * srcWidth) * 4];
+		unsigned char* src = NULL;
+		unsigned int a = 0;
+		unsigned int half = 0;
+		int i = 0;
+		for_iter (j, 0, h)
+		{
+			i = 0;
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+			i = _unpremultiplyRow4Bpp(srcRow, w, sa);
+#endif
+			for (src = &srcRow[i * 4]; i < w; ++i, src += 4)
+			{
+				a = src[sa];
+				if (a > 0 && a < 255)
+				{
+					half = a / 2;
+					src[sr] = (unsigned char)hmin((src[sr] * 255 + half) / a, 255U);
+					src[sg] = (unsigned char)hmin((src[sg] * 255 + half) / a, 255U);
+					src[sb] = (unsigned char)hmin((src[sb] * 255 + half) / a, 255U);
+				}
+			}
+			srcRow += srcStride;
+		}
+		return true;
+	}
+
+	static void _makeColorTable(unsigned char* table, float factor, float offset)
+	{
+		for_iter (i, 0, 256)
+		{
+			table[i] = (unsigned char)hclamp((int)(offset + 0.5f + factor * i), 0, 255);
+		}
+	}
+
+	static inline void _applyColorMatrix(unsigned char* pixel, int sr, int sg, int sb, const float* m)
+	{
+		float r = (float)pixel[sr];
+		float g = (float)pixel[sg];
+		float b = (float)pixel[sb];
+		pixel[sr] = (unsigned char)hclamp((int)(m[3] + 0.5f + m[0] * r + m[1] * g + m[2] * b), 0, 255);
+		pixel[sg] = (unsigned char)hclamp((int)(m[7] + 0.5f + m[4] * r + m[5] * g + m[6] * b), 0, 255);
+		pixel[sb] = (unsigned char)hclamp((int)(m[11] + 0.5f + m[8] * r + m[9] * g + m[10] * b), 0, 255);
+	}
+
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+	// rearranges the matrix into one column per byte of a 4 BPP pixel and a rounding offset, the 4th byte is kept as it is
+	static void _makeColorMatrixColumns(const float* m, int sr, int sg, int sb, float* columns)
+	{
+		int sa = 6 - sr - sg - sb;
+		memset(columns, 0, sizeof(float) * 20);
+		int indices[3] = {sr, sg, sb};
+		for_iter (i, 0, 3)
+		{
+			for_iter (j, 0, 3)
+			{
+				columns[indices[j] * 4 + indices[i]] = m[i * 4 + j];
+			}
+			columns[16 + indices[i]] = m[i * 4 + 3] + 0.5f;
+		}
+		columns[sa * 4 + sa] = 1.0f;
+		columns[16 + sa] = 0.5f;
+	}
+#endif
+
+#ifdef BLIT_SSE2
+	static inline __m128i _transformColor(__m128i pixel, const __m128* columns)
+	{
+		__m128 value = _mm_cvtepi32_ps(pixel);
+		__m128 result = _mm_add_ps(columns[4], _mm_mul_ps(columns[0], _mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 0, 0, 0))));
+		result = _mm_add_ps(result, _mm_mul_ps(columns[1], _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1))));
+		result = _mm_add_ps(result, _mm_mul_ps(columns[2], _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2))));
+		result = _mm_add_ps(result, _mm_mul_ps(columns[3], _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3))));
+		return _mm_cvttps_epi32(result);
+	}
+
+	// transforms 4 pixels at a time, returns how many pixels were processed
+	static int _applyColorMatrixRow4Bpp(unsigned char* data, int count, const float* values)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128 columns[5];
+		for_iter (i, 0, 5)
+		{
+			columns[i] = _mm_loadu_ps(&values[i * 4]);
+		}
+		__m128i pixels;
+		__m128i low;
+		__m128i high;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, data += 16)
+		{
+			pixels = _mm_loadu_si128((const __m128i*)data);
+			low = _mm_unpacklo_epi8(pixels, zero);
+			high = _mm_unpackhi_epi8(pixels, zero);
+			// saturating packs clamp the results to 0-255
+			low = _mm_packs_epi32(_transformColor(_mm_unpacklo_epi16(low, zero), columns), _transformColor(_mm_unpackhi_epi16(low, zero), columns));
+			high = _mm_packs_epi32(_transformColor(_mm_unpacklo_epi16(high, zero), columns), _transformColor(_mm_unpackhi_epi16(high, zero), columns));
+			_mm_storeu_si128((__m128i*)data, _mm_packus_epi16(low, high));
+		}
+		return x;
+	}
+#elif defined(BLIT_NEON)
+	static inline uint16x4_t _transformColor(uint16x4_t pixel, const float32x4_t* columns)
+	{
+		float32x4_t value = vcvtq_f32_u32(vmovl_u16(pixel));
+		float32x4_t result = vmlaq_lane_f32(columns[4], columns[0], vget_low_f32(value), 0);
+		result = vmlaq_lane_f32(result, columns[1], vget_low_f32(value), 1);
+		result = vmlaq_lane_f32(result, columns[2], vget_high_f32(value), 0);
+		result = vmlaq_lane_f32(result, columns[3], vget_high_f32(value), 1);
+		// negative values are converted to 0 and saturating narrowing clamps to 255 afterwards
+		return vqmovn_u32(vcvtq_u32_f32(result));
+	}
+
+	// transforms 4 pixels at a time, returns how many pixels were processed
+	static int _applyColorMatrixRow4Bpp(unsigned char* data, int count, const float* values)
+	{
+		float32x4_t columns[5];
+		for_iter (i, 0, 5)
+		{
+			columns[i] = vld1q_f32(&values[i * 4]);
+		}
+		uint8x16_t pixels;
+		uint16x8_t low;
+		uint16x8_t high;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, data += 16)
+		{
+			pixels = vld1q_u8(data);
+			low = vmovl_u8(vget_low_u8(pixels));
+			high = vmovl_u8(vget_high_u8(pixels));
+			low = vcombine_u16(_transformColor(vget_low_u16(low), columns), _transformColor(vget_high_u16(low), columns));
+			high = vcombine_u16(_transformColor(vget_low_u16(high), columns), _transformColor(vget_high_u16(high), columns));
+			vst1q_u8(data, vcombine_u8(vqmovn_u16(low), vqmovn_u16(high)));
+		}
+		return x;
+	}
+#endif
+
+	bool Image::applyColorMatrix(int x, int y, int w, int h, const ColorMatrix& matrix, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat)
+	{
+		if (!Image::correctRect(x, y, w, h, srcWidth, srcHeight))
 		{
 			return false;
 		}
-		Image* original = Image::create(destWidth, destHeight, destData, destFormat);
-		unsigned char* originalData = original->data;
-		if (originalData == NULL)
+		int srcBpp = srcFormat.getBpp();
+		if (srcBpp != 1 && srcBpp != 3 && srcBpp != 4)
 		{
-			delete original;
 			return false;
 		}
-		memset(destData, 0, destWidth * destHeight * destFormat.getBpp());
+		if (matrix.isIdentity())
+		{
+			return true;
+		}
+		const float* m = matrix.data;
+		int srcStride = srcWidth * srcBpp;
+		unsigned char* srcRow = &srcData[(x + y * srcWidth) * srcBpp];
+		unsigned char* src = NULL;
+		unsigned char* srcEnd = NULL;
+		if (srcBpp == 1)
+		{
+			// red, green and blue are the same in greyscale
+			unsigned char table[256];
+			_makeColorTable(table, m[0] + m[1] + m[2], m[3]);
+			for_iter (j, 0, h)
+			{
+				srcEnd = srcRow + w;
+				for (src = srcRow; src < srcEnd; ++src)
+				{
+					*src = table[*src];
+				}
+				srcRow += srcStride;
+			}
+			return true;
+		}
+		int sr = -1;
+		int sg = -1;
+		int sb = -1;
+		srcFormat.getChannelIndices(&sr, &sg, &sb, NULL);
+		if (matrix.isSeparable())
+		{
+			unsigned char tables[3][256];
+			_makeColorTable(tables[0], m[0], m[3]);
+			_makeColorTable(tables[1], m[5], m[7]);
+			_makeColorTable(tables[2], m[10], m[11]);
+			for_iter (j, 0, h)
+			{
+				srcEnd = srcRow + w * srcBpp;
+				for (src = srcRow; src < srcEnd; src += srcBpp)
+				{
+					src[sr] = tables[0][src[sr]];
+					src[sg] = tables[1][src[sg]];
+					src[sb] = tables[2][src[sb]];
+				}
+				srcRow += srcStride;
+			}
+			return true;
+		}
+		int i = 0;
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+		float columns[20];
+		if (srcBpp == 4)
+		{
+			_makeColorMatrixColumns(m, sr, sg, sb, columns);
+		}
+#endif
+		for_iter (j, 0, h)
+		{
+			i = 0;
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+			if (srcBpp == 4)
+			{
+				i = _applyColorMatrixRow4Bpp(srcRow, w, columns);
+			}
+#endif
+			srcEnd = srcRow + w * srcBpp;
+			for (src = srcRow + i * srcBpp; src < srcEnd; src += srcBpp)
+			{
+				_applyColorMatrix(src, sr, sg, sb, m);
+			}
+			srcRow += srcStride;
+		}
+		return true;
+	}
+
+	bool Image::insertAlphaMap(int w, int h, unsigned char* srcData, Image::Format srcFormat, unsigned char* destData, Image::Format destFormat, unsigned char median, int ambiguity)
+	{
+		if (!CHECK_ALPHA_FORMAT(destFormat)) // not a format that supports an alpha channel
+		{
+			return false;
+		}
+		int srcBpp = srcFormat.getBpp();
+		if (srcBpp == 1 || srcBpp == 3 || srcBpp == 4)
+		{
+			int destBpp = destFormat.getBpp();
+			int sr = -1;
+			srcFormat.getChannelIndices(&sr, NULL, NULL, NULL);
+			int da = -1;
+			destFormat.getChannelIndices(NULL, NULL, NULL, &da);
+			// the alpha value only depends on the red channel so it can be looked up
+			unsigned char table[256];
+			if (ambiguity == 0)
+			{
+				for_iter (i, 0, 256)
+				{
+					table[i] = i;
+				}
+			}
+			else
+			{
+				int min = (int)median - ambiguity / 2;
+				int max = (int)median + ambiguity / 2;
+				for_iter (i, 0, 256)
+				{
+					if (i < min)
+					{
+						table[i] = 255;
+					}
+					else if (i >= max)
+					{
+						table[i] = 0;
+					}
+					else
+					{
+						table[i] = (max - i) * 255 / ambiguity;
+					}
+				}
+			}
+			unsigned char* src = &srcData[sr];
+			unsigned char* dest = &destData[da];
+			int size = w * h;
+			for_iter (i, 0, size)
+			{
+				*dest = table[*src];
+				src += srcBpp;
+				dest += destBpp;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	struct ImageDilateData
+	{
+		unsigned char* srcData;
+		int srcWidth;
+		int srcHeight;
+		unsigned char* originalData;
+		unsigned char* destData;
+		int destWidth;
+		int destHeight;
+	};
+
+	static void _dilateRows(void* data, int start, int end)
+	{
+		ImageDilateData* dilate = (ImageDilateData*)data;
+		unsigned char* srcData = dilate->srcData;
+		int srcWidth = dilate->srcWidth;
+		int srcHeight = dilate->srcHeight;
+		unsigned char* originalData = dilate->originalData;
+		unsigned char* destData = dilate->destData;
+		int destWidth = dilate->destWidth;
+		int destHeight = dilate->destHeight;
 		int i = 0;
 		int j = 0;
 		int m = 0;
@@ -1990,7 +3388,7 @@ namespace april
 		int index = 0;
 		int indexSrc = 0;
 		int indexOriginal = 0;
-		for_iterx (j, 0, destHeight)
+		for_iterx (j, start, end)
 		{
 			for_iterx (i, 0, destWidth)
 			{
@@ -2027,10 +3425,239 @@ namespace april
 				}
 			}
 		}
+	}
+
+	bool Image::dilate(unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat, unsigned char* destData, int destWidth, int destHeight, Image::Format destFormat)
+	{
+		if (destData == NULL || destWidth * destHeight == 0)
+		{
+			return false;
+		}
+		// both images must be single-channel 8-bit images, currently other formats are not supported
+		if ((srcFormat != Format::Alpha && srcFormat != Format::Greyscale) || (destFormat != Format::Alpha && destFormat != Format::Greyscale))
+		{
+			return false;
+		}
+		if (srcWidth % 2 == 0 || srcHeight % 2 == 0) // has to have odd-numbered dimensions with a central pixel
+		{
+			return false;
+		}
+		Image* original = Image::create(destWidth, destHeight, destData, destFormat);
+		unsigned char* originalData = original->data;
+		if (originalData == NULL)
+		{
+			delete original;
+			return false;
+		}
+		memset(destData, 0, destWidth * destHeight * destFormat.getBpp());
+		ImageDilateData dilate;
+		dilate.srcData = srcData;
+		dilate.srcWidth = srcWidth;
+		dilate.srcHeight = srcHeight;
+		dilate.originalData = originalData;
+		dilate.destData = destData;
+		dilate.destWidth = destWidth;
+		dilate.destHeight = destHeight;
+		if (_isParallel(destWidth, destHeight))
+		{
+			WorkerPool::run(destHeight, &_dilateRows, &dilate);
+		}
+		else
+		{
+			_dilateRows(&dilate, 0, destHeight);
+		}
 		delete original;
 		return true;
 	}
 
+	int Image::getMipmapLevelCount(int w, int h)
+	{
+		if (w <= 0 || h <= 0)
+		{
+			return 0;
+		}
+		int result = 1;
+		while (w > 1 || h > 1)
+		{
+			w = hmax(w / 2, 1);
+			h = hmax(h / 2, 1);
+			++result;
+		}
+		return result;
+	}
+
+	int Image::getMipmapsByteSize(int w, int h, Image::Format format)
+	{
+		if (w <= 0 || h <= 0)
+		{
+			return 0;
+		}
+		int bpp = format.getBpp();
+		int result = 0;
+		while (w > 1 || h > 1)
+		{
+			w = hmax(w / 2, 1);
+			h = hmax(h / 2, 1);
+			result += w * h * bpp;
+		}
+		return result;
+	}
+
+	// averages 4 pixels with all 4 channels at once by processing 2 channels in each 16-bit half of a 32-bit integer
+	static inline unsigned int _averageMipmapPixels(unsigned int p0, unsigned int p1, unsigned int p2, unsigned int p3)
+	{
+		unsigned int low = (p0 & 0x00FF00FF) + (p1 & 0x00FF00FF) + (p2 & 0x00FF00FF) + (p3 & 0x00FF00FF) + 0x00020002;
+		unsigned int high = ((p0 >> 8) & 0x00FF00FF) + ((p1 >> 8) & 0x00FF00FF) + ((p2 >> 8) & 0x00FF00FF) + ((p3 >> 8) & 0x00FF00FF) + 0x00020002;
+		return (((low >> 2) & 0x00FF00FF) | (((high >> 2) & 0x00FF00FF) << 8));
+	}
+
+#ifdef BLIT_SSE2
+	// averages 4 destination pixels at a time from 2 source rows, returns how many pixels were processed
+	static int _createMipmapRow4Bpp(const unsigned char* row0, const unsigned char* row1, unsigned char* dest, int count)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi16(2);
+		__m128i top;
+		__m128i bottom;
+		__m128i sums0;
+		__m128i sums1;
+		__m128i lo;
+		__m128i hi;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, row0 += 32, row1 += 32, dest += 16)
+		{
+			// vertical sums of 2 source pixels per register, neighbouring pixels are then added from the register halves
+			top = _mm_loadu_si128((__m128i*)row0);
+			bottom = _mm_loadu_si128((__m128i*)row1);
+			sums0 = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+			sums1 = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+			lo = _mm_add_epi16(_mm_unpacklo_epi64(sums0, sums1), _mm_unpackhi_epi64(sums0, sums1));
+			top = _mm_loadu_si128((__m128i*)(row0 + 16));
+			bottom = _mm_loadu_si128((__m128i*)(row1 + 16));
+			sums0 = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+			sums1 = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+			hi = _mm_add_epi16(_mm_unpacklo_epi64(sums0, sums1), _mm_unpackhi_epi64(sums0, sums1));
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 2);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 2);
+			_mm_storeu_si128((__m128i*)dest, _mm_packus_epi16(lo, hi));
+		}
+		return x;
+	}
+#elif defined(BLIT_NEON)
+	// averages 4 destination pixels at a time from 2 source rows, returns how many pixels were processed
+	static int _createMipmapRow4Bpp(const unsigned char* row0, const unsigned char* row1, unsigned char* dest, int count)
+	{
+		uint8x16_t top;
+		uint8x16_t bottom;
+		uint16x8_t sums0;
+		uint16x8_t sums1;
+		uint16x8_t lo;
+		uint16x8_t hi;
+		int x = 0;
+		for (; x + 4 <= count; x += 4, row0 += 32, row1 += 32, dest += 16)
+		{
+			// vertical sums of 2 source pixels per register, neighbouring pixels are then added from the register halves
+			top = vld1q_u8(row0);
+			bottom = vld1q_u8(row1);
+			sums0 = vaddl_u8(vget_low_u8(top), vget_low_u8(bottom));
+			sums1 = vaddl_u8(vget_high_u8(top), vget_high_u8(bottom));
+			lo = vcombine_u16(vadd_u16(vget_low_u16(sums0), vget_high_u16(sums0)), vadd_u16(vget_low_u16(sums1), vget_high_u16(sums1)));
+			top = vld1q_u8(row0 + 16);
+			bottom = vld1q_u8(row1 + 16);
+			sums0 = vaddl_u8(vget_low_u8(top), vget_low_u8(bottom));
+			sums1 = vaddl_u8(vget_high_u8(top), vget_high_u8(bottom));
+			hi = vcombine_u16(vadd_u16(vget_low_u16(sums0), vget_high_u16(sums0)), vadd_u16(vget_low_u16(sums1), vget_high_u16(sums1)));
+			// the rounding shift is the same as adding 2 before shifting
+			vst1q_u8(dest, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+		}
+		return x;
+	}
+#endif
+
+	static void _createMipmapLevel(int srcWidth, int srcHeight, unsigned char* srcData, int bpp, int destWidth, int destHeight, unsigned char* destData)
+	{
+		unsigned char* row0 = NULL;
+		unsigned char* row1 = NULL;
+		unsigned int* src0 = NULL;
+		unsigned int* src1 = NULL;
+		unsigned int* dest = NULL;
+		unsigned char* destRow = NULL;
+		int x0 = 0;
+		int x1 = 0;
+		int i = 0;
+		int j = 0;
+		int k = 0;
+		for_iterx (j, 0, destHeight)
+		{
+			// odd sizes reuse the last row or column
+			row0 = &srcData[j * 2 * srcWidth * bpp];
+			row1 = &srcData[hmin(j * 2 + 1, srcHeight - 1) * srcWidth * bpp];
+			if (bpp == 4)
+			{
+				src0 = (unsigned int*)row0;
+				src1 = (unsigned int*)row1;
+				dest = (unsigned int*)&destData[j * destWidth * 4];
+				i = 0;
+#if defined(BLIT_SSE2) || defined(BLIT_NEON)
+				// only destination pixels with 2 source columns are vectorized
+				i = _createMipmapRow4Bpp(row0, row1, (unsigned char*)dest, srcWidth / 2);
+#endif
+				for (; i < destWidth; ++i)
+				{
+					x0 = i * 2;
+					x1 = hmin(x0 + 1, srcWidth - 1);
+					dest[i] = _averageMipmapPixels(src0[x0], src0[x1], src1[x0], src1[x1]);
+				}
+			}
+			else
+			{
+				destRow = &destData[j * destWidth * bpp];
+				for_iterx (i, 0, destWidth)
+				{
+					x0 = i * 2 * bpp;
+					x1 = hmin(i * 2 + 1, srcWidth - 1) * bpp;
+					for_iterx (k, 0, bpp)
+					{
+						destRow[i * bpp + k] = (unsigned char)((row0[x0 + k] + row0[x1 + k] + row1[x0 + k] + row1[x1 + k] + 2) >> 2);
+					}
+				}
+			}
+		}
+	}
+
+	bool Image::createMipmaps(int w, int h, unsigned char* srcData, Image::Format format, unsigned char** destData)
+	{
+		if (srcData == NULL || w <= 0 || h <= 0 || format == Format::Compressed || format == Format::Palette || format == Format::Invalid)
+		{
+			return false;
+		}
+		int size = Image::getMipmapsByteSize(w, h, format);
+		if (size == 0)
+		{
+			return false;
+		}
+		if (*destData == NULL)
+		{
+			*destData = new unsigned char[size];
+		}
+		int bpp = format.getBpp();
+		unsigned char* src = srcData;
+		unsigned char* dest = *destData;
+		int destWidth = 0;
+		int destHeight = 0;
+		while (w > 1 || h > 1)
+		{
+			destWidth = hmax(w / 2, 1);
+			destHeight = hmax(h / 2, 1);
+			_createMipmapLevel(w, h, src, bpp, destWidth, destHeight, dest);
+			src = dest;
+			dest += destWidth * destHeight * bpp;
+			w = destWidth;
+			h = destHeight;
+		}
+		return true;
+	}
+
 	bool Image::convertToFormat(int w, int h, unsigned char* srcData, Image::Format srcFormat, unsigned char** destData, Image::Format destFormat, bool preventCopy)
 	{
 		if (preventCopy && srcFormat == destFormat)
@@ -2043,6 +3670,29 @@ namespace april
 		{
 			return true;
 		}
+		int destBpp = destFormat.getBpp();
+		if ((srcBpp == 1 || srcBpp == 3 || srcBpp == 4) && (destBpp == 1 || destBpp == 3 || destBpp == 4) && _isParallel(w, h))
+		{
+			bool createData = (*destData == NULL);
+			if (createData)
+			{
+				*destData = new unsigned char[w * h * destBpp];
+			}
+			ImageBandData band;
+			band.sw = w;
+			band.srcData = srcData;
+			band.srcFormat = srcFormat;
+			band.destData = *destData;
+			band.destFormat = destFormat;
+			band.result = true;
+			WorkerPool::run(h, &_convertToFormatBand, &band);
+			if (!band.result && createData)
+			{
+				delete[] *destData;
+				*destData = NULL;
+			}
+			return band.result;
+		}
 		if (srcBpp == 1)
 		{
 			if (Image::_convertFrom1Bpp(w, h, srcData, srcFormat, destData, destFormat))
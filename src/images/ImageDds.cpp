@@ -0,0 +1,272 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hsbase.h>
+#include <hltypes/hstring.h>
+
+#include "april.h"
+#include "blockCompression.h"
+#include "Image.h"
+
+#define DDS_FOURCC(a, b, c, d) ((unsigned int)(a) | ((unsigned int)(b) << 8) | ((unsigned int)(c) << 16) | ((unsigned int)(d) << 24))
+#define DDS_HEADER_SIZE 124
+#define DDS_PIXEL_FORMAT_SIZE 32
+#define DDS_HEADER_FLAG_MIPMAP_COUNT 0x20000
+#define DDS_HEADER_CAPS2_VOLUME 0x200000
+#define DDS_PIXEL_FORMAT_ALPHA_PIXELS 0x1
+#define DDS_PIXEL_FORMAT_ALPHA 0x2
+#define DDS_PIXEL_FORMAT_FOURCC 0x4
+#define DDS_PIXEL_FORMAT_RGB 0x40
+#define DDS_PIXEL_FORMAT_LUMINANCE 0x20000
+
+namespace april
+{
+	struct DdsPixelFormat
+	{
+		unsigned int size;
+		unsigned int flags;
+		unsigned int fourCC;
+		unsigned int rgbBitCount;
+		unsigned int rBitMask;
+		unsigned int gBitMask;
+		unsigned int bBitMask;
+		unsigned int aBitMask;
+	};
+
+	struct DdsHeader
+	{
+		char signature[4];
+		unsigned int size;
+		unsigned int flags;
+		unsigned int height;
+		unsigned int width;
+		unsigned int pitchOrLinearSize;
+		unsigned int depth;
+		unsigned int mipMapCount;
+		unsigned int reserved1[11];
+		DdsPixelFormat pixelFormat;
+		unsigned int caps;
+		unsigned int caps2;
+		unsigned int caps3;
+		unsigned int caps4;
+		unsigned int reserved2;
+	};
+
+	struct DdsHeaderDx10
+	{
+		unsigned int dxgiFormat;
+		unsigned int resourceDimension;
+		unsigned int miscFlag;
+		unsigned int arraySize;
+		unsigned int miscFlags2;
+	};
+
+	// DXGI formats that can be used, block compressed ones are mapped to their OpenGL equivalents
+	struct DdsDxgiFormat
+	{
+		unsigned int dxgiFormat;
+		unsigned int internalFormat;
+		Image::Format format;
+	};
+
+	static const DdsDxgiFormat ddsDxgiFormats[] =
+	{
+		{28, 0, Image::Format::RGBA}, // DXGI_FORMAT_R8G8B8A8_UNORM
+		{29, 0, Image::Format::RGBA}, // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+		{61, 0, Image::Format::Greyscale}, // DXGI_FORMAT_R8_UNORM
+		{65, 0, Image::Format::Alpha}, // DXGI_FORMAT_A8_UNORM
+		{71, APRIL_COMPRESSED_BC1_RGBA, Image::Format::Compressed}, // DXGI_FORMAT_BC1_UNORM
+		{72, APRIL_COMPRESSED_BC1_SRGB_ALPHA, Image::Format::Compressed}, // DXGI_FORMAT_BC1_UNORM_SRGB
+		{74, APRIL_COMPRESSED_BC2, Image::Format::Compressed}, // DXGI_FORMAT_BC2_UNORM
+		{75, APRIL_COMPRESSED_BC2_SRGB, Image::Format::Compressed}, // DXGI_FORMAT_BC2_UNORM_SRGB
+		{77, APRIL_COMPRESSED_BC3, Image::Format::Compressed}, // DXGI_FORMAT_BC3_UNORM
+		{78, APRIL_COMPRESSED_BC3_SRGB, Image::Format::Compressed}, // DXGI_FORMAT_BC3_UNORM_SRGB
+		{87, 0, Image::Format::BGRA}, // DXGI_FORMAT_B8G8R8A8_UNORM
+		{88, 0, Image::Format::BGRX}, // DXGI_FORMAT_B8G8R8X8_UNORM
+		{91, 0, Image::Format::BGRA}, // DXGI_FORMAT_B8G8R8A8_UNORM_SRGB
+		{93, 0, Image::Format::BGRX} // DXGI_FORMAT_B8G8R8X8_UNORM_SRGB
+	};
+
+	static bool _getDdsLegacyFormat(const DdsPixelFormat& pixelFormat, unsigned int& internalFormat, Image::Format& format)
+	{
+		if ((pixelFormat.flags & DDS_PIXEL_FORMAT_FOURCC) != 0)
+		{
+			switch (pixelFormat.fourCC)
+			{
+			case DDS_FOURCC('D', 'X', 'T', '1'):
+				internalFormat = APRIL_COMPRESSED_BC1_RGBA;
+				break;
+			case DDS_FOURCC('D', 'X', 'T', '2'): // premultiplied alpha is loaded as is
+			case DDS_FOURCC('D', 'X', 'T', '3'):
+				internalFormat = APRIL_COMPRESSED_BC2;
+				break;
+			case DDS_FOURCC('D', 'X', 'T', '4'): // premultiplied alpha is loaded as is
+			case DDS_FOURCC('D', 'X', 'T', '5'):
+				internalFormat = APRIL_COMPRESSED_BC3;
+				break;
+			default:
+				return false;
+			}
+			format = Image::Format::Compressed;
+			return true;
+		}
+		bool alpha = ((pixelFormat.flags & DDS_PIXEL_FORMAT_ALPHA_PIXELS) != 0);
+		if ((pixelFormat.flags & DDS_PIXEL_FORMAT_RGB) != 0)
+		{
+			if (pixelFormat.rgbBitCount == 32 && pixelFormat.rBitMask == 0x000000FF && pixelFormat.gBitMask == 0x0000FF00 && pixelFormat.bBitMask == 0x00FF0000)
+			{
+				format = (alpha ? Image::Format::RGBA : Image::Format::RGBX);
+			}
+			else if (pixelFormat.rgbBitCount == 32 && pixelFormat.rBitMask == 0x00FF0000 && pixelFormat.gBitMask == 0x0000FF00 && pixelFormat.bBitMask == 0x000000FF)
+			{
+				format = (alpha ? Image::Format::BGRA : Image::Format::BGRX);
+			}
+			else if (pixelFormat.rgbBitCount == 24 && pixelFormat.rBitMask == 0x000000FF && pixelFormat.gBitMask == 0x0000FF00 && pixelFormat.bBitMask == 0x00FF0000)
+			{
+				format = Image::Format::RGB;
+			}
+			else if (pixelFormat.rgbBitCount == 24 && pixelFormat.rBitMask == 0x00FF0000 && pixelFormat.gBitMask == 0x0000FF00 && pixelFormat.bBitMask == 0x000000FF)
+			{
+				format = Image::Format::BGR;
+			}
+		}
+		else if ((pixelFormat.flags & DDS_PIXEL_FORMAT_LUMINANCE) != 0 && pixelFormat.rgbBitCount == 8 && !alpha)
+		{
+			format = Image::Format::Greyscale;
+		}
+		else if ((pixelFormat.flags & DDS_PIXEL_FORMAT_ALPHA) != 0 && pixelFormat.rgbBitCount == 8)
+		{
+			format = Image::Format::Alpha;
+		}
+		return (format != Image::Format::Invalid);
+	}
+
+	static bool _getDdsDxgiFormat(const DdsHeaderDx10& header, unsigned int& internalFormat, Image::Format& format)
+	{
+		for_iter (i, 0, (int)(sizeof(ddsDxgiFormats) / sizeof(DdsDxgiFormat)))
+		{
+			if (ddsDxgiFormats[i].dxgiFormat == header.dxgiFormat)
+			{
+				internalFormat = ddsDxgiFormats[i].internalFormat;
+				format = ddsDxgiFormats[i].format;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// only the first face or array element is used since all its mipmaps are stored before the next one
+	static Image* _loadDdsFile(hsbase& stream, bool metaDataOnly)
+	{
+		DdsHeader header;
+		if (stream.readRaw(&header, sizeof(DdsHeader)) != sizeof(DdsHeader) || hstr(header.signature, sizeof(header.signature)) != "DDS ")
+		{
+			hlog::error(logTag, "Not a DDS file!");
+			return NULL;
+		}
+		// the signature isn't part of the header size
+		if (header.size != DDS_HEADER_SIZE || header.pixelFormat.size != DDS_PIXEL_FORMAT_SIZE)
+		{
+			hlog::errorf(logTag, "DDS header is invalid! Header size: %d, pixel format size: %d", header.size, header.pixelFormat.size);
+			return NULL;
+		}
+		int width = (int)header.width;
+		int height = (int)header.height;
+		if (width <= 0 || height <= 0)
+		{
+			hlog::error(logTag, "DDS image has no size!");
+			return NULL;
+		}
+		if (!isContainerImageSizeValid(width, height))
+		{
+			hlog::errorf(logTag, "DDS image is too large: %d x %d", width, height);
+			return NULL;
+		}
+		if ((header.caps2 & DDS_HEADER_CAPS2_VOLUME) != 0)
+		{
+			hlog::error(logTag, "DDS volume textures are not supported!");
+			return NULL;
+		}
+		unsigned int internalFormat = 0;
+		Image::Format format = Image::Format::Invalid;
+		if ((header.pixelFormat.flags & DDS_PIXEL_FORMAT_FOURCC) != 0 && header.pixelFormat.fourCC == DDS_FOURCC('D', 'X', '1', '0'))
+		{
+			DdsHeaderDx10 headerDx10;
+			headerDx10.dxgiFormat = 0;
+			if (stream.readRaw(&headerDx10, sizeof(DdsHeaderDx10)) != sizeof(DdsHeaderDx10) || !_getDdsDxgiFormat(headerDx10, internalFormat, format))
+			{
+				hlog::errorf(logTag, "DDS format is not supported! DXGI format: %d", headerDx10.dxgiFormat);
+				return NULL;
+			}
+		}
+		else if (!_getDdsLegacyFormat(header.pixelFormat, internalFormat, format))
+		{
+			hlog::errorf(logTag, "DDS format is not supported! FourCC: 0x%X, bit count: %d", header.pixelFormat.fourCC, header.pixelFormat.rgbBitCount);
+			return NULL;
+		}
+		if (format != Image::Format::Compressed)
+		{
+			Image* image = Image::create(width, height, NULL, format);
+			if (metaDataOnly)
+			{
+				return image;
+			}
+			int size = image->getByteSize();
+			image->data = new unsigned char[size];
+			if (stream.readRaw(image->data, size) != size)
+			{
+				hlog::error(logTag, "DDS data is incomplete!");
+				delete image;
+				return NULL;
+			}
+			return image;
+		}
+		int levelCount = 1;
+		if ((header.flags & DDS_HEADER_FLAG_MIPMAP_COUNT) != 0 && isBlockCompressionSupported(internalFormat))
+		{
+			levelCount = hclamp((int)header.mipMapCount, 1, Image::getMipmapLevelCount(width, height));
+		}
+		int size = getBlockCompressedSize(internalFormat, width, height, levelCount);
+		if (metaDataOnly)
+		{
+			return createBlockCompressedImage(internalFormat, width, height, NULL, size);
+		}
+		// the levels are stored one after another the same way they are uploaded
+		unsigned char* data = new unsigned char[size];
+		if (stream.readRaw(data, size) != size)
+		{
+			hlog::error(logTag, "DDS data is incomplete!");
+			delete[] data;
+			return NULL;
+		}
+		return createBlockCompressedImage(internalFormat, width, height, data, size);
+	}
+
+	Image* Image::_loadDds(hsbase& stream, int size)
+	{
+		return _loadDdsFile(stream, false);
+	}
+
+	Image* Image::_loadDds(hsbase& stream)
+	{
+		return Image::_loadDds(stream, (int)stream.size());
+	}
+
+	Image* Image::_readMetaDataDds(hsbase& stream, int size)
+	{
+		return _loadDdsFile(stream, true);
+	}
+
+	Image* Image::_readMetaDataDds(hsbase& stream)
+	{
+		return Image::_readMetaDataDds(stream, (int)stream.size());
+	}
+
+}
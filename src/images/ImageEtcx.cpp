@@ -6,12 +6,13 @@
 /// This program is free software; you can redistribute it and/or modify it under
 /// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
 
-#ifdef __ANDROID__
 #define __HL_INCLUDE_PLATFORM_HEADERS
 #include <hltypes/hplatform.h>
 
+#include <stdint.h>
 #include <stdio.h>
 
+#include <hltypes/harray.h>
 #include <hltypes/hlog.h>
 #include <hltypes/hltypesUtil.h>
 #include <hltypes/hmutex.h>
@@ -21,13 +22,19 @@
 #include <zlib.h>
 
 #include "april.h"
+#include "blockCompression.h"
+#ifdef __ANDROID__
 #include "OpenGL_RenderSystem.h"
+#endif
 #include "Image.h"
 #include "Platform.h"
+#include "RenderSystem.h"
+#include "WorkerPool.h"
 #include "zlibUtil.h"
 
 #define ETCX_HEADER_HAS_ALPHA_BIT 0x1
 #define ETCX_HEADER_IS_ZLIB_COMPRESSED_BIT 0x2
+#define ETCX_HEADER_IS_ETC2_BIT 0x4
 
 namespace april
 {
@@ -41,6 +48,368 @@ namespace april
 		unsigned int compressedSize;
 	};
 
+	struct EtcDecodeData
+	{
+		unsigned char* srcData;
+		bool etc2;
+		bool alpha;
+		int blocksX;
+		int blocksY;
+		int width;
+		int height;
+		unsigned char* destData;
+		int destBpp;
+		int destIndices[4];
+	};
+
+	static const int etcModifiers[8][4] =
+	{
+		{2, 8, -2, -8},
+		{5, 17, -5, -17},
+		{9, 29, -9, -29},
+		{13, 42, -13, -42},
+		{18, 60, -18, -60},
+		{24, 80, -24, -80},
+		{33, 106, -33, -106},
+		{47, 183, -47, -183}
+	};
+
+	static const int etc2Distances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+	static const int eacModifiers[16][8] =
+	{
+		{-3, -6, -9, -15, 2, 5, 8, 14},
+		{-3, -7, -10, -13, 2, 6, 9, 12},
+		{-2, -5, -8, -13, 1, 4, 7, 12},
+		{-2, -4, -6, -13, 1, 3, 5, 12},
+		{-3, -6, -8, -12, 2, 5, 7, 11},
+		{-3, -7, -9, -11, 2, 6, 8, 10},
+		{-4, -7, -8, -11, 3, 6, 7, 10},
+		{-3, -5, -8, -11, 2, 4, 7, 10},
+		{-2, -6, -8, -10, 1, 5, 7, 9},
+		{-2, -5, -8, -10, 1, 4, 7, 9},
+		{-2, -4, -8, -10, 1, 3, 7, 9},
+		{-2, -5, -7, -10, 1, 4, 6, 9},
+		{-3, -4, -7, -10, 2, 3, 6, 9},
+		{-1, -2, -3, -10, 0, 1, 2, 9},
+		{-4, -6, -8, -9, 3, 5, 7, 8},
+		{-3, -5, -7, -9, 2, 4, 6, 8}
+	};
+
+	static inline unsigned char _clampColor(int value)
+	{
+		return (unsigned char)(value < 0 ? 0 : (value > 255 ? 255 : value));
+	}
+
+	static inline int _extend4(int value)
+	{
+		return (value | (value << 4));
+	}
+
+	static inline int _extend5(int value)
+	{
+		return ((value << 3) | (value >> 2));
+	}
+
+	static inline int _extend6(int value)
+	{
+		return ((value << 2) | (value >> 4));
+	}
+
+	static inline int _extend7(int value)
+	{
+		return ((value << 1) | (value >> 6));
+	}
+
+	// blocks are stored big-endian, pixel indices go column by column
+	static inline uint64_t _readBlock(const unsigned char* data)
+	{
+		return (((uint64_t)data[0] << 56) | ((uint64_t)data[1] << 48) | ((uint64_t)data[2] << 40) | ((uint64_t)data[3] << 32) |
+			((uint64_t)data[4] << 24) | ((uint64_t)data[5] << 16) | ((uint64_t)data[6] << 8) | (uint64_t)data[7]);
+	}
+
+	static inline int _getBits(uint64_t block, int firstBit, int count)
+	{
+		return (int)((block >> firstBit) & ((1 << count) - 1));
+	}
+
+	static inline int _getPixelIndex(uint64_t block, int x, int y)
+	{
+		int bit = x * 4 + y;
+		return ((int)((block >> (bit + 15)) & 0x2) | (int)((block >> bit) & 0x1));
+	}
+
+	static void _decodePlanarBlock(uint64_t block, unsigned char pixels[16][4])
+	{
+		int ro = _extend6(_getBits(block, 57, 6));
+		int go = _extend7((_getBits(block, 56, 1) << 6) | _getBits(block, 49, 6));
+		int bo = _extend6((_getBits(block, 48, 1) << 5) | (_getBits(block, 43, 2) << 3) | _getBits(block, 39, 3));
+		int rh = _extend6((_getBits(block, 34, 5) << 1) | _getBits(block, 32, 1));
+		int gh = _extend7(_getBits(block, 25, 7));
+		int bh = _extend6(_getBits(block, 19, 6));
+		int rv = _extend6(_getBits(block, 13, 6));
+		int gv = _extend7(_getBits(block, 6, 7));
+		int bv = _extend6(_getBits(block, 0, 6));
+		unsigned char* pixel = NULL;
+		for_iter (y, 0, 4)
+		{
+			for_iter (x, 0, 4)
+			{
+				pixel = pixels[y * 4 + x];
+				pixel[0] = _clampColor((x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2);
+				pixel[1] = _clampColor((x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2);
+				pixel[2] = _clampColor((x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2);
+				pixel[3] = 255;
+			}
+		}
+	}
+
+	// T and H modes pick one of 4 paint colors per pixel
+	static void _decodePaintBlock(uint64_t block, bool hMode, unsigned char pixels[16][4])
+	{
+		int colors[2][3];
+		int distance = 0;
+		if (!hMode)
+		{
+			colors[0][0] = _extend4((_getBits(block, 59, 2) << 2) | _getBits(block, 56, 2));
+			colors[0][1] = _extend4(_getBits(block, 52, 4));
+			colors[0][2] = _extend4(_getBits(block, 48, 4));
+			colors[1][0] = _extend4(_getBits(block, 44, 4));
+			colors[1][1] = _extend4(_getBits(block, 40, 4));
+			colors[1][2] = _extend4(_getBits(block, 36, 4));
+			distance = etc2Distances[(_getBits(block, 34, 2) << 1) | _getBits(block, 32, 1)];
+		}
+		else
+		{
+			colors[0][0] = _extend4(_getBits(block, 59, 4));
+			colors[0][1] = _extend4((_getBits(block, 56, 3) << 1) | _getBits(block, 52, 1));
+			colors[0][2] = _extend4((_getBits(block, 51, 1) << 3) | _getBits(block, 47, 3));
+			colors[1][0] = _extend4(_getBits(block, 43, 4));
+			colors[1][1] = _extend4(_getBits(block, 39, 4));
+			colors[1][2] = _extend4(_getBits(block, 35, 4));
+			int index = (_getBits(block, 34, 1) << 2) | (_getBits(block, 32, 1) << 1);
+			if (((colors[0][0] << 16) | (colors[0][1] << 8) | colors[0][2]) >= ((colors[1][0] << 16) | (colors[1][1] << 8) | colors[1][2]))
+			{
+				++index;
+			}
+			distance = etc2Distances[index];
+		}
+		int paintColors[4][3];
+		for_iter (c, 0, 3)
+		{
+			if (!hMode)
+			{
+				paintColors[0][c] = colors[0][c];
+				paintColors[1][c] = colors[1][c] + distance;
+				paintColors[2][c] = colors[1][c];
+				paintColors[3][c] = colors[1][c] - distance;
+			}
+			else
+			{
+				paintColors[0][c] = colors[0][c] + distance;
+				paintColors[1][c] = colors[0][c] - distance;
+				paintColors[2][c] = colors[1][c] + distance;
+				paintColors[3][c] = colors[1][c] - distance;
+			}
+		}
+		int* paintColor = NULL;
+		unsigned char* pixel = NULL;
+		for_iter (y, 0, 4)
+		{
+			for_iter (x, 0, 4)
+			{
+				paintColor = paintColors[_getPixelIndex(block, x, y)];
+				pixel = pixels[y * 4 + x];
+				pixel[0] = _clampColor(paintColor[0]);
+				pixel[1] = _clampColor(paintColor[1]);
+				pixel[2] = _clampColor(paintColor[2]);
+				pixel[3] = 255;
+			}
+		}
+	}
+
+	// ETC2 RGB is a superset of ETC1, it only reuses differential mode overflows that are invalid in ETC1
+	static void _decodeEtcBlock(const unsigned char* data, bool etc2, unsigned char pixels[16][4])
+	{
+		uint64_t block = _readBlock(data);
+		int colors[2][3];
+		if (_getBits(block, 33, 1) == 0) // individual mode
+		{
+			for_iter (c, 0, 3)
+			{
+				colors[0][c] = _extend4(_getBits(block, 60 - c * 8, 4));
+				colors[1][c] = _extend4(_getBits(block, 56 - c * 8, 4));
+			}
+		}
+		else // differential mode
+		{
+			int base = 0;
+			int delta = 0;
+			for_iter (c, 0, 3)
+			{
+				base = _getBits(block, 59 - c * 8, 5);
+				delta = _getBits(block, 56 - c * 8, 3);
+				if (delta >= 4)
+				{
+					delta -= 8;
+				}
+				if (etc2 && (base + delta < 0 || base + delta > 31))
+				{
+					if (c == 2)
+					{
+						_decodePlanarBlock(block, pixels);
+					}
+					else
+					{
+						_decodePaintBlock(block, (c == 1), pixels);
+					}
+					return;
+				}
+				colors[0][c] = _extend5(base);
+				colors[1][c] = _extend5((base + delta) & 0x1F);
+			}
+		}
+		const int* modifiers[2] = {etcModifiers[_getBits(block, 37, 3)], etcModifiers[_getBits(block, 34, 3)]};
+		bool flip = (_getBits(block, 32, 1) != 0);
+		int subblock = 0;
+		int modifier = 0;
+		unsigned char* pixel = NULL;
+		for_iter (y, 0, 4)
+		{
+			for_iter (x, 0, 4)
+			{
+				subblock = (flip ? (y >> 1) : (x >> 1));
+				modifier = modifiers[subblock][_getPixelIndex(block, x, y)];
+				pixel = pixels[y * 4 + x];
+				pixel[0] = _clampColor(colors[subblock][0] + modifier);
+				pixel[1] = _clampColor(colors[subblock][1] + modifier);
+				pixel[2] = _clampColor(colors[subblock][2] + modifier);
+				pixel[3] = 255;
+			}
+		}
+	}
+
+	static void _decodeEacBlock(const unsigned char* data, unsigned char pixels[16][4])
+	{
+		uint64_t block = _readBlock(data);
+		int base = _getBits(block, 56, 8);
+		int multiplier = _getBits(block, 52, 4);
+		const int* modifiers = eacModifiers[_getBits(block, 48, 4)];
+		for_iter (y, 0, 4)
+		{
+			for_iter (x, 0, 4)
+			{
+				pixels[y * 4 + x][3] = _clampColor(base + modifiers[_getBits(block, 45 - (x * 4 + y) * 3, 3)] * multiplier);
+			}
+		}
+	}
+
+	// block rows write to different pixels so they can be decoded in parallel
+	static void _decodeEtcRows(void* decodeData, int firstRow, int lastRow)
+	{
+		EtcDecodeData* data = (EtcDecodeData*)decodeData;
+		unsigned char pixels[16][4];
+		unsigned char alphaPixels[16][4];
+		unsigned char* block = NULL;
+		unsigned char* pixel = NULL;
+		unsigned char* dest = NULL;
+		int blockCount = data->blocksX * data->blocksY;
+		// ETC2 blocks with alpha are stored as EAC alpha followed by color, ETC1 alpha is stored as a second image in the red channel
+		int blockSize = (data->etc2 && data->alpha ? 16 : 8);
+		int colorOffset = (data->etc2 && data->alpha ? 8 : 0);
+		int width = 0;
+		int height = 0;
+		int x = 0;
+		int y = 0;
+		int c = 0;
+		for_iter (j, firstRow, lastRow)
+		{
+			height = hmin(data->height - j * 4, 4);
+			for_iter (i, 0, data->blocksX)
+			{
+				block = &data->srcData[(j * data->blocksX + i) * blockSize];
+				_decodeEtcBlock(&block[colorOffset], data->etc2, pixels);
+				if (data->alpha)
+				{
+					if (data->etc2)
+					{
+						_decodeEacBlock(block, pixels);
+					}
+					else
+					{
+						_decodeEtcBlock(&data->srcData[(blockCount + j * data->blocksX + i) * blockSize], false, alphaPixels);
+						for_iterx (c, 0, 16)
+						{
+							pixels[c][3] = alphaPixels[c][0];
+						}
+					}
+				}
+				width = hmin(data->width - i * 4, 4);
+				for_iterx (y, 0, height)
+				{
+					dest = &data->destData[((j * 4 + y) * data->width + i * 4) * data->destBpp];
+					for_iterx (x, 0, width)
+					{
+						pixel = pixels[y * 4 + x];
+						for_iterx (c, 0, 4)
+						{
+							if (data->destIndices[c] >= 0)
+							{
+								dest[data->destIndices[c]] = pixel[c];
+							}
+						}
+						dest += data->destBpp;
+					}
+				}
+			}
+		}
+	}
+
+	void decodeEtc(unsigned char* srcData, bool etc2, bool alpha, int width, int height, unsigned char* destData, Image::Format destFormat)
+	{
+		EtcDecodeData data;
+		data.srcData = srcData;
+		data.etc2 = etc2;
+		data.alpha = alpha;
+		data.blocksX = (width + 3) / 4;
+		data.blocksY = (height + 3) / 4;
+		data.width = width;
+		data.height = height;
+		data.destData = destData;
+		data.destBpp = destFormat.getBpp();
+		destFormat.getChannelIndices(&data.destIndices[0], &data.destIndices[1], &data.destIndices[2], &data.destIndices[3]);
+		// images smaller than the threshold are decoded on the calling thread only
+		int threshold = april::getParallelPixelThreshold();
+		if (threshold > 0 && width * height >= threshold)
+		{
+			WorkerPool::run(data.blocksY, &_decodeEtcRows, &data);
+		}
+		else
+		{
+			_decodeEtcRows(&data, 0, data.blocksY);
+		}
+	}
+
+	static bool _isEtcxNativelySupported(const EtcxHeader& header)
+	{
+#ifdef __ANDROID__
+		// only ETC1 data can be uploaded directly
+		return ((header.flags & ETCX_HEADER_IS_ETC2_BIT) == 0 && april::rendersys != NULL && april::rendersys->getCaps().etc1Textures);
+#else
+		return false;
+#endif
+	}
+
+	static Image::Format _getEtcxDecodeFormat(const EtcxHeader& header)
+	{
+		Image::Format format = ((header.flags & ETCX_HEADER_HAS_ALPHA_BIT) != 0 ? Image::Format::RGBA : Image::Format::RGBX);
+		if (april::rendersys != NULL)
+		{
+			format = april::rendersys->getNativeTextureFormat(format);
+		}
+		return format;
+	}
+
 	Image* Image::_loadEtcx(hsbase& stream, int size)
 	{
 		EtcxHeader header;
@@ -52,25 +421,46 @@ namespace april
 		Image* image = new Image();
 		image->w = header.width;
 		image->h = header.height;
-		image->internalFormat = GL_ETC1_RGB8_OES;
-		image->compressedSize = header.size;
-		if ((header.flags & ETCX_HEADER_HAS_ALPHA_BIT) != 0)
+		unsigned char* data = new unsigned char[header.size];
+		if ((header.flags & ETCX_HEADER_IS_ZLIB_COMPRESSED_BIT) == 0)
 		{
-			image->internalFormat = GL_ETCX_RGBA8_OES_HACK;
+			stream.readRaw(data, header.size);
 		}
-		image->format = Image::Format::Compressed;
-		if ((header.flags & ETCX_HEADER_IS_ZLIB_COMPRESSED_BIT) == 0)
+		else if (!zlibDecompress(stream, header.compressedSize, data, header.size))
 		{
-			image->data = new unsigned char[image->compressedSize];
-			stream.readRaw(image->data, image->compressedSize);
+			delete[] data;
+			delete image;
+			return NULL;
+		}
+		if (_isEtcxNativelySupported(header))
+		{
+#ifdef __ANDROID__
+			image->internalFormat = GL_ETC1_RGB8_OES;
+			if ((header.flags & ETCX_HEADER_HAS_ALPHA_BIT) != 0)
+			{
+				image->internalFormat = GL_ETCX_RGBA8_OES_HACK;
+			}
+#endif
+			image->format = Image::Format::Compressed;
+			image->compressedSize = header.size;
+			image->data = data;
 			return image;
 		}
-		image->data = zlibDecompress(header.size, header.compressedSize, stream);
-		if (image->data == NULL)
+		// no native ETC support so it's decoded on the CPU
+		bool etc2 = ((header.flags & ETCX_HEADER_IS_ETC2_BIT) != 0);
+		bool alpha = ((header.flags & ETCX_HEADER_HAS_ALPHA_BIT) != 0);
+		int blockCount = ((image->w + 3) / 4) * ((image->h + 3) / 4);
+		if ((int)header.size < blockCount * (alpha ? 16 : 8))
 		{
+			hlog::error(logTag, "ETCX data is incomplete!");
+			delete[] data;
 			delete image;
-			image = NULL;
+			return NULL;
 		}
+		image->format = _getEtcxDecodeFormat(header);
+		image->data = new unsigned char[image->getByteSize()];
+		decodeEtc(data, etc2, alpha, image->w, image->h, image->data, image->format);
+		delete[] data;
 		return image;
 	}
 
@@ -90,14 +480,21 @@ namespace april
 		Image* image = new Image();
 		image->w = header.width;
 		image->h = header.height;
-		image->internalFormat = GL_ETC1_RGB8_OES;
-		image->compressedSize = header.size;
-		if ((header.flags & ETCX_HEADER_HAS_ALPHA_BIT) != 0)
+		image->data = NULL;
+		if (_isEtcxNativelySupported(header))
 		{
-			image->internalFormat = GL_ETCX_RGBA8_OES_HACK;
+#ifdef __ANDROID__
+			image->internalFormat = GL_ETC1_RGB8_OES;
+			if ((header.flags & ETCX_HEADER_HAS_ALPHA_BIT) != 0)
+			{
+				image->internalFormat = GL_ETCX_RGBA8_OES_HACK;
+			}
+#endif
+			image->format = Image::Format::Compressed;
+			image->compressedSize = header.size;
+			return image;
 		}
-		image->format = Image::Format::Compressed;
-		image->data = NULL;
+		image->format = _getEtcxDecodeFormat(header);
 		return image;
 	}
 
@@ -107,4 +504,3 @@ namespace april
 	}
 
 }
-#endif
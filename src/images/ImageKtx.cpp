@@ -0,0 +1,444 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <stdint.h>
+#include <string.h>
+
+#include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hsbase.h>
+#include <hltypes/hstring.h>
+
+#include "april.h"
+#include "blockCompression.h"
+#include "Image.h"
+#include "zlibUtil.h"
+
+#define KTX_IDENTIFIER_SIZE 12
+#define KTX_ENDIANNESS 0x04030201
+#define KTX_GL_UNSIGNED_BYTE 0x1401
+#define KTX_GL_ALPHA 0x1906
+#define KTX_GL_RGB 0x1907
+#define KTX_GL_RGBA 0x1908
+#define KTX_GL_LUMINANCE 0x1909
+#define KTX_GL_BGRA 0x80E1
+#define KTX2_SUPERCOMPRESSION_NONE 0
+#define KTX2_SUPERCOMPRESSION_ZLIB 3
+// Vulkan ASTC formats alternate between UNORM and SRGB in the same block size order as OpenGL
+#define KTX2_VK_FORMAT_ASTC_FIRST 157
+
+namespace april
+{
+	static const unsigned char ktx1Identifier[KTX_IDENTIFIER_SIZE] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+	static const unsigned char ktx2Identifier[KTX_IDENTIFIER_SIZE] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+	struct Ktx1Header
+	{
+		unsigned int endianness;
+		unsigned int glType;
+		unsigned int glTypeSize;
+		unsigned int glFormat;
+		unsigned int glInternalFormat;
+		unsigned int glBaseInternalFormat;
+		unsigned int pixelWidth;
+		unsigned int pixelHeight;
+		unsigned int pixelDepth;
+		unsigned int numberOfArrayElements;
+		unsigned int numberOfFaces;
+		unsigned int numberOfMipmapLevels;
+		unsigned int bytesOfKeyValueData;
+	};
+
+	struct Ktx2Header
+	{
+		unsigned int vkFormat;
+		unsigned int typeSize;
+		unsigned int pixelWidth;
+		unsigned int pixelHeight;
+		unsigned int pixelDepth;
+		unsigned int layerCount;
+		unsigned int faceCount;
+		unsigned int levelCount;
+		unsigned int supercompressionScheme;
+		unsigned int dfdByteOffset;
+		unsigned int dfdByteLength;
+		unsigned int kvdByteOffset;
+		unsigned int kvdByteLength;
+		// 64-bit values are split so the struct has no padding
+		unsigned int sgdByteOffset[2];
+		unsigned int sgdByteLength[2];
+	};
+
+	struct Ktx2Level
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+
+	// Vulkan formats that are used in KTX2 files, block compressed ones are mapped to their OpenGL equivalents
+	struct Ktx2Format
+	{
+		unsigned int vkFormat;
+		unsigned int internalFormat;
+		Image::Format format;
+	};
+
+	static const Ktx2Format ktx2Formats[] =
+	{
+		{9, 0, Image::Format::Greyscale}, // VK_FORMAT_R8_UNORM
+		{15, 0, Image::Format::Greyscale}, // VK_FORMAT_R8_SRGB
+		{23, 0, Image::Format::RGB}, // VK_FORMAT_R8G8B8_UNORM
+		{29, 0, Image::Format::RGB}, // VK_FORMAT_R8G8B8_SRGB
+		{30, 0, Image::Format::BGR}, // VK_FORMAT_B8G8R8_UNORM
+		{36, 0, Image::Format::BGR}, // VK_FORMAT_B8G8R8_SRGB
+		{37, 0, Image::Format::RGBA}, // VK_FORMAT_R8G8B8A8_UNORM
+		{43, 0, Image::Format::RGBA}, // VK_FORMAT_R8G8B8A8_SRGB
+		{44, 0, Image::Format::BGRA}, // VK_FORMAT_B8G8R8A8_UNORM
+		{50, 0, Image::Format::BGRA}, // VK_FORMAT_B8G8R8A8_SRGB
+		{131, APRIL_COMPRESSED_BC1_RGB, Image::Format::Compressed},
+		{132, APRIL_COMPRESSED_BC1_SRGB, Image::Format::Compressed},
+		{133, APRIL_COMPRESSED_BC1_RGBA, Image::Format::Compressed},
+		{134, APRIL_COMPRESSED_BC1_SRGB_ALPHA, Image::Format::Compressed},
+		{135, APRIL_COMPRESSED_BC2, Image::Format::Compressed},
+		{136, APRIL_COMPRESSED_BC2_SRGB, Image::Format::Compressed},
+		{137, APRIL_COMPRESSED_BC3, Image::Format::Compressed},
+		{138, APRIL_COMPRESSED_BC3_SRGB, Image::Format::Compressed},
+		{147, APRIL_COMPRESSED_ETC2_RGB, Image::Format::Compressed},
+		{148, APRIL_COMPRESSED_ETC2_SRGB, Image::Format::Compressed},
+		{149, APRIL_COMPRESSED_ETC2_RGB_A1, Image::Format::Compressed},
+		{150, APRIL_COMPRESSED_ETC2_SRGB_A1, Image::Format::Compressed},
+		{151, APRIL_COMPRESSED_ETC2_RGBA, Image::Format::Compressed},
+		{152, APRIL_COMPRESSED_ETC2_SRGB_ALPHA, Image::Format::Compressed}
+	};
+
+	static bool _getKtx1Format(const Ktx1Header& header, unsigned int& internalFormat, Image::Format& format)
+	{
+		internalFormat = 0;
+		format = Image::Format::Invalid;
+		if (header.glType == 0)
+		{
+			internalFormat = header.glInternalFormat;
+			format = Image::Format::Compressed;
+			return (getBlockCompressedSize(internalFormat, 1, 1) > 0);
+		}
+		if (header.glType == KTX_GL_UNSIGNED_BYTE)
+		{
+			switch (header.glFormat)
+			{
+			case KTX_GL_ALPHA:		format = Image::Format::Alpha;		break;
+			case KTX_GL_RGB:		format = Image::Format::RGB;		break;
+			case KTX_GL_RGBA:		format = Image::Format::RGBA;		break;
+			case KTX_GL_LUMINANCE:	format = Image::Format::Greyscale;	break;
+			case KTX_GL_BGRA:		format = Image::Format::BGRA;		break;
+			}
+		}
+		return (format != Image::Format::Invalid);
+	}
+
+	static bool _getKtx2Format(const Ktx2Header& header, unsigned int& internalFormat, Image::Format& format)
+	{
+		internalFormat = 0;
+		format = Image::Format::Invalid;
+		for_iter (i, 0, (int)(sizeof(ktx2Formats) / sizeof(Ktx2Format)))
+		{
+			if (ktx2Formats[i].vkFormat == header.vkFormat)
+			{
+				internalFormat = ktx2Formats[i].internalFormat;
+				format = ktx2Formats[i].format;
+				return true;
+			}
+		}
+		int astcIndex = (int)header.vkFormat - KTX2_VK_FORMAT_ASTC_FIRST;
+		if (astcIndex >= 0 && astcIndex < APRIL_COMPRESSED_ASTC_COUNT * 2)
+		{
+			internalFormat = (astcIndex % 2 == 0 ? APRIL_COMPRESSED_ASTC_FIRST : APRIL_COMPRESSED_ASTC_SRGB_FIRST) + astcIndex / 2;
+			format = Image::Format::Compressed;
+			return true;
+		}
+		return false;
+	}
+
+	static bool _checkKtxSize(int width, int height, int depth)
+	{
+		if (width <= 0 || height <= 0)
+		{
+			hlog::error(logTag, "KTX image has no size!");
+			return false;
+		}
+		if (depth > 1)
+		{
+			hlog::error(logTag, "KTX 3D textures are not supported!");
+			return false;
+		}
+		if (!isContainerImageSizeValid(width, height))
+		{
+			hlog::errorf(logTag, "KTX image is too large: %d x %d", width, height);
+			return false;
+		}
+		return true;
+	}
+
+	static bool _skipKtx(hsbase& stream, int size)
+	{
+		return (size <= 0 || stream.seek(size));
+	}
+
+	// only the first face or array element of each level is used
+	static Image* _loadKtx1(hsbase& stream, bool metaDataOnly)
+	{
+		Ktx1Header header;
+		if (stream.readRaw(&header, sizeof(Ktx1Header)) != sizeof(Ktx1Header))
+		{
+			return NULL;
+		}
+		if (header.endianness != KTX_ENDIANNESS)
+		{
+			hlog::error(logTag, "KTX files with swapped endianness are not supported!");
+			return NULL;
+		}
+		int width = (int)header.pixelWidth;
+		int height = hmax((int)header.pixelHeight, 1);
+		if (!_checkKtxSize(width, height, (int)header.pixelDepth))
+		{
+			return NULL;
+		}
+		unsigned int internalFormat = 0;
+		Image::Format format = Image::Format::Invalid;
+		if (!_getKtx1Format(header, internalFormat, format))
+		{
+			hlog::errorf(logTag, "KTX format is not supported! glType: 0x%X, glFormat: 0x%X, glInternalFormat: 0x%X", header.glType, header.glFormat, header.glInternalFormat);
+			return NULL;
+		}
+		bool cubemap = (header.numberOfFaces == 6 && header.numberOfArrayElements == 0);
+		int levelCount = hclamp((int)header.numberOfMipmapLevels, 1, Image::getMipmapLevelCount(width, height));
+		if (format != Image::Format::Compressed)
+		{
+			Image* image = Image::create(width, height, NULL, format);
+			if (metaDataOnly)
+			{
+				return image;
+			}
+			image->data = new unsigned char[image->getByteSize()];
+			// rows are padded to 4 bytes
+			int rowSize = width * format.getBpp();
+			int padding = (4 - rowSize % 4) % 4;
+			unsigned int imageSize = 0;
+			bool success = (_skipKtx(stream, header.bytesOfKeyValueData) && stream.readRaw(&imageSize, 4) == 4 && (int)imageSize >= (rowSize + padding) * height - padding);
+			for_iter (j, 0, height)
+			{
+				if (!success)
+				{
+					break;
+				}
+				success = (stream.readRaw(&image->data[j * rowSize], rowSize) == rowSize && (j == height - 1 || _skipKtx(stream, padding)));
+			}
+			if (!success)
+			{
+				hlog::error(logTag, "KTX data is incomplete!");
+				delete image;
+				return NULL;
+			}
+			return image;
+		}
+		if (!isBlockCompressionSupported(internalFormat))
+		{
+			levelCount = 1; // only the base level is decoded on the CPU
+		}
+		int size = getBlockCompressedSize(internalFormat, width, height, levelCount);
+		if (metaDataOnly)
+		{
+			return createBlockCompressedImage(internalFormat, width, height, NULL, size);
+		}
+		if (!_skipKtx(stream, header.bytesOfKeyValueData))
+		{
+			return NULL;
+		}
+		unsigned char* data = new unsigned char[size];
+		unsigned int imageSize = 0;
+		int paddedSize = 0;
+		int levelSize = 0;
+		int offset = 0;
+		int w = width;
+		int h = height;
+		for_iter (i, 0, levelCount)
+		{
+			levelSize = getBlockCompressedSize(internalFormat, w, h);
+			if (stream.readRaw(&imageSize, 4) != 4 || (int)imageSize < levelSize || stream.readRaw(&data[offset], levelSize) != levelSize)
+			{
+				hlog::error(logTag, "KTX data is incomplete!");
+				delete[] data;
+				return NULL;
+			}
+			paddedSize = ((int)imageSize + 3) / 4 * 4;
+			if (i < levelCount - 1 && !_skipKtx(stream, (cubemap ? paddedSize * 6 : paddedSize) - levelSize))
+			{
+				delete[] data;
+				return NULL;
+			}
+			offset += levelSize;
+			w = hmax(w / 2, 1);
+			h = hmax(h / 2, 1);
+		}
+		return createBlockCompressedImage(internalFormat, width, height, data, size);
+	}
+
+	static bool _readKtx2Level(hsbase& stream, int64_t start, const Ktx2Header& header, const Ktx2Level& level, unsigned char* data, int size)
+	{
+		if (!stream.seek(start + (int64_t)level.byteOffset, hseek::Start))
+		{
+			return false;
+		}
+		if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_NONE)
+		{
+			return ((int64_t)level.byteLength >= size && stream.readRaw(data, size) == size);
+		}
+		// a level contains all faces and layers, but only the first one is used
+		int uncompressedSize = (int)level.uncompressedByteLength;
+		if (uncompressedSize < size)
+		{
+			return false;
+		}
+		if (uncompressedSize == size)
+		{
+			return zlibDecompress(stream, (int)level.byteLength, data, size);
+		}
+		unsigned char* levelData = new unsigned char[uncompressedSize];
+		bool result = zlibDecompress(stream, (int)level.byteLength, levelData, uncompressedSize);
+		if (result)
+		{
+			memcpy(data, levelData, size);
+		}
+		delete[] levelData;
+		return result;
+	}
+
+	static Image* _loadKtx2(hsbase& stream, int64_t start, bool metaDataOnly)
+	{
+		Ktx2Header header;
+		if (stream.readRaw(&header, sizeof(Ktx2Header)) != sizeof(Ktx2Header))
+		{
+			return NULL;
+		}
+		int width = (int)header.pixelWidth;
+		int height = hmax((int)header.pixelHeight, 1);
+		if (!_checkKtxSize(width, height, (int)header.pixelDepth))
+		{
+			return NULL;
+		}
+		if (header.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE && header.supercompressionScheme != KTX2_SUPERCOMPRESSION_ZLIB)
+		{
+			hlog::errorf(logTag, "KTX2 supercompression scheme %d is not supported!", header.supercompressionScheme);
+			return NULL;
+		}
+		unsigned int internalFormat = 0;
+		Image::Format format = Image::Format::Invalid;
+		if (!_getKtx2Format(header, internalFormat, format))
+		{
+			hlog::errorf(logTag, "KTX2 format is not supported! vkFormat: %d", header.vkFormat);
+			return NULL;
+		}
+		int levelCount = hclamp((int)header.levelCount, 1, Image::getMipmapLevelCount(width, height));
+		if (format != Image::Format::Compressed || !isBlockCompressionSupported(internalFormat))
+		{
+			levelCount = 1; // only the base level is needed
+		}
+		if (format != Image::Format::Compressed)
+		{
+			Image* image = Image::create(width, height, NULL, format);
+			if (metaDataOnly)
+			{
+				return image;
+			}
+			image->data = new unsigned char[image->getByteSize()];
+			Ktx2Level level;
+			if (stream.readRaw(&level, sizeof(Ktx2Level)) != sizeof(Ktx2Level) || !_readKtx2Level(stream, start, header, level, image->data, image->getByteSize()))
+			{
+				hlog::error(logTag, "KTX2 data is incomplete!");
+				delete image;
+				return NULL;
+			}
+			return image;
+		}
+		int size = getBlockCompressedSize(internalFormat, width, height, levelCount);
+		if (metaDataOnly)
+		{
+			return createBlockCompressedImage(internalFormat, width, height, NULL, size);
+		}
+		// the level index has to be read completely before seeking to the level data
+		Ktx2Level* levels = new Ktx2Level[levelCount];
+		if (stream.readRaw(levels, sizeof(Ktx2Level) * levelCount) != (int)sizeof(Ktx2Level) * levelCount)
+		{
+			hlog::error(logTag, "KTX2 data is incomplete!");
+			delete[] levels;
+			return NULL;
+		}
+		unsigned char* data = new unsigned char[size];
+		int levelSize = 0;
+		int offset = 0;
+		int w = width;
+		int h = height;
+		for_iter (i, 0, levelCount)
+		{
+			levelSize = getBlockCompressedSize(internalFormat, w, h);
+			if (!_readKtx2Level(stream, start, header, levels[i], &data[offset], levelSize))
+			{
+				hlog::error(logTag, "KTX2 data is incomplete!");
+				delete[] levels;
+				delete[] data;
+				return NULL;
+			}
+			offset += levelSize;
+			w = hmax(w / 2, 1);
+			h = hmax(h / 2, 1);
+		}
+		delete[] levels;
+		return createBlockCompressedImage(internalFormat, width, height, data, size);
+	}
+
+	static Image* _loadKtxFile(hsbase& stream, bool metaDataOnly)
+	{
+		int64_t start = stream.position();
+		unsigned char identifier[KTX_IDENTIFIER_SIZE];
+		if (stream.readRaw(identifier, KTX_IDENTIFIER_SIZE) != KTX_IDENTIFIER_SIZE)
+		{
+			return NULL;
+		}
+		if (memcmp(identifier, ktx1Identifier, KTX_IDENTIFIER_SIZE) == 0)
+		{
+			return _loadKtx1(stream, metaDataOnly);
+		}
+		if (memcmp(identifier, ktx2Identifier, KTX_IDENTIFIER_SIZE) == 0)
+		{
+			return _loadKtx2(stream, start, metaDataOnly);
+		}
+		hlog::error(logTag, "Not a KTX file!");
+		return NULL;
+	}
+
+	Image* Image::_loadKtx(hsbase& stream, int size)
+	{
+		return _loadKtxFile(stream, false);
+	}
+
+	Image* Image::_loadKtx(hsbase& stream)
+	{
+		return Image::_loadKtx(stream, (int)stream.size());
+	}
+
+	Image* Image::_readMetaDataKtx(hsbase& stream, int size)
+	{
+		return _loadKtxFile(stream, true);
+	}
+
+	Image* Image::_readMetaDataKtx(hsbase& stream)
+	{
+		return Image::_readMetaDataKtx(stream, (int)stream.size());
+	}
+
+}
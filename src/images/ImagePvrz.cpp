@@ -50,11 +50,6 @@ namespace april
 		{
 			return NULL;
 		}
-		unsigned char* pvrData = zlibDecompress(header.size, header.compressedSize, stream);
-		if (pvrData == NULL)
-		{
-			return NULL;
-		}
 		Image* image = new Image();
 		image->w = header.width;
 		image->h = header.height;
@@ -62,8 +57,13 @@ namespace april
 		image->compressedSize = header.size - PVR_HEADER_SIZE;
 		image->format = Image::Format::Compressed;
 		image->data = new unsigned char[image->compressedSize];
-		memcpy(image->data, &pvrData[PVR_HEADER_SIZE], image->compressedSize);
-		delete[] pvrData;
+		// the PVR header is split off so the texture data is decompressed straight into the final buffer
+		unsigned char pvrHeader[PVR_HEADER_SIZE];
+		if (!zlibDecompress(stream, header.compressedSize, image->data, image->compressedSize, pvrHeader, PVR_HEADER_SIZE))
+		{
+			delete image;
+			return NULL;
+		}
 		return image;
 	}
 
@@ -7,6 +7,14 @@
 /// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
 
 #ifdef _UNIX
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/sysinfo.h>
+#endif
+
 #include <gtypes/Vector2.h>
 #include <hltypes/hlog.h>
 #include <hltypes/hltypesUtil.h>
@@ -18,16 +26,112 @@
 namespace april
 {
 	extern SystemInfo info;
-	
+
+#ifdef __linux__
+	// files in /proc and /sys report a size of 0 so they are read with plain stdio
+	static bool _readLine(const char* filename, char* buffer, int size)
+	{
+		FILE* file = fopen(filename, "r");
+		if (file == NULL)
+		{
+			return false;
+		}
+		bool result = (fgets(buffer, size, file) != NULL);
+		fclose(file);
+		return result;
+	}
+
+	// returns 0 if there is no CPU quota
+	static int _getCgroupCpuLimit()
+	{
+		char buffer[256] = {0};
+		char quotaString[32] = {0};
+		long long quota = -1LL;
+		long long period = 0LL;
+		if (_readLine("/sys/fs/cgroup/cpu.max", buffer, sizeof(buffer))) // cgroup v2
+		{
+			if (sscanf(buffer, "%31s %lld", quotaString, &period) == 2 && strcmp(quotaString, "max") != 0)
+			{
+				sscanf(quotaString, "%lld", &quota);
+			}
+		}
+		else if (_readLine("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", buffer, sizeof(buffer))) // cgroup v1
+		{
+			sscanf(buffer, "%lld", &quota);
+			if (_readLine("/sys/fs/cgroup/cpu/cpu.cfs_period_us", buffer, sizeof(buffer)))
+			{
+				sscanf(buffer, "%lld", &period);
+			}
+		}
+		if (quota <= 0LL || period <= 0LL)
+		{
+			return 0;
+		}
+		return hmax((int)((quota + period - 1LL) / period), 1);
+	}
+
+	// returns 0 if there is no memory limit
+	static int64_t _getCgroupMemoryLimit()
+	{
+		char buffer[256] = {0};
+		long long limit = 0LL;
+		if (_readLine("/sys/fs/cgroup/memory.max", buffer, sizeof(buffer)) || // cgroup v2, "max" if unlimited
+			_readLine("/sys/fs/cgroup/memory/memory.limit_in_bytes", buffer, sizeof(buffer))) // cgroup v1, a huge value if unlimited
+		{
+			if (sscanf(buffer, "%lld", &limit) != 1)
+			{
+				limit = 0LL;
+			}
+		}
+		return (int64_t)limit;
+	}
+#endif
+
 	void _setupSystemInfo_platform(SystemInfo& info)
 	{
-		info.name = "posix";
-		info.osType = SystemInfo::OsType::Posix;
-		info.cpuCores = 1; // TODO
-		info.displayResolution.set(1024.0f, 768.0f); // TODO
-		info.displayDpi = 96.0f; // TODO
-		//info.ram = 1024; // TODO
-		info.locale = "en"; // TODO
+		if (info.locale == "")
+		{
+			info.name = "posix";
+			info.osType = SystemInfo::OsType::Posix;
+			// CPU cores
+			info.cpuCores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#ifdef __linux__
+			// only the cores the process is actually allowed to run on are relevant
+			cpu_set_t cpuSet;
+			CPU_ZERO(&cpuSet);
+			if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+			{
+				info.cpuCores = CPU_COUNT(&cpuSet);
+			}
+			int cpuLimit = _getCgroupCpuLimit();
+			if (cpuLimit > 0)
+			{
+				info.cpuCores = hmin(info.cpuCores, cpuLimit);
+			}
+#endif
+			info.cpuCores = hmax(info.cpuCores, 1);
+			// RAM
+			int64_t ram = (int64_t)sysconf(_SC_PAGESIZE) * sysconf(_SC_PHYS_PAGES);
+#ifdef __linux__
+			struct sysinfo systemInfo;
+			if (sysinfo(&systemInfo) == 0)
+			{
+				ram = (int64_t)systemInfo.totalram * systemInfo.mem_unit;
+			}
+			int64_t ramLimit = _getCgroupMemoryLimit();
+			if (ramLimit > 0LL)
+			{
+				ram = hmin(ram, ramLimit);
+			}
+#endif
+			if (ram > 0LL)
+			{
+				info.ram = (int)(ram / (1024 * 1024)); // in MB
+			}
+			info.displayResolution.set(1024.0f, 768.0f); // TODO
+			info.displayDpi = 96.0f; // TODO
+			info.locale = "en"; // TODO
+		}
 	}
 
 	hstr _getPackageName_platform()
@@ -44,6 +148,16 @@ namespace april
 	
 	int64_t _getRamConsumption_platform()
 	{
+#ifdef __linux__
+		// the second value is the resident set size in pages
+		char buffer[256] = {0};
+		long long size = 0LL;
+		long long resident = 0LL;
+		if (_readLine("/proc/self/statm", buffer, sizeof(buffer)) && sscanf(buffer, "%lld %lld", &size, &resident) == 2)
+		{
+			return ((int64_t)resident * sysconf(_SC_PAGESIZE));
+		}
+#endif
 		hlog::warn(logTag, "Cannot use getRamConsumption() on this platform.");
 		return 0LL;
 	}
@@ -27,6 +27,7 @@
 #include "DirectX11_PixelShader.h"
 #include "DirectX11_RenderSystem.h"
 #include "DirectX11_Texture.h"
+#include "DirectX11_VertexBuffer.h"
 #include "DirectX11_VertexShader.h"
 #include "Image.h"
 #include "Keys.h"
@@ -138,6 +139,7 @@ namespace april
 		this->blendStateAdd = nullptr;
 		this->blendStateSubtract = nullptr;
 		this->blendStateOverwrite = nullptr;
+		this->blendStatePremultipliedAlpha = nullptr;
 		this->samplerLinearWrap = nullptr;
 		this->samplerLinearClamp = nullptr;
 		this->samplerNearestWrap = nullptr;
@@ -686,6 +688,14 @@ namespace april
 		blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
 		blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_ZERO;
 		this->d3dDevice->CreateBlendState(&blendDesc, &this->blendStateOverwrite);
+		// premultiplied alpha
+		blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+		blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+		blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+		blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+		blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+		blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+		this->d3dDevice->CreateBlendState(&blendDesc, &this->blendStatePremultipliedAlpha);
 		// texture samplers
 		D3D11_SAMPLER_DESC samplerDesc;
 		memset(&samplerDesc, 0, sizeof(samplerDesc));
@@ -783,6 +793,11 @@ namespace april
 		return new DirectX11_VertexShader();
 	}
 
+	VertexBuffer* DirectX11_RenderSystem::_deviceCreateVertexBuffer()
+	{
+		return new DirectX11_VertexBuffer();
+	}
+
 	void DirectX11_RenderSystem::_deviceChangeResolution(int width, int height, bool fullscreen)
 	{
 		ApplicationView^ view = ApplicationView::GetForCurrentView();
@@ -888,7 +903,7 @@ namespace april
 		if (texture != NULL)
 		{
 			this->d3dDeviceContext->PSSetShaderResources(0, 1, ((DirectX11_Texture*)texture)->d3dView.GetAddressOf());
-			Texture::Filter filter = texture->getFilter();
+			Texture::Filter filter = texture->getEffectiveFilter();
 			Texture::AddressMode addressMode = texture->getAddressMode();
 			ComPtr<ID3D11SamplerState> sampler = nullptr;
 			if (filter == Texture::Filter::Linear && addressMode == Texture::AddressMode::Wrap)
@@ -948,6 +963,10 @@ namespace april
 		{
 			this->d3dDeviceContext->OMSetBlendState(this->blendStateOverwrite.Get(), blendFactor, 0xFFFFFFFF);
 		}
+		else if (blendMode == BlendMode::PremultipliedAlpha)
+		{
+			this->d3dDeviceContext->OMSetBlendState(this->blendStatePremultipliedAlpha.Get(), blendFactor, 0xFFFFFFFF);
+		}
 		else
 		{
 			hlog::error(logTag, "Trying to set unsupported blend mode!");
@@ -1109,6 +1128,26 @@ namespace april
 		this->d3dDeviceContext->Draw(count, 0);
 	}
 
+	void DirectX11_RenderSystem::_deviceRender(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count)
+	{
+		DirectX11_VertexBuffer* dx11VertexBuffer = (DirectX11_VertexBuffer*)vertexBuffer;
+		if (!dx11VertexBuffer->_ensureUploaded())
+		{
+			RenderSystem::_deviceRender(renderOperation, vertexBuffer, first, count);
+			return;
+		}
+		if (this->deviceState_renderOperation != renderOperation)
+		{
+			this->d3dDeviceContext->IASetPrimitiveTopology(_dx11RenderOperations[renderOperation.value]);
+			this->deviceState_renderOperation = renderOperation;
+		}
+		// _setDX11VertexBuffer() binds the streaming buffer again for the next regular render call
+		unsigned int stride = (unsigned int)dx11VertexBuffer->vertexSize;
+		static unsigned int offset = 0;
+		this->d3dDeviceContext->IASetVertexBuffers(0, 1, dx11VertexBuffer->d3dBuffer.GetAddressOf(), &stride, &offset);
+		this->d3dDeviceContext->Draw(count, first);
+	}
+
 	void DirectX11_RenderSystem::_setDX11VertexBuffer(const RenderOperation& renderOperation, const void* data, int count, unsigned int vertexSize)
 	{
 		if (this->deviceState_renderOperation != renderOperation)
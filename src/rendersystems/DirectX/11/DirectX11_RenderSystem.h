@@ -33,6 +33,7 @@ namespace april
 {
 	class DirectX11_PixelShader;
 	class DirectX11_Texture;
+	class DirectX11_VertexBuffer;
 	class DirectX11_VertexShader;
 	class Window;
 
@@ -41,6 +42,7 @@ namespace april
 	public:
 		friend class DirectX11_PixelShader;
 		friend class DirectX11_Texture;
+		friend class DirectX11_VertexBuffer;
 		friend class DirectX11_VertexShader;
 
 		class ShaderComposition
@@ -96,6 +98,7 @@ namespace april
 		ComPtr<ID3D11BlendState> blendStateAdd;
 		ComPtr<ID3D11BlendState> blendStateSubtract;
 		ComPtr<ID3D11BlendState> blendStateOverwrite;
+		ComPtr<ID3D11BlendState> blendStatePremultipliedAlpha;
 		ComPtr<ID3D11SamplerState> samplerLinearWrap;
 		ComPtr<ID3D11SamplerState> samplerLinearClamp;
 		ComPtr<ID3D11SamplerState> samplerNearestWrap;
@@ -176,6 +179,7 @@ namespace april
 		Texture* _deviceCreateTexture(bool fromResource);
 		PixelShader* _deviceCreatePixelShader();
 		VertexShader* _deviceCreateVertexShader();
+		VertexBuffer* _deviceCreateVertexBuffer();
 
 		void _deviceChangeResolution(int width, int height, bool fullscreen);
 		void _updateOrientation();
@@ -202,6 +206,7 @@ namespace april
 		void _deviceRender(const RenderOperation& renderOperation, const TexturedVertex* vertices, int count);
 		void _deviceRender(const RenderOperation& renderOperation, const ColoredVertex* vertices, int count);
 		void _deviceRender(const RenderOperation& renderOperation, const ColoredTexturedVertex* vertices, int count);
+		void _deviceRender(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count);
 		void _devicePresentFrame(bool systemEnabled);
 
 		void _setDX11VertexBuffer(const RenderOperation& renderOperation, const void* data, int count, unsigned int vertexSize);
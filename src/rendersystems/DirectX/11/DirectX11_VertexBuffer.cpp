@@ -0,0 +1,78 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#ifdef _DIRECTX11
+#include <hltypes/hlog.h>
+
+#include "april.h"
+#include "DirectX11_RenderSystem.h"
+#include "DirectX11_VertexBuffer.h"
+
+#define APRIL_D3D_DEVICE (((DirectX11_RenderSystem*)april::rendersys)->d3dDevice)
+#define APRIL_D3D_DEVICE_CONTEXT (((DirectX11_RenderSystem*)april::rendersys)->d3dDeviceContext)
+
+namespace april
+{
+	DirectX11_VertexBuffer::DirectX11_VertexBuffer() : VertexBuffer()
+	{
+		this->d3dBuffer = nullptr;
+	}
+
+	bool DirectX11_VertexBuffer::_deviceCreateBuffer(unsigned char* data, int size)
+	{
+		D3D11_SUBRESOURCE_DATA bufferData = {0};
+		bufferData.pSysMem = data;
+		bufferData.SysMemPitch = 0;
+		bufferData.SysMemSlicePitch = 0;
+		D3D11_BUFFER_DESC bufferDesc = {0};
+		bufferDesc.ByteWidth = size;
+		// default usage allows partial updates through UpdateSubresource() which dynamic buffers don't
+		bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bufferDesc.CPUAccessFlags = 0;
+		bufferDesc.MiscFlags = 0;
+		bufferDesc.StructureByteStride = this->vertexSize;
+		HRESULT hr = APRIL_D3D_DEVICE->CreateBuffer(&bufferDesc, &bufferData, &this->d3dBuffer);
+		if (FAILED(hr))
+		{
+			hlog::error(logTag, "Failed to create DX11 vertex buffer!");
+			this->d3dBuffer = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	bool DirectX11_VertexBuffer::_deviceDestroyBuffer()
+	{
+		if (this->d3dBuffer != nullptr)
+		{
+			this->d3dBuffer = nullptr;
+			return true;
+		}
+		return false;
+	}
+
+	bool DirectX11_VertexBuffer::_deviceUpdateBuffer(int offset, unsigned char* data, int size)
+	{
+		if (this->d3dBuffer == nullptr)
+		{
+			return false;
+		}
+		D3D11_BOX box;
+		box.left = offset;
+		box.right = offset + size;
+		box.top = 0;
+		box.bottom = 1;
+		box.front = 0;
+		box.back = 1;
+		APRIL_D3D_DEVICE_CONTEXT->UpdateSubresource(this->d3dBuffer.Get(), 0, &box, data, 0, 0);
+		return true;
+	}
+
+}
+#endif
@@ -0,0 +1,47 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a DirectX11 specific vertex buffer.
+
+#ifdef _DIRECTX11
+#ifndef APRIL_DIRECTX11_VERTEX_BUFFER_H
+#define APRIL_DIRECTX11_VERTEX_BUFFER_H
+
+#include <d3d11_4.h>
+
+#include <hltypes/hplatform.h>
+
+#include "VertexBuffer.h"
+
+using namespace Microsoft::WRL;
+
+namespace april
+{
+	class DirectX11_RenderSystem;
+
+	class DirectX11_VertexBuffer : public VertexBuffer
+	{
+	public:
+		friend class DirectX11_RenderSystem;
+
+		DirectX11_VertexBuffer();
+
+	protected:
+		ComPtr<ID3D11Buffer> d3dBuffer;
+
+		bool _deviceCreateBuffer(unsigned char* data, int size);
+		bool _deviceDestroyBuffer();
+		bool _deviceUpdateBuffer(int offset, unsigned char* data, int size);
+
+	};
+	
+}
+#endif
+#endif
@@ -740,6 +740,16 @@ namespace april
 		renderTargetOverwrite.BlendOp = D3D12_BLEND_OP_ADD;
 		renderTargetOverwrite.SrcBlend = D3D12_BLEND_SRC_ALPHA;
 		renderTargetOverwrite.DestBlend = D3D12_BLEND_ZERO;
+		D3D12_RENDER_TARGET_BLEND_DESC renderTargetPremultipliedAlpha;
+		renderTargetPremultipliedAlpha.BlendEnable = true;
+		renderTargetPremultipliedAlpha.LogicOpEnable = false;
+		renderTargetPremultipliedAlpha.RenderTargetWriteMask = (D3D12_COLOR_WRITE_ENABLE_RED | D3D12_COLOR_WRITE_ENABLE_GREEN | D3D12_COLOR_WRITE_ENABLE_BLUE);
+		renderTargetPremultipliedAlpha.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+		renderTargetPremultipliedAlpha.SrcBlendAlpha = D3D12_BLEND_ONE;
+		renderTargetPremultipliedAlpha.DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+		renderTargetPremultipliedAlpha.BlendOp = D3D12_BLEND_OP_ADD;
+		renderTargetPremultipliedAlpha.SrcBlend = D3D12_BLEND_ONE;
+		renderTargetPremultipliedAlpha.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
 		const D3D12_DEPTH_STENCILOP_DESC defaultStencilOperation = { D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_COMPARISON_FUNC_ALWAYS };
 		// indexed data
 		this->inputLayoutDescs.clear();
@@ -768,6 +778,7 @@ namespace april
 		this->blendStateRenderTargets += renderTargetAdd;
 		this->blendStateRenderTargets += renderTargetSubtract;
 		this->blendStateRenderTargets += renderTargetOverwrite;
+		this->blendStateRenderTargets += renderTargetPremultipliedAlpha;
 		this->primitiveTopologyTypes.clear();
 		this->primitiveTopologyTypes += D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
 		this->primitiveTopologyTypes += D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
@@ -1195,7 +1206,7 @@ namespace april
 			this->commandList[this->commandListIndex]->SetGraphicsRootDescriptorTable(1, gpuHandle);
 			// sampler
 			int adressModeSize = Texture::AddressMode::getCount();
-			gpuHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(this->samplerHeaps[this->commandListIndex]->GetGPUDescriptorHandleForHeapStart(), texture->getFilter().value * adressModeSize + texture->getAddressMode().value, this->samplerDescSize);
+			gpuHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(this->samplerHeaps[this->commandListIndex]->GetGPUDescriptorHandleForHeapStart(), texture->getEffectiveFilter().value * adressModeSize + texture->getAddressMode().value, this->samplerDescSize);
 			this->commandList[this->commandListIndex]->SetGraphicsRootDescriptorTable(2, gpuHandle);
 		}
 		else
@@ -120,6 +120,8 @@ namespace april
 			extensions = (const char*)extensionsString;
 		}
 		hlog::write(logTag, "Extensions supported:\n- " + extensions.trimmedRight().replaced(" ", "\n- "));
+		// core since OpenGL 1.4, but exported as an extension by most drivers
+		this->caps.mipmapGeneration = extensions.contains("SGIS_generate_mipmap");
 		if (extensions.contains("ARB_texture_non_power_of_two"))
 		{
 			this->caps.npotTexturesLimited = true;
@@ -137,6 +139,10 @@ namespace april
 		// TODO - is there a way to make this work on Win32?
 #ifndef _WIN32
 		this->blendSeparationSupported = extensions.contains("EXT_blend_equation_separate") && extensions.contains("EXT_blend_func_separate");
+		// glCompressedTexImage2D() isn't exported on Win32 either so block compressed data is decoded on the CPU there
+		this->caps.bcTextures = extensions.contains("EXT_texture_compression_s3tc");
+		this->caps.etc2Textures = extensions.contains("ARB_ES3_compatibility");
+		this->caps.astcTextures = extensions.contains("KHR_texture_compression_astc_ldr");
 #endif
 		OpenGL_RenderSystem::_deviceSetupCaps();
 	}
@@ -237,6 +243,11 @@ namespace april
 				GL_SAFE_CALL(glBlendEquationSeparate, (GL_FUNC_ADD, GL_FUNC_ADD));
 				GL_SAFE_CALL(glBlendFuncSeparate, (GL_ONE, GL_ZERO, GL_ONE, GL_ZERO));
 			}
+			else if (blendMode == BlendMode::PremultipliedAlpha)
+			{
+				GL_SAFE_CALL(glBlendEquationSeparate, (GL_FUNC_ADD, GL_FUNC_ADD));
+				GL_SAFE_CALL(glBlendFuncSeparate, (GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+			}
 			else
 			{
 				hlog::warn(logTag, "Trying to set unsupported blend mode!");
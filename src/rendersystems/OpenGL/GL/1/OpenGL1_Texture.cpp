@@ -7,7 +7,13 @@
 /// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
 
 #ifdef _OPENGL1
+#include "april.h"
 #include "OpenGL1_Texture.h"
+#include "RenderSystem.h"
+
+#ifndef GL_GENERATE_MIPMAP_SGIS
+#define GL_GENERATE_MIPMAP_SGIS 0x8191
+#endif
 
 namespace april
 {
@@ -16,6 +22,26 @@ namespace april
 	{
 	}
 
+	bool OpenGL1_Texture::_deviceCreateTexture(unsigned char* data, int size)
+	{
+		if (!OpenGL_Texture::_deviceCreateTexture(data, size))
+		{
+			return false;
+		}
+		// the flag has to be set before the base level is uploaded, afterwards every change of the base level updates the mipmaps on the GPU
+		if (this->_canUseMipmaps() && april::rendersys->getCaps().mipmapGeneration)
+		{
+			this->_setCurrentTexture();
+			glTexParameteri(this->internalType, GL_GENERATE_MIPMAP_SGIS, GL_TRUE);
+		}
+		return true;
+	}
+
+	bool OpenGL1_Texture::_deviceGenerateMipmaps()
+	{
+		return april::rendersys->getCaps().mipmapGeneration;
+	}
+
 }
 
 #endif
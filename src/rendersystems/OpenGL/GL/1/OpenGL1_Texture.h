@@ -27,6 +27,10 @@ namespace april
 
 		OpenGL1_Texture(bool fromResource);
 
+	protected:
+		bool _deviceCreateTexture(unsigned char* data, int size);
+		bool _deviceGenerateMipmaps();
+
 	};
 
 }
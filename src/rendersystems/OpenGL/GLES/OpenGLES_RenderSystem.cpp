@@ -290,6 +290,7 @@ namespace april
 	{
 		OpenGL_RenderSystem::_deviceSuspend();
 		this->_deviceUnloadTextures();
+		this->_deviceUnloadVertexBuffers();
 		this->_tryDestroyIntermediateRenderTextures();
 		this->_destroyShaders();
 	}
@@ -325,11 +326,33 @@ namespace april
 #endif
 #ifdef __ANDROID__
 		this->etc1Supported = extensions.contains("OES_compressed_ETC1_RGB8_texture");
+		this->caps.etc1Textures = this->etc1Supported;
 		hlog::write(logTag, "ETC1 supported: " + hstr(this->etc1Supported ? "yes" : "no"));
+#endif
+		hstr version;
+		GL_SAFE_CALL(const GLubyte* versionString = glGetString, (GL_VERSION));
+		if (versionString != NULL)
+		{
+			version = (const char*)versionString;
+		}
+		this->caps.bcTextures = extensions.contains("EXT_texture_compression_s3tc");
+		// ETC2 is part of the OpenGLES 3.0 core
+		this->caps.etc2Textures = (version.startsWith("OpenGL ES 3") || extensions.contains("OES_compressed_ETC2_RGBA8_texture"));
+		this->caps.astcTextures = extensions.contains("KHR_texture_compression_astc_ldr");
+		hlog::writef(logTag, "Block compression supported: BC %s, ETC2 %s, ASTC %s", (this->caps.bcTextures ? "yes" : "no"),
+			(this->caps.etc2Textures ? "yes" : "no"), (this->caps.astcTextures ? "yes" : "no"));
+#ifdef __ANDROID__
+		// each codec is checked on its own, compressed data is only decoded on the CPU if none of them is available
+		if (!this->caps.etc1Textures && !this->caps.bcTextures && !this->caps.etc2Textures && !this->caps.astcTextures)
+		{
+			this->caps.textureFormats /= Image::Format::Compressed;
+		}
 #endif
         // OpenGLES implementations do not appear to support alpha textures by default
 		this->caps.textureFormats /= Image::Format::Alpha;
 		this->caps.textureFormats /= Image::Format::Greyscale;
+		// glGenerateMipmap() is part of the OpenGLES 2.0 core
+		this->caps.mipmapGeneration = true;
 		return OpenGL_RenderSystem::_deviceSetupCaps();
 	}
 
@@ -663,6 +686,11 @@ namespace april
 				GL_SAFE_CALL(glBlendEquationSeparate, (GL_FUNC_ADD, GL_FUNC_ADD));
 				GL_SAFE_CALL(glBlendFuncSeparate, (GL_ONE, GL_ZERO, GL_ONE, GL_ZERO));
 			}
+			else if (blendMode == BlendMode::PremultipliedAlpha)
+			{
+				GL_SAFE_CALL(glBlendEquationSeparate, (GL_FUNC_ADD, GL_FUNC_ADD));
+				GL_SAFE_CALL(glBlendFuncSeparate, (GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+			}
 			else
 			{
 				hlog::warn(logTag, "Trying to set unsupported blend mode!");
@@ -912,6 +940,7 @@ namespace april
 			this->_presentIntermediateRenderTexture();
 		}
 		OpenGL_RenderSystem::_devicePresentFrame(systemEnabled);
+		this->_updateIntermediateRenderTextures();
 		if (this->_currentIntermediateRenderTexture != NULL)
 		{
 			GL_SAFE_CALL(glBindFramebuffer, (GL_FRAMEBUFFER, ((OpenGLES_Texture*)this->_currentIntermediateRenderTexture)->framebufferId));
@@ -936,9 +965,9 @@ namespace april
 		unsigned int previousFramebufferId = 0;
 		GL_SAFE_CALL(glGetIntegerv, (GL_FRAMEBUFFER_BINDING, (GLint*)&previousFramebufferId));
 		GL_SAFE_CALL(glBindFramebuffer, (GL_FRAMEBUFFER, ((OpenGLES_Texture*)destination)->framebufferId));
-		this->_intermediateState->viewport.setSize(source->getWidth(), source->getHeight());
+		this->_intermediateState->viewport.setSize(destination->getWidth(), destination->getHeight());
 		this->_intermediateState->projectionMatrix.setOrthoProjection(
-			grectf(1.0f - 2.0f * this->pixelOffset / source->getWidth(), 1.0f - 2.0f * this->pixelOffset / source->getHeight(), 2.0f, 2.0f));
+			grectf(1.0f - 2.0f * this->pixelOffset / destination->getWidth(), 1.0f - 2.0f * this->pixelOffset / destination->getHeight(), 2.0f, 2.0f));
 		this->_intermediateState->texture = source;
 		RenderState deviceState(*this->deviceState);
 		this->_updateDeviceState(this->_intermediateState, true);
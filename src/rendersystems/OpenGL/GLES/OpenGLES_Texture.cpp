@@ -62,7 +62,8 @@ namespace april
 		}
 #endif
 #ifdef __ANDROID__
-		if ((this->dataFormat & GL_ETC1_RGB8_OES) == GL_ETC1_RGB8_OES)
+		// ETC1 data from KTX files was already uploaded with its mipmaps as block compressed data
+		if (this->firstUpload && (this->dataFormat & GL_ETC1_RGB8_OES) == GL_ETC1_RGB8_OES)
 		{
 			if (!APRIL_OGLES_RENDERSYS->etc1Supported)
 			{
@@ -136,5 +137,12 @@ namespace april
 		OpenGL_Texture::_assignFormat();
 	}
 
+	bool OpenGLES_Texture::_deviceGenerateMipmaps()
+	{
+		this->_setCurrentTexture();
+		glGenerateMipmap(this->internalType);
+		return (glGetError() == GL_NO_ERROR);
+	}
+
 }
 #endif
@@ -38,6 +38,8 @@ namespace april
 		bool _deviceDestroyTexture();
 		void _assignFormat();
 
+		bool _deviceGenerateMipmaps();
+
 	};
 
 }
@@ -29,6 +29,7 @@
 #include "Image.h"
 #include "OpenGL_RenderSystem.h"
 #include "OpenGL_Texture.h"
+#include "OpenGL_VertexBuffer.h"
 #include "Platform.h"
 #include "RenderState.h"
 #include "UpdateDelegate.h"
@@ -112,6 +113,7 @@ namespace april
 	void OpenGL_RenderSystem::_deviceSetupCaps()
 	{
 		GL_SAFE_CALL(glGetIntegerv, (GL_MAX_TEXTURE_SIZE, &this->caps.maxTextureSize));
+		this->caps.mipmaps = true;
 	}
 
 #if defined(_WIN32) && !defined(_UWP)
@@ -162,6 +164,11 @@ namespace april
 		return 0; // this API is likely not available on OpenGL
 	}
 
+	VertexBuffer* OpenGL_RenderSystem::_deviceCreateVertexBuffer()
+	{
+		return new OpenGL_VertexBuffer();
+	}
+
 	void OpenGL_RenderSystem::_deviceChangeResolution(int width, int height, bool fullscreen)
 	{
 		grecti viewport(0, 0, width, height);
@@ -177,7 +184,7 @@ namespace april
 		{
 			height = this->deviceState->renderTarget->getHeight();
 		}
-		else if (this->_currentIntermediateRenderTexture != NULL)
+		else if (this->_currentIntermediateRenderTexture != NULL && !this->_presentingIntermediateRenderTexture)
 		{
 			height = this->_currentIntermediateRenderTexture->getHeight();
 		}
@@ -236,6 +243,11 @@ namespace april
 			GL_SAFE_CALL(glTexParameteri, (type, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
 			GL_SAFE_CALL(glTexParameteri, (type, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
 		}
+		else if (textureFilter == Texture::Filter::Trilinear)
+		{
+			GL_SAFE_CALL(glTexParameteri, (type, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+			GL_SAFE_CALL(glTexParameteri, (type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+		}
 		else
 		{
 			hlog::warn(logTag, "Trying to set unsupported texture filter!");
@@ -275,6 +287,10 @@ namespace april
 		{
 			GL_SAFE_CALL(glBlendFunc, (GL_ONE, GL_ZERO));
 		}
+		else if (blendMode == BlendMode::PremultipliedAlpha)
+		{
+			GL_SAFE_CALL(glBlendFunc, (GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+		}
 		else
 		{
 			GL_SAFE_CALL(glBlendFunc, (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
@@ -393,6 +409,57 @@ namespace april
 #endif
 	}
 
+	void OpenGL_RenderSystem::_deviceRender(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count)
+	{
+#if !defined(_WIN32) || defined(_OPENGLES)
+		OpenGL_VertexBuffer* glVertexBuffer = (OpenGL_VertexBuffer*)vertexBuffer;
+		if (!glVertexBuffer->_ensureUploaded())
+		{
+			RenderSystem::_deviceRender(renderOperation, vertexBuffer, first, count);
+			return;
+		}
+		VertexBuffer::VertexType vertexType = glVertexBuffer->vertexType;
+		int stride = glVertexBuffer->vertexSize;
+		glBindBuffer(GL_ARRAY_BUFFER, glVertexBuffer->bufferId);
+		// pointers are offsets into the bound buffer here
+		this->_setDeviceVertexPointer(stride, NULL, true);
+		if (vertexType == VertexBuffer::VertexType::Colored)
+		{
+			this->_setDeviceColorPointer(stride, (void*)sizeof(PlainVertex), true);
+		}
+		else if (vertexType == VertexBuffer::VertexType::Textured)
+		{
+			this->_setDeviceTexturePointer(stride, (void*)sizeof(PlainVertex), true);
+		}
+		else if (vertexType == VertexBuffer::VertexType::ColoredTextured)
+		{
+			this->_setDeviceColorPointer(stride, (void*)sizeof(PlainVertex), true);
+			this->_setDeviceTexturePointer(stride, (void*)sizeof(ColoredVertex), true);
+		}
+		static int size = 0;
+		size = count;
+#ifdef _SEGMENTED_RENDERING
+		for_iter_step (i, 0, count, size)
+		{
+			size = this->_limitVertices(renderOperation, hmin(count - i, MAX_VERTEX_COUNT));
+			GL_SAFE_CALL(glDrawArrays, (_glRenderOperations[renderOperation.value], first + i, size));
+		}
+#else
+		GL_SAFE_CALL(glDrawArrays, (_glRenderOperations[renderOperation.value], first, size));
+#endif
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		// the offsets mean nothing without the buffer so client side arrays have to be set again
+		this->deviceState_vertexPointer = NULL;
+		this->deviceState_vertexStride = 0;
+		this->deviceState_texturePointer = NULL;
+		this->deviceState_textureStride = 0;
+		this->deviceState_colorPointer = NULL;
+		this->deviceState_colorStride = 0;
+#else
+		RenderSystem::_deviceRender(renderOperation, vertexBuffer, first, count);
+#endif
+	}
+
 	void OpenGL_RenderSystem::_setDeviceVertexPointer(int stride, const void* pointer, bool forceUpdate)
 	{
 		if (forceUpdate || this->deviceState_vertexStride != stride || this->deviceState_vertexPointer != pointer)
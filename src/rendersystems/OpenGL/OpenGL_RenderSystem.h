@@ -77,12 +77,14 @@
 namespace april
 {
 	class OpenGL_Texture;
+	class OpenGL_VertexBuffer;
 	class Window;
 
 	class OpenGL_RenderSystem : public RenderSystem
 	{
 	public:
 		friend class OpenGL_Texture;
+		friend class OpenGL_VertexBuffer;
 
 		OpenGL_RenderSystem();
 
@@ -108,6 +110,8 @@ namespace april
 		void _deviceSetupCaps();
 		void _deviceSetup();
 
+		VertexBuffer* _deviceCreateVertexBuffer();
+
 		void _deviceChangeResolution(int width, int height, bool fullscreen);
 
 		void _setDeviceViewport(cgrecti rect);
@@ -125,6 +129,7 @@ namespace april
 		void _deviceRender(const RenderOperation& renderOperation, const TexturedVertex* vertices, int count);
 		void _deviceRender(const RenderOperation& renderOperation, const ColoredVertex* vertices, int count);
 		void _deviceRender(const RenderOperation& renderOperation, const ColoredTexturedVertex* vertices, int count);
+		void _deviceRender(const RenderOperation& renderOperation, VertexBuffer* vertexBuffer, int first, int count);
 
 		void _setDeviceVertexPointer(int stride, const void* pointer, bool forceUpdate = false);
 		void _setDeviceTexturePointer(int stride, const void* pointer, bool forceUpdate = false);
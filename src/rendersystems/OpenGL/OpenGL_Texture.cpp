@@ -11,9 +11,11 @@
 #include <hltypes/hplatform.h>
 
 #include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
 #include <hltypes/hstring.h>
 
 #include "april.h"
+#include "blockCompression.h"
 #include "Image.h"
 #include "OpenGL_RenderSystem.h"
 #include "OpenGL_Texture.h"
@@ -48,7 +50,18 @@ namespace april
 		}
 		GL_SAFE_CALL(glGenTextures, (1, &this->textureId));
 		this->firstUpload = true;
-		return (this->textureId != 0);
+		if (this->textureId == 0)
+		{
+			return false;
+		}
+#if !defined(_WIN32) || defined(_OPENGLES)
+		// block compressed data has to be uploaded right away, including the mipmaps that came with it
+		if (data != NULL && this->format == Image::Format::Compressed && getBlockCompressedSize(this->dataFormat, 1, 1) > 0)
+		{
+			return this->_uploadBlockCompressedToGpu(data, size);
+		}
+#endif
+		return true;
 	}
 	
 	bool OpenGL_Texture::_deviceDestroyTexture()
@@ -66,6 +79,24 @@ namespace april
 		return false;
 	}
 
+	bool OpenGL_Texture::_deviceAllocateTexture()
+	{
+		if (this->textureId == 0 || this->format == Image::Format::Compressed || this->format == Image::Format::Palette || this->type == Type::External)
+		{
+			return false;
+		}
+		this->_setCurrentTexture();
+		glTexImage2D(this->internalType, 0, this->internalFormat, this->width, this->height, 0, this->glFormat, GL_UNSIGNED_BYTE, NULL);
+		GLenum glError = glGetError();
+		SAFE_TEXTURE_UPLOAD_CHECK(glError, glTexImage2D(this->internalType, 0, this->internalFormat, this->width, this->height, 0, this->glFormat, GL_UNSIGNED_BYTE, NULL));
+		if (glError != GL_NO_ERROR)
+		{
+			return false;
+		}
+		this->firstUpload = false;
+		return true;
+	}
+
 	void OpenGL_Texture::_assignFormat()
 	{
 		if (this->format == Image::Format::ARGB || this->format == Image::Format::XRGB || this->format == Image::Format::RGBA ||
@@ -128,7 +159,7 @@ namespace april
 	void OpenGL_Texture::_setCurrentTexture()
 	{
 		// filtering and address mode applied before loading texture data, some systems are optimized to work like this (e.g. iOS OpenGLES guidelines suggest it)
-		OGL_RENDERSYS->_setDeviceTextureFilter(this->filter);
+		OGL_RENDERSYS->_setDeviceTextureFilter(this->getEffectiveFilter());
 		OGL_RENDERSYS->_setDeviceTextureAddressMode(this->addressMode);
 		OGL_RENDERSYS->_setDeviceTexture(this);
 		OGL_RENDERSYS->deviceState->texture = this;
@@ -207,6 +238,63 @@ namespace april
 		return true;
 	}
 
+	bool OpenGL_Texture::_uploadMipmapToGpu(int level, int w, int h, unsigned char* data)
+	{
+		this->_setCurrentTexture();
+		glTexImage2D(this->internalType, level, this->internalFormat, w, h, 0, this->glFormat, GL_UNSIGNED_BYTE, data);
+		GLenum glError = glGetError();
+		SAFE_TEXTURE_UPLOAD_CHECK(glError, glTexImage2D(this->internalType, level, this->internalFormat, w, h, 0, this->glFormat, GL_UNSIGNED_BYTE, data));
+		return (glError == GL_NO_ERROR);
+	}
+
+#if !defined(_WIN32) || defined(_OPENGLES)
+	bool OpenGL_Texture::_uploadBlockCompressedToGpu(unsigned char* data, int size)
+	{
+		this->_setCurrentTexture();
+		int levelCount = 1;
+		if (this->mipmapsEnabled && april::rendersys->getCaps().mipmaps)
+		{
+			levelCount = Image::getMipmapLevelCount(this->width, this->height);
+		}
+		int w = this->width;
+		int h = this->height;
+		int levelSize = 0;
+		int offset = 0;
+		int level = 0;
+		GLenum glError = GL_NO_ERROR;
+		while (level < levelCount)
+		{
+			levelSize = getBlockCompressedSize(this->dataFormat, w, h);
+			// files don't have to contain a full chain, the remaining levels are simply not used
+			if (offset + levelSize > size)
+			{
+				break;
+			}
+			glCompressedTexImage2D(this->internalType, level, this->dataFormat, w, h, 0, levelSize, &data[offset]);
+			glError = glGetError();
+			SAFE_TEXTURE_UPLOAD_CHECK(glError, glCompressedTexImage2D(this->internalType, level, this->dataFormat, w, h, 0, levelSize, &data[offset]));
+			if (glError != GL_NO_ERROR)
+			{
+				break;
+			}
+			offset += levelSize;
+			w = hmax(w / 2, 1);
+			h = hmax(h / 2, 1);
+			++level;
+		}
+		if (level == 0)
+		{
+			hlog::error(logTag, "Could not upload block compressed data: " + this->_getInternalName());
+			this->_deviceDestroyTexture();
+			return false;
+		}
+		// sampling only uses the mipmaps when the chain is complete
+		this->mipmapsUploaded = (level > 1 && level == levelCount);
+		this->firstUpload = false;
+		return true;
+	}
+#endif
+
 	void OpenGL_Texture::_uploadPotSafeData(unsigned char* data)
 	{
 		glTexImage2D(this->internalType, 0, this->internalFormat, this->width, this->height, 0, this->glFormat, GL_UNSIGNED_BYTE, data);
@@ -62,11 +62,16 @@ namespace april
 
 		bool _deviceCreateTexture(unsigned char* data, int size);
 		bool _deviceDestroyTexture();
+		bool _deviceAllocateTexture();
 		void _assignFormat();
 
 		Lock _tryLockSystem(int x, int y, int w, int h);
 		bool _unlockSystem(Lock& lock, bool update);
 		bool _uploadToGpu(int sx, int sy, int sw, int sh, int dx, int dy, unsigned char* srcData, int srcWidth, int srcHeight, Image::Format srcFormat);
+		bool _uploadMipmapToGpu(int level, int w, int h, unsigned char* data);
+#if !defined(_WIN32) || defined(_OPENGLES)
+		bool _uploadBlockCompressedToGpu(unsigned char* data, int size);
+#endif
 
 		void _uploadPotSafeData(unsigned char* data);
 		void _uploadPotSafeClearData();
@@ -0,0 +1,90 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#ifdef _OPENGL
+#define __HL_INCLUDE_PLATFORM_HEADERS
+#include <hltypes/hplatform.h>
+
+#include <hltypes/hlog.h>
+
+#include "april.h"
+#include "OpenGL_RenderSystem.h"
+#include "OpenGL_VertexBuffer.h"
+
+namespace april
+{
+	OpenGL_VertexBuffer::OpenGL_VertexBuffer() :
+		VertexBuffer(),
+		bufferId(0)
+	{
+	}
+
+	bool OpenGL_VertexBuffer::_deviceCreateBuffer(unsigned char* data, int size)
+	{
+		// GL 1.x on Windows doesn't expose buffer objects without loading extensions so the vertices are rendered from RAM there
+#if !defined(_WIN32) || defined(_OPENGLES)
+		if (!april::rendersys->canUseLowLevelCalls())
+		{
+			return false;
+		}
+		GL_SAFE_CALL(glGenBuffers, (1, &this->bufferId));
+		if (this->bufferId == 0)
+		{
+			return false;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, this->bufferId);
+		glBufferData(GL_ARRAY_BUFFER, size, data, (this->usage == Usage::Dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
+		GLenum glError = glGetError();
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		if (glError != GL_NO_ERROR)
+		{
+			hlog::errorf(logTag, "Failed to upload vertex buffer data, GL error code: 0x%X!", glError);
+			glDeleteBuffers(1, &this->bufferId);
+			this->bufferId = 0;
+			return false;
+		}
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	bool OpenGL_VertexBuffer::_deviceDestroyBuffer()
+	{
+		if (this->bufferId != 0)
+		{
+#if !defined(_WIN32) || defined(_OPENGLES)
+			if (april::rendersys->canUseLowLevelCalls())
+			{
+				glDeleteBuffers(1, &this->bufferId);
+			}
+#endif
+			this->bufferId = 0;
+			return true;
+		}
+		return false;
+	}
+
+	bool OpenGL_VertexBuffer::_deviceUpdateBuffer(int offset, unsigned char* data, int size)
+	{
+#if !defined(_WIN32) || defined(_OPENGLES)
+		if (this->bufferId == 0 || !april::rendersys->canUseLowLevelCalls())
+		{
+			return false;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, this->bufferId);
+		GL_SAFE_CALL(glBufferSubData, (GL_ARRAY_BUFFER, offset, size, data));
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		return true;
+#else
+		return false;
+#endif
+	}
+
+}
+#endif
@@ -0,0 +1,42 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a generic OpenGL vertex buffer.
+
+#ifdef _OPENGL
+#ifndef APRIL_OPENGL_VERTEX_BUFFER_H
+#define APRIL_OPENGL_VERTEX_BUFFER_H
+
+#include "OpenGL_RenderSystem.h" // for GL header inclusion
+#include "VertexBuffer.h"
+
+namespace april
+{
+	class OpenGL_RenderSystem;
+
+	class OpenGL_VertexBuffer : public VertexBuffer
+	{
+	public:
+		friend class OpenGL_RenderSystem;
+
+		OpenGL_VertexBuffer();
+
+	protected:
+		unsigned int bufferId;
+
+		bool _deviceCreateBuffer(unsigned char* data, int size);
+		bool _deviceDestroyBuffer();
+		bool _deviceUpdateBuffer(int offset, unsigned char* data, int size);
+
+	};
+	
+}
+#endif
+#endif
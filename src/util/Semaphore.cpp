@@ -0,0 +1,135 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#ifdef _WIN32
+#define __HL_INCLUDE_PLATFORM_HEADERS
+#include <hltypes/hplatform.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/time.h>
+#endif
+
+#include <hltypes/hltypesUtil.h>
+
+#include "Semaphore.h"
+
+namespace april
+{
+#ifndef _WIN32
+	struct SemaphoreData
+	{
+		pthread_mutex_t mutex;
+		pthread_cond_t condition;
+		int count;
+		int maxCount;
+	};
+#endif
+
+	Semaphore::Semaphore(int initialCount, int maxCount)
+	{
+#ifdef _WIN32
+		this->data = (void*)CreateSemaphoreExW(NULL, (LONG)initialCount, (LONG)maxCount, NULL, 0, SEMAPHORE_ALL_ACCESS);
+#else
+		SemaphoreData* semaphoreData = new SemaphoreData();
+		pthread_mutex_init(&semaphoreData->mutex, NULL);
+		pthread_cond_init(&semaphoreData->condition, NULL);
+		semaphoreData->count = initialCount;
+		semaphoreData->maxCount = maxCount;
+		this->data = semaphoreData;
+#endif
+	}
+
+	Semaphore::~Semaphore()
+	{
+#ifdef _WIN32
+		if (this->data != NULL)
+		{
+			CloseHandle((HANDLE)this->data);
+		}
+#else
+		SemaphoreData* semaphoreData = (SemaphoreData*)this->data;
+		pthread_cond_destroy(&semaphoreData->condition);
+		pthread_mutex_destroy(&semaphoreData->mutex);
+		delete semaphoreData;
+#endif
+	}
+
+	void Semaphore::signal(int count)
+	{
+		if (count <= 0)
+		{
+			return;
+		}
+#ifdef _WIN32
+		// releasing beyond the maximum count fails so the count is saturated one by one
+		for_iter (i, 0, count)
+		{
+			if (!ReleaseSemaphore((HANDLE)this->data, 1, NULL))
+			{
+				break;
+			}
+		}
+#else
+		SemaphoreData* semaphoreData = (SemaphoreData*)this->data;
+		pthread_mutex_lock(&semaphoreData->mutex);
+		semaphoreData->count = hmin(semaphoreData->count + count, semaphoreData->maxCount);
+		if (count == 1)
+		{
+			pthread_cond_signal(&semaphoreData->condition);
+		}
+		else
+		{
+			pthread_cond_broadcast(&semaphoreData->condition);
+		}
+		pthread_mutex_unlock(&semaphoreData->mutex);
+#endif
+	}
+
+	bool Semaphore::wait(float timeout)
+	{
+#ifdef _WIN32
+		DWORD milliseconds = (timeout < 0.0f ? INFINITE : (DWORD)hceil(timeout));
+		return (WaitForSingleObjectEx((HANDLE)this->data, milliseconds, FALSE) == WAIT_OBJECT_0);
+#else
+		SemaphoreData* semaphoreData = (SemaphoreData*)this->data;
+		pthread_mutex_lock(&semaphoreData->mutex);
+		if (timeout < 0.0f)
+		{
+			while (semaphoreData->count <= 0)
+			{
+				pthread_cond_wait(&semaphoreData->condition, &semaphoreData->mutex);
+			}
+		}
+		else if (semaphoreData->count <= 0)
+		{
+			// gettimeofday() is used, because clock_gettime() isn't available on older Mac OS X versions
+			struct timeval now;
+			gettimeofday(&now, NULL);
+			int64_t nanoseconds = (int64_t)now.tv_usec * 1000LL + (int64_t)(timeout * 1000000.0f);
+			struct timespec until;
+			until.tv_sec = now.tv_sec + (time_t)(nanoseconds / 1000000000LL);
+			until.tv_nsec = (long)(nanoseconds % 1000000000LL);
+			int result = 0;
+			while (semaphoreData->count <= 0 && result != ETIMEDOUT)
+			{
+				result = pthread_cond_timedwait(&semaphoreData->condition, &semaphoreData->mutex, &until);
+			}
+		}
+		bool result = (semaphoreData->count > 0);
+		if (result)
+		{
+			--semaphoreData->count;
+		}
+		pthread_mutex_unlock(&semaphoreData->mutex);
+		return result;
+#endif
+	}
+
+}
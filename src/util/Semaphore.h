@@ -0,0 +1,52 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a counting semaphore for thread handoff.
+
+#ifndef APRIL_SEMAPHORE_H
+#define APRIL_SEMAPHORE_H
+
+/// @brief Safe-guard for thread handoff waits in case a signal is never sent, in milliseconds.
+#define HANDOFF_TIMEOUT 100.0f
+
+namespace april
+{
+	/// @brief Counting semaphore used to hand off work between threads without polling.
+	class Semaphore
+	{
+	public:
+		/// @brief Basic constructor.
+		/// @param[in] initialCount The initial count.
+		/// @param[in] maxCount The maximum count.
+		/// @note A maximum count of 1 makes this a simple wake-up signal where multiple signals before a wait are merged.
+		Semaphore(int initialCount = 0, int maxCount = 1);
+		/// @brief Destructor.
+		~Semaphore();
+
+		/// @brief Increases the count up to the maximum and wakes up as many waiting threads.
+		/// @param[in] count By how much the count is increased.
+		void signal(int count = 1);
+		/// @brief Waits until the count is positive and decreases it.
+		/// @param[in] timeout The timeout in milliseconds. Negative values wait indefinitely.
+		/// @return False if the timeout ran out.
+		bool wait(float timeout = -1.0f);
+
+	protected:
+		/// @brief Platform specific data.
+		void* data;
+
+	private:
+		Semaphore(const Semaphore& other);
+		Semaphore& operator=(const Semaphore& other);
+
+	};
+	
+}
+#endif
@@ -0,0 +1,215 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <hltypes/harray.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hmutex.h>
+#include <hltypes/hthread.h>
+
+#include "april.h"
+#include "Profiler.h"
+#include "Semaphore.h"
+#include "WorkerPool.h"
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+// more bands than threads so threads that finish early can help out
+#define BANDS_PER_THREAD 4
+#define MAX_WAKE_UPS 65536
+
+namespace april
+{
+	struct WorkerPoolJob
+	{
+		WorkerPool::BandFunction bandFunction;
+		WorkerPool::TaskFunction taskFunction;
+		void* data;
+		int count;
+		int bandSize;
+		int next;
+		int remaining;
+		Semaphore* finished; // NULL for queued tasks, they are deleted by the pool
+	};
+
+	static hmutex jobsMutex;
+	static harray<WorkerPoolJob*> jobs;
+	static harray<hthread*> workers;
+	static Semaphore* wakeUp = NULL;
+	static bool running = false;
+	static THREAD_LOCAL bool insideBand = false;
+
+	// claims and executes one band, returns false if there was nothing left to claim
+	static bool _executeBand(WorkerPoolJob* ownJob)
+	{
+		hmutex::ScopeLock lock(&jobsMutex);
+		WorkerPoolJob* job = ownJob;
+		if (job == NULL)
+		{
+			if (jobs.size() == 0)
+			{
+				return false;
+			}
+			job = jobs.first();
+		}
+		if (job->next >= job->count)
+		{
+			return false;
+		}
+		int start = job->next;
+		int end = hmin(start + job->bandSize, job->count);
+		job->next = end;
+		if (end >= job->count)
+		{
+			jobs -= job;
+		}
+		lock.release();
+		if (job->taskFunction != NULL)
+		{
+			// a task may still split its own work into bands
+			job->taskFunction(job->data);
+		}
+		else
+		{
+			insideBand = true;
+			job->bandFunction(job->data, start, end);
+			insideBand = false;
+		}
+		lock.acquire(&jobsMutex);
+		--job->remaining;
+		if (job->remaining == 0)
+		{
+			if (job->finished != NULL)
+			{
+				job->finished->signal();
+			}
+			else
+			{
+				delete job;
+			}
+		}
+		return true;
+	}
+
+	static void _executeWorker(hthread* thread)
+	{
+		APRIL_PROFILE_THREAD("APRIL worker");
+		bool stopping = false;
+		while (!stopping)
+		{
+			wakeUp->wait();
+			while (_executeBand(NULL))
+			{
+			}
+			hmutex::ScopeLock lock(&jobsMutex);
+			stopping = !running;
+		}
+		APRIL_PROFILE_THREAD_END();
+	}
+
+	// has to be called while jobsMutex is locked
+	static void _ensureWorkers(int count)
+	{
+		if (wakeUp == NULL)
+		{
+			wakeUp = new Semaphore(0, MAX_WAKE_UPS);
+		}
+		running = true;
+		hthread* worker = NULL;
+		while (workers.size() < count)
+		{
+			worker = new hthread(&_executeWorker, "APRIL worker");
+			worker->start();
+			workers += worker;
+		}
+	}
+
+	void WorkerPool::run(int count, BandFunction function, void* data)
+	{
+		int threadCount = april::getMaxWorkerThreads();
+		if (count <= 1 || threadCount <= 1 || insideBand)
+		{
+			function(data, 0, count);
+			return;
+		}
+		Semaphore finished;
+		WorkerPoolJob job;
+		job.bandFunction = function;
+		job.taskFunction = NULL;
+		job.data = data;
+		job.count = count;
+		job.bandSize = hmax(count / (threadCount * BANDS_PER_THREAD), 1);
+		job.next = 0;
+		job.remaining = (count + job.bandSize - 1) / job.bandSize;
+		job.finished = &finished;
+		hmutex::ScopeLock lock(&jobsMutex);
+		_ensureWorkers(threadCount - 1);
+		jobs += &job;
+		int wakeUps = hmin(job.remaining - 1, workers.size());
+		lock.release();
+		wakeUp->signal(wakeUps);
+		// the calling thread helps out with its own bands instead of just waiting
+		while (_executeBand(&job))
+		{
+		}
+		finished.wait();
+		// the band that signaled might still hold the lock so the job can't be destroyed yet
+		lock.acquire(&jobsMutex);
+	}
+
+	void WorkerPool::queue(TaskFunction function, void* data)
+	{
+		WorkerPoolJob* job = new WorkerPoolJob();
+		job->bandFunction = NULL;
+		job->taskFunction = function;
+		job->data = data;
+		job->count = 1;
+		job->bandSize = 1;
+		job->next = 0;
+		job->remaining = 1;
+		job->finished = NULL;
+		hmutex::ScopeLock lock(&jobsMutex);
+		_ensureWorkers(hmax(april::getMaxWorkerThreads() - 1, 1));
+		jobs += job;
+		lock.release();
+		wakeUp->signal();
+	}
+
+	bool WorkerPool::canSplit()
+	{
+		return (!insideBand && april::getMaxWorkerThreads() > 1);
+	}
+
+	void WorkerPool::destroy()
+	{
+		hmutex::ScopeLock lock(&jobsMutex);
+		running = false;
+		harray<hthread*> stoppedWorkers = workers;
+		workers.clear();
+		lock.release();
+		if (stoppedWorkers.size() == 0)
+		{
+			return;
+		}
+		wakeUp->signal(stoppedWorkers.size());
+		foreach (hthread*, it, stoppedWorkers)
+		{
+			(*it)->join();
+			delete (*it);
+		}
+		lock.acquire(&jobsMutex);
+		if (workers.size() == 0)
+		{
+			delete wakeUp;
+			wakeUp = NULL;
+		}
+	}
+
+}
@@ -0,0 +1,402 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <stdint.h>
+#include <string.h>
+
+#include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hstring.h>
+
+#include "april.h"
+#include "blockCompression.h"
+#include "Image.h"
+#include "RenderSystem.h"
+#include "WorkerPool.h"
+
+#define BLOCK_FAMILY_BC 0
+#define BLOCK_FAMILY_ETC1 1
+#define BLOCK_FAMILY_ETC2 2
+#define BLOCK_FAMILY_ASTC 3
+
+namespace april
+{
+	struct BlockFormat
+	{
+		unsigned int internalFormat;
+		int family;
+		int blockWidth;
+		int blockHeight;
+		int blockSize;
+	};
+
+	struct BcDecodeData
+	{
+		unsigned int internalFormat;
+		unsigned char* srcData;
+		int blocksX;
+		int width;
+		int height;
+		unsigned char* destData;
+		int destBpp;
+		int destIndices[4];
+	};
+
+	static const BlockFormat blockFormats[] =
+	{
+		{APRIL_COMPRESSED_BC1_RGB, BLOCK_FAMILY_BC, 4, 4, 8},
+		{APRIL_COMPRESSED_BC1_RGBA, BLOCK_FAMILY_BC, 4, 4, 8},
+		{APRIL_COMPRESSED_BC2, BLOCK_FAMILY_BC, 4, 4, 16},
+		{APRIL_COMPRESSED_BC3, BLOCK_FAMILY_BC, 4, 4, 16},
+		{APRIL_COMPRESSED_ETC1, BLOCK_FAMILY_ETC1, 4, 4, 8},
+		{APRIL_COMPRESSED_ETC2_RGB, BLOCK_FAMILY_ETC2, 4, 4, 8},
+		{APRIL_COMPRESSED_ETC2_RGB_A1, BLOCK_FAMILY_ETC2, 4, 4, 8},
+		{APRIL_COMPRESSED_ETC2_RGBA, BLOCK_FAMILY_ETC2, 4, 4, 16}
+	};
+
+	static const int astcBlockSizes[APRIL_COMPRESSED_ASTC_COUNT][2] =
+	{
+		{4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6},
+		{8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}
+	};
+
+	static bool _findBlockFormat(unsigned int internalFormat, BlockFormat& format)
+	{
+		internalFormat = getBlockCompressedLinearFormat(internalFormat);
+		for_iter (i, 0, (int)(sizeof(blockFormats) / sizeof(BlockFormat)))
+		{
+			if (blockFormats[i].internalFormat == internalFormat)
+			{
+				format = blockFormats[i];
+				return true;
+			}
+		}
+		int astcIndex = (int)internalFormat - APRIL_COMPRESSED_ASTC_FIRST;
+		if (astcIndex >= 0 && astcIndex < APRIL_COMPRESSED_ASTC_COUNT)
+		{
+			format.internalFormat = internalFormat;
+			format.family = BLOCK_FAMILY_ASTC;
+			format.blockWidth = astcBlockSizes[astcIndex][0];
+			format.blockHeight = astcBlockSizes[astcIndex][1];
+			format.blockSize = 16; // every ASTC block has 128 bits
+			return true;
+		}
+		return false;
+	}
+
+	bool isContainerImageSizeValid(int width, int height)
+	{
+		// 4 bytes per pixel is the largest decoded format and a mipmap chain adds less than half of the base level
+		return (width > 0 && height > 0 && (int64_t)width * (int64_t)height * 6 <= (int64_t)0x7FFFFFFF);
+	}
+
+	int getBlockCompressedSize(unsigned int internalFormat, int width, int height)
+	{
+		BlockFormat format;
+		if (!_findBlockFormat(internalFormat, format))
+		{
+			return 0;
+		}
+		return (((width + format.blockWidth - 1) / format.blockWidth) * ((height + format.blockHeight - 1) / format.blockHeight) * format.blockSize);
+	}
+
+	int getBlockCompressedSize(unsigned int internalFormat, int width, int height, int levelCount)
+	{
+		int result = 0;
+		for_iter (i, 0, levelCount)
+		{
+			result += getBlockCompressedSize(internalFormat, width, height);
+			width = hmax(width / 2, 1);
+			height = hmax(height / 2, 1);
+		}
+		return result;
+	}
+
+	unsigned int getBlockCompressedLinearFormat(unsigned int internalFormat)
+	{
+		switch (internalFormat)
+		{
+		case APRIL_COMPRESSED_BC1_SRGB:			return APRIL_COMPRESSED_BC1_RGB;
+		case APRIL_COMPRESSED_BC1_SRGB_ALPHA:	return APRIL_COMPRESSED_BC1_RGBA;
+		case APRIL_COMPRESSED_BC2_SRGB:			return APRIL_COMPRESSED_BC2;
+		case APRIL_COMPRESSED_BC3_SRGB:			return APRIL_COMPRESSED_BC3;
+		case APRIL_COMPRESSED_ETC2_SRGB:		return APRIL_COMPRESSED_ETC2_RGB;
+		case APRIL_COMPRESSED_ETC2_SRGB_A1:		return APRIL_COMPRESSED_ETC2_RGB_A1;
+		case APRIL_COMPRESSED_ETC2_SRGB_ALPHA:	return APRIL_COMPRESSED_ETC2_RGBA;
+		}
+		int astcIndex = (int)internalFormat - APRIL_COMPRESSED_ASTC_SRGB_FIRST;
+		if (astcIndex >= 0 && astcIndex < APRIL_COMPRESSED_ASTC_COUNT)
+		{
+			return (APRIL_COMPRESSED_ASTC_FIRST + astcIndex);
+		}
+		return internalFormat;
+	}
+
+	bool isBlockCompressionSupported(unsigned int internalFormat)
+	{
+		BlockFormat format;
+		if (april::rendersys == NULL || !_findBlockFormat(internalFormat, format))
+		{
+			return false;
+		}
+		RenderSystem::Caps caps = april::rendersys->getCaps();
+		if (!caps.textureFormats.has(Image::Format::Compressed))
+		{
+			return false;
+		}
+		switch (format.family)
+		{
+		case BLOCK_FAMILY_BC:	return caps.bcTextures;
+		case BLOCK_FAMILY_ETC1:	return caps.etc1Textures;
+		case BLOCK_FAMILY_ETC2:	return caps.etc2Textures;
+		case BLOCK_FAMILY_ASTC:	return caps.astcTextures;
+		}
+		return false;
+	}
+
+	bool canDecodeBlockCompressed(unsigned int internalFormat)
+	{
+		BlockFormat format;
+		if (!_findBlockFormat(internalFormat, format))
+		{
+			return false;
+		}
+		return (format.family == BLOCK_FAMILY_BC || format.family == BLOCK_FAMILY_ETC1 || format.internalFormat == APRIL_COMPRESSED_ETC2_RGB ||
+			format.internalFormat == APRIL_COMPRESSED_ETC2_RGBA);
+	}
+
+	static inline unsigned int _readUint16(const unsigned char* data)
+	{
+		return (data[0] | (data[1] << 8));
+	}
+
+	// BC1 color blocks are also used by BC2 and BC3, but those always use the 4-color mode
+	static void _decodeBc1Block(const unsigned char* data, bool fourColorsOnly, bool punchThrough, unsigned char pixels[16][4])
+	{
+		unsigned int color0 = _readUint16(data);
+		unsigned int color1 = _readUint16(&data[2]);
+		unsigned char colors[4][4];
+		colors[0][0] = (unsigned char)(((color0 >> 11) & 0x1F) * 255 / 31);
+		colors[0][1] = (unsigned char)(((color0 >> 5) & 0x3F) * 255 / 63);
+		colors[0][2] = (unsigned char)((color0 & 0x1F) * 255 / 31);
+		colors[0][3] = 255;
+		colors[1][0] = (unsigned char)(((color1 >> 11) & 0x1F) * 255 / 31);
+		colors[1][1] = (unsigned char)(((color1 >> 5) & 0x3F) * 255 / 63);
+		colors[1][2] = (unsigned char)((color1 & 0x1F) * 255 / 31);
+		colors[1][3] = 255;
+		bool fourColors = (fourColorsOnly || color0 > color1);
+		for_iter (c, 0, 3)
+		{
+			if (fourColors)
+			{
+				colors[2][c] = (unsigned char)((colors[0][c] * 2 + colors[1][c] + 1) / 3);
+				colors[3][c] = (unsigned char)((colors[0][c] + colors[1][c] * 2 + 1) / 3);
+			}
+			else
+			{
+				colors[2][c] = (unsigned char)((colors[0][c] + colors[1][c] + 1) / 2);
+				colors[3][c] = 0;
+			}
+		}
+		colors[2][3] = 255;
+		colors[3][3] = (fourColors || !punchThrough ? 255 : 0);
+		unsigned int indices = data[4] | (data[5] << 8) | (data[6] << 16) | ((unsigned int)data[7] << 24);
+		for_iter (i, 0, 16)
+		{
+			memcpy(pixels[i], colors[(indices >> (i * 2)) & 0x3], 4);
+		}
+	}
+
+	static void _decodeBc2AlphaBlock(const unsigned char* data, unsigned char pixels[16][4])
+	{
+		int value = 0;
+		for_iter (i, 0, 16)
+		{
+			value = (data[i / 2] >> ((i % 2) * 4)) & 0xF;
+			pixels[i][3] = (unsigned char)(value | (value << 4));
+		}
+	}
+
+	static void _decodeBc3AlphaBlock(const unsigned char* data, unsigned char pixels[16][4])
+	{
+		int alphas[8];
+		alphas[0] = data[0];
+		alphas[1] = data[1];
+		if (alphas[0] > alphas[1])
+		{
+			for_iter (i, 1, 7)
+			{
+				alphas[i + 1] = (alphas[0] * (7 - i) + alphas[1] * i + 3) / 7;
+			}
+		}
+		else
+		{
+			for_iter (i, 1, 5)
+			{
+				alphas[i + 1] = (alphas[0] * (5 - i) + alphas[1] * i + 2) / 5;
+			}
+			alphas[6] = 0;
+			alphas[7] = 255;
+		}
+		// 16 indices with 3 bits each are packed into 6 bytes
+		uint64_t indices = 0;
+		for_iter (i, 0, 6)
+		{
+			indices |= ((uint64_t)data[2 + i] << (i * 8));
+		}
+		for_iter (i, 0, 16)
+		{
+			pixels[i][3] = (unsigned char)alphas[(indices >> (i * 3)) & 0x7];
+		}
+	}
+
+	// block rows write to different pixels so they can be decoded in parallel
+	static void _decodeBcRows(void* decodeData, int firstRow, int lastRow)
+	{
+		BcDecodeData* data = (BcDecodeData*)decodeData;
+		unsigned char pixels[16][4];
+		unsigned char* block = NULL;
+		unsigned char* pixel = NULL;
+		unsigned char* dest = NULL;
+		bool bc1 = (data->internalFormat == APRIL_COMPRESSED_BC1_RGB || data->internalFormat == APRIL_COMPRESSED_BC1_RGBA);
+		int blockSize = (bc1 ? 8 : 16);
+		int width = 0;
+		int height = 0;
+		int x = 0;
+		int y = 0;
+		int c = 0;
+		for_iter (j, firstRow, lastRow)
+		{
+			height = hmin(data->height - j * 4, 4);
+			for_iter (i, 0, data->blocksX)
+			{
+				block = &data->srcData[(j * data->blocksX + i) * blockSize];
+				if (bc1)
+				{
+					_decodeBc1Block(block, false, (data->internalFormat == APRIL_COMPRESSED_BC1_RGBA), pixels);
+				}
+				else
+				{
+					_decodeBc1Block(&block[8], true, false, pixels);
+					if (data->internalFormat == APRIL_COMPRESSED_BC2)
+					{
+						_decodeBc2AlphaBlock(block, pixels);
+					}
+					else
+					{
+						_decodeBc3AlphaBlock(block, pixels);
+					}
+				}
+				width = hmin(data->width - i * 4, 4);
+				for_iterx (y, 0, height)
+				{
+					dest = &data->destData[((j * 4 + y) * data->width + i * 4) * data->destBpp];
+					for_iterx (x, 0, width)
+					{
+						pixel = pixels[y * 4 + x];
+						for_iterx (c, 0, 4)
+						{
+							if (data->destIndices[c] >= 0)
+							{
+								dest[data->destIndices[c]] = pixel[c];
+							}
+						}
+						dest += data->destBpp;
+					}
+				}
+			}
+		}
+	}
+
+	static void _decodeBc(unsigned int internalFormat, unsigned char* srcData, int width, int height, unsigned char* destData, Image::Format destFormat)
+	{
+		BcDecodeData data;
+		data.internalFormat = internalFormat;
+		data.srcData = srcData;
+		data.blocksX = (width + 3) / 4;
+		data.width = width;
+		data.height = height;
+		data.destData = destData;
+		data.destBpp = destFormat.getBpp();
+		destFormat.getChannelIndices(&data.destIndices[0], &data.destIndices[1], &data.destIndices[2], &data.destIndices[3]);
+		int blocksY = (height + 3) / 4;
+		// images smaller than the threshold are decoded on the calling thread only
+		int threshold = april::getParallelPixelThreshold();
+		if (threshold > 0 && width * height >= threshold)
+		{
+			WorkerPool::run(blocksY, &_decodeBcRows, &data);
+		}
+		else
+		{
+			_decodeBcRows(&data, 0, blocksY);
+		}
+	}
+
+	bool decodeBlockCompressed(unsigned int internalFormat, unsigned char* srcData, int width, int height, unsigned char* destData, Image::Format destFormat)
+	{
+		if (!canDecodeBlockCompressed(internalFormat))
+		{
+			return false;
+		}
+		internalFormat = getBlockCompressedLinearFormat(internalFormat);
+		if (internalFormat == APRIL_COMPRESSED_ETC1 || internalFormat == APRIL_COMPRESSED_ETC2_RGB || internalFormat == APRIL_COMPRESSED_ETC2_RGBA)
+		{
+			decodeEtc(srcData, (internalFormat != APRIL_COMPRESSED_ETC1), (internalFormat == APRIL_COMPRESSED_ETC2_RGBA), width, height, destData, destFormat);
+		}
+		else
+		{
+			_decodeBc(internalFormat, srcData, width, height, destData, destFormat);
+		}
+		return true;
+	}
+
+	Image* createBlockCompressedImage(unsigned int internalFormat, int width, int height, unsigned char* data, int size)
+	{
+		if (isBlockCompressionSupported(internalFormat))
+		{
+			Image* image = Image::create(width, height, NULL, Image::Format::Compressed);
+			image->internalFormat = (int)getBlockCompressedLinearFormat(internalFormat);
+			image->compressedSize = size;
+			image->data = data;
+			return image;
+		}
+		if (!canDecodeBlockCompressed(internalFormat))
+		{
+			hlog::errorf(logTag, "Block compressed format 0x%X is not supported on this device!", internalFormat);
+			if (data != NULL)
+			{
+				delete[] data;
+			}
+			return NULL;
+		}
+		// not supported by the GPU so it's decoded on the CPU
+		unsigned int linearFormat = getBlockCompressedLinearFormat(internalFormat);
+		Image::Format format = (linearFormat == APRIL_COMPRESSED_BC1_RGB || linearFormat == APRIL_COMPRESSED_ETC1 || linearFormat == APRIL_COMPRESSED_ETC2_RGB ? Image::Format::RGBX : Image::Format::RGBA);
+		if (april::rendersys != NULL)
+		{
+			format = april::rendersys->getNativeTextureFormat(format);
+		}
+		Image* image = Image::create(width, height, NULL, format);
+		if (data == NULL)
+		{
+			return image;
+		}
+		if (size < getBlockCompressedSize(internalFormat, width, height))
+		{
+			hlog::error(logTag, "Block compressed data is incomplete!");
+			delete[] data;
+			delete image;
+			return NULL;
+		}
+		image->data = new unsigned char[image->getByteSize()];
+		decodeBlockCompressed(internalFormat, data, width, height, image->data, format);
+		delete[] data;
+		return image;
+	}
+
+}
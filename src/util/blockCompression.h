@@ -0,0 +1,103 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines utility functions for block compressed texture data.
+
+#ifndef APRIL_BLOCK_COMPRESSION_H
+#define APRIL_BLOCK_COMPRESSION_H
+
+#include "Image.h"
+
+// these are the same values as the OpenGL enums so they can be used as Image::internalFormat directly
+#define APRIL_COMPRESSED_BC1_RGB 0x83F0
+#define APRIL_COMPRESSED_BC1_RGBA 0x83F1
+#define APRIL_COMPRESSED_BC2 0x83F2
+#define APRIL_COMPRESSED_BC3 0x83F3
+#define APRIL_COMPRESSED_BC1_SRGB 0x8C4C
+#define APRIL_COMPRESSED_BC1_SRGB_ALPHA 0x8C4D
+#define APRIL_COMPRESSED_BC2_SRGB 0x8C4E
+#define APRIL_COMPRESSED_BC3_SRGB 0x8C4F
+#define APRIL_COMPRESSED_ETC1 0x8D64
+#define APRIL_COMPRESSED_ETC2_RGB 0x9274
+#define APRIL_COMPRESSED_ETC2_SRGB 0x9275
+#define APRIL_COMPRESSED_ETC2_RGB_A1 0x9276
+#define APRIL_COMPRESSED_ETC2_SRGB_A1 0x9277
+#define APRIL_COMPRESSED_ETC2_RGBA 0x9278
+#define APRIL_COMPRESSED_ETC2_SRGB_ALPHA 0x9279
+// ASTC formats are consecutive for the 14 block sizes from 4x4 to 12x12
+#define APRIL_COMPRESSED_ASTC_FIRST 0x93B0
+#define APRIL_COMPRESSED_ASTC_SRGB_FIRST 0x93D0
+#define APRIL_COMPRESSED_ASTC_COUNT 14
+
+namespace april
+{
+	/// @brief Checks whether the size of an image from a container file can be used safely.
+	/// @param[in] width Width of the base level.
+	/// @param[in] height Height of the base level.
+	/// @return True if the size is positive and the decoded data including a mipmap chain fits into an int byte size.
+	bool isContainerImageSizeValid(int width, int height);
+	/// @brief Gets the byte size of one level of block compressed data.
+	/// @param[in] internalFormat The block compressed format.
+	/// @param[in] width Width of the level.
+	/// @param[in] height Height of the level.
+	/// @return The byte size or 0 if the format isn't a known block compressed format.
+	int getBlockCompressedSize(unsigned int internalFormat, int width, int height);
+	/// @brief Gets the byte size of a mipmap chain of block compressed data.
+	/// @param[in] internalFormat The block compressed format.
+	/// @param[in] width Width of the base level.
+	/// @param[in] height Height of the base level.
+	/// @param[in] levelCount Number of levels including the base level.
+	/// @return The byte size or 0 if the format isn't a known block compressed format.
+	int getBlockCompressedSize(unsigned int internalFormat, int width, int height, int levelCount);
+	/// @brief Gets the linear equivalent of an sRGB block compressed format.
+	/// @param[in] internalFormat The block compressed format.
+	/// @return The linear format or internalFormat if it's already linear.
+	/// @note Image data is not treated as sRGB anywhere else either so it's sampled as is.
+	unsigned int getBlockCompressedLinearFormat(unsigned int internalFormat);
+	/// @brief Checks whether block compressed data can be uploaded to the GPU without decoding.
+	/// @param[in] internalFormat The block compressed format.
+	/// @return True if the current RenderSystem reports support for the format.
+	bool isBlockCompressionSupported(unsigned int internalFormat);
+	/// @brief Checks whether block compressed data can be decoded on the CPU.
+	/// @param[in] internalFormat The block compressed format.
+	/// @return True if there is a CPU decoder for the format.
+	bool canDecodeBlockCompressed(unsigned int internalFormat);
+	/// @brief Decodes the base level of block compressed data on the CPU.
+	/// @param[in] internalFormat The block compressed format.
+	/// @param[in] srcData The block compressed data.
+	/// @param[in] width Width of the base level.
+	/// @param[in] height Height of the base level.
+	/// @param[out] destData Where the decoded pixels are written.
+	/// @param[in] destFormat Format of the decoded pixels.
+	/// @return True if successful.
+	/// @note BC1, BC2, BC3, ETC1 and ETC2 without punch-through alpha can be decoded.
+	bool decodeBlockCompressed(unsigned int internalFormat, unsigned char* srcData, int width, int height, unsigned char* destData, Image::Format destFormat);
+	/// @brief Creates an Image from block compressed data that was loaded from a container file.
+	/// @param[in] internalFormat The block compressed format.
+	/// @param[in] width Width of the base level.
+	/// @param[in] height Height of the base level.
+	/// @param[in] data The block compressed data of all mipmap levels one after another or NULL if only meta data is needed.
+	/// @param[in] size Byte size of the data.
+	/// @return The created Image object or NULL if failed.
+	/// @note If the data can't be uploaded directly, the base level is decoded on the CPU and the data is deleted.
+	Image* createBlockCompressedImage(unsigned int internalFormat, int width, int height, unsigned char* data, int size);
+	/// @brief Decodes ETC1 and ETC2 data on the CPU.
+	/// @param[in] srcData The ETC data.
+	/// @param[in] etc2 Whether the data is ETC2.
+	/// @param[in] alpha Whether the data has EAC alpha blocks (ETC2) or a second alpha image (ETC1).
+	/// @param[in] width Width of the image.
+	/// @param[in] height Height of the image.
+	/// @param[out] destData Where the decoded pixels are written.
+	/// @param[in] destFormat Format of the decoded pixels.
+	/// @note This is implemented in ImageEtcx.cpp.
+	void decodeEtc(unsigned char* srcData, bool etc2, bool alpha, int width, int height, unsigned char* destData, Image::Format destFormat);
+
+}
+#endif
@@ -0,0 +1,152 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUAD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define QUAD_NEON
+#include <arm_neon.h>
+#endif
+
+#include <hltypes/hltypesUtil.h>
+
+#include "quadInstances.h"
+
+namespace april
+{
+	// corner order of a quad is top-left, top-right, bottom-left, bottom-right
+	static const int quadIndices[APRIL_QUAD_INSTANCE_VERTICES_COUNT] = {0, 1, 2, 2, 1, 3};
+
+	static inline void _writeQuad(ColoredTexturedVertex* vertices, const float* x, const float* y, float z, unsigned int color, const float* u, const float* v)
+	{
+		int index = 0;
+		for_iter (i, 0, APRIL_QUAD_INSTANCE_VERTICES_COUNT)
+		{
+			index = quadIndices[i];
+			vertices[i].x = x[index];
+			vertices[i].y = y[index];
+			vertices[i].z = z;
+			vertices[i].color = color;
+			vertices[i].u = u[index];
+			vertices[i].v = v[index];
+		}
+	}
+
+	void expandQuadInstances(cgrectf rect, float z, const QuadInstance* instances, int count, ColoredTexturedVertex* vertices)
+	{
+		float x[4];
+		float y[4];
+		float u[4];
+		float v[4];
+		int i = 0;
+#ifdef QUAD_SSE2
+		// corner coordinates of the base quad and the UV interpolation factors
+		const __m128 cornerX = _mm_setr_ps(rect.x, rect.x + rect.w, rect.x, rect.x + rect.w);
+		const __m128 cornerY = _mm_setr_ps(rect.y, rect.y, rect.y + rect.h, rect.y + rect.h);
+		const __m128 factorU = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f);
+		const __m128 factorV = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+		const __m128 zValue = _mm_set1_ps(z);
+		__m128 positionsX;
+		__m128 positionsY;
+		__m128 coordinatesU;
+		__m128 coordinatesV;
+		__m128 positions01;
+		__m128 positions23;
+		__m128 coordinates01;
+		__m128 coordinates23;
+		__m128 zColor;
+		// a ColoredTexturedVertex consists of 6 floats so whole vertices can be assembled in registers
+		float* data = (float*)vertices;
+		for (; i < count; ++i, data += APRIL_QUAD_INSTANCE_VERTICES_COUNT * 6)
+		{
+			const QuadInstance& instance = instances[i];
+			positionsX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cornerX, _mm_set1_ps(instance.a)), _mm_mul_ps(cornerY, _mm_set1_ps(instance.c))), _mm_set1_ps(instance.tx));
+			positionsY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cornerX, _mm_set1_ps(instance.b)), _mm_mul_ps(cornerY, _mm_set1_ps(instance.d))), _mm_set1_ps(instance.ty));
+			coordinatesU = _mm_add_ps(_mm_set1_ps(instance.src.x), _mm_mul_ps(factorU, _mm_set1_ps(instance.src.w)));
+			coordinatesV = _mm_add_ps(_mm_set1_ps(instance.src.y), _mm_mul_ps(factorV, _mm_set1_ps(instance.src.h)));
+			// interleaved pairs of corners, the vertices are then assembled from 64-bit halves and written with 9 stores
+			positions01 = _mm_unpacklo_ps(positionsX, positionsY);
+			positions23 = _mm_unpackhi_ps(positionsX, positionsY);
+			coordinates01 = _mm_unpacklo_ps(coordinatesU, coordinatesV);
+			coordinates23 = _mm_unpackhi_ps(coordinatesU, coordinatesV);
+			zColor = _mm_unpacklo_ps(zValue, _mm_castsi128_ps(_mm_set1_epi32((int)instance.color)));
+			// vertices for corners 0 and 1
+			_mm_storeu_ps(&data[0], _mm_movelh_ps(positions01, zColor));
+			_mm_storeu_ps(&data[4], _mm_shuffle_ps(coordinates01, positions01, _MM_SHUFFLE(3, 2, 1, 0)));
+			_mm_storeu_ps(&data[8], _mm_shuffle_ps(zColor, coordinates01, _MM_SHUFFLE(3, 2, 1, 0)));
+			// vertices for corners 2 and 2
+			_mm_storeu_ps(&data[12], _mm_movelh_ps(positions23, zColor));
+			_mm_storeu_ps(&data[16], _mm_movelh_ps(coordinates23, positions23));
+			_mm_storeu_ps(&data[20], _mm_movelh_ps(zColor, coordinates23));
+			// vertices for corners 1 and 3
+			_mm_storeu_ps(&data[24], _mm_shuffle_ps(positions01, zColor, _MM_SHUFFLE(1, 0, 3, 2)));
+			_mm_storeu_ps(&data[28], _mm_shuffle_ps(coordinates01, positions23, _MM_SHUFFLE(3, 2, 3, 2)));
+			_mm_storeu_ps(&data[32], _mm_shuffle_ps(zColor, coordinates23, _MM_SHUFFLE(3, 2, 1, 0)));
+		}
+#elif defined(QUAD_NEON)
+		const float cornerXValues[4] = {rect.x, rect.x + rect.w, rect.x, rect.x + rect.w};
+		const float cornerYValues[4] = {rect.y, rect.y, rect.y + rect.h, rect.y + rect.h};
+		const float factorUValues[4] = {0.0f, 1.0f, 0.0f, 1.0f};
+		const float factorVValues[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+		const float32x4_t cornerX = vld1q_f32(cornerXValues);
+		const float32x4_t cornerY = vld1q_f32(cornerYValues);
+		const float32x4_t factorU = vld1q_f32(factorUValues);
+		const float32x4_t factorV = vld1q_f32(factorVValues);
+		float32x4x2_t positions;
+		float32x4x2_t coordinates;
+		float32x2_t zColor;
+		// a ColoredTexturedVertex consists of 6 floats so whole vertices can be assembled in registers
+		float* data = (float*)vertices;
+		for (; i < count; ++i, data += APRIL_QUAD_INSTANCE_VERTICES_COUNT * 6)
+		{
+			const QuadInstance& instance = instances[i];
+			// interleaved pairs of corners, the vertices are then assembled from 64-bit halves and written with 9 stores
+			positions = vzipq_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(instance.tx), cornerX, instance.a), cornerY, instance.c),
+				vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(instance.ty), cornerX, instance.b), cornerY, instance.d));
+			coordinates = vzipq_f32(vmlaq_n_f32(vdupq_n_f32(instance.src.x), factorU, instance.src.w),
+				vmlaq_n_f32(vdupq_n_f32(instance.src.y), factorV, instance.src.h));
+			zColor = vset_lane_f32(z, vreinterpret_f32_u32(vdup_n_u32(instance.color)), 0);
+			// vertices for corners 0 and 1
+			vst1q_f32(&data[0], vcombine_f32(vget_low_f32(positions.val[0]), zColor));
+			vst1q_f32(&data[4], vcombine_f32(vget_low_f32(coordinates.val[0]), vget_high_f32(positions.val[0])));
+			vst1q_f32(&data[8], vcombine_f32(zColor, vget_high_f32(coordinates.val[0])));
+			// vertices for corners 2 and 2
+			vst1q_f32(&data[12], vcombine_f32(vget_low_f32(positions.val[1]), zColor));
+			vst1q_f32(&data[16], vcombine_f32(vget_low_f32(coordinates.val[1]), vget_low_f32(positions.val[1])));
+			vst1q_f32(&data[20], vcombine_f32(zColor, vget_low_f32(coordinates.val[1])));
+			// vertices for corners 1 and 3
+			vst1q_f32(&data[24], vcombine_f32(vget_high_f32(positions.val[0]), zColor));
+			vst1q_f32(&data[28], vcombine_f32(vget_high_f32(coordinates.val[0]), vget_high_f32(positions.val[1])));
+			vst1q_f32(&data[32], vcombine_f32(zColor, vget_high_f32(coordinates.val[1])));
+		}
+#endif
+		float left = rect.x;
+		float right = rect.x + rect.w;
+		float top = rect.y;
+		float bottom = rect.y + rect.h;
+		for (; i < count; ++i)
+		{
+			const QuadInstance& instance = instances[i];
+			x[0] = instance.a * left + instance.c * top + instance.tx;
+			x[1] = instance.a * right + instance.c * top + instance.tx;
+			x[2] = instance.a * left + instance.c * bottom + instance.tx;
+			x[3] = instance.a * right + instance.c * bottom + instance.tx;
+			y[0] = instance.b * left + instance.d * top + instance.ty;
+			y[1] = instance.b * right + instance.d * top + instance.ty;
+			y[2] = instance.b * left + instance.d * bottom + instance.ty;
+			y[3] = instance.b * right + instance.d * bottom + instance.ty;
+			u[0] = u[2] = instance.src.x;
+			u[1] = u[3] = instance.src.x + instance.src.w;
+			v[0] = v[1] = instance.src.y;
+			v[2] = v[3] = instance.src.y + instance.src.h;
+			_writeQuad(&vertices[i * APRIL_QUAD_INSTANCE_VERTICES_COUNT], x, y, z, instance.color, u, v);
+		}
+	}
+
+}
@@ -0,0 +1,32 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines utility functions for instanced quads.
+
+#ifndef APRIL_QUAD_INSTANCES_H
+#define APRIL_QUAD_INSTANCES_H
+
+#include <gtypes/Rectangle.h>
+
+#include "aprilUtil.h"
+
+namespace april
+{
+	/// @brief Expands quad instances into a triangle list.
+	/// @param[in] rect The base quad that is transformed by each instance.
+	/// @param[in] z The Z-coordinate of all vertices.
+	/// @param[in] instances The quad instances.
+	/// @param[in] count Number of instances.
+	/// @param[out] vertices Where the vertices are written, APRIL_QUAD_INSTANCE_VERTICES_COUNT per instance.
+	/// @note Uses SSE2 or NEON where available.
+	void expandQuadInstances(cgrectf rect, float z, const QuadInstance* instances, int count, ColoredTexturedVertex* vertices);
+
+}
+#endif
@@ -0,0 +1,327 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORM_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define TRANSFORM_NEON
+#include <arm_neon.h>
+#endif
+
+#include <gtypes/Matrix4.h>
+#include <gtypes/Vector2.h>
+#include <gtypes/Vector3.h>
+#include <hltypes/hltypesUtil.h>
+
+#include "vertexTransform.h"
+
+namespace april
+{
+	// copies everything except the position
+	static inline void _copyAttributes(const PlainVertex& vertex, unsigned int color, ColoredVertex& destVertex)
+	{
+		destVertex.color = color;
+	}
+
+	static inline void _copyAttributes(const TexturedVertex& vertex, unsigned int color, ColoredTexturedVertex& destVertex)
+	{
+		destVertex.color = color;
+		destVertex.u = vertex.u;
+		destVertex.v = vertex.v;
+	}
+
+	static inline void _copyAttributes(const ColoredVertex& vertex, unsigned int color, ColoredVertex& destVertex)
+	{
+		destVertex.color = vertex.color;
+	}
+
+	static inline void _copyAttributes(const ColoredTexturedVertex& vertex, unsigned int color, ColoredTexturedVertex& destVertex)
+	{
+		destVertex.color = vertex.color;
+		destVertex.u = vertex.u;
+		destVertex.v = vertex.v;
+	}
+
+	static inline void _extendBounds(const PlainVertex& vertex, gvec2f& minimum, gvec2f& maximum)
+	{
+		minimum.x = hmin(minimum.x, vertex.x);
+		minimum.y = hmin(minimum.y, vertex.y);
+		maximum.x = hmax(maximum.x, vertex.x);
+		maximum.y = hmax(maximum.y, vertex.y);
+	}
+
+#ifdef TRANSFORM_SSE2
+	// the last vertex of an array can't be read beyond its Z-coordinate
+	template <typename T>
+	static inline __m128 _loadPosition(const T& vertex, bool wide)
+	{
+		return (wide ? _mm_loadu_ps(&vertex.x) : _mm_setr_ps(vertex.x, vertex.y, vertex.z, 0.0f));
+	}
+
+	// the result has the minimum of all lanes in every lane
+	static inline __m128 _horizontalMinimum(__m128 value)
+	{
+		value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+	}
+
+	// the result has the maximum of all lanes in every lane
+	static inline __m128 _horizontalMaximum(__m128 value)
+	{
+		value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+	}
+#elif defined(TRANSFORM_NEON)
+	// the last vertex of an array can't be read beyond its Z-coordinate
+	template <typename T>
+	static inline float32x4_t _loadPosition(const T& vertex, bool wide)
+	{
+		if (wide)
+		{
+			return vld1q_f32(&vertex.x);
+		}
+		return vsetq_lane_f32(vertex.z, vcombine_f32(vld1_f32(&vertex.x), vdup_n_f32(0.0f)), 2);
+	}
+
+	static inline void _transpose(float32x4_t& row0, float32x4_t& row1, float32x4_t& row2, float32x4_t& row3)
+	{
+		float32x4x2_t rows01 = vtrnq_f32(row0, row1);
+		float32x4x2_t rows23 = vtrnq_f32(row2, row3);
+		row0 = vcombine_f32(vget_low_f32(rows01.val[0]), vget_low_f32(rows23.val[0]));
+		row1 = vcombine_f32(vget_low_f32(rows01.val[1]), vget_low_f32(rows23.val[1]));
+		row2 = vcombine_f32(vget_high_f32(rows01.val[0]), vget_high_f32(rows23.val[0]));
+		row3 = vcombine_f32(vget_high_f32(rows01.val[1]), vget_high_f32(rows23.val[1]));
+	}
+#endif
+
+	template <typename T, typename D>
+	static void _transformVertices(const gmat4& matrix, const T* vertices, int count, unsigned int color, D* destVertices, gvec2f& minimum, gvec2f& maximum)
+	{
+		if (count <= 0)
+		{
+			minimum.set(0.0f, 0.0f);
+			maximum.set(0.0f, 0.0f);
+			return;
+		}
+		const float* m = matrix.data;
+		int i = 0;
+		// an affine matrix (which all 2D transformations are) doesn't need the W-coordinate
+		if (m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f)
+		{
+#ifdef TRANSFORM_SSE2
+			float result[4];
+			const __m128 column0 = _mm_loadu_ps(&m[0]);
+			const __m128 column1 = _mm_loadu_ps(&m[4]);
+			const __m128 column2 = _mm_loadu_ps(&m[8]);
+			const __m128 column3 = _mm_loadu_ps(&m[12]);
+			__m128 position = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(vertices[0].x)), _mm_mul_ps(column1, _mm_set1_ps(vertices[0].y))), _mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(vertices[0].z)), column3));
+			__m128 positionMinimum = position;
+			__m128 positionMaximum = position;
+			if (count >= 4)
+			{
+				// 4 vertices at a time are transposed so every register holds one coordinate of all of them
+				const __m128 m0 = _mm_set1_ps(m[0]);
+				const __m128 m1 = _mm_set1_ps(m[1]);
+				const __m128 m2 = _mm_set1_ps(m[2]);
+				const __m128 m4 = _mm_set1_ps(m[4]);
+				const __m128 m5 = _mm_set1_ps(m[5]);
+				const __m128 m6 = _mm_set1_ps(m[6]);
+				const __m128 m8 = _mm_set1_ps(m[8]);
+				const __m128 m9 = _mm_set1_ps(m[9]);
+				const __m128 m10 = _mm_set1_ps(m[10]);
+				const __m128 m12 = _mm_set1_ps(m[12]);
+				const __m128 m13 = _mm_set1_ps(m[13]);
+				const __m128 m14 = _mm_set1_ps(m[14]);
+				__m128 minimumX = _mm_shuffle_ps(position, position, _MM_SHUFFLE(0, 0, 0, 0));
+				__m128 minimumY = _mm_shuffle_ps(position, position, _MM_SHUFFLE(1, 1, 1, 1));
+				__m128 maximumX = minimumX;
+				__m128 maximumY = minimumY;
+				__m128 x;
+				__m128 y;
+				__m128 z;
+				__m128 w;
+				__m128 resultX;
+				__m128 resultY;
+				for (; i + 4 <= count; i += 4)
+				{
+					x = _loadPosition(vertices[i], true);
+					y = _loadPosition(vertices[i + 1], true);
+					z = _loadPosition(vertices[i + 2], true);
+					w = _loadPosition(vertices[i + 3], (sizeof(T) > sizeof(PlainVertex) || i + 4 < count));
+					_MM_TRANSPOSE4_PS(x, y, z, w);
+					resultX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_add_ps(_mm_mul_ps(m8, z), m12));
+					resultY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_add_ps(_mm_mul_ps(m9, z), m13));
+					z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_add_ps(_mm_mul_ps(m10, z), m14));
+					x = resultX;
+					y = resultY;
+					minimumX = _mm_min_ps(minimumX, x);
+					minimumY = _mm_min_ps(minimumY, y);
+					maximumX = _mm_max_ps(maximumX, x);
+					maximumY = _mm_max_ps(maximumY, y);
+					w = _mm_setzero_ps();
+					_MM_TRANSPOSE4_PS(x, y, z, w);
+					// the 4th float of every store lands in the color which is overwritten right after
+					_mm_storeu_ps(&destVertices[i].x, x);
+					_mm_storeu_ps(&destVertices[i + 1].x, y);
+					_mm_storeu_ps(&destVertices[i + 2].x, z);
+					_mm_storeu_ps(&destVertices[i + 3].x, w);
+					_copyAttributes(vertices[i], color, destVertices[i]);
+					_copyAttributes(vertices[i + 1], color, destVertices[i + 1]);
+					_copyAttributes(vertices[i + 2], color, destVertices[i + 2]);
+					_copyAttributes(vertices[i + 3], color, destVertices[i + 3]);
+				}
+				positionMinimum = _mm_unpacklo_ps(_horizontalMinimum(minimumX), _horizontalMinimum(minimumY));
+				positionMaximum = _mm_unpacklo_ps(_horizontalMaximum(maximumX), _horizontalMaximum(maximumY));
+			}
+			for (; i < count; ++i)
+			{
+				const T& vertex = vertices[i];
+				position = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(vertex.x)), _mm_mul_ps(column1, _mm_set1_ps(vertex.y))), _mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(vertex.z)), column3));
+				positionMinimum = _mm_min_ps(positionMinimum, position);
+				positionMaximum = _mm_max_ps(positionMaximum, position);
+				_mm_storeu_ps(result, position);
+				destVertices[i].set(result[0], result[1], result[2]);
+				_copyAttributes(vertex, color, destVertices[i]);
+			}
+			_mm_storeu_ps(result, positionMinimum);
+			minimum.set(result[0], result[1]);
+			_mm_storeu_ps(result, positionMaximum);
+			maximum.set(result[0], result[1]);
+			return;
+#elif defined(TRANSFORM_NEON)
+			float result[4];
+			const float32x4_t column0 = vld1q_f32(&m[0]);
+			const float32x4_t column1 = vld1q_f32(&m[4]);
+			const float32x4_t column2 = vld1q_f32(&m[8]);
+			const float32x4_t column3 = vld1q_f32(&m[12]);
+			float32x4_t position = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(column3, column0, vertices[0].x), column1, vertices[0].y), column2, vertices[0].z);
+			float32x4_t positionMinimum = position;
+			float32x4_t positionMaximum = position;
+			if (count >= 4)
+			{
+				// 4 vertices at a time are transposed so every register holds one coordinate of all of them
+				const float32x4_t m12 = vdupq_n_f32(m[12]);
+				const float32x4_t m13 = vdupq_n_f32(m[13]);
+				const float32x4_t m14 = vdupq_n_f32(m[14]);
+				float32x4_t minimumX = vdupq_lane_f32(vget_low_f32(position), 0);
+				float32x4_t minimumY = vdupq_lane_f32(vget_low_f32(position), 1);
+				float32x4_t maximumX = minimumX;
+				float32x4_t maximumY = minimumY;
+				float32x4_t x;
+				float32x4_t y;
+				float32x4_t z;
+				float32x4_t w;
+				float32x4_t resultX;
+				float32x4_t resultY;
+				float32x2_t pair;
+				for (; i + 4 <= count; i += 4)
+				{
+					x = _loadPosition(vertices[i], true);
+					y = _loadPosition(vertices[i + 1], true);
+					z = _loadPosition(vertices[i + 2], true);
+					w = _loadPosition(vertices[i + 3], (sizeof(T) > sizeof(PlainVertex) || i + 4 < count));
+					_transpose(x, y, z, w);
+					resultX = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(m12, x, m[0]), y, m[4]), z, m[8]);
+					resultY = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(m13, x, m[1]), y, m[5]), z, m[9]);
+					z = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(m14, x, m[2]), y, m[6]), z, m[10]);
+					x = resultX;
+					y = resultY;
+					minimumX = vminq_f32(minimumX, x);
+					minimumY = vminq_f32(minimumY, y);
+					maximumX = vmaxq_f32(maximumX, x);
+					maximumY = vmaxq_f32(maximumY, y);
+					w = vdupq_n_f32(0.0f);
+					_transpose(x, y, z, w);
+					// the 4th float of every store lands in the color which is overwritten right after
+					vst1q_f32(&destVertices[i].x, x);
+					vst1q_f32(&destVertices[i + 1].x, y);
+					vst1q_f32(&destVertices[i + 2].x, z);
+					vst1q_f32(&destVertices[i + 3].x, w);
+					_copyAttributes(vertices[i], color, destVertices[i]);
+					_copyAttributes(vertices[i + 1], color, destVertices[i + 1]);
+					_copyAttributes(vertices[i + 2], color, destVertices[i + 2]);
+					_copyAttributes(vertices[i + 3], color, destVertices[i + 3]);
+				}
+				pair = vpmin_f32(vget_low_f32(minimumX), vget_high_f32(minimumX));
+				positionMinimum = vcombine_f32(vpmin_f32(pair, pair), vdup_n_f32(0.0f));
+				pair = vpmin_f32(vget_low_f32(minimumY), vget_high_f32(minimumY));
+				positionMinimum = vsetq_lane_f32(vget_lane_f32(vpmin_f32(pair, pair), 0), positionMinimum, 1);
+				pair = vpmax_f32(vget_low_f32(maximumX), vget_high_f32(maximumX));
+				positionMaximum = vcombine_f32(vpmax_f32(pair, pair), vdup_n_f32(0.0f));
+				pair = vpmax_f32(vget_low_f32(maximumY), vget_high_f32(maximumY));
+				positionMaximum = vsetq_lane_f32(vget_lane_f32(vpmax_f32(pair, pair), 0), positionMaximum, 1);
+			}
+			for (; i < count; ++i)
+			{
+				const T& vertex = vertices[i];
+				position = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(column3, column0, vertex.x), column1, vertex.y), column2, vertex.z);
+				positionMinimum = vminq_f32(positionMinimum, position);
+				positionMaximum = vmaxq_f32(positionMaximum, position);
+				vst1q_f32(result, position);
+				destVertices[i].set(result[0], result[1], result[2]);
+				_copyAttributes(vertex, color, destVertices[i]);
+			}
+			vst1q_f32(result, positionMinimum);
+			minimum.set(result[0], result[1]);
+			vst1q_f32(result, positionMaximum);
+			maximum.set(result[0], result[1]);
+			return;
+#else
+			destVertices[0].set(m[0] * vertices[0].x + m[4] * vertices[0].y + m[8] * vertices[0].z + m[12],
+				m[1] * vertices[0].x + m[5] * vertices[0].y + m[9] * vertices[0].z + m[13],
+				m[2] * vertices[0].x + m[6] * vertices[0].y + m[10] * vertices[0].z + m[14]);
+			_copyAttributes(vertices[0], color, destVertices[0]);
+			minimum.set(destVertices[0].x, destVertices[0].y);
+			maximum = minimum;
+			for (i = 1; i < count; ++i)
+			{
+				const T& vertex = vertices[i];
+				destVertices[i].set(m[0] * vertex.x + m[4] * vertex.y + m[8] * vertex.z + m[12],
+					m[1] * vertex.x + m[5] * vertex.y + m[9] * vertex.z + m[13],
+					m[2] * vertex.x + m[6] * vertex.y + m[10] * vertex.z + m[14]);
+				_copyAttributes(vertex, color, destVertices[i]);
+				_extendBounds(destVertices[i], minimum, maximum);
+			}
+			return;
+#endif
+		}
+		destVertices[0].set(matrix * gvec3f(vertices[0].x, vertices[0].y, vertices[0].z));
+		_copyAttributes(vertices[0], color, destVertices[0]);
+		minimum.set(destVertices[0].x, destVertices[0].y);
+		maximum = minimum;
+		for (i = 1; i < count; ++i)
+		{
+			const T& vertex = vertices[i];
+			destVertices[i].set(matrix * gvec3f(vertex.x, vertex.y, vertex.z));
+			_copyAttributes(vertex, color, destVertices[i]);
+			_extendBounds(destVertices[i], minimum, maximum);
+		}
+	}
+
+	void transformVertices(const gmat4& matrix, const PlainVertex* vertices, int count, unsigned int color, ColoredVertex* destVertices, gvec2f& minimum, gvec2f& maximum)
+	{
+		_transformVertices(matrix, vertices, count, color, destVertices, minimum, maximum);
+	}
+
+	void transformVertices(const gmat4& matrix, const TexturedVertex* vertices, int count, unsigned int color, ColoredTexturedVertex* destVertices, gvec2f& minimum, gvec2f& maximum)
+	{
+		_transformVertices(matrix, vertices, count, color, destVertices, minimum, maximum);
+	}
+
+	void transformVertices(const gmat4& matrix, const ColoredVertex* vertices, int count, ColoredVertex* destVertices, gvec2f& minimum, gvec2f& maximum)
+	{
+		_transformVertices(matrix, vertices, count, 0, destVertices, minimum, maximum);
+	}
+
+	void transformVertices(const gmat4& matrix, const ColoredTexturedVertex* vertices, int count, ColoredTexturedVertex* destVertices, gvec2f& minimum, gvec2f& maximum)
+	{
+		_transformVertices(matrix, vertices, count, 0, destVertices, minimum, maximum);
+	}
+
+}
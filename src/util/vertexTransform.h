@@ -0,0 +1,63 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines utility functions for transforming vertex arrays.
+
+#ifndef APRIL_VERTEX_TRANSFORM_H
+#define APRIL_VERTEX_TRANSFORM_H
+
+#include <gtypes/Matrix4.h>
+#include <gtypes/Vector2.h>
+
+#include "aprilUtil.h"
+
+namespace april
+{
+	/// @brief Transforms vertices, applies a color and calculates the bounds of the transformed positions in one pass.
+	/// @param[in] matrix The transformation matrix.
+	/// @param[in] vertices The vertices.
+	/// @param[in] count Number of vertices.
+	/// @param[in] color The native color that is applied to all vertices.
+	/// @param[out] destVertices Where the transformed vertices are written.
+	/// @param[out] minimum The minimum X and Y of the transformed positions.
+	/// @param[out] maximum The maximum X and Y of the transformed positions.
+	/// @note Affine matrices use SSE2 or NEON where available.
+	void transformVertices(const gmat4& matrix, const PlainVertex* vertices, int count, unsigned int color, ColoredVertex* destVertices, gvec2f& minimum, gvec2f& maximum);
+	/// @brief Transforms vertices, applies a color and calculates the bounds of the transformed positions in one pass.
+	/// @param[in] matrix The transformation matrix.
+	/// @param[in] vertices The vertices.
+	/// @param[in] count Number of vertices.
+	/// @param[in] color The native color that is applied to all vertices.
+	/// @param[out] destVertices Where the transformed vertices are written.
+	/// @param[out] minimum The minimum X and Y of the transformed positions.
+	/// @param[out] maximum The maximum X and Y of the transformed positions.
+	/// @note Affine matrices use SSE2 or NEON where available.
+	void transformVertices(const gmat4& matrix, const TexturedVertex* vertices, int count, unsigned int color, ColoredTexturedVertex* destVertices, gvec2f& minimum, gvec2f& maximum);
+	/// @brief Transforms vertices and calculates the bounds of the transformed positions in one pass.
+	/// @param[in] matrix The transformation matrix.
+	/// @param[in] vertices The vertices.
+	/// @param[in] count Number of vertices.
+	/// @param[out] destVertices Where the transformed vertices are written.
+	/// @param[out] minimum The minimum X and Y of the transformed positions.
+	/// @param[out] maximum The maximum X and Y of the transformed positions.
+	/// @note Affine matrices use SSE2 or NEON where available.
+	void transformVertices(const gmat4& matrix, const ColoredVertex* vertices, int count, ColoredVertex* destVertices, gvec2f& minimum, gvec2f& maximum);
+	/// @brief Transforms vertices and calculates the bounds of the transformed positions in one pass.
+	/// @param[in] matrix The transformation matrix.
+	/// @param[in] vertices The vertices.
+	/// @param[in] count Number of vertices.
+	/// @param[out] destVertices Where the transformed vertices are written.
+	/// @param[out] minimum The minimum X and Y of the transformed positions.
+	/// @param[out] maximum The maximum X and Y of the transformed positions.
+	/// @note Affine matrices use SSE2 or NEON where available.
+	void transformVertices(const gmat4& matrix, const ColoredTexturedVertex* vertices, int count, ColoredTexturedVertex* destVertices, gvec2f& minimum, gvec2f& maximum);
+
+}
+#endif
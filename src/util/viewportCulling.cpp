@@ -0,0 +1,218 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CULLING_NEON
+#include <arm_neon.h>
+#endif
+
+#include <gtypes/Matrix4.h>
+#include <hltypes/hltypesUtil.h>
+
+#include "viewportCulling.h"
+
+// up to this many vertices are transformed directly instead of the corners of their bounding box
+#define DIRECT_VERTICES_MAX 8
+
+// bits for the clip planes, the near and far planes are not used since their depth range differs between graphics APIs
+#define PLANE_LEFT 0x1
+#define PLANE_RIGHT 0x2
+#define PLANE_BOTTOM 0x4
+#define PLANE_TOP 0x8
+#define PLANE_ALL 0xF
+
+namespace april
+{
+#ifdef CULLING_NEON
+	static inline bool _isAllSet(uint32x4_t mask)
+	{
+		uint32x2_t result = vand_u32(vget_low_u32(mask), vget_high_u32(mask));
+		return ((vget_lane_u32(result, 0) & vget_lane_u32(result, 1)) != 0);
+	}
+#endif
+
+	// transforms 4 points to clip space and returns the planes that all of them are outside of
+	static inline int _getOutsidePlanes(const float* m, const float* x, const float* y, const float* z)
+	{
+		int result = 0;
+#ifdef CULLING_SSE2
+		const __m128 pointsX = _mm_loadu_ps(x);
+		const __m128 pointsY = _mm_loadu_ps(y);
+		const __m128 pointsZ = _mm_loadu_ps(z);
+		const __m128 clipX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pointsX, _mm_set1_ps(m[0])), _mm_mul_ps(pointsY, _mm_set1_ps(m[4]))), _mm_add_ps(_mm_mul_ps(pointsZ, _mm_set1_ps(m[8])), _mm_set1_ps(m[12])));
+		const __m128 clipY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pointsX, _mm_set1_ps(m[1])), _mm_mul_ps(pointsY, _mm_set1_ps(m[5]))), _mm_add_ps(_mm_mul_ps(pointsZ, _mm_set1_ps(m[9])), _mm_set1_ps(m[13])));
+		const __m128 clipW = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pointsX, _mm_set1_ps(m[3])), _mm_mul_ps(pointsY, _mm_set1_ps(m[7]))), _mm_add_ps(_mm_mul_ps(pointsZ, _mm_set1_ps(m[11])), _mm_set1_ps(m[15])));
+		const __m128 negativeClipW = _mm_sub_ps(_mm_setzero_ps(), clipW);
+		if (_mm_movemask_ps(_mm_cmplt_ps(clipX, negativeClipW)) == 0xF)
+		{
+			result |= PLANE_LEFT;
+		}
+		if (_mm_movemask_ps(_mm_cmpgt_ps(clipX, clipW)) == 0xF)
+		{
+			result |= PLANE_RIGHT;
+		}
+		if (_mm_movemask_ps(_mm_cmplt_ps(clipY, negativeClipW)) == 0xF)
+		{
+			result |= PLANE_BOTTOM;
+		}
+		if (_mm_movemask_ps(_mm_cmpgt_ps(clipY, clipW)) == 0xF)
+		{
+			result |= PLANE_TOP;
+		}
+#elif defined(CULLING_NEON)
+		const float32x4_t pointsX = vld1q_f32(x);
+		const float32x4_t pointsY = vld1q_f32(y);
+		const float32x4_t pointsZ = vld1q_f32(z);
+		const float32x4_t clipX = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[12]), pointsX, m[0]), pointsY, m[4]), pointsZ, m[8]);
+		const float32x4_t clipY = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[13]), pointsX, m[1]), pointsY, m[5]), pointsZ, m[9]);
+		const float32x4_t clipW = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[15]), pointsX, m[3]), pointsY, m[7]), pointsZ, m[11]);
+		const float32x4_t negativeClipW = vnegq_f32(clipW);
+		if (_isAllSet(vcltq_f32(clipX, negativeClipW)))
+		{
+			result |= PLANE_LEFT;
+		}
+		if (_isAllSet(vcgtq_f32(clipX, clipW)))
+		{
+			result |= PLANE_RIGHT;
+		}
+		if (_isAllSet(vcltq_f32(clipY, negativeClipW)))
+		{
+			result |= PLANE_BOTTOM;
+		}
+		if (_isAllSet(vcgtq_f32(clipY, clipW)))
+		{
+			result |= PLANE_TOP;
+		}
+#else
+		result = PLANE_ALL;
+		float clipX = 0.0f;
+		float clipY = 0.0f;
+		float clipW = 0.0f;
+		int planes = 0;
+		for_iter (i, 0, 4)
+		{
+			clipX = x[i] * m[0] + y[i] * m[4] + z[i] * m[8] + m[12];
+			clipY = x[i] * m[1] + y[i] * m[5] + z[i] * m[9] + m[13];
+			clipW = x[i] * m[3] + y[i] * m[7] + z[i] * m[11] + m[15];
+			planes = 0;
+			if (clipX < -clipW)
+			{
+				planes |= PLANE_LEFT;
+			}
+			if (clipX > clipW)
+			{
+				planes |= PLANE_RIGHT;
+			}
+			if (clipY < -clipW)
+			{
+				planes |= PLANE_BOTTOM;
+			}
+			if (clipY > clipW)
+			{
+				planes |= PLANE_TOP;
+			}
+			result &= planes;
+		}
+#endif
+		return result;
+	}
+
+	bool isOutsideClipSpace(const gmat4& matrix, const PlainVertex* vertices, int count, int vertexSize)
+	{
+		if (count <= 0)
+		{
+			return false;
+		}
+		const unsigned char* data = (const unsigned char*)vertices;
+		const PlainVertex* vertex = NULL;
+		float x[4];
+		float y[4];
+		float z[4];
+		if (count <= DIRECT_VERTICES_MAX)
+		{
+			int planes = PLANE_ALL;
+			for (int i = 0; i < count && planes != 0; i += 4)
+			{
+				for_iter (j, 0, 4)
+				{
+					// the last group is filled up with the last vertex which doesn't change the result
+					vertex = (const PlainVertex*)(data + hmin(i + j, count - 1) * vertexSize);
+					x[j] = vertex->x;
+					y[j] = vertex->y;
+					z[j] = vertex->z;
+				}
+				planes &= _getOutsidePlanes(matrix.data, x, y, z);
+			}
+			return (planes != 0);
+		}
+		float minimum[4];
+		float maximum[4];
+#ifdef CULLING_SSE2
+		vertex = (const PlainVertex*)data;
+		__m128 position = _mm_setr_ps(vertex->x, vertex->y, vertex->z, 0.0f);
+		__m128 positionMinimum = position;
+		__m128 positionMaximum = position;
+		for_iter (i, 1, count)
+		{
+			vertex = (const PlainVertex*)(data + i * vertexSize);
+			position = _mm_setr_ps(vertex->x, vertex->y, vertex->z, 0.0f);
+			positionMinimum = _mm_min_ps(positionMinimum, position);
+			positionMaximum = _mm_max_ps(positionMaximum, position);
+		}
+		_mm_storeu_ps(minimum, positionMinimum);
+		_mm_storeu_ps(maximum, positionMaximum);
+#elif defined(CULLING_NEON)
+		vertex = (const PlainVertex*)data;
+		float32x4_t position = vcombine_f32(vld1_f32(&vertex->x), vld1_lane_f32(&vertex->z, vdup_n_f32(0.0f), 0));
+		float32x4_t positionMinimum = position;
+		float32x4_t positionMaximum = position;
+		for_iter (i, 1, count)
+		{
+			vertex = (const PlainVertex*)(data + i * vertexSize);
+			position = vcombine_f32(vld1_f32(&vertex->x), vld1_lane_f32(&vertex->z, vdup_n_f32(0.0f), 0));
+			positionMinimum = vminq_f32(positionMinimum, position);
+			positionMaximum = vmaxq_f32(positionMaximum, position);
+		}
+		vst1q_f32(minimum, positionMinimum);
+		vst1q_f32(maximum, positionMaximum);
+#else
+		vertex = (const PlainVertex*)data;
+		minimum[0] = maximum[0] = vertex->x;
+		minimum[1] = maximum[1] = vertex->y;
+		minimum[2] = maximum[2] = vertex->z;
+		for_iter (i, 1, count)
+		{
+			vertex = (const PlainVertex*)(data + i * vertexSize);
+			minimum[0] = hmin(minimum[0], vertex->x);
+			minimum[1] = hmin(minimum[1], vertex->y);
+			minimum[2] = hmin(minimum[2], vertex->z);
+			maximum[0] = hmax(maximum[0], vertex->x);
+			maximum[1] = hmax(maximum[1], vertex->y);
+			maximum[2] = hmax(maximum[2], vertex->z);
+		}
+#endif
+		// the corners of the bounding box are transformed in 2 groups, one for each Z-coordinate
+		x[0] = x[2] = minimum[0];
+		x[1] = x[3] = maximum[0];
+		y[0] = y[1] = minimum[1];
+		y[2] = y[3] = maximum[1];
+		z[0] = z[1] = z[2] = z[3] = minimum[2];
+		int planes = _getOutsidePlanes(matrix.data, x, y, z);
+		if (planes == 0)
+		{
+			return false;
+		}
+		z[0] = z[1] = z[2] = z[3] = maximum[2];
+		planes &= _getOutsidePlanes(matrix.data, x, y, z);
+		return (planes != 0);
+	}
+
+}
@@ -0,0 +1,32 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines utility functions for culling geometry outside of the viewport.
+
+#ifndef APRIL_VIEWPORT_CULLING_H
+#define APRIL_VIEWPORT_CULLING_H
+
+#include <gtypes/Matrix4.h>
+
+#include "aprilUtil.h"
+
+namespace april
+{
+	/// @brief Checks whether vertices lie completely outside of the clip space.
+	/// @param[in] matrix The combined projection and modelview matrix.
+	/// @param[in] vertices The vertices.
+	/// @param[in] count Number of vertices.
+	/// @param[in] vertexSize The byte size of one vertex.
+	/// @return True if all vertices are outside of the same clip plane and nothing of them can be visible.
+	/// @note Small vertex counts are transformed directly, otherwise the corners of their bounding box are. Uses SSE2 or NEON where available.
+	bool isOutsideClipSpace(const gmat4& matrix, const PlainVertex* vertices, int count, int vertexSize);
+
+}
+#endif
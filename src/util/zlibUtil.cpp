@@ -6,46 +6,188 @@
 /// This program is free software; you can redistribute it and/or modify it under
 /// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
 
+#include <string.h>
+
+#include <hltypes/harray.h>
 #include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
 #include <hltypes/hmutex.h>
 #include <hltypes/hstring.h>
 #include <zlib.h>
+#ifdef _LIBDEFLATE
+#include <libdeflate.h>
+#endif
 
 #include "april.h"
 #include "zlibUtil.h"
 
+#define CHUNK_SIZE 65536
+#define MAX_POOLED_INFLATERS 8
+
 namespace april
 {
-	static hmutex zlibMutex;
+	// only borrowing and returning an inflater is synchronized, the decompression itself runs without any lock
+	struct ZlibInflater
+	{
+		z_stream stream;
+		unsigned char chunk[CHUNK_SIZE];
+#ifdef _LIBDEFLATE
+		libdeflate_decompressor* decompressor;
+#endif
+	};
+
+	static hmutex inflatersMutex;
+	static harray<ZlibInflater*> inflaters;
+
+	static void _destroyInflater(ZlibInflater* inflater)
+	{
+		inflateEnd(&inflater->stream);
+#ifdef _LIBDEFLATE
+		if (inflater->decompressor != NULL)
+		{
+			libdeflate_free_decompressor(inflater->decompressor);
+		}
+#endif
+		delete inflater;
+	}
 
-	unsigned char* zlibDecompress(int streamSize, int compressedSize, hsbase& stream)
+	static ZlibInflater* _borrowInflater()
 	{
-		// zlib inflate init
-		z_stream zlibStream;
-		memset(&zlibStream, 0, sizeof(zlibStream));
-		hmutex::ScopeLock lock(&zlibMutex);
-		int result = inflateInit(&zlibStream);
+		hmutex::ScopeLock lock(&inflatersMutex);
+		if (inflaters.size() > 0)
+		{
+			return inflaters.removeLast();
+		}
+		lock.release();
+		ZlibInflater* inflater = new ZlibInflater();
+		memset(&inflater->stream, 0, sizeof(inflater->stream));
+		int result = inflateInit(&inflater->stream);
 		if (result != Z_OK)
 		{
 			hlog::error(logTag, "zlib Error: " + hstr(result));
+			delete inflater;
 			return NULL;
 		}
-		unsigned char* data = new unsigned char[streamSize];
-		unsigned char* input = new unsigned char[compressedSize];
-		stream.readRaw(input, compressedSize);
-		// decompress
-		zlibStream.next_in = input;
-		zlibStream.avail_in = compressedSize;
-		zlibStream.next_out = data;
-		zlibStream.avail_out = streamSize;
-		if (inflate(&zlibStream, Z_FINISH) == Z_STREAM_ERROR)
-		{
-			delete[] data;
-			data = NULL;
-		}
-		inflateEnd(&zlibStream);
-		delete[] input;
-		return data;
+#ifdef _LIBDEFLATE
+		inflater->decompressor = libdeflate_alloc_decompressor();
+#endif
+		return inflater;
+	}
+
+	static void _returnInflater(ZlibInflater* inflater)
+	{
+		inflateReset(&inflater->stream);
+		hmutex::ScopeLock lock(&inflatersMutex);
+		if (inflaters.size() < MAX_POOLED_INFLATERS)
+		{
+			inflaters += inflater;
+			return;
+		}
+		lock.release();
+		_destroyInflater(inflater);
+	}
+
+	static int _inflate(z_stream* stream, int flush, bool& headerPending, unsigned char* destData, int destSize)
+	{
+		int result = inflate(stream, flush);
+		// once the header is filled, the rest goes straight into the destination
+		while (headerPending && stream->avail_out == 0 && (result == Z_OK || result == Z_BUF_ERROR))
+		{
+			headerPending = false;
+			stream->next_out = destData;
+			stream->avail_out = destSize;
+			result = inflate(stream, flush);
+		}
+		return result;
+	}
+
+	bool zlibDecompress(unsigned char* srcData, int compressedSize, unsigned char* destData, int destSize, unsigned char* headerData, int headerSize)
+	{
+		ZlibInflater* inflater = _borrowInflater();
+		if (inflater == NULL)
+		{
+			return false;
+		}
+#ifdef _LIBDEFLATE
+		// libdeflate can only write into one contiguous buffer
+		if (inflater->decompressor != NULL && headerSize == 0)
+		{
+			bool success = (libdeflate_zlib_decompress(inflater->decompressor, srcData, compressedSize, destData, destSize, NULL) == LIBDEFLATE_SUCCESS);
+			_returnInflater(inflater);
+			return success;
+		}
+#endif
+		bool headerPending = (headerSize > 0);
+		inflater->stream.next_in = srcData;
+		inflater->stream.avail_in = compressedSize;
+		inflater->stream.next_out = (headerPending ? headerData : destData);
+		inflater->stream.avail_out = (headerPending ? headerSize : destSize);
+		int result = _inflate(&inflater->stream, Z_FINISH, headerPending, destData, destSize);
+		_returnInflater(inflater);
+		if (result != Z_STREAM_END)
+		{
+			hlog::error(logTag, "zlib Error: " + hstr(result));
+			return false;
+		}
+		return true;
+	}
+
+	bool zlibDecompress(hsbase& stream, int compressedSize, unsigned char* destData, int destSize, unsigned char* headerData, int headerSize)
+	{
+		ZlibInflater* inflater = _borrowInflater();
+		if (inflater == NULL)
+		{
+			return false;
+		}
+#ifdef _LIBDEFLATE
+		// libdeflate can only work with the whole input at once and write into one contiguous buffer
+		if (inflater->decompressor != NULL && headerSize == 0)
+		{
+			unsigned char* input = new unsigned char[compressedSize];
+			bool success = (stream.readRaw(input, compressedSize) == compressedSize &&
+				libdeflate_zlib_decompress(inflater->decompressor, input, compressedSize, destData, destSize, NULL) == LIBDEFLATE_SUCCESS);
+			delete[] input;
+			_returnInflater(inflater);
+			return success;
+		}
+#endif
+		bool headerPending = (headerSize > 0);
+		inflater->stream.next_out = (headerPending ? headerData : destData);
+		inflater->stream.avail_out = (headerPending ? headerSize : destSize);
+		int remaining = compressedSize;
+		int read = 0;
+		int result = Z_OK;
+		while (remaining > 0 && result == Z_OK)
+		{
+			read = stream.readRaw(inflater->chunk, hmin(remaining, CHUNK_SIZE));
+			if (read <= 0)
+			{
+				break;
+			}
+			remaining -= read;
+			inflater->stream.next_in = inflater->chunk;
+			inflater->stream.avail_in = read;
+			result = _inflate(&inflater->stream, (remaining > 0 ? Z_NO_FLUSH : Z_FINISH), headerPending, destData, destSize);
+		}
+		_returnInflater(inflater);
+		if (result != Z_STREAM_END)
+		{
+			hlog::error(logTag, "zlib Error: " + hstr(result));
+			return false;
+		}
+		return true;
+	}
+
+	void zlibDestroyInflaters()
+	{
+		hmutex::ScopeLock lock(&inflatersMutex);
+		harray<ZlibInflater*> pooledInflaters = inflaters;
+		inflaters.clear();
+		lock.release();
+		foreach (ZlibInflater*, it, pooledInflaters)
+		{
+			_destroyInflater(*it);
+		}
 	}
 
 }
@@ -17,7 +17,29 @@
 
 namespace april
 {
-	unsigned char* zlibDecompress(int streamSize, int compressedSize, hsbase& stream);
+	/// @brief Decompresses zlib data from a buffer.
+	/// @param[in] srcData The compressed data.
+	/// @param[in] compressedSize Size of the compressed data.
+	/// @param[out] destData Where the decompressed data is written.
+	/// @param[in] destSize Size of the decompressed data without the header.
+	/// @param[out] headerData Where the first headerSize bytes of the decompressed data are written.
+	/// @param[in] headerSize Size of the header that is split off from the decompressed data.
+	/// @return True if successful.
+	/// @note This is thread-safe and multiple threads can decompress at the same time.
+	bool zlibDecompress(unsigned char* srcData, int compressedSize, unsigned char* destData, int destSize, unsigned char* headerData = NULL, int headerSize = 0);
+	/// @brief Decompresses zlib data from a stream in chunks.
+	/// @param[in] stream The stream where the compressed data is read from.
+	/// @param[in] compressedSize Size of the compressed data.
+	/// @param[out] destData Where the decompressed data is written.
+	/// @param[in] destSize Size of the decompressed data without the header.
+	/// @param[out] headerData Where the first headerSize bytes of the decompressed data are written.
+	/// @param[in] headerSize Size of the header that is split off from the decompressed data.
+	/// @return True if successful.
+	/// @note This is thread-safe and multiple threads can decompress at the same time.
+	bool zlibDecompress(hsbase& stream, int compressedSize, unsigned char* destData, int destSize, unsigned char* headerData = NULL, int headerSize = 0);
+	/// @brief Destroys all pooled decompression states.
+	/// @note This is called by april::destroy(). Inflaters that are still in use at that time are pooled again when they are returned.
+	void zlibDestroyInflaters();
 
 }
 #endif
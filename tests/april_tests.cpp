@@ -0,0 +1,91 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+// Runs all registered correctness tests. Tests only use functionality that doesn't need a window or a render device.
+// usage: april_tests [test name]
+// The exit code is non-zero if a test failed.
+
+#include <hltypes/harray.h>
+#include <hltypes/hlog.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hstring.h>
+
+#include <april/Image.h>
+
+#include "tests.h"
+
+struct Test
+{
+	const char* name;
+	TestFunction function;
+};
+
+static harray<Test>& _getTests()
+{
+	// constructed on first use since registrars run during static initialization
+	static harray<Test> tests;
+	return tests;
+}
+
+static int failedChecks = 0;
+
+TestRegistrar::TestRegistrar(const char* name, TestFunction function)
+{
+	Test test;
+	test.name = name;
+	test.function = function;
+	_getTests() += test;
+}
+
+void _testCheck(bool result, chstr message, const char* file, int line)
+{
+	if (!result)
+	{
+		hlog::errorf(TESTS_LOG_TAG, "%s:%d: check failed: %s", file, line, message.cStr());
+		++failedChecks;
+	}
+}
+
+harray<april::Image::Format> _testGetPixelFormats()
+{
+	harray<april::Image::Format> formats = april::Image::Format::getValues();
+	formats -= april::Image::Format::Invalid;
+	formats -= april::Image::Format::Compressed;
+	formats -= april::Image::Format::Palette;
+	return formats;
+}
+
+int main(int argc, char** argv)
+{
+	hstr filter = (argc > 1 ? hstr(argv[1]) : hstr(""));
+	harray<Test>& tests = _getTests();
+	int failedTests = 0;
+	int runTests = 0;
+	int checks = 0;
+	foreach (Test, it, tests)
+	{
+		if (filter != "" && filter != (*it).name)
+		{
+			continue;
+		}
+		checks = failedChecks;
+		(*it).function();
+		++runTests;
+		if (failedChecks > checks)
+		{
+			hlog::error(TESTS_LOG_TAG, hstr((*it).name) + ": FAILED");
+			++failedTests;
+		}
+		else
+		{
+			hlog::write(TESTS_LOG_TAG, hstr((*it).name) + ": OK");
+		}
+	}
+	hlog::writef(TESTS_LOG_TAG, "%d of %d tests passed.", runTests - failedTests, runTests);
+	return (failedTests == 0 && runTests > 0 ? 0 : 1);
+}
@@ -0,0 +1,249 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <string.h>
+
+#include <hltypes/harray.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hstring.h>
+
+#include <april/Image.h>
+
+#include "tests.h"
+
+#define TEST_SIZE 8
+
+static void _fillPattern(unsigned char* data, int size, int seed)
+{
+	for_iter (i, 0, size)
+	{
+		data[i] = (unsigned char)(i * 37 + seed * 11 + (i >> 3) * 5);
+	}
+}
+
+APRIL_TEST(invert)
+{
+	// the padding byte of X formats and the alpha channel must not be changed
+	harray<april::Image::Format> formats = _testGetPixelFormats();
+	unsigned char data[2 * 2 * 4];
+	int value = 0;
+	int channel = 0;
+	foreach (april::Image::Format, it, formats)
+	{
+		int bpp = (*it).getBpp();
+		int alpha = -1;
+		if (bpp == 4)
+		{
+			(*it).getChannelIndices(NULL, NULL, NULL, &alpha);
+		}
+		for_iter (i, 0, 2 * 2 * bpp)
+		{
+			data[i] = (unsigned char)(i * 11 + 5);
+		}
+		april::Image::invert(0, 0, 2, 2, data, 2, 2, (*it));
+		bool result = true;
+		for_iter (i, 0, 2 * 2 * bpp)
+		{
+			channel = i % bpp;
+			value = (unsigned char)(i * 11 + 5);
+			if (data[i] != (channel == alpha ? value : 255 - value))
+			{
+				result = false;
+			}
+		}
+		APRIL_CHECK_MESSAGE(result, "invert " + (*it).getName());
+	}
+}
+
+APRIL_TEST(adjustHueSaturation)
+{
+	// the fused pass must produce exactly the same result as the two separate operations
+	harray<april::Image::Format> formats = _testGetPixelFormats();
+	unsigned char expected[TEST_SIZE * TEST_SIZE * 4];
+	unsigned char data[TEST_SIZE * TEST_SIZE * 4];
+	float degrees[] = {0.0f, 45.0f, 180.0f, -100.0f};
+	float factors[] = {1.0f, 0.0f, 0.5f, 1.7f};
+	foreach (april::Image::Format, it, formats)
+	{
+		int size = TEST_SIZE * TEST_SIZE * (*it).getBpp();
+		for_iter (i, 0, 4)
+		{
+			for_iter (j, 0, 4)
+			{
+				_fillPattern(expected, size, i * 4 + j);
+				memcpy(data, expected, size);
+				april::Image::rotateHue(0, 0, TEST_SIZE, TEST_SIZE, degrees[i], expected, TEST_SIZE, TEST_SIZE, (*it));
+				april::Image::saturate(0, 0, TEST_SIZE, TEST_SIZE, factors[j], expected, TEST_SIZE, TEST_SIZE, (*it));
+				april::Image::adjustHueSaturation(0, 0, TEST_SIZE, TEST_SIZE, degrees[i], factors[j], data, TEST_SIZE, TEST_SIZE, (*it));
+				APRIL_CHECK_MESSAGE(memcmp(data, expected, size) == 0, hsprintf("adjustHueSaturation %s %g %g", (*it).getName().cStr(), degrees[i], factors[j]));
+			}
+		}
+	}
+}
+
+APRIL_TEST(hueSaturationKeepsGrey)
+{
+	// grey pixels have no hue or saturation so neither operation may change them
+	unsigned char data[TEST_SIZE * 3];
+	for_iter (i, 0, TEST_SIZE)
+	{
+		data[i * 3] = data[i * 3 + 1] = data[i * 3 + 2] = (unsigned char)(i * 31);
+	}
+	april::Image::adjustHueSaturation(0, 0, TEST_SIZE, 1, 77.0f, 1.5f, data, TEST_SIZE, 1, april::Image::Format::RGB);
+	bool result = true;
+	for_iter (i, 0, TEST_SIZE)
+	{
+		if (data[i * 3] != i * 31 || data[i * 3 + 1] != i * 31 || data[i * 3 + 2] != i * 31)
+		{
+			result = false;
+		}
+	}
+	APRIL_CHECK(result);
+}
+
+APRIL_TEST(blitPremultiplied)
+{
+	// every code path has to produce src + dest * (255 - a) / 255 rounded to nearest with saturated colors
+	harray<april::Image::Format> formats;
+	formats += april::Image::Format::RGBA;
+	formats += april::Image::Format::ARGB;
+	formats += april::Image::Format::BGRA;
+	formats += april::Image::Format::ABGR;
+	unsigned char src[TEST_SIZE * TEST_SIZE * 4];
+	unsigned char dest[TEST_SIZE * TEST_SIZE * 4];
+	unsigned char expected[TEST_SIZE * TEST_SIZE * 4];
+	unsigned char alphas[] = {255, 128, 1};
+	int destWidth = TEST_SIZE - 1; // leaves a tail for the scalar path after the vectorized pixels
+	int channels[4] = {0, 0, 0, 0};
+	int a = 0;
+	unsigned char* s = NULL;
+	unsigned char* d = NULL;
+	foreach (april::Image::Format, it, formats)
+	{
+		(*it).getChannelIndices(&channels[0], &channels[1], &channels[2], &channels[3]);
+		for_iter (i, 0, 3)
+		{
+			_fillPattern(src, TEST_SIZE * TEST_SIZE * 4, i);
+			_fillPattern(dest, TEST_SIZE * TEST_SIZE * 4, i + 7);
+			// a fully transparent span, fully opaque pixels and an additive pixel
+			memset(src, 0, 16);
+			src[16 + channels[3]] = 255;
+			src[20 + channels[3]] = 255;
+			src[24 + channels[3]] = 0;
+			memcpy(expected, dest, sizeof(dest));
+			for_iter (y, 0, TEST_SIZE)
+			{
+				for_iter (x, 0, destWidth)
+				{
+					s = &src[(x + y * TEST_SIZE) * 4];
+					d = &expected[(x + y * destWidth) * 4];
+					a = (s[channels[3]] * alphas[i] + 127) / 255;
+					for_iter (c, 0, 3)
+					{
+						d[channels[c]] = (unsigned char)hmin((s[channels[c]] * alphas[i] + 127) / 255 + (d[channels[c]] * (255 - a) + 127) / 255, 255);
+					}
+					d[channels[3]] = (unsigned char)(a + (d[channels[3]] * (255 - a) + 127) / 255);
+				}
+			}
+			april::Image::blitPremultiplied(0, 0, destWidth, TEST_SIZE, 0, 0, src, TEST_SIZE, TEST_SIZE, (*it), dest, destWidth, TEST_SIZE, (*it), alphas[i]);
+			APRIL_CHECK_MESSAGE(memcmp(dest, expected, destWidth * TEST_SIZE * 4) == 0, hsprintf("blitPremultiplied %s %d", (*it).getName().cStr(), alphas[i]));
+		}
+	}
+}
+
+APRIL_TEST(unpremultiplyAlpha)
+{
+	// every code path has to produce (x * 255 + a / 2) / a with saturated colors, all alphas and colors are checked
+	harray<april::Image::Format> formats;
+	formats += april::Image::Format::RGBA;
+	formats += april::Image::Format::ARGB;
+	formats += april::Image::Format::BGRA;
+	formats += april::Image::Format::ABGR;
+	int w = 257; // leaves a tail for the scalar path after the vectorized pixels
+	int h = 256;
+	unsigned char* data = new unsigned char[w * h * 4];
+	unsigned char* expected = new unsigned char[w * h * 4];
+	int channels[4] = {0, 0, 0, 0};
+	unsigned char* p = NULL;
+	unsigned char* e = NULL;
+	unsigned int a = 0;
+	foreach (april::Image::Format, it, formats)
+	{
+		(*it).getChannelIndices(&channels[0], &channels[1], &channels[2], &channels[3]);
+		for_iter (y, 0, h)
+		{
+			for_iter (x, 0, w)
+			{
+				p = &data[(x + y * w) * 4];
+				e = &expected[(x + y * w) * 4];
+				a = x % 256;
+				p[channels[0]] = (unsigned char)y;
+				p[channels[1]] = (unsigned char)(y ^ 0x55);
+				p[channels[2]] = (unsigned char)(y * 7);
+				p[channels[3]] = (unsigned char)a;
+				memcpy(e, p, 4);
+				if (a > 0 && a < 255)
+				{
+					for_iter (c, 0, 3)
+					{
+						e[channels[c]] = (unsigned char)hmin((p[channels[c]] * 255 + a / 2) / a, 255U);
+					}
+				}
+			}
+		}
+		april::Image::unpremultiplyAlpha(0, 0, w, h, data, w, h, (*it));
+		APRIL_CHECK_MESSAGE(memcmp(data, expected, w * h * 4) == 0, "unpremultiplyAlpha " + (*it).getName());
+	}
+	delete[] data;
+	delete[] expected;
+}
+
+APRIL_TEST(createMipmaps)
+{
+	// every level has to be the rounded average of 2x2 pixels, odd sizes reuse the last row or column
+	int w = 19; // leaves a tail and an odd column after the vectorized pixels
+	int h = 5;
+	unsigned char src[19 * 5 * 4];
+	_fillPattern(src, w * h * 4, 3);
+	unsigned char* levels = NULL;
+	APRIL_CHECK(april::Image::createMipmaps(w, h, src, april::Image::Format::RGBA, &levels));
+	bool result = true;
+	unsigned char* level = src;
+	unsigned char* dest = levels;
+	int destWidth = 0;
+	int destHeight = 0;
+	int x1 = 0;
+	int y1 = 0;
+	while (w > 1 || h > 1)
+	{
+		destWidth = hmax(w / 2, 1);
+		destHeight = hmax(h / 2, 1);
+		for_iter (y, 0, destHeight)
+		{
+			y1 = hmin(y * 2 + 1, h - 1);
+			for_iter (x, 0, destWidth)
+			{
+				x1 = hmin(x * 2 + 1, w - 1);
+				for_iter (c, 0, 4)
+				{
+					if (dest[(x + y * destWidth) * 4 + c] != (level[(x * 2 + y * 2 * w) * 4 + c] + level[(x1 + y * 2 * w) * 4 + c] +
+						level[(x * 2 + y1 * w) * 4 + c] + level[(x1 + y1 * w) * 4 + c] + 2) / 4)
+					{
+						result = false;
+					}
+				}
+			}
+		}
+		level = dest;
+		dest += destWidth * destHeight * 4;
+		w = destWidth;
+		h = destHeight;
+	}
+	APRIL_CHECK(result);
+	delete[] levels;
+}
@@ -0,0 +1,63 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <math.h>
+
+#include <gtypes/Rectangle.h>
+#include <gtypes/Vector2.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hstring.h>
+
+#include <april/aprilUtil.h>
+
+#include "util/quadInstances.h"
+#include "tests.h"
+
+#define TEST_INSTANCE_COUNT 5
+
+static bool _isClose(float value, float expected)
+{
+	return (fabs(value - expected) <= 0.0001f * (1.0f + fabs(expected)));
+}
+
+APRIL_TEST(expandQuadInstances)
+{
+	// every instance has to become 2 triangles with the corners in the order 0, 1, 2, 2, 1, 3
+	static const int corners[APRIL_QUAD_INSTANCE_VERTICES_COUNT] = {0, 1, 2, 2, 1, 3};
+	grectf rect(-3.0f, 4.0f, 10.0f, 20.0f);
+	april::QuadInstance instances[TEST_INSTANCE_COUNT];
+	april::ColoredTexturedVertex vertices[TEST_INSTANCE_COUNT * APRIL_QUAD_INSTANCE_VERTICES_COUNT];
+	for_iter (i, 0, TEST_INSTANCE_COUNT)
+	{
+		instances[i].setTransform(gvec2f(i * 50.0f - 70.0f, i * -13.0f), gvec2f(1.0f + i * 0.5f, 2.0f - i * 0.25f), i * 37.0f);
+		instances[i].src.set(i * 0.125f, 0.5f - i * 0.0625f, 0.125f, 0.25f);
+		instances[i].color = 0x10203040 * (i + 1);
+	}
+	april::expandQuadInstances(rect, 0.5f, instances, TEST_INSTANCE_COUNT, vertices);
+	bool result = true;
+	float x = 0.0f;
+	float y = 0.0f;
+	for_iter (i, 0, TEST_INSTANCE_COUNT)
+	{
+		const april::QuadInstance& instance = instances[i];
+		for_iter (j, 0, APRIL_QUAD_INSTANCE_VERTICES_COUNT)
+		{
+			const april::ColoredTexturedVertex& vertex = vertices[i * APRIL_QUAD_INSTANCE_VERTICES_COUNT + j];
+			x = ((corners[j] & 1) != 0 ? rect.x + rect.w : rect.x);
+			y = ((corners[j] & 2) != 0 ? rect.y + rect.h : rect.y);
+			if (!_isClose(vertex.x, instance.a * x + instance.c * y + instance.tx) || !_isClose(vertex.y, instance.b * x + instance.d * y + instance.ty) ||
+				vertex.z != 0.5f || vertex.color != instance.color ||
+				!_isClose(vertex.u, (corners[j] & 1) != 0 ? instance.src.x + instance.src.w : instance.src.x) ||
+				!_isClose(vertex.v, (corners[j] & 2) != 0 ? instance.src.y + instance.src.h : instance.src.y))
+			{
+				result = false;
+			}
+		}
+	}
+	APRIL_CHECK(result);
+}
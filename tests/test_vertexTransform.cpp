@@ -0,0 +1,117 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+
+#include <math.h>
+
+#include <gtypes/Matrix4.h>
+#include <gtypes/Vector2.h>
+#include <gtypes/Vector3.h>
+#include <hltypes/hltypesUtil.h>
+#include <hltypes/hstring.h>
+
+#include <april/aprilUtil.h>
+
+#include "util/vertexTransform.h"
+#include "tests.h"
+
+#define TEST_VERTEX_COUNT 23 // leaves a tail after the batches of 4 vertices
+
+static bool _isClose(float value, float expected)
+{
+	return (fabs(value - expected) <= 0.0001f * (1.0f + fabs(expected)));
+}
+
+static void _makeMatrices(gmat4& affine, gmat4& projection)
+{
+	affine.setIdentity();
+	affine.translate(-120.0f, 64.0f, 3.0f);
+	affine.rotate(0.3f, -0.8f, 0.5f, 37.0f);
+	affine.scale(1.5f, 0.75f, 2.0f);
+	projection.setPerspective(60.0f, 1.5f, 0.1f, 1000.0f);
+	projection = projection * affine;
+}
+
+APRIL_TEST(transformVertices)
+{
+	// the results have to match the old per-vertex path and the bounds have to match the transformed positions
+	gmat4 matrices[2];
+	_makeMatrices(matrices[0], matrices[1]);
+	april::TexturedVertex vertices[TEST_VERTEX_COUNT];
+	april::ColoredTexturedVertex destVertices[TEST_VERTEX_COUNT];
+	gvec3f expected;
+	gvec2f minimum;
+	gvec2f maximum;
+	gvec2f expectedMinimum;
+	gvec2f expectedMaximum;
+	for_iter (i, 0, TEST_VERTEX_COUNT)
+	{
+		vertices[i].set(i * 13.0f - 150.0f, (i % 7) * -21.0f + 40.0f, (i % 3) * 0.25f - 5.0f);
+		vertices[i].u = i * 0.1f;
+		vertices[i].v = 1.0f - i * 0.1f;
+	}
+	int counts[] = {1, 3, 4, 9, TEST_VERTEX_COUNT};
+	for_iter (m, 0, 2)
+	{
+		for_iter (c, 0, 5)
+		{
+			april::transformVertices(matrices[m], vertices, counts[c], 0x12345678, destVertices, minimum, maximum);
+			bool result = true;
+			for_iter (i, 0, counts[c])
+			{
+				expected = matrices[m] * gvec3f(vertices[i].x, vertices[i].y, vertices[i].z);
+				if (!_isClose(destVertices[i].x, expected.x) || !_isClose(destVertices[i].y, expected.y) || !_isClose(destVertices[i].z, expected.z) ||
+					destVertices[i].color != 0x12345678 || destVertices[i].u != vertices[i].u || destVertices[i].v != vertices[i].v)
+				{
+					result = false;
+				}
+				if (i == 0)
+				{
+					expectedMinimum.set(destVertices[i].x, destVertices[i].y);
+					expectedMaximum = expectedMinimum;
+				}
+				expectedMinimum.x = hmin(expectedMinimum.x, destVertices[i].x);
+				expectedMinimum.y = hmin(expectedMinimum.y, destVertices[i].y);
+				expectedMaximum.x = hmax(expectedMaximum.x, destVertices[i].x);
+				expectedMaximum.y = hmax(expectedMaximum.y, destVertices[i].y);
+			}
+			APRIL_CHECK_MESSAGE(result, hsprintf("transformVertices matrix %d count %d", m, counts[c]));
+			APRIL_CHECK_MESSAGE(minimum == expectedMinimum && maximum == expectedMaximum, hsprintf("transformVertices bounds matrix %d count %d", m, counts[c]));
+		}
+	}
+}
+
+APRIL_TEST(transformVerticesPlain)
+{
+	// plain vertices are tightly packed so the last one must not be read beyond its end
+	gmat4 matrices[2];
+	_makeMatrices(matrices[0], matrices[1]);
+	april::PlainVertex vertices[TEST_VERTEX_COUNT];
+	april::ColoredVertex destVertices[TEST_VERTEX_COUNT];
+	gvec3f expected;
+	gvec2f minimum;
+	gvec2f maximum;
+	for_iter (i, 0, TEST_VERTEX_COUNT)
+	{
+		vertices[i].set(i * -7.0f + 30.0f, i * 5.0f, 1.0f);
+	}
+	for_iter (m, 0, 2)
+	{
+		april::transformVertices(matrices[m], vertices, TEST_VERTEX_COUNT, 0xFF00FF00, destVertices, minimum, maximum);
+		bool result = true;
+		for_iter (i, 0, TEST_VERTEX_COUNT)
+		{
+			expected = matrices[m] * gvec3f(vertices[i].x, vertices[i].y, vertices[i].z);
+			if (!_isClose(destVertices[i].x, expected.x) || !_isClose(destVertices[i].y, expected.y) || !_isClose(destVertices[i].z, expected.z) ||
+				destVertices[i].color != 0xFF00FF00 || destVertices[i].x < minimum.x || destVertices[i].y < minimum.y || destVertices[i].x > maximum.x || destVertices[i].y > maximum.y)
+			{
+				result = false;
+			}
+		}
+		APRIL_CHECK_MESSAGE(result, hsprintf("transformVertices plain matrix %d", m));
+	}
+}
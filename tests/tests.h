@@ -0,0 +1,49 @@
+/// @file
+/// @version 5.2
+/// 
+/// @section LICENSE
+/// 
+/// This program is free software; you can redistribute it and/or modify it under
+/// the terms of the BSD license: http://opensource.org/licenses/BSD-3-Clause
+/// 
+/// @section DESCRIPTION
+/// 
+/// Defines a minimal test registry for the april_tests runner.
+
+#ifndef APRIL_TESTS_H
+#define APRIL_TESTS_H
+
+#include <hltypes/harray.h>
+#include <hltypes/hstring.h>
+
+#include <april/Image.h>
+
+#define TESTS_LOG_TAG "tests"
+
+/// @brief Defines a test function that is registered with the runner.
+#define APRIL_TEST(name) \
+	static void _test_ ## name(); \
+	static TestRegistrar _testRegistrar_ ## name(#name, &_test_ ## name); \
+	static void _test_ ## name()
+
+/// @brief Fails the current test if the condition is false, but keeps running it.
+#define APRIL_CHECK(condition) _testCheck((condition), #condition, __FILE__, __LINE__)
+/// @brief Fails the current test with a custom message if the condition is false, but keeps running it.
+#define APRIL_CHECK_MESSAGE(condition, message) _testCheck((condition), (message), __FILE__, __LINE__)
+
+typedef void (*TestFunction)();
+
+/// @brief Registers a test function with the runner during static initialization.
+class TestRegistrar
+{
+public:
+	TestRegistrar(const char* name, TestFunction function);
+
+};
+
+/// @brief Records the result of a check.
+void _testCheck(bool result, chstr message, const char* file, int line);
+/// @brief Gets all pixel formats that hold uncompressed pixels.
+harray<april::Image::Format> _testGetPixelFormats();
+
+#endif